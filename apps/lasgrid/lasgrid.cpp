@@ -64,9 +64,9 @@ main(int argc, char* argv[])
       const spgl::io::LasPoint cellPoint = grid[gridIndexKey];
 
       // Compute distance to grid cell center
-      const spgl::Vector3 cellCenter =
-        (gridIndex.staticCast<double>() * spacing) +
-        spgl::Vector3(0.5 * spacing);
+      spgl::Vector3 cellCenter = gridIndex.staticCast<double>();
+      cellCenter += 0.5;
+      cellCenter *= spacing;
       const double distanceGridPoint = cellCenter.distance(cellPoint.xyz);
       const double distanceNewPoint = cellCenter.distance(lasPoint.xyz);
 
@@ -15,16 +15,31 @@
 
 #include <spatiumgl/idx/NTree.hpp>
 
+#include <array>  // std::array
+#include <string> // std::string
+
 using Point = std::array<double, 3>;
 using Extent = std::array<Point, 2>;
 
-class LasOctree : public spgl::idx::NTree<void, 8>
+/// \class LasOctree
+/// \brief Octree of LAS files.
+///
+/// The payload of every node is the path to the LAS file with its points.
+class LasOctree : public spgl::idx::NTree<8, std::string>
 {
-  std::array<std::array<double, 3>, 2> computeNodeExtent(
-    const spgl::idx::NTree<void, 8>* node) const
-  {
+public:
+  /// Constructor.
+  ///
+  /// \param[in] extent Extent of entire octree
+  LasOctree(const Extent& extent)
+    : NTree()
+    , m_extent(extent)
+  {}
 
-  }
+  /// Get extent of entire octree.
+  ///
+  /// \return Extent
+  const Extent& extent() const { return m_extent; }
 
 protected:
   Extent m_extent;
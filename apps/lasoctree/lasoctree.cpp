@@ -2,6 +2,8 @@
 
 #include "LasOctant.hpp"
 #include <spatiumgl/idx/NTree.hpp>
+#include <spatiumgl/idx/Octree.hpp>
+#include <spatiumgl/idx/OctreeHierarchyFile.hpp>
 
 #include "lasreader.hpp" // LASlib
 
@@ -67,20 +69,29 @@ main(int argc, char* argv[])
   lasReader->close();
   lasReader.reset(nullptr);
 
+  // Hierarchy of nodes, for streaming (see octree.idx)
+  spgl::idx::Octree hierarchy(
+    spgl::BoundingCube({ center[0], center[1], center[2] }, radius));
+
   // Process root node
-  LasOctant octant(fileIn, dirOut + "\\r.las"); // Windows backslash!
+  LasOctant octant(fileIn, dirOut + "/r.las");
   if (!octant.isOpen()) {
     return 1;
   }
   std::array<long long, 8> childPointCounts = octant.process(extent, spacing);
 
   // Push first children on queue
-  std::queue<std::tuple<std::string,Extent,double>> queue;
+  std::queue<std::tuple<std::string, Extent, double, spgl::idx::OctreeNode*>>
+    queue;
   for (size_t i = 0; i < 8; i++) {
+    if (childPointCounts[i] > 0) {
+      hierarchy.root()->createChild(i);
+    }
     if (childPointCounts[i] > targetPointCount) {
       queue.push({ LasOctant::computeFilePath(octant.fileOut(), static_cast<unsigned char>(i)),
                    LasOctant::computeChildExtent(extent, static_cast<unsigned char>(i)),
-				   spacing / 2});
+				   spacing / 2,
+                   hierarchy.root()->child(i) });
 	}
   }
   octant.close();
@@ -89,11 +100,13 @@ main(int argc, char* argv[])
   while (!queue.empty()) {
 
     // Pop first file from queue
-    std::tuple<std::string, Extent,double> item = queue.front();
+    std::tuple<std::string, Extent, double, spgl::idx::OctreeNode*> item =
+      queue.front();
     queue.pop();
     std::string fileName =  std::get<0>(item);
     Extent extent = std::get<1>(item);
     double spacing = std::get<2>(item);
+    spgl::idx::OctreeNode* node = std::get<3>(item);
 
 	// Process octant
     LasOctant octant(fileName);
@@ -105,13 +118,25 @@ main(int argc, char* argv[])
 
 	// Push children on queue
     for (size_t i = 0; i < 8; i++) {
+      if (childPointCounts[i] > 0) {
+        node->createChild(i);
+      }
       if (childPointCounts[i] > targetPointCount) {
         queue.push({ LasOctant::computeFilePath(octant.fileOut(), static_cast<unsigned char>(i)),
                      LasOctant::computeChildExtent(extent, static_cast<unsigned char>(i)),
-					 spacing / 2});
+					 spacing / 2,
+                     node->child(i) });
       }
     }
   }
 
+  // Write hierarchy: nodes r<child indices>.las, with the root spacing
+  if (spgl::idx::OctreeHierarchyFile::write(
+        hierarchy, dirOut + "/octree.idx", 6, static_cast<float>(spacing)) ==
+      0) {
+    std::cerr << "Failed to write hierarchy." << std::endl;
+    return 1;
+  }
+
   return 0;
 }
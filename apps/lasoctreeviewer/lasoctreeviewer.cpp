@@ -1,14 +1,33 @@
 #include <spatiumgl/Math.hpp>
 #include <spatiumgl/idx/Octree.hpp>
+#include <spatiumgl/idx/OctreeHierarchyFile.hpp>
 #include <spatiumgl/gfx3d/GlfwRenderWindow.hpp>
 #include <spatiumgl/gfx3d/OGLOctreeRenderer.hpp>
+#include <spatiumgl/gfx3d/OGLStreamingPointCloudRenderer.hpp>
 #include <spatiumgl/gfx3d/PerspectiveCamera.hpp>
 #include <spatiumgl/gfx3d/PivotInteractor.hpp>
 #include <spatiumgl/io/LasReadTask.hpp>
+#include <spatiumgl/io/LasReader.hpp>
+#include <spatiumgl/io/LasUtils.hpp>
 
 #include "CLI11.hpp"
 
+#include <algorithm> // std::max
 #include <iostream>
+#include <memory> // std::shared_ptr
+#include <vector>
+
+/// Copy the nodes of an octree (not the points) into another one.
+void
+copyTopology(const spgl::idx::OctreeNode* from, spgl::idx::OctreeNode* to)
+{
+  for (size_t i = 0; i < 8; i++) {
+    if (from->child(i) != nullptr) {
+      to->createChild(i);
+      copyTopology(from->child(i), to->child(i));
+    }
+  }
+}
 
 int
 main(int argc, char* argv[])
@@ -17,10 +36,118 @@ main(int argc, char* argv[])
   CLI::App app{ "View massive LAS/LAZ point cloud in 3D utilizing a spatial index." };
   std::string dirIn;
   app.add_option("-i,--input", dirIn, "Input directory with spatial index (*.idx) and point cloud (LAS/LAZ) files.")
-    ->required()
     ->check(CLI::ExistingDirectory);
+  std::string lasIn;
+  app.add_option("-l,--las", lasIn, "LAS/LAZ file to voxelize into an occupancy octree.")
+    ->check(CLI::ExistingFile);
+  size_t maxDepth = 8;
+  app.add_option("-d,--depth", maxDepth, "Octree depth when voxelizing (<= 21, default = 8).");
+  size_t budget = 1024;
+  app.add_option("-b,--budget", budget, "Memory budget of loaded nodes in MiB, for CPU and GPU each (default = 1024).");
+  bool showOctree = false;
+  app.add_flag("-w,--wireframe", showOctree, "Show octree nodes when streaming.");
+  bool compact = false;
+  app.add_flag("-q,--quantize", compact, "Store nodes in compact formats (16 bit positions, 8 bit colors).");
   CLI11_PARSE(app, argc, argv)
 
+  spgl::idx::Octree octree(spgl::BoundingCube({ 5, 5, 5 }, 5));
+  std::unique_ptr<spgl::gfx3d::StreamingPointCloudObject> streamingObject;
+  if (!dirIn.empty()) {
+    // Read hierarchy written by lasoctree
+    spgl::idx::OctreeHierarchyFile hierarchyFile;
+    if (!hierarchyFile.open(dirIn + "/octree.idx") ||
+        !hierarchyFile.readOctree(octree)) {
+      std::cerr << "Failed to read " << dirIn << "/octree.idx" << std::endl;
+      return 1;
+    }
+    std::cout << "Octree nodes: " << octree.nodeCount() << std::endl;
+
+    // Nodes are positioned relative to the minimum of the octree bounds, to
+    // keep single precision coordinates accurate
+    const spgl::BoundingCube& cube = hierarchyFile.bounds();
+    const spgl::Vector3 origin =
+      cube.center() -
+      spgl::Vector3(cube.radius(), cube.radius(), cube.radius());
+    spgl::idx::Octree hierarchy(
+      spgl::BoundingCube(cube.center() - origin, cube.radius()));
+    copyTopology(octree.root(), hierarchy.root());
+
+    // Load node file r<child indices>.las
+    auto loader = [dirIn, origin, compact](spgl::gfx3d::LodNodeKey key) {
+      spgl::io::LasReader lasReader(dirIn + "/" +
+                                    spgl::gfx3d::lodNodeName(key) + ".las");
+      if (!lasReader.open()) {
+        return std::shared_ptr<spgl::gfx3d::PointCloudData>();
+      }
+      const spgl::io::LasHeader& lasHeader = lasReader.lasHeader();
+      const spgl::Vector3 offset = lasHeader.extent.min() - origin;
+      const bool hasRgb =
+        spgl::io::LasUtils::formatHasRgb(lasHeader.point_data_format);
+      std::vector<spgl::Vector3f> positions;
+      std::vector<spgl::Vector3f> colors;
+      std::vector<spgl::gfx3d::Rgba8> packedColors;
+      while (lasReader.readLasPoint()) {
+        const spgl::io::LasPoint& lasPoint = lasReader.lasPoint();
+        positions.push_back((lasPoint.xyz + offset).staticCast<float>());
+        if (hasRgb) {
+          const spgl::Vector3f color(
+            static_cast<float>(lasPoint.rgb[0]) / 65535,
+            static_cast<float>(lasPoint.rgb[1]) / 65535,
+            static_cast<float>(lasPoint.rgb[2]) / 65535);
+          if (compact) {
+            packedColors.push_back(spgl::gfx3d::packColor(color));
+          } else {
+            colors.push_back(color);
+          }
+        }
+      }
+      if (compact) {
+        return std::make_shared<spgl::gfx3d::PointCloudData>(
+          std::move(positions), std::move(packedColors));
+      }
+      return std::make_shared<spgl::gfx3d::PointCloudData>(std::move(positions),
+                                                           std::move(colors));
+    };
+
+    // Spacing is unknown in hierarchies of older versions: guess
+    const double spacing = (hierarchyFile.spacing() > 0
+                              ? hierarchyFile.spacing()
+                              : cube.radius() / 64);
+    streamingObject.reset(new spgl::gfx3d::StreamingPointCloudObject(
+      std::move(hierarchy), spacing, loader, budget << 20, 2, origin));
+  } else if (!lasIn.empty()) {
+    // Read all points from file
+    spgl::io::LasReadTask readTask(lasIn, false);
+    std::string error = readTask.validate();
+    if (!error.empty()) {
+      std::cerr << error << std::endl;
+      return 1;
+    }
+    readTask.start();
+    readTask.join();
+    std::shared_ptr<spgl::gfx3d::PointCloud> pointCloud = readTask.result();
+    if (pointCloud == nullptr) {
+      std::cerr << "Error reading point cloud." << std::endl;
+      return 1;
+    }
+
+    // Voxelize in cubical bounds
+    const std::vector<spgl::Vector3f>& positions =
+      pointCloud->data().positions();
+    const spgl::BoundingBox box = spgl::BoundingBox::fromPoints(positions, 0);
+    const spgl::Vector3& radii = box.radii();
+    const double radius = std::max(std::max(radii[0], radii[1]), radii[2]);
+    octree = spgl::idx::Octree::fromPoints(
+      positions, spgl::BoundingCube(box.center(), radius), maxDepth);
+    std::cout << "Octree nodes: " << octree.nodeCount() << std::endl;
+  } else {
+    // Example octree
+    octree.root()->createChild(4);
+    octree.root()->child(4)->createChild(5);
+    octree.root()->child(4)->child(5)->createChild(6);
+    octree.root()->child(4)->child(5)->child(6)->createChild(7);
+  }
+
   // Create and initialize render window
   spgl::gfx3d::GlfwRenderWindow renderWindow(true);
   if (!renderWindow.init()) {
@@ -45,16 +172,10 @@ main(int argc, char* argv[])
   spgl::gfx3d::PivotInteractor interactor(&renderWindow);
   renderWindow.setInteractor(&interactor);
 
-  spgl::idx::Octree octree(spgl::BoundingCube({ 5, 5, 5 }, 5));
-  octree.root()->createChild(4);
-  octree.root()->child(4)->createChild(5);
-  octree.root()->child(4)->child(5)->createChild(6);
-  octree.root()->child(4)->child(5)->child(6)->createChild(7);
-
-  // Create point cloud render object
+  // Create octree render object
   spgl::gfx3d::OctreeObject octreeObject(std::move(octree)); // move!
 
-  // Create point cloud renderer
+  // Create octree renderer
   spgl::gfx3d::OGLOctreeRenderer renderer(&octreeObject);
   if (!renderer.isValid()) {
     // Exit
@@ -63,7 +184,28 @@ main(int argc, char* argv[])
   }
 
   // Add renderer to window
-  renderWindow.addRenderer(&renderer);
+  if (streamingObject == nullptr || showOctree) {
+    renderWindow.addRenderer(&renderer);
+  }
+
+  // Create streaming point cloud renderer
+  std::unique_ptr<spgl::gfx3d::OGLStreamingPointCloudRenderer>
+    streamingRenderer;
+  if (streamingObject != nullptr) {
+    spgl::gfx3d::StreamingPointCloudRenderOptions renderOptions;
+    renderOptions.gpuMemoryBudget = budget << 20;
+    if (compact) {
+      renderOptions.positionFormat = spgl::gfx3d::PointPositionFormat::UInt16;
+    }
+    streamingRenderer.reset(new spgl::gfx3d::OGLStreamingPointCloudRenderer(
+      streamingObject.get(), renderOptions));
+    if (!streamingRenderer->isValid()) {
+      // Exit
+      renderWindow.terminate();
+      return 1;
+    }
+    renderWindow.addRenderer(streamingRenderer.get());
+  }
 
   // Point camera to dataset
   interactor.resetCamera();
@@ -1,4 +1,5 @@
 #include <spatiumgl/Math.hpp>
+#include <spatiumgl/gfx3d/Animator.hpp>
 #include <spatiumgl/gfx3d/GlfwRenderWindow.hpp>
 #include <spatiumgl/gfx3d/OGLPointCloudRenderer.hpp>
 #include <spatiumgl/gfx3d/PerspectiveCamera.hpp>
@@ -27,6 +28,52 @@ enum ColoringMethod : int
   UserData
 };
 
+/// Appends the points read by a LAS read task to a point cloud, every frame.
+///
+/// Once all points are read and uploaded, the point cloud data is cleared to
+/// free memory, and the animator deactivates.
+class LasReadAnimator : public spgl::gfx3d::Animator
+{
+public:
+  LasReadAnimator(spgl::gfx3d::PointCloudObject* pointCloudObject,
+                  spgl::io::LasReadTask* readTask,
+                  const spgl::gfx3d::OGLPointCloudRenderer* renderer)
+    : Animator(pointCloudObject)
+    , m_pointCloudObject(pointCloudObject)
+    , m_readTask(readTask)
+    , m_renderer(renderer)
+  {}
+
+  void animate(double deltaTime) override
+  {
+    // Batches handed out before the task stopped are taken below
+    const bool reading = m_readTask->isRunning();
+
+    spgl::gfx3d::PointCloudData& data = m_pointCloudObject->pointCloud().data();
+    for (spgl::gfx3d::PointCloudData& batch : m_readTask->takeBatches()) {
+      data.append(std::move(batch));
+    }
+
+    // Chunks are extended when rendering, after animating
+    const std::vector<spgl::gfx3d::PointCloudChunk>& chunks =
+      m_renderer->chunks();
+    const size_t chunked =
+      chunks.empty() ? 0 : chunks.back().first + chunks.back().count;
+    if (!reading && chunked == data.positions().size() &&
+        !m_renderer->needsRedraw()) {
+      std::cout << "Point cloud size: " << data.computeSize() << " bytes"
+                << std::endl;
+      data.clear();
+      setActive(false);
+    }
+  }
+
+private:
+  spgl::gfx3d::PointCloudObject* m_pointCloudObject;
+  spgl::io::LasReadTask* m_readTask;
+  const spgl::gfx3d::OGLPointCloudRenderer* m_renderer;
+};
+
 int
 main(int argc, char* argv[])
 {
@@ -65,6 +112,23 @@ main(int argc, char* argv[])
     pointScaleWorld,
     "Flag to set point size in world space. (Default = screen space)");
 
+  bool compact = false;
+  app.add_flag("-q,--quantize",
+               compact,
+               "Flag to store points in compact formats (16 bit positions and "
+               "scalars, 8 bit colors).");
+
+  bool adaptive = false;
+  app.add_flag("-a,--adaptive",
+               adaptive,
+               "Flag to draw fewer points while navigating, to keep the frame "
+               "rate (points are reordered while reading).");
+
+  size_t pointBudget = 0;
+  app.add_option("-b,--budget",
+                 pointBudget,
+                 "Maximum number of points drawn per frame (0 = unlimited).");
+
   CLI11_PARSE(app, argc, argv)
 
   // Map coloring method to LAS scalars
@@ -88,7 +152,7 @@ main(int argc, char* argv[])
 
   // Construct point cloud reader
   spgl::io::LasReadTask readTask(
-    fileIn, (coloringMethod == ColoringMethod::RGB), scalarsToRead);
+    fileIn, (coloringMethod == ColoringMethod::RGB), scalarsToRead, compact);
   std::string error = readTask.validate();
   if (!error.empty()) {
     std::cerr << error << std::endl;
@@ -105,44 +169,55 @@ main(int argc, char* argv[])
                   : "No")
             << std::endl;
 
-  // Read all points from file
-  readTask.start();
-
-  // Print progress every second
-  int progress = 0;
-  while (readTask.isRunning()) {
-    // Sleep for 1 second
-    std::this_thread::sleep_for(std::chrono::milliseconds(1000));
-
-    // Check and print progress if updated
-    int currentProgress = readTask.progress().percentage();
-    if (currentProgress > progress) {
-      int dots = currentProgress - progress;
-      for (int i = 0; i < dots; i++) {
-        std::cout << "." << std::flush;
-      }
-      progress = currentProgress;
+  // Header of the point cloud, from the LAS header. Points are appended in
+  // batches while they are read.
+  const spgl::io::LasHeader& lasHeader = readTask.lasReader().lasHeader();
+  const size_t pointCount =
+    static_cast<size_t>(lasHeader.number_of_point_records);
+  const bool hasRgb = readTask.readsRgb();
+  const spgl::io::LasScalars readScalars = readTask.readsScalars();
+  const bool hasScalars = (readScalars != spgl::io::LasScalars::None);
+  const spgl::gfx3d::PointCloudHeader header(
+    pointCount, hasRgb, hasScalars, lasHeader.extent);
+
+  // Reserve memory for all points, to append without reallocations
+  std::vector<spgl::Vector3f> positions;
+  positions.reserve(pointCount);
+  std::vector<spgl::Vector3f> colors;
+  std::vector<spgl::gfx3d::Rgba8> packedColors;
+  if (hasRgb) {
+    if (compact) {
+      packedColors.reserve(pointCount);
+    } else {
+      colors.reserve(pointCount);
     }
   }
-  std::cout << std::endl;
-
-  // Join with read task
-  readTask.join();
+  spgl::gfx3d::Scalars<float> scalars(
+    hasScalars ? pointCount : 0,
+    spgl::io::LasUtils::scalarsToString(readScalars));
+  spgl::gfx3d::PointCloudData data =
+    compact ? spgl::gfx3d::PointCloudData(std::move(positions),
+                                          std::move(packedColors),
+                                          std::move(scalars))
+            : spgl::gfx3d::PointCloudData(
+                std::move(positions), std::move(colors), std::move(scalars));
+  spgl::gfx3d::PointCloudObject pointCloudObject(
+    spgl::gfx3d::PointCloud(header, std::move(data)));
 
-  std::shared_ptr<spgl::gfx3d::PointCloud> pointCloud = readTask.result();
-  if (pointCloud == nullptr) {
-    std::cerr << "Error reading point cloud." << std::endl;
-    return 1;
+  // Read points from file, in batches
+  readTask.setBatchSize(1 << 18);
+  if (adaptive || pointBudget > 0) {
+    // Every batch becomes a chunk, in which every prefix is a subsample
+    readTask.setPointOrder(spgl::gfx3d::PointOrder::MortonStratified);
   }
-
-  std::cout << "Point cloud size: "
-            << std::to_string(pointCloud->data().computeSize()) << " bytes"
-            << std::endl;
+  readTask.start();
 
   // Create and initialize render window
   spgl::gfx3d::GlfwRenderWindow renderWindow(true);
   if (!renderWindow.init()) {
     std::cerr << "Failed to initialize GLFW." << std::endl;
+    readTask.cancel();
+    readTask.join();
     return 1;
   }
 
@@ -152,24 +227,32 @@ main(int argc, char* argv[])
 
     // Release resources of GLFW
     renderWindow.terminate();
+    readTask.cancel();
+    readTask.join();
     return 1;
   }
 
   // Set up camera
   spgl::gfx3d::PerspectiveCamera camera;
   renderWindow.setCamera(&camera);
+  renderWindow.setPointBudget(pointBudget);
 
   // Set up render window interactor
   spgl::gfx3d::PlaneInteractor interactor(&renderWindow);
   renderWindow.setInteractor(&interactor);
 
-  // Create point cloud render object
-  spgl::gfx3d::PointCloudObject pointCloudObject(
-    std::move(*pointCloud)); // move!
-
   spgl::gfx3d::PointCloudRenderOptions renderOptions;
   renderOptions.pointSize = pointSize;
   renderOptions.pointScaleWorld = pointScaleWorld;
+  if (compact) {
+    renderOptions.positionFormat = spgl::gfx3d::PointPositionFormat::UInt16;
+    renderOptions.packColors = true;
+    renderOptions.scalarFormat = spgl::gfx3d::PointScalarFormat::UInt16;
+  }
+  if (adaptive || pointBudget > 0) {
+    renderOptions.chunkSize = readTask.batchSize();
+    renderOptions.adaptivePointBudget = adaptive;
+  }
   if (coloringMethod == RGB) {
     renderOptions.colorMethod =
       spgl::gfx3d::PointCloudRenderingColorMethod::RGB;
@@ -186,20 +269,28 @@ main(int argc, char* argv[])
   if (!renderer.isValid()) {
     // Exit
     renderWindow.terminate();
+    readTask.cancel();
+    readTask.join();
     return 1;
   }
 
-  pointCloudObject.pointCloud().data().clear();
-
   // Add renderer to window
   renderWindow.addRenderer(&renderer);
 
+  // Append points to the point cloud while they are read
+  LasReadAnimator readAnimator(&pointCloudObject, &readTask, &renderer);
+  renderWindow.addAnimator(&readAnimator);
+
   // Point camera to dataset
   interactor.resetCamera();
 
   // Show window
   renderWindow.show();
 
+  // Stop reading if the window was closed early
+  readTask.cancel();
+  readTask.join();
+
   // Destroy window
   renderWindow.destroyWindow();
 
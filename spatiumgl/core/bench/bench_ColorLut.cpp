@@ -0,0 +1,80 @@
+#include <spatiumgl/ColorLut.hpp>
+#include <spatiumgl/Simd.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+// Compare mapping scalars to colors through a color lookup table against
+// ColorRampT::map().
+//
+// Usage: core_bench_colorlut [value_count]
+
+namespace {
+
+template<typename Function>
+double
+measure(Function function, int repetitions)
+{
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < repetitions; i++) {
+    function();
+  }
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count() /
+         repetitions;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  const size_t count =
+    (argc > 1 ? static_cast<size_t>(std::atol(argv[1])) : 10000000);
+  const int repetitions = 5;
+
+  std::vector<float> values(count);
+  for (size_t i = 0; i < count; i++) {
+    values[i] = static_cast<float>(i % 1000);
+  }
+  std::vector<spgl::Color8> result(count);
+
+  std::cout << "Values: " << count << std::endl;
+
+  const spgl::ColorRampT<float> ramp =
+    spgl::ColorRampT<float>::spectral(0, 999);
+  const size_t rampCount = count / 100;
+  const double rampTime = measure(
+    [&]() {
+      for (size_t i = 0; i < rampCount; i++) {
+        const spgl::ColorT<float> color = ramp.map(values[i]);
+        result[i].R = static_cast<std::uint8_t>(color.R * 255);
+      }
+    },
+    repetitions);
+  std::cout << "ColorRampT::map (extrapolated): " << rampTime * 100 << " ms"
+            << std::endl;
+
+  const double build = measure(
+    [&]() { const spgl::ColorLut lut(ramp); }, repetitions);
+  std::cout << "ColorLut construction (256 entries): " << build << " ms"
+            << std::endl;
+
+  const spgl::ColorLut lut(ramp);
+  const spgl::SimdLevel levels[] = { spgl::SimdLevel::None,
+                                     spgl::SimdLevel::SSE2,
+                                     spgl::SimdLevel::AVX };
+  for (spgl::SimdLevel level : levels) {
+    if (spgl::setSimdLevel(level) != level) {
+      continue;
+    }
+    const double time = measure(
+      [&]() { lut.map(values.data(), count, result.data()); }, repetitions);
+    std::cout << "ColorLut::map (level " << static_cast<int>(level)
+              << "): " << time << " ms" << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,78 @@
+#include <spatiumgl/Bounds.hpp>
+#include <spatiumgl/Simd.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+// Compare the parallel SIMD bounding box computation against including
+// points one by one.
+//
+// Usage: core_bench_minmax [point_count]
+
+namespace {
+
+template<typename Function>
+double
+measure(Function function, int repetitions)
+{
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < repetitions; i++) {
+    function();
+  }
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count() /
+         repetitions;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  const size_t count =
+    (argc > 1 ? static_cast<size_t>(std::atol(argv[1])) : 10000000);
+  const int repetitions = 5;
+
+  std::vector<spgl::Vector3f> points(count);
+  for (size_t i = 0; i < count; i++) {
+    points[i] = { static_cast<float>(i % 1000),
+                  static_cast<float>(i % 777),
+                  static_cast<float>(i % 333) };
+  }
+
+  std::cout << "Points: " << count << std::endl;
+
+  spgl::BoundingBox reference;
+  const double include = measure(
+    [&]() {
+      reference = spgl::BoundingBox(points[0].staticCast<double>(), {});
+      for (size_t i = 1; i < count; i++) {
+        reference.include(points[i].staticCast<double>());
+      }
+    },
+    repetitions);
+  std::cout << "BoundingBox::include: " << include << " ms" << std::endl;
+
+  const spgl::SimdLevel levels[] = { spgl::SimdLevel::None,
+                                     spgl::SimdLevel::SSE2,
+                                     spgl::SimdLevel::AVX };
+  for (spgl::SimdLevel level : levels) {
+    if (spgl::setSimdLevel(level) != level) {
+      continue;
+    }
+    for (size_t threads : { 1, 0 }) {
+      spgl::BoundingBox box;
+      const double time = measure(
+        [&]() { box = spgl::BoundingBox::fromPoints(points, threads); },
+        repetitions);
+      std::cout << "BoundingBox::fromPoints (level "
+                << static_cast<int>(level) << ", threads "
+                << spgl::resolveThreadCount(threads) << "): " << time << " ms"
+                << (box == reference ? "" : " (MISMATCH)") << std::endl;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,105 @@
+#include <spatiumgl/Matrix.hpp>
+#include <spatiumgl/PointTransform.hpp>
+#include <spatiumgl/Simd.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+// Compare the batched point transformation kernels against transforming
+// every point through Matrix::operator*().
+//
+// Usage: core_bench [point_count]
+
+namespace {
+
+const char*
+levelName(spgl::SimdLevel level)
+{
+  switch (level) {
+    case spgl::SimdLevel::AVX:
+      return "AVX";
+    case spgl::SimdLevel::SSE2:
+      return "SSE2";
+    default:
+      return "scalar";
+  }
+}
+
+template<typename Function>
+double
+measure(Function function, int repetitions)
+{
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < repetitions; i++) {
+    function();
+  }
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count() /
+         repetitions;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  const size_t count =
+    (argc > 1 ? static_cast<size_t>(std::atol(argv[1])) : 1000000);
+  const int repetitions = 10;
+
+  std::vector<spgl::Vector3f> points(count);
+  for (size_t i = 0; i < count; i++) {
+    points[i] = { static_cast<float>(i % 1000),
+                  static_cast<float>(i % 777),
+                  static_cast<float>(i % 333) };
+  }
+  std::vector<spgl::Vector3f> result(count);
+  std::vector<spgl::Vector4f> projected(count);
+
+  const spgl::Matrix4 matrix = spgl::Matrix4::perspective(1.0, 1.5, 0.1, 100.0) *
+                               spgl::Matrix4::translation(1, 2, 3);
+  const spgl::Matrix4f matrixf = matrix.staticCast<float>();
+
+  std::cout << "Points: " << count << std::endl;
+
+  const double reference = measure(
+    [&]() {
+      for (size_t i = 0; i < count; i++) {
+        const spgl::Vector4f p = matrixf * spgl::Vector4f(
+                                             points[i].x(),
+                                             points[i].y(),
+                                             points[i].z(),
+                                             1.0f);
+        projected[i] = p;
+      }
+    },
+    repetitions);
+  std::cout << "Matrix4f * Vector4f: " << reference << " ms" << std::endl;
+
+  const spgl::SimdLevel levels[] = { spgl::SimdLevel::None,
+                                     spgl::SimdLevel::SSE2,
+                                     spgl::SimdLevel::AVX };
+  for (spgl::SimdLevel level : levels) {
+    if (spgl::setSimdLevel(level) != level) {
+      continue;
+    }
+    const double transform = measure(
+      [&]() {
+        spgl::transformPoints(matrix, points.data(), count, result.data());
+      },
+      repetitions);
+    const double project = measure(
+      [&]() {
+        spgl::projectPoints(matrix, points.data(), count, projected.data());
+      },
+      repetitions);
+    std::cout << "transformPoints (" << levelName(level) << "): " << transform
+              << " ms" << std::endl;
+    std::cout << "projectPoints (" << levelName(level) << "): " << project
+              << " ms" << std::endl;
+  }
+
+  return 0;
+}
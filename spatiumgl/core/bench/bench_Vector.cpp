@@ -0,0 +1,86 @@
+#include <spatiumgl/Vector.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+// Compare compound Vector expressions against the equivalent hand-written
+// scalar code. With the unrolled operators both should perform equally.
+//
+// Usage: core_bench_vector [point_count]
+
+namespace {
+
+template<typename Function>
+double
+measure(Function function, int repetitions)
+{
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < repetitions; i++) {
+    function();
+  }
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count() /
+         repetitions;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  const size_t count =
+    (argc > 1 ? static_cast<size_t>(std::atol(argv[1])) : 1000000);
+  const int repetitions = 10;
+  const double spacing = 0.25;
+
+  std::vector<spgl::Vector3i> indices(count);
+  for (size_t i = 0; i < count; i++) {
+    const int j = static_cast<int>(i);
+    indices[i] = { j % 1000, j % 777, j % 333 };
+  }
+  std::vector<spgl::Vector3> result(count);
+  const spgl::Vector3 point(12.5, -3.25, 7.75);
+
+  std::cout << "Points: " << count << std::endl;
+
+  // Grid cell center and distance (see lasgrid)
+  double sumVector = 0;
+  const double vector = measure(
+    [&]() {
+      for (size_t i = 0; i < count; i++) {
+        const spgl::Vector3 center =
+          (indices[i].staticCast<double>() * spacing) +
+          spgl::Vector3(0.5 * spacing);
+        result[i] = center;
+        sumVector += center.distance(point);
+      }
+    },
+    repetitions);
+
+  double sumScalar = 0;
+  const double scalar = measure(
+    [&]() {
+      for (size_t i = 0; i < count; i++) {
+        const double x = indices[i][0] * spacing + 0.5 * spacing;
+        const double y = indices[i][1] * spacing + 0.5 * spacing;
+        const double z = indices[i][2] * spacing + 0.5 * spacing;
+        result[i][0] = x;
+        result[i][1] = y;
+        result[i][2] = z;
+        const double dx = x - point[0];
+        const double dy = y - point[1];
+        const double dz = z - point[2];
+        sumScalar += std::sqrt(dx * dx + dy * dy + dz * dz);
+      }
+    },
+    repetitions);
+
+  std::cout << "Vector expression: " << vector << " ms (" << sumVector << ")"
+            << std::endl;
+  std::cout << "Scalar code: " << scalar << " ms (" << sumScalar << ")"
+            << std::endl;
+
+  return 0;
+}
@@ -18,6 +18,7 @@
 
 #include <thread> // std::thread
 #include <atomic> // std::atomic
+#include <memory> // std::shared_ptr, std::unique_ptr
 #include <mutex>  // std::mutex
 #include <string> // std::string
 
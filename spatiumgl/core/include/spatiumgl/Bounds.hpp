@@ -14,9 +14,12 @@
 #define SPATIUMGL_GFX3D_BOUNDS_H
 
 #include "spatiumglexport.hpp"
+#include "MinMax.hpp"
+#include "Parallel.hpp"
 #include "Vector.hpp"
 
-#include <vector> // std::vector
+#include <type_traits> // std::is_same
+#include <vector>      // std::vector
 
 namespace spgl {
 
@@ -316,6 +319,66 @@ struct BoundingBoxT
     return BoundingBoxT::fromMinMax(minVal, maxVal);
   }
 
+  /// Construct from points (parallel).
+  ///
+  /// The minimum and maximum coordinates are computed with SIMD kernels
+  /// (see computeMinMax()) in multiple threads. The result does not depend
+  /// on the number of threads.
+  ///
+  /// \param[in] points Points (single or double precision)
+  /// \param[in] count Number of points
+  /// \param[in] threads Maximum number of threads (0 = hardware concurrency)
+  /// \return Bounding box
+  template<typename U,
+           spgl_enable_if_t<std::is_same<U, float>::value ||
+                              std::is_same<U, double>::value,
+                            int> = 0>
+  static BoundingBoxT<T> fromPoints(const Vector<U, 3>* points,
+                                    size_t count,
+                                    size_t threads = 1)
+  {
+    if (count == 0) {
+      return {};
+    }
+
+    // Reduce chunks in parallel, then combine chunks in order
+    std::vector<Vector<U, 3>> chunkMin(resolveThreadCount(threads));
+    std::vector<Vector<U, 3>> chunkMax(chunkMin.size());
+    const size_t chunks = parallelFor(
+      count, threads, [&](size_t chunk, size_t begin, size_t end) {
+        computeMinMax(
+          points + begin, end - begin, chunkMin[chunk], chunkMax[chunk]);
+      });
+
+    Vector<U, 3> minVal = chunkMin[0];
+    Vector<U, 3> maxVal = chunkMax[0];
+    for (size_t chunk = 1; chunk < chunks; chunk++) {
+      for (size_t i = 0; i < 3; i++) {
+        if (chunkMin[chunk][i] < minVal[i]) {
+          minVal[i] = chunkMin[chunk][i];
+        }
+        if (chunkMax[chunk][i] > maxVal[i]) {
+          maxVal[i] = chunkMax[chunk][i];
+        }
+      }
+    }
+
+    return BoundingBoxT::fromMinMax(minVal.template staticCast<T>(),
+                                    maxVal.template staticCast<T>());
+  }
+
+  /// Construct from points (parallel).
+  ///
+  /// \param[in] points Points (single or double precision)
+  /// \param[in] threads Maximum number of threads (0 = hardware concurrency)
+  /// \return Bounding box
+  template<typename U>
+  static BoundingBoxT<T> fromPoints(const std::vector<Vector<U, 3>>& points,
+                                    size_t threads)
+  {
+    return fromPoints(points.data(), points.size(), threads);
+  }
+
   /// Construct from minimum and maximum coordinates.
   ///
   /// \param[in] min Minimum coordinates
@@ -0,0 +1,172 @@
+/*
+ * Program: Spatium Graphics Library
+ *
+ * Copyright (C) Martijn Koopman
+ * All Rights Reserved
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.
+ *
+ */
+
+#ifndef SPATIUMGL_COLORLUT_H
+#define SPATIUMGL_COLORLUT_H
+
+#include "spatiumglexport.hpp"
+#include "Color.hpp"
+
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint8_t
+#include <vector>  // std::vector
+
+namespace spgl {
+
+/// Color with 8-bit channels (RGBA, 0-255)
+using Color8 = ColorT<std::uint8_t>;
+
+/// \class ColorLut
+/// \brief Color lookup table, precomputed from a color ramp.
+///
+/// ColorRampT::map() interpolates in HSV space for every value, which is too
+/// slow for millions of values. A ColorLut samples the ramp once at N evenly
+/// spaced values over [min, max]. Mapping a value then selects the nearest
+/// entry; values out of range are clamped.
+///
+/// The lookup table is immutable. Construct a new one when the ramp or its
+/// range changes.
+class SPATIUMGL_EXPORT ColorLut
+{
+public:
+  /// Default constructor.
+  ///
+  /// Constructs an empty lookup table that maps every value to transparent
+  /// black.
+  ColorLut()
+    : m_min(0)
+    , m_max(0)
+    , m_colors()
+    , m_colors8()
+  {}
+
+  /// Constructor.
+  ///
+  /// \param[in] ramp Color ramp
+  /// \param[in] size Number of entries (>= 2)
+  template<typename T>
+  explicit ColorLut(const ColorRampT<T>& ramp, size_t size = 256)
+    : m_min(static_cast<float>(ramp.min()))
+    , m_max(static_cast<float>(ramp.max()))
+    , m_colors()
+    , m_colors8()
+  {
+    const std::vector<ColorT<T>> colors = sample(ramp, size < 2 ? 2 : size);
+    m_colors.reserve(colors.size());
+    m_colors8.reserve(colors.size());
+    for (const ColorT<T>& color : colors) {
+      const ColorT<float> colorF = { static_cast<float>(color.R),
+                                     static_cast<float>(color.G),
+                                     static_cast<float>(color.B),
+                                     static_cast<float>(color.A) };
+      m_colors.push_back(colorF);
+      m_colors8.push_back({ toByte(colorF.R),
+                            toByte(colorF.G),
+                            toByte(colorF.B),
+                            toByte(colorF.A) });
+    }
+  }
+
+  /// Get minimum value (mapped to the first entry).
+  ///
+  /// \return Minimum value
+  float min() const { return m_min; }
+
+  /// Get maximum value (mapped to the last entry).
+  ///
+  /// \return Maximum value
+  float max() const { return m_max; }
+
+  /// Get number of entries.
+  ///
+  /// \return Number of entries
+  size_t size() const { return m_colors.size(); }
+
+  /// Get entries (floating point channels [0,1]).
+  ///
+  /// \return Colors
+  const std::vector<ColorT<float>>& colors() const { return m_colors; }
+
+  /// Get entries (8-bit channels).
+  ///
+  /// \return Colors
+  const std::vector<Color8>& colors8() const { return m_colors8; }
+
+  /// Compute entry index for value.
+  ///
+  /// \param[in] value Value
+  /// \return Entry index (nearest entry, clamped)
+  size_t index(float value) const;
+
+  /// Map value to color.
+  ///
+  /// \param[in] value Value
+  /// \return Color
+  Color8 map(float value) const;
+
+  /// Map values to colors. (batched)
+  ///
+  /// The entry indices are computed with SIMD instructions (see simdLevel()).
+  /// The results equal those of map(float).
+  ///
+  /// \param[in] values Values
+  /// \param[in] count Number of values
+  /// \param[out] result Colors (count elements)
+  void map(const float* values, size_t count, Color8* result) const;
+
+  /// Map values to colors. (batched)
+  ///
+  /// \param[in] values Values
+  /// \return Colors
+  std::vector<Color8> map(const std::vector<float>& values) const
+  {
+    std::vector<Color8> result(values.size());
+    map(values.data(), values.size(), result.data());
+    return result;
+  }
+
+private:
+  /// Sample color ramp at evenly spaced values.
+  template<typename T>
+  static std::vector<ColorT<T>> sample(const ColorRampT<T>& ramp, size_t size)
+  {
+    std::vector<ColorT<T>> colors;
+    colors.reserve(size);
+    const T minValue = ramp.min();
+    const T maxValue = ramp.max();
+    const T step = (maxValue - minValue) / static_cast<T>(size - 1);
+    for (size_t i = 0; i < size - 1; i++) {
+      colors.emplace_back(ramp.map(minValue + static_cast<T>(i) * step));
+    }
+    colors.emplace_back(ramp.map(maxValue));
+    return colors;
+  }
+
+  /// Convert channel [0,1] to byte [0,255].
+  static std::uint8_t toByte(float channel)
+  {
+    const float value = channel * 255.0f + 0.5f;
+    if (!(value > 0.0f)) {
+      return 0;
+    }
+    return (value >= 255.0f ? 255 : static_cast<std::uint8_t>(value));
+  }
+
+  float m_min;
+  float m_max;
+  std::vector<ColorT<float>> m_colors;
+  std::vector<Color8> m_colors8;
+};
+
+} // namespace spgl
+
+#endif // SPATIUMGL_COLORLUT_H
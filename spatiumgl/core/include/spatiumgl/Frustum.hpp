@@ -0,0 +1,176 @@
+/*
+ * Program: Spatium Graphics Library
+ *
+ * Copyright (C) Martijn Koopman
+ * All Rights Reserved
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.
+ *
+ */
+
+#ifndef SPATIUMGL_FRUSTUM_H
+#define SPATIUMGL_FRUSTUM_H
+
+#include "spatiumglexport.hpp"
+#include "Bounds.hpp"
+#include "Matrix.hpp"
+#include "Vector.hpp"
+
+#include <array>   // std::array
+#include <cstddef> // std::size_t
+#include <vector>  // std::vector
+
+namespace spgl {
+
+/// \enum Visibility
+/// \brief Result of a frustum visibility test.
+enum class Visibility : unsigned char
+{
+  Outside = 0,   ///< Completely outside the frustum
+  Intersect = 1, ///< Partially inside the frustum
+  Inside = 2     ///< Completely inside the frustum
+};
+
+/// \class Frustum
+/// \brief View frustum (6 planes)
+///
+/// The frustum is extracted from a (view) projection matrix: the planes are
+/// in the space that is transformed by the matrix. For a projection matrix
+/// the planes are in view space; for projection * view they are in world
+/// space; for projection * view * model they are in model space.
+///
+/// Every plane is stored as (a, b, c, d) with a normalized normal (a, b, c)
+/// pointing inwards. A point p is on the inner side of a plane if
+/// a * p.x + b * p.y + c * p.z + d >= 0.
+///
+/// Bounding volumes are tested conservatively: a volume reported as
+/// Outside is guaranteed to be invisible, but some invisible volumes near
+/// the frustum corners are reported as Intersect.
+class SPATIUMGL_EXPORT Frustum
+{
+public:
+  /// Plane index
+  enum Plane : size_t
+  {
+    Left = 0,
+    Right = 1,
+    Bottom = 2,
+    Top = 3,
+    Near = 4,
+    Far = 5
+  };
+
+  /// Default constructor.
+  ///
+  /// Constructs a degenerate frustum for which every test returns Inside.
+  Frustum();
+
+  /// Constructor.
+  ///
+  /// Extracts the planes from a (view) projection matrix with OpenGL clip
+  /// space conventions (-w <= x, y, z <= w).
+  ///
+  /// \param[in] matrix (View) projection matrix
+  explicit Frustum(const Matrix4& matrix);
+
+  /// Get plane.
+  ///
+  /// \param[in] index Plane index (see Plane)
+  /// \return Plane (a, b, c, d)
+  const Vector4& plane(size_t index) const { return m_planes[index]; }
+
+  /// Compute signed distance of point to plane.
+  ///
+  /// \param[in] index Plane index (see Plane)
+  /// \param[in] point Point
+  /// \return Signed distance (positive on the inner side)
+  double distance(size_t index, const Vector3& point) const
+  {
+    const Vector4& p = m_planes[index];
+    return p[0] * point[0] + p[1] * point[1] + p[2] * point[2] + p[3];
+  }
+
+  /// Check whether a point is inside the frustum.
+  ///
+  /// A point exactly on a plane is considered inside.
+  ///
+  /// \param[in] point Point
+  /// \return True if inside, false otherwise
+  bool contains(const Vector3& point) const;
+
+  /// Test visibility of a sphere.
+  ///
+  /// \param[in] center Sphere center
+  /// \param[in] radius Sphere radius
+  /// \return Visibility
+  Visibility test(const Vector3& center, double radius) const;
+
+  /// Test visibility of a bounding sphere.
+  ///
+  /// \param[in] sphere Bounding sphere
+  /// \return Visibility
+  Visibility test(const BoundingSphere& sphere) const
+  {
+    return test(sphere.center(), sphere.radius());
+  }
+
+  /// Test visibility of a bounding box.
+  ///
+  /// \param[in] box Bounding box
+  /// \return Visibility
+  Visibility test(const BoundingBox& box) const;
+
+  /// Test visibility of a bounding cube.
+  ///
+  /// \param[in] cube Bounding cube
+  /// \return Visibility
+  Visibility test(const BoundingCube& cube) const;
+
+  /// Test visibility of bounding boxes. (batched)
+  ///
+  /// Multiple boxes are tested at once with SIMD instructions (see
+  /// simdLevel()). The results equal those of test(const BoundingBox&).
+  ///
+  /// \param[in] boxes Bounding boxes
+  /// \param[in] count Number of bounding boxes
+  /// \param[out] result Visibility of each box (count elements)
+  void test(const BoundingBox* boxes, size_t count, Visibility* result) const;
+
+  /// Test visibility of bounding cubes. (batched)
+  ///
+  /// \param[in] cubes Bounding cubes
+  /// \param[in] count Number of bounding cubes
+  /// \param[out] result Visibility of each cube (count elements)
+  void test(const BoundingCube* cubes, size_t count, Visibility* result) const;
+
+  /// Test visibility of bounding boxes. (batched)
+  ///
+  /// \param[in] boxes Bounding boxes
+  /// \return Visibility of each box
+  std::vector<Visibility> test(const std::vector<BoundingBox>& boxes) const
+  {
+    std::vector<Visibility> result(boxes.size());
+    test(boxes.data(), boxes.size(), result.data());
+    return result;
+  }
+
+  /// Test visibility of bounding cubes. (batched)
+  ///
+  /// \param[in] cubes Bounding cubes
+  /// \return Visibility of each cube
+  std::vector<Visibility> test(const std::vector<BoundingCube>& cubes) const
+  {
+    std::vector<Visibility> result(cubes.size());
+    test(cubes.data(), cubes.size(), result.data());
+    return result;
+  }
+
+private:
+  std::array<Vector4, 6> m_planes;
+};
+
+} // namespace spgl
+
+#endif // SPATIUMGL_FRUSTUM_H
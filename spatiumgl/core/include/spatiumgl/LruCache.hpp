@@ -0,0 +1,195 @@
+/*
+ * Program: Spatium Graphics Library
+ *
+ * Copyright (C) Martijn Koopman
+ * All Rights Reserved
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.
+ *
+ */
+
+#ifndef SPATIUMGL_LRUCACHE_H
+#define SPATIUMGL_LRUCACHE_H
+
+#include "spatiumglexport.hpp"
+
+#include <cstddef>       // std::size_t
+#include <list>          // std::list
+#include <unordered_map> // std::unordered_map
+#include <utility>       // std::pair, std::move
+#include <vector>        // std::vector
+
+namespace spgl {
+
+/// \class LruCache
+/// \brief Cache with a memory budget that evicts least recently used entries.
+///
+/// Every entry has a size (for example in bytes). When the total size
+/// exceeds the budget, trim() evicts the least recently used entries. Entries
+/// used during the current frame (see nextFrame()) are never evicted, so the
+/// budget may be exceeded temporarily when everything in view is needed.
+///
+/// Evicted entries are handed back to the caller, which releases their
+/// resources (for example GPU buffers).
+///
+/// \tparam Key Key type (hashable)
+/// \tparam Value Value type (movable)
+template<typename Key, typename Value>
+class SPATIUMGL_EXPORT LruCache
+{
+public:
+  /// Evicted entry
+  using Entry = std::pair<Key, Value>;
+
+  /// Constructor.
+  ///
+  /// \param[in] budget Maximum total size of entries
+  explicit LruCache(size_t budget)
+    : m_entries()
+    , m_index()
+    , m_budget(budget)
+    , m_size(0)
+    , m_frame(0)
+  {}
+
+  /// Get budget.
+  ///
+  /// \return Maximum total size of entries
+  size_t budget() const { return m_budget; }
+
+  /// Set budget.
+  ///
+  /// Call trim() to evict entries when the budget is reduced.
+  ///
+  /// \param[in] budget Maximum total size of entries
+  void setBudget(size_t budget) { m_budget = budget; }
+
+  /// Get total size of entries.
+  ///
+  /// \return Size
+  size_t size() const { return m_size; }
+
+  /// Get number of entries.
+  ///
+  /// \return Number of entries
+  size_t count() const { return m_index.size(); }
+
+  /// Start a new frame.
+  ///
+  /// Entries used in previous frames may be evicted again.
+  void nextFrame() { m_frame++; }
+
+  /// Check whether an entry exists, without marking it as used.
+  ///
+  /// \param[in] key Key
+  /// \return True if cached, false otherwise
+  bool contains(const Key& key) const
+  {
+    return m_index.find(key) != m_index.end();
+  }
+
+  /// Get value and mark it as most recently used.
+  ///
+  /// \param[in] key Key
+  /// \return Value, nullptr if not cached
+  Value* get(const Key& key)
+  {
+    const auto it = m_index.find(key);
+    if (it == m_index.end()) {
+      return nullptr;
+    }
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    it->second->frame = m_frame;
+    return &it->second->value;
+  }
+
+  /// Insert (or replace) a value as most recently used.
+  ///
+  /// \param[in] key Key
+  /// \param[in] value Value
+  /// \param[in] size Size of value
+  /// \return Cached value
+  Value* insert(const Key& key, Value value, size_t size)
+  {
+    erase(key);
+    m_entries.push_front({ key, std::move(value), size, m_frame });
+    m_index[key] = m_entries.begin();
+    m_size += size;
+    return &m_entries.front().value;
+  }
+
+  /// Remove an entry.
+  ///
+  /// \param[in] key Key
+  /// \return True if removed, false if not cached
+  bool erase(const Key& key)
+  {
+    const auto it = m_index.find(key);
+    if (it == m_index.end()) {
+      return false;
+    }
+    m_size -= it->second->size;
+    m_entries.erase(it->second);
+    m_index.erase(it);
+    return true;
+  }
+
+  /// Evict least recently used entries until the budget is met.
+  ///
+  /// Entries used in the current frame are kept.
+  ///
+  /// \param[out] evicted Evicted entries are appended (optional)
+  /// \return Number of evicted entries
+  size_t trim(std::vector<Entry>* evicted = nullptr)
+  {
+    size_t count = 0;
+    while (m_size > m_budget && !m_entries.empty() &&
+           m_entries.back().frame != m_frame) {
+      Node& node = m_entries.back();
+      if (evicted != nullptr) {
+        evicted->emplace_back(node.key, std::move(node.value));
+      }
+      m_size -= node.size;
+      m_index.erase(node.key);
+      m_entries.pop_back();
+      count++;
+    }
+    return count;
+  }
+
+  /// Remove all entries.
+  ///
+  /// \param[out] evicted Removed entries are appended (optional)
+  void clear(std::vector<Entry>* evicted = nullptr)
+  {
+    if (evicted != nullptr) {
+      for (Node& node : m_entries) {
+        evicted->emplace_back(node.key, std::move(node.value));
+      }
+    }
+    m_entries.clear();
+    m_index.clear();
+    m_size = 0;
+  }
+
+private:
+  struct Node
+  {
+    Key key;
+    Value value;
+    size_t size;
+    size_t frame; // Frame of last use
+  };
+
+  std::list<Node> m_entries; // Most recently used first
+  std::unordered_map<Key, typename std::list<Node>::iterator> m_index;
+  size_t m_budget;
+  size_t m_size;
+  size_t m_frame;
+};
+
+} // namespace spgl
+
+#endif // SPATIUMGL_LRUCACHE_H
@@ -0,0 +1,56 @@
+/*
+ * Program: Spatium Graphics Library
+ *
+ * Copyright (C) Martijn Koopman
+ * All Rights Reserved
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.
+ *
+ */
+
+#ifndef SPATIUMGL_MINMAX_H
+#define SPATIUMGL_MINMAX_H
+
+#include "spatiumglexport.hpp"
+#include "Vector.hpp"
+
+#include <cstddef> // std::size_t
+
+namespace spgl {
+
+// Minimum/maximum reduction kernels for arrays of points.
+//
+// The SSE2 or AVX implementation is selected at runtime (see simdLevel()).
+// Minimum and maximum are exact, so all implementations return identical
+// results. Points with NaN coordinates yield undefined results.
+
+/// Compute the minimum and maximum coordinates of points.
+///
+/// The output is not modified if count is 0.
+///
+/// \param[in] points Points
+/// \param[in] count Number of points
+/// \param[out] min Minimum coordinates
+/// \param[out] max Maximum coordinates
+SPATIUMGL_EXPORT void
+computeMinMax(const Vector3f* points,
+              size_t count,
+              Vector3f& min,
+              Vector3f& max);
+
+/// Compute the minimum and maximum coordinates of points. (double)
+///
+/// The output is not modified if count is 0.
+///
+/// \param[in] points Points
+/// \param[in] count Number of points
+/// \param[out] min Minimum coordinates
+/// \param[out] max Maximum coordinates
+SPATIUMGL_EXPORT void
+computeMinMax(const Vector3* points, size_t count, Vector3& min, Vector3& max);
+
+} // namespace spgl
+
+#endif // SPATIUMGL_MINMAX_H
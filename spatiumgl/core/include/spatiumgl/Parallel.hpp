@@ -0,0 +1,91 @@
+/*
+ * Program: Spatium Graphics Library
+ *
+ * Copyright (C) Martijn Koopman
+ * All Rights Reserved
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.
+ *
+ */
+
+#ifndef SPATIUMGL_PARALLEL_H
+#define SPATIUMGL_PARALLEL_H
+
+#include <algorithm> // std::min
+#include <cstddef>   // std::size_t
+#include <thread>    // std::thread
+#include <vector>    // std::vector
+
+namespace spgl {
+
+/// Resolve the number of threads to use.
+///
+/// \param[in] threads Requested number of threads (0 = hardware concurrency)
+/// \return Number of threads (>= 1)
+inline size_t
+resolveThreadCount(size_t threads)
+{
+  if (threads == 0) {
+    threads = static_cast<size_t>(std::thread::hardware_concurrency());
+  }
+  return (threads == 0 ? 1 : threads);
+}
+
+/// Split a range in contiguous chunks and process them in parallel.
+///
+/// The range [0, count) is split in at most 'threads' chunks of (nearly) equal
+/// size. The partitioning only depends on count and the number of chunks,
+/// so a reduction that combines per-chunk results in chunk order is
+/// deterministic. Chunks smaller than minChunkSize are avoided, so small
+/// ranges are processed on the calling thread.
+///
+/// The function is called as function(chunkIndex, begin, end). The first
+/// chunk is processed on the calling thread.
+///
+/// \param[in] count Number of elements
+/// \param[in] threads Maximum number of threads (0 = hardware concurrency)
+/// \param[in] function Function (object) processing a chunk
+/// \param[in] minChunkSize Minimum number of elements per chunk
+/// \return Number of chunks
+template<typename Function>
+size_t
+parallelFor(size_t count,
+            size_t threads,
+            Function function,
+            size_t minChunkSize = 65536)
+{
+  if (count == 0) {
+    return 0;
+  }
+
+  size_t chunks = resolveThreadCount(threads);
+  if (minChunkSize > 0) {
+    chunks = std::min(chunks, (count + minChunkSize - 1) / minChunkSize);
+  }
+  chunks = std::max(chunks, static_cast<size_t>(1));
+
+  const size_t chunkSize = count / chunks;
+  const size_t remainder = count % chunks;
+  auto chunkBegin = [&](size_t chunk) -> size_t {
+    return chunk * chunkSize + std::min(chunk, remainder);
+  };
+
+  std::vector<std::thread> workers;
+  workers.reserve(chunks - 1);
+  for (size_t chunk = 1; chunk < chunks; chunk++) {
+    workers.emplace_back(
+      function, chunk, chunkBegin(chunk), chunkBegin(chunk + 1));
+  }
+  function(static_cast<size_t>(0), chunkBegin(0), chunkBegin(1));
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+
+  return chunks;
+}
+
+} // namespace spgl
+
+#endif // SPATIUMGL_PARALLEL_H
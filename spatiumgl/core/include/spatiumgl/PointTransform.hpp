@@ -0,0 +1,151 @@
+/*
+ * Program: Spatium Graphics Library
+ *
+ * Copyright (C) Martijn Koopman
+ * All Rights Reserved
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.
+ *
+ */
+
+#ifndef SPATIUMGL_POINTTRANSFORM_H
+#define SPATIUMGL_POINTTRANSFORM_H
+
+#include "spatiumglexport.hpp"
+#include "Matrix.hpp"
+#include "Vector.hpp"
+
+#include <cstddef> // std::size_t
+#include <vector>  // std::vector
+
+namespace spgl {
+
+// Batched point transformation kernels.
+//
+// These functions transform arrays of points at once instead of one Vector
+// at a time through Matrix::operator*(). The SSE2 or AVX implementation is
+// selected at runtime (see simdLevel()); the results equal those of the
+// scalar implementation up to floating point rounding.
+//
+// Points may be stored as an array of structures (AoS: Vector3f, Vector3) or
+// as a structure of arrays (SoA: separate x, y and z arrays). The input and
+// output arrays may be the same (in-place) but must not partially overlap.
+
+/// Transform points by an affine transformation matrix. (AoS)
+///
+/// Every point p is transformed as matrix * (p, 1). The bottom row of the
+/// matrix is ignored, i.e. no perspective division is performed.
+/// The matrix is converted to single precision before use.
+///
+/// \param[in] matrix Affine transformation matrix
+/// \param[in] points Points
+/// \param[in] count Number of points
+/// \param[out] result Transformed points (count elements)
+SPATIUMGL_EXPORT void
+transformPoints(const Matrix4& matrix,
+                const Vector3f* points,
+                size_t count,
+                Vector3f* result);
+
+/// Transform points by an affine transformation matrix. (AoS, double)
+///
+/// \param[in] matrix Affine transformation matrix
+/// \param[in] points Points
+/// \param[in] count Number of points
+/// \param[out] result Transformed points (count elements)
+SPATIUMGL_EXPORT void
+transformPoints(const Matrix4& matrix,
+                const Vector3* points,
+                size_t count,
+                Vector3* result);
+
+/// Transform points by an affine transformation matrix. (SoA)
+///
+/// \param[in] matrix Affine transformation matrix
+/// \param[in] x X coordinates
+/// \param[in] y Y coordinates
+/// \param[in] z Z coordinates
+/// \param[in] count Number of points
+/// \param[out] resultX Transformed X coordinates (count elements)
+/// \param[out] resultY Transformed Y coordinates (count elements)
+/// \param[out] resultZ Transformed Z coordinates (count elements)
+SPATIUMGL_EXPORT void
+transformPoints(const Matrix4& matrix,
+                const float* x,
+                const float* y,
+                const float* z,
+                size_t count,
+                float* resultX,
+                float* resultY,
+                float* resultZ);
+
+/// Project points to homogeneous clip space. (AoS)
+///
+/// Every point p is transformed as matrix * (p, 1), including the bottom
+/// row. Typically the matrix is projection * view * model. Divide by w to
+/// obtain normalized device coordinates.
+///
+/// \param[in] matrix Projection matrix
+/// \param[in] points Points
+/// \param[in] count Number of points
+/// \param[out] result Points in clip space (count elements)
+SPATIUMGL_EXPORT void
+projectPoints(const Matrix4& matrix,
+              const Vector3f* points,
+              size_t count,
+              Vector4f* result);
+
+/// Project points to homogeneous clip space. (SoA)
+///
+/// \param[in] matrix Projection matrix
+/// \param[in] x X coordinates
+/// \param[in] y Y coordinates
+/// \param[in] z Z coordinates
+/// \param[in] count Number of points
+/// \param[out] resultX Clip space X coordinates (count elements)
+/// \param[out] resultY Clip space Y coordinates (count elements)
+/// \param[out] resultZ Clip space Z coordinates (count elements)
+/// \param[out] resultW Clip space W coordinates (count elements)
+SPATIUMGL_EXPORT void
+projectPoints(const Matrix4& matrix,
+              const float* x,
+              const float* y,
+              const float* z,
+              size_t count,
+              float* resultX,
+              float* resultY,
+              float* resultZ,
+              float* resultW);
+
+/// Transform points by an affine transformation matrix.
+///
+/// \param[in] matrix Affine transformation matrix
+/// \param[in] points Points
+/// \return Transformed points
+template<typename T>
+std::vector<Vector<T, 3>>
+transformPoints(const Matrix4& matrix, const std::vector<Vector<T, 3>>& points)
+{
+  std::vector<Vector<T, 3>> result(points.size());
+  transformPoints(matrix, points.data(), points.size(), result.data());
+  return result;
+}
+
+/// Project points to homogeneous clip space.
+///
+/// \param[in] matrix Projection matrix
+/// \param[in] points Points
+/// \return Points in clip space
+inline std::vector<Vector4f>
+projectPoints(const Matrix4& matrix, const std::vector<Vector3f>& points)
+{
+  std::vector<Vector4f> result(points.size());
+  projectPoints(matrix, points.data(), points.size(), result.data());
+  return result;
+}
+
+} // namespace spgl
+
+#endif // SPATIUMGL_POINTTRANSFORM_H
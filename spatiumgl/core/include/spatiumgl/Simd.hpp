@@ -0,0 +1,59 @@
+/*
+ * Program: Spatium Graphics Library
+ *
+ * Copyright (C) Martijn Koopman
+ * All Rights Reserved
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.
+ *
+ */
+
+#ifndef SPATIUMGL_SIMD_H
+#define SPATIUMGL_SIMD_H
+
+#include "spatiumglexport.hpp"
+
+namespace spgl {
+
+/// \enum SimdLevel
+/// \brief SIMD instruction set used by the batched kernels.
+///
+/// Levels are ordered: a higher level implies support for all lower levels.
+enum class SimdLevel : int
+{
+  None = 0, ///< Scalar code only
+  SSE2 = 1, ///< 128-bit SSE2
+  AVX = 2   ///< 256-bit AVX
+};
+
+/// Get the highest SIMD level supported by the CPU (and operating system).
+///
+/// The CPU is queried once; subsequent calls return the cached value.
+///
+/// \return Supported SIMD level
+SPATIUMGL_EXPORT SimdLevel
+supportedSimdLevel();
+
+/// Get the SIMD level used by the batched kernels.
+///
+/// Defaults to the supported SIMD level.
+///
+/// \return Active SIMD level
+SPATIUMGL_EXPORT SimdLevel
+simdLevel();
+
+/// Set the SIMD level used by the batched kernels.
+///
+/// The level is clamped to the supported SIMD level. This is mainly useful
+/// to compare the SIMD kernels against the scalar code.
+///
+/// \param[in] level Requested SIMD level
+/// \return Active SIMD level
+SPATIUMGL_EXPORT SimdLevel
+setSimdLevel(SimdLevel level);
+
+} // namespace spgl
+
+#endif // SPATIUMGL_SIMD_H
@@ -26,6 +26,45 @@ namespace spgl {
 template<bool cond, typename U>
 using spgl_enable_if_t = typename std::enable_if<cond, U>::type;
 
+namespace detail {
+
+/// Compile-time unrolled loop over indices [I, N).
+///
+/// Calls function(i) for every index. The element-wise operators of Vector
+/// are implemented with it, so that chained expressions like (a * s) + b
+/// reduce to straight-line code without loops or intermediate arrays once
+/// inlined, regardless of the optimizer's loop unrolling heuristics.
+template<size_t I, size_t N>
+struct Unroll
+{
+  template<typename Function>
+  static void apply(Function& function)
+  {
+    function(I);
+    Unroll<I + 1, N>::apply(function);
+  }
+};
+
+template<size_t N>
+struct Unroll<N, N>
+{
+  template<typename Function>
+  static void apply(Function&)
+  {}
+};
+
+/// Call function(i) for every index i in [Begin, N).
+///
+/// \param[in] function Function (object) taking the index
+template<size_t N, size_t Begin = 0, typename Function>
+inline void
+unroll(Function function)
+{
+  Unroll<Begin, N>::apply(function);
+}
+
+} // namespace detail
+
 template<typename T,
          size_t N,
          spgl_enable_if_t<std::is_arithmetic<T>::value, int> = 0>
@@ -46,9 +85,7 @@ public:
   Vector(T value)
     : m_data{}
   {
-    for (size_t i = 0; i < N; i++) {
-      m_data[i] = value;
-    }
+    detail::unroll<N>([&](size_t i) { m_data[i] = value; });
   }
 
   /// Constructor.
@@ -130,9 +167,8 @@ public:
   Vector<T2, N> staticCast() const
   {
     Vector<T2, N> result;
-    for (size_t i = 0; i < N; i++) {
-      result[i] = static_cast<T2>(m_data[i]);
-    }
+    detail::unroll<N>(
+      [&](size_t i) { result[i] = static_cast<T2>(m_data[i]); });
     return result;
   }
 
@@ -264,17 +300,54 @@ public:
 
   // Arithmetic operators:
 
+  /// Add another vector (in place).
+  ///
+  /// \param[in] other Vector to add
+  /// \return Reference to this vector
+  Vector<T, N>& operator+=(const Vector<T, N>& other)
+  {
+    detail::unroll<N>([&](size_t row) { m_data[row] += other[row]; });
+    return *this;
+  }
+
+  /// Subtract other vector (in place).
+  ///
+  /// \param[in] other Vector to subtract
+  /// \return Reference to this vector
+  Vector<T, N>& operator-=(const Vector<T, N>& other)
+  {
+    detail::unroll<N>([&](size_t row) { m_data[row] -= other[row]; });
+    return *this;
+  }
+
+  /// Multiply by scalar (in place).
+  ///
+  /// \param[in] scalar Scalar
+  /// \return Reference to this vector
+  Vector<T, N>& operator*=(T scalar)
+  {
+    detail::unroll<N>([&](size_t row) { m_data[row] *= scalar; });
+    return *this;
+  }
+
+  /// Divide by scalar (in place).
+  ///
+  /// \param[in] scalar Scalar
+  /// \return Reference to this vector
+  Vector<T, N>& operator/=(T scalar)
+  {
+    detail::unroll<N>([&](size_t row) { m_data[row] /= scalar; });
+    return *this;
+  }
+
   /// Add another vector.
   ///
   /// \param[in] other Vector to add
   /// \return Added vector
   Vector<T, N> operator+(const Vector<T, N>& other) const
   {
-    Vector<T, N> result;
-    for (size_t row = 0; row < N; row++) {
-      result[row] = m_data[row] + other[row];
-    }
-    return result;
+    Vector<T, N> result(*this);
+    return result += other;
   }
 
   /// Subtract other vector.
@@ -283,11 +356,8 @@ public:
   /// \return Subtracted vector
   Vector<T, N> operator-(const Vector<T, N>& other) const
   {
-    Vector<T, N> result;
-    for (size_t row = 0; row < N; row++) {
-      result[row] = m_data[row] - other[row];
-    }
-    return result;
+    Vector<T, N> result(*this);
+    return result -= other;
   }
 
   /// Multiply by scalar.
@@ -296,11 +366,8 @@ public:
   /// \return Multiplied vector
   Vector<T, N> operator*(T scalar) const
   {
-    Vector<T, N> result;
-    for (size_t row = 0; row < N; row++) {
-      result[row] = m_data[row] * scalar;
-    }
-    return result;
+    Vector<T, N> result(*this);
+    return result *= scalar;
   }
 
   /// Divide by scalar.
@@ -309,11 +376,8 @@ public:
   /// \return Divided vector
   Vector<T, N> operator/(T scalar) const
   {
-    Vector<T, N> result;
-    for (size_t row = 0; row < N; row++) {
-      result[row] = m_data[row] / scalar;
-    }
-    return result;
+    Vector<T, N> result(*this);
+    return result /= scalar;
   }
 
   /// Calculate magnitude of vector (length, euclidean).
@@ -321,10 +385,11 @@ public:
   /// \return Magnitude
   T magnitude() const
   {
-    T result = 0;
-    for (size_t row = 0; row < N; row++) {
-      result += m_data[row] * m_data[row];
-    }
+    // Start from the first term instead of 0: adding 0 cannot be optimized
+    // away for floating points.
+    T result = m_data[0] * m_data[0];
+    detail::unroll<N, 1>(
+      [&](size_t row) { result += m_data[row] * m_data[row]; });
     return std::sqrt(result);
   }
 
@@ -363,10 +428,9 @@ public:
   template<typename U = T>
   spgl_enable_if_t<N >= 2, U> dot(const Vector<T, N>& other) const
   {
-    T result = 0;
-    for (size_t row = 0; row < N; row++) {
-      result += m_data[row] * other[row];
-    }
+    T result = m_data[0] * other[0];
+    detail::unroll<N, 1>(
+      [&](size_t row) { result += m_data[row] * other[row]; });
     return result;
   }
 
@@ -413,10 +477,11 @@ public:
   template<typename U = T>
   spgl_enable_if_t<N >= 2, U> distance(const Vector<T, N>& other) const
   {
-    T result = 0;
-    for (size_t row = 0; row < N; row++) {
-      result += (m_data[row] - other[row]) * (m_data[row] - other[row]);
-    }
+    T result = (m_data[0] - other[0]) * (m_data[0] - other[0]);
+    detail::unroll<N, 1>([&](size_t row) {
+      const T difference = m_data[row] - other[row];
+      result += difference * difference;
+    });
     return std::sqrt(result);
   }
 
@@ -0,0 +1,98 @@
+/*
+ * Program: Spatium Graphics Library
+ *
+ * Copyright (C) Martijn Koopman
+ * All Rights Reserved
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.
+ *
+ */
+
+#ifndef SPATIUMGL_WORKERPOOL_H
+#define SPATIUMGL_WORKERPOOL_H
+
+#include "spatiumglexport.hpp"
+
+#include <condition_variable> // std::condition_variable
+#include <deque>              // std::deque
+#include <functional>         // std::function
+#include <mutex>              // std::mutex
+#include <thread>             // std::thread
+#include <vector>             // std::vector
+
+namespace spgl {
+
+/// \class WorkerPool
+/// \brief Fixed number of threads executing submitted tasks in order.
+///
+/// Unlike AsyncTask, which starts a thread per task, the threads of a pool
+/// are started once and wait for tasks. Tasks that have not started yet can
+/// be discarded with clear().
+class SPATIUMGL_EXPORT WorkerPool
+{
+public:
+  /// Task
+  using Task = std::function<void()>;
+
+  /// Constructor.
+  ///
+  /// \param[in] threads Number of threads (0 = hardware concurrency)
+  explicit WorkerPool(size_t threads = 0);
+
+  /// Copy constructor. (deleted)
+  WorkerPool(const WorkerPool& other) = delete;
+
+  /// Copy assignment operator. (deleted)
+  WorkerPool& operator=(const WorkerPool& other) = delete;
+
+  /// Destructor.
+  ///
+  /// Discards pending tasks and waits for running tasks to finish.
+  ~WorkerPool();
+
+  /// Get number of threads.
+  ///
+  /// \return Number of threads
+  size_t threadCount() const { return m_threads.size(); }
+
+  /// Submit a task.
+  ///
+  /// \param[in] task Task
+  void submit(Task task);
+
+  /// Discard all tasks that have not started yet.
+  ///
+  /// \return Number of discarded tasks
+  size_t clear();
+
+  /// Get number of tasks that have not started yet.
+  ///
+  /// \return Number of tasks
+  size_t pendingCount() const;
+
+  /// Get number of running tasks.
+  ///
+  /// \return Number of tasks
+  size_t activeCount() const;
+
+  /// Wait until all submitted tasks have finished.
+  void wait();
+
+private:
+  /// Thread function
+  void work();
+
+  std::vector<std::thread> m_threads;
+  std::deque<Task> m_tasks;
+  mutable std::mutex m_mutex;
+  std::condition_variable m_taskAvailable;
+  std::condition_variable m_idle;
+  size_t m_active;
+  bool m_stop;
+};
+
+} // namespace spgl
+
+#endif // SPATIUMGL_WORKERPOOL_H
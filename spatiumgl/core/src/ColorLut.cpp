@@ -0,0 +1,166 @@
+/*
+ * Program: Spatium Graphics Library
+ *
+ * Copyright (C) Martijn Koopman
+ * All Rights Reserved
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.
+ *
+ */
+
+#include "spatiumgl/ColorLut.hpp"
+#include "SimdImpl.hpp"
+
+namespace spgl {
+
+static_assert(sizeof(Color8) == 4, "Color8 must be tightly packed");
+
+/// Parameters to compute entry indices:
+///   index = trunc(clamp((value - min) * scale + 0.5, 0, last))
+/// NaN values map to index 0.
+struct LutParameters
+{
+  float min;
+  float scale;
+  float last;
+};
+
+static LutParameters
+lutParameters(float min, float max, size_t size)
+{
+  const float last = static_cast<float>(size - 1);
+  const float scale = (max > min ? last / (max - min) : 0.0f);
+  return { min, scale, last };
+}
+
+static inline size_t
+indexScalar(const LutParameters& p, float value)
+{
+  float t = (value - p.min) * p.scale + 0.5f;
+  t = (t > 0.0f ? t : 0.0f); // also NaN -> 0
+  t = (t < p.last ? t : p.last);
+  return static_cast<size_t>(t);
+}
+
+static void
+mapScalar(const LutParameters& p,
+          const Color8* table,
+          const float* values,
+          size_t count,
+          Color8* result)
+{
+  for (size_t i = 0; i < count; i++) {
+    result[i] = table[indexScalar(p, values[i])];
+  }
+}
+
+#ifdef SPATIUMGL_SIMD_X86
+
+SPATIUMGL_TARGET_SSE2 static void
+mapSse2(const LutParameters& p,
+        const Color8* table,
+        const float* values,
+        size_t count,
+        Color8* result)
+{
+  const __m128 min = _mm_set1_ps(p.min);
+  const __m128 scale = _mm_set1_ps(p.scale);
+  const __m128 half = _mm_set1_ps(0.5f);
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 last = _mm_set1_ps(p.last);
+
+  size_t i = 0;
+  alignas(16) int indices[4];
+  for (; i + 4 <= count; i += 4) {
+    __m128 t = _mm_add_ps(
+      _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(values + i), min), scale), half);
+    t = _mm_max_ps(t, zero); // returns zero for NaN
+    t = _mm_min_ps(t, last);
+    _mm_store_si128(reinterpret_cast<__m128i*>(indices), _mm_cvttps_epi32(t));
+    result[i] = table[indices[0]];
+    result[i + 1] = table[indices[1]];
+    result[i + 2] = table[indices[2]];
+    result[i + 3] = table[indices[3]];
+  }
+  mapScalar(p, table, values + i, count - i, result + i);
+}
+
+SPATIUMGL_TARGET_AVX static void
+mapAvx(const LutParameters& p,
+       const Color8* table,
+       const float* values,
+       size_t count,
+       Color8* result)
+{
+  const __m256 min = _mm256_set1_ps(p.min);
+  const __m256 scale = _mm256_set1_ps(p.scale);
+  const __m256 half = _mm256_set1_ps(0.5f);
+  const __m256 zero = _mm256_setzero_ps();
+  const __m256 last = _mm256_set1_ps(p.last);
+
+  size_t i = 0;
+  alignas(32) int indices[8];
+  for (; i + 8 <= count; i += 8) {
+    __m256 t = _mm256_add_ps(
+      _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(values + i), min), scale),
+      half);
+    t = _mm256_max_ps(t, zero); // returns zero for NaN
+    t = _mm256_min_ps(t, last);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(indices),
+                       _mm256_cvttps_epi32(t));
+    for (size_t j = 0; j < 8; j++) {
+      result[i + j] = table[indices[j]];
+    }
+  }
+  mapScalar(p, table, values + i, count - i, result + i);
+}
+
+#endif // SPATIUMGL_SIMD_X86
+
+size_t
+ColorLut::index(float value) const
+{
+  if (m_colors8.empty()) {
+    return 0;
+  }
+  return indexScalar(lutParameters(m_min, m_max, m_colors8.size()), value);
+}
+
+Color8
+ColorLut::map(float value) const
+{
+  if (m_colors8.empty()) {
+    return { 0, 0, 0, 0 };
+  }
+  return m_colors8[index(value)];
+}
+
+void
+ColorLut::map(const float* values, size_t count, Color8* result) const
+{
+  if (m_colors8.empty()) {
+    for (size_t i = 0; i < count; i++) {
+      result[i] = { 0, 0, 0, 0 };
+    }
+    return;
+  }
+
+  const LutParameters p = lutParameters(m_min, m_max, m_colors8.size());
+  const Color8* table = m_colors8.data();
+  switch (simdLevel()) {
+#ifdef SPATIUMGL_SIMD_X86
+    case SimdLevel::AVX:
+      mapAvx(p, table, values, count, result);
+      break;
+    case SimdLevel::SSE2:
+      mapSse2(p, table, values, count, result);
+      break;
+#endif
+    default:
+      mapScalar(p, table, values, count, result);
+  }
+}
+
+} // namespace spgl
@@ -0,0 +1,319 @@
+/*
+ * Program: Spatium Graphics Library
+ *
+ * Copyright (C) Martijn Koopman
+ * All Rights Reserved
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.
+ *
+ */
+
+#include "spatiumgl/Frustum.hpp"
+#include "SimdImpl.hpp"
+
+#include <cmath> // std::sqrt, std::abs
+
+namespace spgl {
+
+// Bounding volumes are tested against every plane with their center c and
+// the projected radius r of their extent on the plane normal n:
+//   d = n . c + w
+//   r = |n.x| * radius.x + |n.y| * radius.y + |n.z| * radius.z
+// The volume is outside if d < -r for any plane, and inside if d >= r for
+// all planes. The SIMD kernels evaluate the same expressions in the same
+// order as the scalar code, so the results are identical.
+
+/// Planes prepared for testing: (a, b, c, d, |a|, |b|, |c|) per plane.
+struct FrustumPlanes
+{
+  double values[6][7];
+};
+
+/// Radii accessors for the supported bounding volumes.
+static inline double
+radius(const BoundingBox& box, size_t axis)
+{
+  return box.radii()[axis];
+}
+
+static inline double
+radius(const BoundingCube& cube, size_t)
+{
+  return cube.radius();
+}
+
+/// Test one bounding volume. (scalar)
+template<typename Bounds>
+static inline Visibility
+testScalar(const FrustumPlanes& planes, const Bounds& bounds)
+{
+  const Vector3& c = bounds.center();
+  const double rx = radius(bounds, 0);
+  const double ry = radius(bounds, 1);
+  const double rz = radius(bounds, 2);
+
+  bool intersect = false;
+  for (size_t i = 0; i < 6; i++) {
+    const double* p = planes.values[i];
+    const double d = p[0] * c[0] + p[1] * c[1] + p[2] * c[2] + p[3];
+    const double r = p[4] * rx + p[5] * ry + p[6] * rz;
+    if (d < -r) {
+      return Visibility::Outside;
+    }
+    if (d < r) {
+      intersect = true;
+    }
+  }
+  return (intersect ? Visibility::Intersect : Visibility::Inside);
+}
+
+/// Test bounding volumes one by one. (scalar)
+template<typename Bounds>
+static void
+testScalar(const FrustumPlanes& planes,
+           const Bounds* bounds,
+           size_t count,
+           Visibility* result)
+{
+  for (size_t i = 0; i < count; i++) {
+    result[i] = testScalar(planes, bounds[i]);
+  }
+}
+
+/// Convert outside/intersect bit masks to visibility.
+static inline void
+masksToVisibility(int outside, int intersect, size_t lanes, Visibility* result)
+{
+  for (size_t lane = 0; lane < lanes; lane++) {
+    if ((outside >> lane) & 1) {
+      result[lane] = Visibility::Outside;
+    } else if ((intersect >> lane) & 1) {
+      result[lane] = Visibility::Intersect;
+    } else {
+      result[lane] = Visibility::Inside;
+    }
+  }
+}
+
+#ifdef SPATIUMGL_SIMD_X86
+
+/// Test bounding volumes, 2 at once. (SSE2)
+template<typename Bounds>
+SPATIUMGL_TARGET_SSE2 static void
+testSse2(const FrustumPlanes& planes,
+         const Bounds* bounds,
+         size_t count,
+         Visibility* result)
+{
+  size_t i = 0;
+  for (; i + 2 <= count; i += 2) {
+    const Bounds& b0 = bounds[i];
+    const Bounds& b1 = bounds[i + 1];
+    const __m128d cx = _mm_set_pd(b1.center()[0], b0.center()[0]);
+    const __m128d cy = _mm_set_pd(b1.center()[1], b0.center()[1]);
+    const __m128d cz = _mm_set_pd(b1.center()[2], b0.center()[2]);
+    const __m128d rx = _mm_set_pd(radius(b1, 0), radius(b0, 0));
+    const __m128d ry = _mm_set_pd(radius(b1, 1), radius(b0, 1));
+    const __m128d rz = _mm_set_pd(radius(b1, 2), radius(b0, 2));
+
+    __m128d outside = _mm_setzero_pd();
+    __m128d intersect = _mm_setzero_pd();
+    for (size_t j = 0; j < 6; j++) {
+      const double* p = planes.values[j];
+      const __m128d d = _mm_add_pd(
+        _mm_add_pd(_mm_add_pd(_mm_mul_pd(_mm_set1_pd(p[0]), cx),
+                              _mm_mul_pd(_mm_set1_pd(p[1]), cy)),
+                   _mm_mul_pd(_mm_set1_pd(p[2]), cz)),
+        _mm_set1_pd(p[3]));
+      const __m128d r =
+        _mm_add_pd(_mm_add_pd(_mm_mul_pd(_mm_set1_pd(p[4]), rx),
+                              _mm_mul_pd(_mm_set1_pd(p[5]), ry)),
+                   _mm_mul_pd(_mm_set1_pd(p[6]), rz));
+      const __m128d negR = _mm_sub_pd(_mm_setzero_pd(), r);
+      outside = _mm_or_pd(outside, _mm_cmplt_pd(d, negR));
+      intersect = _mm_or_pd(intersect, _mm_cmplt_pd(d, r));
+    }
+    masksToVisibility(
+      _mm_movemask_pd(outside), _mm_movemask_pd(intersect), 2, result + i);
+  }
+  testScalar(planes, bounds + i, count - i, result + i);
+}
+
+/// Test bounding volumes, 4 at once. (AVX)
+template<typename Bounds>
+SPATIUMGL_TARGET_AVX static void
+testAvx(const FrustumPlanes& planes,
+        const Bounds* bounds,
+        size_t count,
+        Visibility* result)
+{
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    const Bounds& b0 = bounds[i];
+    const Bounds& b1 = bounds[i + 1];
+    const Bounds& b2 = bounds[i + 2];
+    const Bounds& b3 = bounds[i + 3];
+    const __m256d cx = _mm256_set_pd(
+      b3.center()[0], b2.center()[0], b1.center()[0], b0.center()[0]);
+    const __m256d cy = _mm256_set_pd(
+      b3.center()[1], b2.center()[1], b1.center()[1], b0.center()[1]);
+    const __m256d cz = _mm256_set_pd(
+      b3.center()[2], b2.center()[2], b1.center()[2], b0.center()[2]);
+    const __m256d rx = _mm256_set_pd(
+      radius(b3, 0), radius(b2, 0), radius(b1, 0), radius(b0, 0));
+    const __m256d ry = _mm256_set_pd(
+      radius(b3, 1), radius(b2, 1), radius(b1, 1), radius(b0, 1));
+    const __m256d rz = _mm256_set_pd(
+      radius(b3, 2), radius(b2, 2), radius(b1, 2), radius(b0, 2));
+
+    __m256d outside = _mm256_setzero_pd();
+    __m256d intersect = _mm256_setzero_pd();
+    for (size_t j = 0; j < 6; j++) {
+      const double* p = planes.values[j];
+      const __m256d d = _mm256_add_pd(
+        _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(_mm256_set1_pd(p[0]), cx),
+                                    _mm256_mul_pd(_mm256_set1_pd(p[1]), cy)),
+                      _mm256_mul_pd(_mm256_set1_pd(p[2]), cz)),
+        _mm256_set1_pd(p[3]));
+      const __m256d r = _mm256_add_pd(
+        _mm256_add_pd(_mm256_mul_pd(_mm256_set1_pd(p[4]), rx),
+                      _mm256_mul_pd(_mm256_set1_pd(p[5]), ry)),
+        _mm256_mul_pd(_mm256_set1_pd(p[6]), rz));
+      const __m256d negR = _mm256_sub_pd(_mm256_setzero_pd(), r);
+      outside =
+        _mm256_or_pd(outside, _mm256_cmp_pd(d, negR, _CMP_LT_OQ));
+      intersect = _mm256_or_pd(intersect, _mm256_cmp_pd(d, r, _CMP_LT_OQ));
+    }
+    masksToVisibility(_mm256_movemask_pd(outside),
+                      _mm256_movemask_pd(intersect),
+                      4,
+                      result + i);
+  }
+  testScalar(planes, bounds + i, count - i, result + i);
+}
+
+#endif // SPATIUMGL_SIMD_X86
+
+/// Prepare planes for testing.
+static FrustumPlanes
+preparePlanes(const std::array<Vector4, 6>& planes)
+{
+  FrustumPlanes result;
+  for (size_t i = 0; i < 6; i++) {
+    for (size_t j = 0; j < 4; j++) {
+      result.values[i][j] = planes[i][j];
+    }
+    for (size_t j = 0; j < 3; j++) {
+      result.values[i][4 + j] = std::abs(planes[i][j]);
+    }
+  }
+  return result;
+}
+
+/// Dispatch batched test to the active SIMD level.
+template<typename Bounds>
+static void
+testDispatch(const std::array<Vector4, 6>& planes,
+             const Bounds* bounds,
+             size_t count,
+             Visibility* result)
+{
+  const FrustumPlanes prepared = preparePlanes(planes);
+  switch (simdLevel()) {
+#ifdef SPATIUMGL_SIMD_X86
+    case SimdLevel::AVX:
+      testAvx(prepared, bounds, count, result);
+      break;
+    case SimdLevel::SSE2:
+      testSse2(prepared, bounds, count, result);
+      break;
+#endif
+    default:
+      testScalar(prepared, bounds, count, result);
+  }
+}
+
+Frustum::Frustum()
+  : m_planes()
+{}
+
+Frustum::Frustum(const Matrix4& matrix)
+  : m_planes()
+{
+  // Gribb & Hartmann: planes from the rows of the (column-major) matrix
+  Vector4 rows[4];
+  for (size_t row = 0; row < 4; row++) {
+    rows[row] = { matrix[0][row], matrix[1][row], matrix[2][row],
+                  matrix[3][row] };
+  }
+  m_planes[Left] = rows[3] + rows[0];
+  m_planes[Right] = rows[3] - rows[0];
+  m_planes[Bottom] = rows[3] + rows[1];
+  m_planes[Top] = rows[3] - rows[1];
+  m_planes[Near] = rows[3] + rows[2];
+  m_planes[Far] = rows[3] - rows[2];
+
+  // Normalize
+  for (Vector4& plane : m_planes) {
+    const double length =
+      std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+    if (length > 0) {
+      plane /= length;
+    }
+  }
+}
+
+bool
+Frustum::contains(const Vector3& point) const
+{
+  for (size_t i = 0; i < 6; i++) {
+    if (distance(i, point) < 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+Visibility
+Frustum::test(const Vector3& center, double radius) const
+{
+  bool intersect = false;
+  for (size_t i = 0; i < 6; i++) {
+    const double d = distance(i, center);
+    if (d < -radius) {
+      return Visibility::Outside;
+    }
+    if (d < radius) {
+      intersect = true;
+    }
+  }
+  return (intersect ? Visibility::Intersect : Visibility::Inside);
+}
+
+Visibility
+Frustum::test(const BoundingBox& box) const
+{
+  return testScalar(preparePlanes(m_planes), box);
+}
+
+Visibility
+Frustum::test(const BoundingCube& cube) const
+{
+  return testScalar(preparePlanes(m_planes), cube);
+}
+
+void
+Frustum::test(const BoundingBox* boxes, size_t count, Visibility* result) const
+{
+  testDispatch(m_planes, boxes, count, result);
+}
+
+void
+Frustum::test(const BoundingCube* cubes, size_t count, Visibility* result) const
+{
+  testDispatch(m_planes, cubes, count, result);
+}
+
+} // namespace spgl
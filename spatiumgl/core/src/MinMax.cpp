@@ -0,0 +1,253 @@
+/*
+ * Program: Spatium Graphics Library
+ *
+ * Copyright (C) Martijn Koopman
+ * All Rights Reserved
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.
+ *
+ */
+
+#include "spatiumgl/MinMax.hpp"
+#include "SimdImpl.hpp"
+
+namespace spgl {
+
+// The SIMD kernels load the interleaved coordinates (x y z x y z ...) as is.
+// Three registers hold a whole number of points, so every lane of the three
+// running minimum/maximum registers always holds the same coordinate. The
+// lanes are reduced per coordinate (lane index modulo 3) at the end.
+
+/// Reduce minimum/maximum of interleaved coordinates.
+///
+/// \param[in] points Interleaved coordinates (3 per point)
+/// \param[in] count Number of points
+/// \param[in,out] min Minimum coordinates
+/// \param[in,out] max Maximum coordinates
+template<typename T>
+static void
+minMaxScalar(const T* points, size_t count, T* min, T* max)
+{
+  for (size_t i = 0; i < count; i++) {
+    for (size_t c = 0; c < 3; c++) {
+      const T value = points[3 * i + c];
+      if (value < min[c]) {
+        min[c] = value;
+      }
+      if (value > max[c]) {
+        max[c] = value;
+      }
+    }
+  }
+}
+
+/// Reduce stored register lanes to minimum/maximum per coordinate.
+///
+/// \param[in] lanesMin Minimum lanes (interleaved coordinates)
+/// \param[in] lanesMax Maximum lanes (interleaved coordinates)
+/// \param[in] lanes Number of lanes (multiple of 3)
+/// \param[in,out] min Minimum coordinates
+/// \param[in,out] max Maximum coordinates
+template<typename T>
+static void
+reduceLanes(const T* lanesMin, const T* lanesMax, size_t lanes, T* min, T* max)
+{
+  for (size_t i = 0; i < lanes; i++) {
+    if (lanesMin[i] < min[i % 3]) {
+      min[i % 3] = lanesMin[i];
+    }
+    if (lanesMax[i] > max[i % 3]) {
+      max[i % 3] = lanesMax[i];
+    }
+  }
+}
+
+#ifdef SPATIUMGL_SIMD_X86
+
+SPATIUMGL_TARGET_SSE2 static void
+minMaxSse2(const float* points, size_t count, float* min, float* max)
+{
+  // 4 points per iteration
+  size_t i = 0;
+  if (count >= 4) {
+    __m128 min0 = _mm_loadu_ps(points);
+    __m128 min1 = _mm_loadu_ps(points + 4);
+    __m128 min2 = _mm_loadu_ps(points + 8);
+    __m128 max0 = min0, max1 = min1, max2 = min2;
+    for (i = 4; i + 4 <= count; i += 4) {
+      const float* p = points + 3 * i;
+      const __m128 a = _mm_loadu_ps(p);
+      const __m128 b = _mm_loadu_ps(p + 4);
+      const __m128 c = _mm_loadu_ps(p + 8);
+      min0 = _mm_min_ps(min0, a);
+      min1 = _mm_min_ps(min1, b);
+      min2 = _mm_min_ps(min2, c);
+      max0 = _mm_max_ps(max0, a);
+      max1 = _mm_max_ps(max1, b);
+      max2 = _mm_max_ps(max2, c);
+    }
+    float lanesMin[12], lanesMax[12];
+    _mm_storeu_ps(lanesMin, min0);
+    _mm_storeu_ps(lanesMin + 4, min1);
+    _mm_storeu_ps(lanesMin + 8, min2);
+    _mm_storeu_ps(lanesMax, max0);
+    _mm_storeu_ps(lanesMax + 4, max1);
+    _mm_storeu_ps(lanesMax + 8, max2);
+    reduceLanes(lanesMin, lanesMax, 12, min, max);
+  }
+  minMaxScalar(points + 3 * i, count - i, min, max);
+}
+
+SPATIUMGL_TARGET_SSE2 static void
+minMaxSse2(const double* points, size_t count, double* min, double* max)
+{
+  // 2 points per iteration
+  size_t i = 0;
+  if (count >= 2) {
+    __m128d min0 = _mm_loadu_pd(points);
+    __m128d min1 = _mm_loadu_pd(points + 2);
+    __m128d min2 = _mm_loadu_pd(points + 4);
+    __m128d max0 = min0, max1 = min1, max2 = min2;
+    for (i = 2; i + 2 <= count; i += 2) {
+      const double* p = points + 3 * i;
+      const __m128d a = _mm_loadu_pd(p);
+      const __m128d b = _mm_loadu_pd(p + 2);
+      const __m128d c = _mm_loadu_pd(p + 4);
+      min0 = _mm_min_pd(min0, a);
+      min1 = _mm_min_pd(min1, b);
+      min2 = _mm_min_pd(min2, c);
+      max0 = _mm_max_pd(max0, a);
+      max1 = _mm_max_pd(max1, b);
+      max2 = _mm_max_pd(max2, c);
+    }
+    double lanesMin[6], lanesMax[6];
+    _mm_storeu_pd(lanesMin, min0);
+    _mm_storeu_pd(lanesMin + 2, min1);
+    _mm_storeu_pd(lanesMin + 4, min2);
+    _mm_storeu_pd(lanesMax, max0);
+    _mm_storeu_pd(lanesMax + 2, max1);
+    _mm_storeu_pd(lanesMax + 4, max2);
+    reduceLanes(lanesMin, lanesMax, 6, min, max);
+  }
+  minMaxScalar(points + 3 * i, count - i, min, max);
+}
+
+SPATIUMGL_TARGET_AVX static void
+minMaxAvx(const float* points, size_t count, float* min, float* max)
+{
+  // 8 points per iteration
+  size_t i = 0;
+  if (count >= 8) {
+    __m256 min0 = _mm256_loadu_ps(points);
+    __m256 min1 = _mm256_loadu_ps(points + 8);
+    __m256 min2 = _mm256_loadu_ps(points + 16);
+    __m256 max0 = min0, max1 = min1, max2 = min2;
+    for (i = 8; i + 8 <= count; i += 8) {
+      const float* p = points + 3 * i;
+      const __m256 a = _mm256_loadu_ps(p);
+      const __m256 b = _mm256_loadu_ps(p + 8);
+      const __m256 c = _mm256_loadu_ps(p + 16);
+      min0 = _mm256_min_ps(min0, a);
+      min1 = _mm256_min_ps(min1, b);
+      min2 = _mm256_min_ps(min2, c);
+      max0 = _mm256_max_ps(max0, a);
+      max1 = _mm256_max_ps(max1, b);
+      max2 = _mm256_max_ps(max2, c);
+    }
+    float lanesMin[24], lanesMax[24];
+    _mm256_storeu_ps(lanesMin, min0);
+    _mm256_storeu_ps(lanesMin + 8, min1);
+    _mm256_storeu_ps(lanesMin + 16, min2);
+    _mm256_storeu_ps(lanesMax, max0);
+    _mm256_storeu_ps(lanesMax + 8, max1);
+    _mm256_storeu_ps(lanesMax + 16, max2);
+    reduceLanes(lanesMin, lanesMax, 24, min, max);
+  }
+  minMaxScalar(points + 3 * i, count - i, min, max);
+}
+
+SPATIUMGL_TARGET_AVX static void
+minMaxAvx(const double* points, size_t count, double* min, double* max)
+{
+  // 4 points per iteration
+  size_t i = 0;
+  if (count >= 4) {
+    __m256d min0 = _mm256_loadu_pd(points);
+    __m256d min1 = _mm256_loadu_pd(points + 4);
+    __m256d min2 = _mm256_loadu_pd(points + 8);
+    __m256d max0 = min0, max1 = min1, max2 = min2;
+    for (i = 4; i + 4 <= count; i += 4) {
+      const double* p = points + 3 * i;
+      const __m256d a = _mm256_loadu_pd(p);
+      const __m256d b = _mm256_loadu_pd(p + 4);
+      const __m256d c = _mm256_loadu_pd(p + 8);
+      min0 = _mm256_min_pd(min0, a);
+      min1 = _mm256_min_pd(min1, b);
+      min2 = _mm256_min_pd(min2, c);
+      max0 = _mm256_max_pd(max0, a);
+      max1 = _mm256_max_pd(max1, b);
+      max2 = _mm256_max_pd(max2, c);
+    }
+    double lanesMin[12], lanesMax[12];
+    _mm256_storeu_pd(lanesMin, min0);
+    _mm256_storeu_pd(lanesMin + 4, min1);
+    _mm256_storeu_pd(lanesMin + 8, min2);
+    _mm256_storeu_pd(lanesMax, max0);
+    _mm256_storeu_pd(lanesMax + 4, max1);
+    _mm256_storeu_pd(lanesMax + 8, max2);
+    reduceLanes(lanesMin, lanesMax, 12, min, max);
+  }
+  minMaxScalar(points + 3 * i, count - i, min, max);
+}
+
+#endif // SPATIUMGL_SIMD_X86
+
+/// Dispatch minimum/maximum reduction to the active SIMD level.
+template<typename T>
+static void
+minMaxDispatch(const T* points, size_t count, T* min, T* max)
+{
+  // Initialize with first point
+  for (size_t c = 0; c < 3; c++) {
+    min[c] = points[c];
+    max[c] = points[c];
+  }
+
+  switch (simdLevel()) {
+#ifdef SPATIUMGL_SIMD_X86
+    case SimdLevel::AVX:
+      minMaxAvx(points, count, min, max);
+      break;
+    case SimdLevel::SSE2:
+      minMaxSse2(points, count, min, max);
+      break;
+#endif
+    default:
+      minMaxScalar(points + 3, count - 1, min, max);
+  }
+}
+
+void
+computeMinMax(const Vector3f* points,
+              size_t count,
+              Vector3f& min,
+              Vector3f& max)
+{
+  if (count == 0) {
+    return;
+  }
+  minMaxDispatch(points->data(), count, min.data(), max.data());
+}
+
+void
+computeMinMax(const Vector3* points, size_t count, Vector3& min, Vector3& max)
+{
+  if (count == 0) {
+    return;
+  }
+  minMaxDispatch(points->data(), count, min.data(), max.data());
+}
+
+} // namespace spgl
@@ -0,0 +1,575 @@
+/*
+ * Program: Spatium Graphics Library
+ *
+ * Copyright (C) Martijn Koopman
+ * All Rights Reserved
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.
+ *
+ */
+
+#include "spatiumgl/PointTransform.hpp"
+#include "SimdImpl.hpp"
+
+namespace spgl {
+
+static_assert(sizeof(Vector3f) == 3 * sizeof(float),
+              "Vector3f must be tightly packed");
+static_assert(sizeof(Vector4f) == 4 * sizeof(float),
+              "Vector4f must be tightly packed");
+static_assert(sizeof(Vector3) == 3 * sizeof(double),
+              "Vector3 must be tightly packed");
+
+// Matrices are passed to the kernels as 16 elements in column-major order,
+// identical to the memory layout of Matrix.
+
+/// Convert matrix to single precision column-major array.
+static void
+toFloatArray(const Matrix4& matrix, float* m)
+{
+  const double* data = matrix.data();
+  for (size_t i = 0; i < 16; i++) {
+    m[i] = static_cast<float>(data[i]);
+  }
+}
+
+// Scalar kernels
+
+static void
+transformScalar(const float* m,
+                const float* points,
+                size_t count,
+                float* result)
+{
+  for (size_t i = 0; i < count; i++) {
+    const float x = points[3 * i];
+    const float y = points[3 * i + 1];
+    const float z = points[3 * i + 2];
+    result[3 * i] = m[0] * x + m[4] * y + m[8] * z + m[12];
+    result[3 * i + 1] = m[1] * x + m[5] * y + m[9] * z + m[13];
+    result[3 * i + 2] = m[2] * x + m[6] * y + m[10] * z + m[14];
+  }
+}
+
+static void
+transformScalar(const double* m,
+                const double* points,
+                size_t count,
+                double* result)
+{
+  for (size_t i = 0; i < count; i++) {
+    const double x = points[3 * i];
+    const double y = points[3 * i + 1];
+    const double z = points[3 * i + 2];
+    result[3 * i] = m[0] * x + m[4] * y + m[8] * z + m[12];
+    result[3 * i + 1] = m[1] * x + m[5] * y + m[9] * z + m[13];
+    result[3 * i + 2] = m[2] * x + m[6] * y + m[10] * z + m[14];
+  }
+}
+
+static void
+projectScalar(const float* m, const float* points, size_t count, float* result)
+{
+  for (size_t i = 0; i < count; i++) {
+    const float x = points[3 * i];
+    const float y = points[3 * i + 1];
+    const float z = points[3 * i + 2];
+    result[4 * i] = m[0] * x + m[4] * y + m[8] * z + m[12];
+    result[4 * i + 1] = m[1] * x + m[5] * y + m[9] * z + m[13];
+    result[4 * i + 2] = m[2] * x + m[6] * y + m[10] * z + m[14];
+    result[4 * i + 3] = m[3] * x + m[7] * y + m[11] * z + m[15];
+  }
+}
+
+static void
+transformScalarSoa(const float* m,
+                   const float* x,
+                   const float* y,
+                   const float* z,
+                   size_t count,
+                   float* rx,
+                   float* ry,
+                   float* rz,
+                   float* rw)
+{
+  for (size_t i = 0; i < count; i++) {
+    const float px = x[i];
+    const float py = y[i];
+    const float pz = z[i];
+    rx[i] = m[0] * px + m[4] * py + m[8] * pz + m[12];
+    ry[i] = m[1] * px + m[5] * py + m[9] * pz + m[13];
+    rz[i] = m[2] * px + m[6] * py + m[10] * pz + m[14];
+    if (rw != nullptr) {
+      rw[i] = m[3] * px + m[7] * py + m[11] * pz + m[15];
+    }
+  }
+}
+
+#ifdef SPATIUMGL_SIMD_X86
+
+// SSE2 kernels (4 points per iteration)
+
+/// Transpose 4 points from AoS (x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3)
+/// to SoA (x0 x1 x2 x3 | y0 y1 y2 y3 | z0 z1 z2 z3). Also valid per 128-bit
+/// lane for AVX.
+#define SPATIUMGL_AOS_TO_SOA(SHUFFLE, a, b, c, x, y, z)                      \
+  x = SHUFFLE(SHUFFLE(a, a, _MM_SHUFFLE(3, 3, 0, 0)),                          \
+              SHUFFLE(b, c, _MM_SHUFFLE(1, 1, 2, 2)),                          \
+              _MM_SHUFFLE(2, 0, 2, 0));                                        \
+  y = SHUFFLE(SHUFFLE(a, b, _MM_SHUFFLE(0, 0, 1, 1)),                          \
+              SHUFFLE(b, c, _MM_SHUFFLE(2, 2, 3, 3)),                          \
+              _MM_SHUFFLE(2, 0, 2, 0));                                        \
+  z = SHUFFLE(SHUFFLE(a, b, _MM_SHUFFLE(1, 1, 2, 2)),                          \
+              SHUFFLE(c, c, _MM_SHUFFLE(3, 3, 0, 0)),                          \
+              _MM_SHUFFLE(2, 0, 2, 0));
+
+/// Inverse of SPATIUMGL_AOS_TO_SOA.
+#define SPATIUMGL_SOA_TO_AOS(SHUFFLE, UNPACKLO, x, y, z, a, b, c)            \
+  a = SHUFFLE(UNPACKLO(x, y),                                                  \
+              SHUFFLE(z, x, _MM_SHUFFLE(1, 1, 0, 0)),                          \
+              _MM_SHUFFLE(2, 0, 1, 0));                                        \
+  b = SHUFFLE(SHUFFLE(y, z, _MM_SHUFFLE(1, 1, 1, 1)),                          \
+              SHUFFLE(x, y, _MM_SHUFFLE(2, 2, 2, 2)),                          \
+              _MM_SHUFFLE(2, 0, 2, 0));                                        \
+  c = SHUFFLE(SHUFFLE(z, x, _MM_SHUFFLE(3, 3, 2, 2)),                          \
+              SHUFFLE(y, z, _MM_SHUFFLE(3, 3, 3, 3)),                          \
+              _MM_SHUFFLE(2, 0, 2, 0));
+
+SPATIUMGL_TARGET_SSE2 static inline __m128
+rowSse2(const float* m, size_t row, __m128 x, __m128 y, __m128 z)
+{
+  return _mm_add_ps(
+    _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(m[row]), x),
+                          _mm_mul_ps(_mm_set1_ps(m[4 + row]), y)),
+               _mm_mul_ps(_mm_set1_ps(m[8 + row]), z)),
+    _mm_set1_ps(m[12 + row]));
+}
+
+SPATIUMGL_TARGET_SSE2 static void
+transformSse2(const float* m, const float* points, size_t count, float* result)
+{
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    const float* p = points + 3 * i;
+    const __m128 a = _mm_loadu_ps(p);
+    const __m128 b = _mm_loadu_ps(p + 4);
+    const __m128 c = _mm_loadu_ps(p + 8);
+    __m128 x, y, z;
+    SPATIUMGL_AOS_TO_SOA(_mm_shuffle_ps, a, b, c, x, y, z)
+
+    const __m128 rx = rowSse2(m, 0, x, y, z);
+    const __m128 ry = rowSse2(m, 1, x, y, z);
+    const __m128 rz = rowSse2(m, 2, x, y, z);
+
+    __m128 ra, rb, rc;
+    SPATIUMGL_SOA_TO_AOS(_mm_shuffle_ps, _mm_unpacklo_ps, rx, ry, rz, ra, rb, rc)
+    float* r = result + 3 * i;
+    _mm_storeu_ps(r, ra);
+    _mm_storeu_ps(r + 4, rb);
+    _mm_storeu_ps(r + 8, rc);
+  }
+  transformScalar(m, points + 3 * i, count - i, result + 3 * i);
+}
+
+SPATIUMGL_TARGET_SSE2 static void
+transformSse2(const double* m,
+              const double* points,
+              size_t count,
+              double* result)
+{
+  const __m128d c0xy = _mm_loadu_pd(m);
+  const __m128d c1xy = _mm_loadu_pd(m + 4);
+  const __m128d c2xy = _mm_loadu_pd(m + 8);
+  const __m128d c3xy = _mm_loadu_pd(m + 12);
+  const __m128d c0z = _mm_set_sd(m[2]);
+  const __m128d c1z = _mm_set_sd(m[6]);
+  const __m128d c2z = _mm_set_sd(m[10]);
+  const __m128d c3z = _mm_set_sd(m[14]);
+  for (size_t i = 0; i < count; i++) {
+    const double* p = points + 3 * i;
+    const __m128d x = _mm_set1_pd(p[0]);
+    const __m128d y = _mm_set1_pd(p[1]);
+    const __m128d z = _mm_set1_pd(p[2]);
+    const __m128d xy = _mm_add_pd(
+      _mm_add_pd(_mm_add_pd(_mm_mul_pd(c0xy, x), _mm_mul_pd(c1xy, y)),
+                 _mm_mul_pd(c2xy, z)),
+      c3xy);
+    const __m128d rz = _mm_add_sd(
+      _mm_add_sd(_mm_add_sd(_mm_mul_sd(c0z, x), _mm_mul_sd(c1z, y)),
+                 _mm_mul_sd(c2z, z)),
+      c3z);
+    double* r = result + 3 * i;
+    _mm_storeu_pd(r, xy);
+    _mm_store_sd(r + 2, rz);
+  }
+}
+
+SPATIUMGL_TARGET_SSE2 static void
+projectSse2(const float* m, const float* points, size_t count, float* result)
+{
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    const float* p = points + 3 * i;
+    const __m128 a = _mm_loadu_ps(p);
+    const __m128 b = _mm_loadu_ps(p + 4);
+    const __m128 c = _mm_loadu_ps(p + 8);
+    __m128 x, y, z;
+    SPATIUMGL_AOS_TO_SOA(_mm_shuffle_ps, a, b, c, x, y, z)
+
+    __m128 rx = rowSse2(m, 0, x, y, z);
+    __m128 ry = rowSse2(m, 1, x, y, z);
+    __m128 rz = rowSse2(m, 2, x, y, z);
+    __m128 rw = rowSse2(m, 3, x, y, z);
+    _MM_TRANSPOSE4_PS(rx, ry, rz, rw);
+
+    float* r = result + 4 * i;
+    _mm_storeu_ps(r, rx);
+    _mm_storeu_ps(r + 4, ry);
+    _mm_storeu_ps(r + 8, rz);
+    _mm_storeu_ps(r + 12, rw);
+  }
+  projectScalar(m, points + 3 * i, count - i, result + 4 * i);
+}
+
+SPATIUMGL_TARGET_SSE2 static void
+transformSse2Soa(const float* m,
+                 const float* x,
+                 const float* y,
+                 const float* z,
+                 size_t count,
+                 float* rx,
+                 float* ry,
+                 float* rz,
+                 float* rw)
+{
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    const __m128 px = _mm_loadu_ps(x + i);
+    const __m128 py = _mm_loadu_ps(y + i);
+    const __m128 pz = _mm_loadu_ps(z + i);
+    const __m128 tx = rowSse2(m, 0, px, py, pz);
+    const __m128 ty = rowSse2(m, 1, px, py, pz);
+    const __m128 tz = rowSse2(m, 2, px, py, pz);
+    if (rw != nullptr) {
+      _mm_storeu_ps(rw + i, rowSse2(m, 3, px, py, pz));
+    }
+    _mm_storeu_ps(rx + i, tx);
+    _mm_storeu_ps(ry + i, ty);
+    _mm_storeu_ps(rz + i, tz);
+  }
+  transformScalarSoa(m,
+                     x + i,
+                     y + i,
+                     z + i,
+                     count - i,
+                     rx + i,
+                     ry + i,
+                     rz + i,
+                     rw != nullptr ? rw + i : nullptr);
+}
+
+// AVX kernels (8 points per iteration)
+
+SPATIUMGL_TARGET_AVX static inline __m256
+rowAvx(const float* m, size_t row, __m256 x, __m256 y, __m256 z)
+{
+  return _mm256_add_ps(
+    _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(m[row]), x),
+                                _mm256_mul_ps(_mm256_set1_ps(m[4 + row]), y)),
+                  _mm256_mul_ps(_mm256_set1_ps(m[8 + row]), z)),
+    _mm256_set1_ps(m[12 + row]));
+}
+
+/// Load 8 points (24 floats) with points 0-3 in the low and points 4-7 in
+/// the high 128-bit lanes.
+SPATIUMGL_TARGET_AVX static inline void
+loadAvx(const float* p, __m256& a, __m256& b, __m256& c)
+{
+  a = _mm256_insertf128_ps(
+    _mm256_castps128_ps256(_mm_loadu_ps(p)), _mm_loadu_ps(p + 12), 1);
+  b = _mm256_insertf128_ps(
+    _mm256_castps128_ps256(_mm_loadu_ps(p + 4)), _mm_loadu_ps(p + 16), 1);
+  c = _mm256_insertf128_ps(
+    _mm256_castps128_ps256(_mm_loadu_ps(p + 8)), _mm_loadu_ps(p + 20), 1);
+}
+
+SPATIUMGL_TARGET_AVX static void
+transformAvx(const float* m, const float* points, size_t count, float* result)
+{
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m256 a, b, c;
+    loadAvx(points + 3 * i, a, b, c);
+    __m256 x, y, z;
+    SPATIUMGL_AOS_TO_SOA(_mm256_shuffle_ps, a, b, c, x, y, z)
+
+    const __m256 rx = rowAvx(m, 0, x, y, z);
+    const __m256 ry = rowAvx(m, 1, x, y, z);
+    const __m256 rz = rowAvx(m, 2, x, y, z);
+
+    __m256 ra, rb, rc;
+    SPATIUMGL_SOA_TO_AOS(
+      _mm256_shuffle_ps, _mm256_unpacklo_ps, rx, ry, rz, ra, rb, rc)
+    float* r = result + 3 * i;
+    _mm_storeu_ps(r, _mm256_castps256_ps128(ra));
+    _mm_storeu_ps(r + 4, _mm256_castps256_ps128(rb));
+    _mm_storeu_ps(r + 8, _mm256_castps256_ps128(rc));
+    _mm_storeu_ps(r + 12, _mm256_extractf128_ps(ra, 1));
+    _mm_storeu_ps(r + 16, _mm256_extractf128_ps(rb, 1));
+    _mm_storeu_ps(r + 20, _mm256_extractf128_ps(rc, 1));
+  }
+  transformScalar(m, points + 3 * i, count - i, result + 3 * i);
+}
+
+SPATIUMGL_TARGET_AVX static void
+transformAvx(const double* m,
+             const double* points,
+             size_t count,
+             double* result)
+{
+  const __m256d c0 = _mm256_loadu_pd(m);
+  const __m256d c1 = _mm256_loadu_pd(m + 4);
+  const __m256d c2 = _mm256_loadu_pd(m + 8);
+  const __m256d c3 = _mm256_loadu_pd(m + 12);
+  for (size_t i = 0; i < count; i++) {
+    const double* p = points + 3 * i;
+    const __m256d r = _mm256_add_pd(
+      _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(c0, _mm256_set1_pd(p[0])),
+                                  _mm256_mul_pd(c1, _mm256_set1_pd(p[1]))),
+                    _mm256_mul_pd(c2, _mm256_set1_pd(p[2]))),
+      c3);
+    double* out = result + 3 * i;
+    _mm_storeu_pd(out, _mm256_castpd256_pd128(r));
+    _mm_store_sd(out + 2, _mm256_extractf128_pd(r, 1));
+  }
+}
+
+SPATIUMGL_TARGET_AVX static void
+projectAvx(const float* m, const float* points, size_t count, float* result)
+{
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m256 a, b, c;
+    loadAvx(points + 3 * i, a, b, c);
+    __m256 x, y, z;
+    SPATIUMGL_AOS_TO_SOA(_mm256_shuffle_ps, a, b, c, x, y, z)
+
+    const __m256 rx = rowAvx(m, 0, x, y, z);
+    const __m256 ry = rowAvx(m, 1, x, y, z);
+    const __m256 rz = rowAvx(m, 2, x, y, z);
+    const __m256 rw = rowAvx(m, 3, x, y, z);
+
+    // Transpose 4x4 within each 128-bit lane
+    const __m256 t0 = _mm256_unpacklo_ps(rx, ry);
+    const __m256 t1 = _mm256_unpacklo_ps(rz, rw);
+    const __m256 t2 = _mm256_unpackhi_ps(rx, ry);
+    const __m256 t3 = _mm256_unpackhi_ps(rz, rw);
+    const __m256 p0 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 p1 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2));
+    const __m256 p2 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 p3 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2));
+
+    float* r = result + 4 * i;
+    _mm_storeu_ps(r, _mm256_castps256_ps128(p0));
+    _mm_storeu_ps(r + 4, _mm256_castps256_ps128(p1));
+    _mm_storeu_ps(r + 8, _mm256_castps256_ps128(p2));
+    _mm_storeu_ps(r + 12, _mm256_castps256_ps128(p3));
+    _mm_storeu_ps(r + 16, _mm256_extractf128_ps(p0, 1));
+    _mm_storeu_ps(r + 20, _mm256_extractf128_ps(p1, 1));
+    _mm_storeu_ps(r + 24, _mm256_extractf128_ps(p2, 1));
+    _mm_storeu_ps(r + 28, _mm256_extractf128_ps(p3, 1));
+  }
+  projectScalar(m, points + 3 * i, count - i, result + 4 * i);
+}
+
+SPATIUMGL_TARGET_AVX static void
+transformAvxSoa(const float* m,
+                const float* x,
+                const float* y,
+                const float* z,
+                size_t count,
+                float* rx,
+                float* ry,
+                float* rz,
+                float* rw)
+{
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    const __m256 px = _mm256_loadu_ps(x + i);
+    const __m256 py = _mm256_loadu_ps(y + i);
+    const __m256 pz = _mm256_loadu_ps(z + i);
+    const __m256 tx = rowAvx(m, 0, px, py, pz);
+    const __m256 ty = rowAvx(m, 1, px, py, pz);
+    const __m256 tz = rowAvx(m, 2, px, py, pz);
+    if (rw != nullptr) {
+      _mm256_storeu_ps(rw + i, rowAvx(m, 3, px, py, pz));
+    }
+    _mm256_storeu_ps(rx + i, tx);
+    _mm256_storeu_ps(ry + i, ty);
+    _mm256_storeu_ps(rz + i, tz);
+  }
+  transformScalarSoa(m,
+                     x + i,
+                     y + i,
+                     z + i,
+                     count - i,
+                     rx + i,
+                     ry + i,
+                     rz + i,
+                     rw != nullptr ? rw + i : nullptr);
+}
+
+#undef SPATIUMGL_AOS_TO_SOA
+#undef SPATIUMGL_SOA_TO_AOS
+
+#endif // SPATIUMGL_SIMD_X86
+
+// Public functions (runtime dispatch)
+
+void
+transformPoints(const Matrix4& matrix,
+                const Vector3f* points,
+                size_t count,
+                Vector3f* result)
+{
+  if (count == 0) {
+    return; // Points may be nullptr
+  }
+  float m[16];
+  toFloatArray(matrix, m);
+  const float* in = points->data();
+  float* out = result->data();
+
+  switch (simdLevel()) {
+#ifdef SPATIUMGL_SIMD_X86
+    case SimdLevel::AVX:
+      transformAvx(m, in, count, out);
+      break;
+    case SimdLevel::SSE2:
+      transformSse2(m, in, count, out);
+      break;
+#endif
+    default:
+      transformScalar(m, in, count, out);
+  }
+}
+
+void
+transformPoints(const Matrix4& matrix,
+                const Vector3* points,
+                size_t count,
+                Vector3* result)
+{
+  if (count == 0) {
+    return; // Points may be nullptr
+  }
+  const double* m = matrix.data();
+  const double* in = points->data();
+  double* out = result->data();
+
+  switch (simdLevel()) {
+#ifdef SPATIUMGL_SIMD_X86
+    case SimdLevel::AVX:
+      transformAvx(m, in, count, out);
+      break;
+    case SimdLevel::SSE2:
+      transformSse2(m, in, count, out);
+      break;
+#endif
+    default:
+      transformScalar(m, in, count, out);
+  }
+}
+
+void
+transformPoints(const Matrix4& matrix,
+                const float* x,
+                const float* y,
+                const float* z,
+                size_t count,
+                float* resultX,
+                float* resultY,
+                float* resultZ)
+{
+  float m[16];
+  toFloatArray(matrix, m);
+
+  switch (simdLevel()) {
+#ifdef SPATIUMGL_SIMD_X86
+    case SimdLevel::AVX:
+      transformAvxSoa(
+        m, x, y, z, count, resultX, resultY, resultZ, nullptr);
+      break;
+    case SimdLevel::SSE2:
+      transformSse2Soa(
+        m, x, y, z, count, resultX, resultY, resultZ, nullptr);
+      break;
+#endif
+    default:
+      transformScalarSoa(
+        m, x, y, z, count, resultX, resultY, resultZ, nullptr);
+  }
+}
+
+void
+projectPoints(const Matrix4& matrix,
+              const Vector3f* points,
+              size_t count,
+              Vector4f* result)
+{
+  if (count == 0) {
+    return; // Points may be nullptr
+  }
+  float m[16];
+  toFloatArray(matrix, m);
+  const float* in = points->data();
+  float* out = result->data();
+
+  switch (simdLevel()) {
+#ifdef SPATIUMGL_SIMD_X86
+    case SimdLevel::AVX:
+      projectAvx(m, in, count, out);
+      break;
+    case SimdLevel::SSE2:
+      projectSse2(m, in, count, out);
+      break;
+#endif
+    default:
+      projectScalar(m, in, count, out);
+  }
+}
+
+void
+projectPoints(const Matrix4& matrix,
+              const float* x,
+              const float* y,
+              const float* z,
+              size_t count,
+              float* resultX,
+              float* resultY,
+              float* resultZ,
+              float* resultW)
+{
+  float m[16];
+  toFloatArray(matrix, m);
+
+  switch (simdLevel()) {
+#ifdef SPATIUMGL_SIMD_X86
+    case SimdLevel::AVX:
+      transformAvxSoa(
+        m, x, y, z, count, resultX, resultY, resultZ, resultW);
+      break;
+    case SimdLevel::SSE2:
+      transformSse2Soa(
+        m, x, y, z, count, resultX, resultY, resultZ, resultW);
+      break;
+#endif
+    default:
+      transformScalarSoa(
+        m, x, y, z, count, resultX, resultY, resultZ, resultW);
+  }
+}
+
+} // namespace spgl
@@ -0,0 +1,83 @@
+/*
+ * Program: Spatium Graphics Library
+ *
+ * Copyright (C) Martijn Koopman
+ * All Rights Reserved
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.
+ *
+ */
+
+#include "SimdImpl.hpp"
+
+#include <atomic> // std::atomic
+
+#if defined(SPATIUMGL_SIMD_X86) && defined(_MSC_VER)
+#include <intrin.h> // __cpuid, _xgetbv
+#endif
+
+namespace spgl {
+
+/// Query the CPU for its SIMD capabilities.
+///
+/// \return Supported SIMD level
+static SimdLevel
+detectSimdLevel()
+{
+#if defined(SPATIUMGL_SIMD_X86) && defined(_MSC_VER)
+  int info[4];
+  __cpuid(info, 1);
+  const bool sse2 = (info[3] & (1 << 26)) != 0;
+  const bool osxsave = (info[2] & (1 << 27)) != 0;
+  const bool avx = (info[2] & (1 << 28)) != 0;
+  if (avx && osxsave && (_xgetbv(0) & 0x6) == 0x6) {
+    return SimdLevel::AVX;
+  }
+  return sse2 ? SimdLevel::SSE2 : SimdLevel::None;
+#elif defined(SPATIUMGL_SIMD_X86)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx")) {
+    return SimdLevel::AVX;
+  }
+  if (__builtin_cpu_supports("sse2")) {
+    return SimdLevel::SSE2;
+  }
+  return SimdLevel::None;
+#else
+  return SimdLevel::None;
+#endif
+}
+
+static std::atomic<int> g_simdLevel(-1);
+
+SimdLevel
+supportedSimdLevel()
+{
+  static const SimdLevel supported = detectSimdLevel();
+  return supported;
+}
+
+SimdLevel
+simdLevel()
+{
+  const int level = g_simdLevel.load(std::memory_order_relaxed);
+  if (level < 0) {
+    return supportedSimdLevel();
+  }
+  return static_cast<SimdLevel>(level);
+}
+
+SimdLevel
+setSimdLevel(SimdLevel level)
+{
+  const SimdLevel supported = supportedSimdLevel();
+  if (static_cast<int>(level) > static_cast<int>(supported)) {
+    level = supported;
+  }
+  g_simdLevel.store(static_cast<int>(level), std::memory_order_relaxed);
+  return level;
+}
+
+} // namespace spgl
@@ -0,0 +1,39 @@
+/*
+ * Program: Spatium Graphics Library
+ *
+ * Copyright (C) Martijn Koopman
+ * All Rights Reserved
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.
+ *
+ */
+
+#ifndef SPATIUMGL_SIMDIMPL_H
+#define SPATIUMGL_SIMDIMPL_H
+
+// Private header for translation units that implement SIMD kernels.
+//
+// The library is compiled without any instruction set flags. SSE2 and AVX
+// kernels are compiled for their target through function attributes (GCC,
+// Clang) and selected at runtime through spgl::simdLevel(). MSVC allows the
+// intrinsics without any flags.
+
+#include "spatiumgl/Simd.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) ||            \
+  defined(_M_IX86)
+#define SPATIUMGL_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define SPATIUMGL_TARGET_SSE2 __attribute__((target("sse2")))
+#define SPATIUMGL_TARGET_AVX __attribute__((target("avx")))
+#else
+#define SPATIUMGL_TARGET_SSE2
+#define SPATIUMGL_TARGET_AVX
+#endif
+
+#endif // SPATIUMGL_SIMDIMPL_H
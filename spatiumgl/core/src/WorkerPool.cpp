@@ -0,0 +1,113 @@
+/*
+ * Program: Spatium Graphics Library
+ *
+ * Copyright (C) Martijn Koopman
+ * All Rights Reserved
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.
+ *
+ */
+
+#include "spatiumgl/WorkerPool.hpp"
+#include "spatiumgl/Parallel.hpp" // resolveThreadCount
+
+namespace spgl {
+
+WorkerPool::WorkerPool(size_t threads)
+  : m_threads()
+  , m_tasks()
+  , m_mutex()
+  , m_taskAvailable()
+  , m_idle()
+  , m_active(0)
+  , m_stop(false)
+{
+  threads = resolveThreadCount(threads);
+  m_threads.reserve(threads);
+  for (size_t i = 0; i < threads; i++) {
+    m_threads.emplace_back(&WorkerPool::work, this);
+  }
+}
+
+WorkerPool::~WorkerPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_tasks.clear();
+    m_stop = true;
+  }
+  m_taskAvailable.notify_all();
+  for (std::thread& thread : m_threads) {
+    thread.join();
+  }
+}
+
+void
+WorkerPool::submit(Task task)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_tasks.push_back(std::move(task));
+  }
+  m_taskAvailable.notify_one();
+}
+
+size_t
+WorkerPool::clear()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  const size_t count = m_tasks.size();
+  m_tasks.clear();
+  if (m_active == 0) {
+    m_idle.notify_all();
+  }
+  return count;
+}
+
+size_t
+WorkerPool::pendingCount() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_tasks.size();
+}
+
+size_t
+WorkerPool::activeCount() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_active;
+}
+
+void
+WorkerPool::wait()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_idle.wait(lock, [this]() { return m_tasks.empty() && m_active == 0; });
+}
+
+void
+WorkerPool::work()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (true) {
+    m_taskAvailable.wait(lock, [this]() { return m_stop || !m_tasks.empty(); });
+    if (m_stop) {
+      return;
+    }
+
+    Task task = std::move(m_tasks.front());
+    m_tasks.pop_front();
+    m_active++;
+    lock.unlock();
+    task();
+    lock.lock();
+    m_active--;
+    if (m_active == 0 && m_tasks.empty()) {
+      m_idle.notify_all();
+    }
+  }
+}
+
+} // namespace spgl
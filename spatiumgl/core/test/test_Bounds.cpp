@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 
 #include <spatiumgl/Bounds.hpp>
+#include <spatiumgl/Simd.hpp>
 
 TEST(Bounds, defaultConstructors)
 {
@@ -97,6 +98,45 @@ TEST(BoundingBox, fromPoints)
   EXPECT_EQ(box.max(), spgl::Vector3(3, 6, 9));
 }
 
+TEST(BoundingBox, fromPointsParallel)
+{
+  // Pseudo random points; odd count to exercise the scalar tail
+  std::vector<spgl::Vector3f> pointsf(200003);
+  std::vector<spgl::Vector3> points(pointsf.size());
+  unsigned int seed = 12345;
+  for (size_t i = 0; i < pointsf.size(); i++) {
+    for (size_t c = 0; c < 3; c++) {
+      seed = seed * 1103515245u + 12345u;
+      pointsf[i][c] = static_cast<float>(seed % 100000) / 7.0f - 5000.0f;
+    }
+    points[i] = pointsf[i].staticCast<double>();
+  }
+  pointsf[150001] = { -20000, 20000, 0.5f };
+  points[150001] = pointsf[150001].staticCast<double>();
+  const auto correct = spgl::BoundingBox::fromPoints(points);
+  EXPECT_EQ(correct.min()[0], -20000);
+  EXPECT_EQ(correct.max()[1], 20000);
+
+  const spgl::SimdLevel levels[] = { spgl::SimdLevel::None,
+                                     spgl::SimdLevel::SSE2,
+                                     spgl::SimdLevel::AVX };
+  for (spgl::SimdLevel level : levels) {
+    spgl::setSimdLevel(level);
+    for (size_t threads : { 1, 3, 0 }) {
+      EXPECT_EQ(correct, spgl::BoundingBox::fromPoints(points, threads));
+      EXPECT_EQ(correct, spgl::BoundingBox::fromPoints(pointsf, threads));
+    }
+  }
+  spgl::setSimdLevel(spgl::supportedSimdLevel());
+
+  // Empty and single point
+  EXPECT_EQ(spgl::BoundingBox(),
+            spgl::BoundingBox::fromPoints(std::vector<spgl::Vector3f>(), 0));
+  const auto single = spgl::BoundingBox::fromPoints(pointsf.data(), 1, 0);
+  EXPECT_EQ(single.center(), points[0]);
+  EXPECT_EQ(single.radii(), spgl::Vector3(0, 0, 0));
+}
+
 TEST(BoundingBox, fromMinMax)
 {
   const spgl::Vector3 min(2, 3, 4);
@@ -1,6 +1,11 @@
 #include <gtest/gtest.h>
 
 #include <spatiumgl/Color.hpp>
+#include <spatiumgl/ColorLut.hpp>
+#include <spatiumgl/Simd.hpp>
+
+#include <limits>
+#include <vector>
 
 TEST(Color, constructor)
 {
@@ -198,3 +203,61 @@ TEST(ColorRamp, toVector)
   EXPECT_EQ(vec[4], (spgl::Color{ 0, 1, 1, 1 }));
   EXPECT_EQ(vec[5], (spgl::Color{ 0, 0, 1, 1 }));
 }
+
+TEST(ColorLut, construct)
+{
+  const spgl::ColorLut lut(spgl::ColorRamp::grayscale(0, 4), 5);
+  EXPECT_EQ(lut.size(), 5);
+  EXPECT_EQ(lut.min(), 0);
+  EXPECT_EQ(lut.max(), 4);
+  EXPECT_EQ(lut.colors()[2], (spgl::ColorT<float>{ 0.5f, 0.5f, 0.5f, 1 }));
+  EXPECT_EQ(lut.colors8()[0], (spgl::Color8{ 0, 0, 0, 255 }));
+  EXPECT_EQ(lut.colors8()[1], (spgl::Color8{ 64, 64, 64, 255 }));
+  EXPECT_EQ(lut.colors8()[4], (spgl::Color8{ 255, 255, 255, 255 }));
+
+  // Empty lookup table
+  const spgl::ColorLut empty;
+  EXPECT_EQ(empty.size(), 0);
+  EXPECT_EQ(empty.map(1), (spgl::Color8{ 0, 0, 0, 0 }));
+}
+
+TEST(ColorLut, map)
+{
+  const spgl::ColorLut lut(spgl::ColorRamp::grayscale(0, 4), 5);
+  EXPECT_EQ(lut.index(-1), 0);
+  EXPECT_EQ(lut.index(0), 0);
+  EXPECT_EQ(lut.index(0.49f), 0);
+  EXPECT_EQ(lut.index(0.51f), 1);
+  EXPECT_EQ(lut.index(3), 3);
+  EXPECT_EQ(lut.index(4), 4);
+  EXPECT_EQ(lut.index(100), 4);
+  EXPECT_EQ(lut.index(std::numeric_limits<float>::quiet_NaN()), 0);
+  EXPECT_EQ(lut.map(2), lut.colors8()[2]);
+}
+
+TEST(ColorLut, mapBatched)
+{
+  const spgl::ColorLut lut(spgl::ColorRampT<float>::spectral(-10, 10));
+
+  // Odd count to exercise the scalar tail
+  std::vector<float> values;
+  for (int i = 0; i < 1001; i++) {
+    values.push_back(static_cast<float>(i) * 0.025f - 12.5f);
+  }
+  values.push_back(std::numeric_limits<float>::quiet_NaN());
+  values.push_back(std::numeric_limits<float>::infinity());
+  values.push_back(-std::numeric_limits<float>::infinity());
+
+  const spgl::SimdLevel levels[] = { spgl::SimdLevel::None,
+                                     spgl::SimdLevel::SSE2,
+                                     spgl::SimdLevel::AVX };
+  for (spgl::SimdLevel level : levels) {
+    spgl::setSimdLevel(level);
+    const std::vector<spgl::Color8> result = lut.map(values);
+    ASSERT_EQ(result.size(), values.size());
+    for (size_t i = 0; i < values.size(); i++) {
+      EXPECT_EQ(result[i], lut.map(values[i]));
+    }
+  }
+  spgl::setSimdLevel(spgl::supportedSimdLevel());
+}
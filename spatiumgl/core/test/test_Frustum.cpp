@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+
+#include <spatiumgl/Frustum.hpp>
+#include <spatiumgl/Simd.hpp>
+
+#include <vector>
+
+namespace {
+
+/// Perspective frustum looking down the negative Z axis (view space).
+/// Vertical and horizontal field of view: 90 degrees; near 1, far 100.
+spgl::Frustum
+testFrustum()
+{
+  return spgl::Frustum(
+    spgl::Matrix4::perspective(1.5707963267948966, 1.0, 1.0, 100.0));
+}
+
+} // namespace
+
+TEST(Frustum, planes)
+{
+  const spgl::Frustum frustum = testFrustum();
+
+  // Normals are normalized and point inwards
+  for (size_t i = 0; i < 6; i++) {
+    const spgl::Vector4& plane = frustum.plane(i);
+    EXPECT_NEAR(spgl::Vector3(plane[0], plane[1], plane[2]).magnitude(),
+                1.0,
+                1e-12);
+    EXPECT_GT(frustum.distance(i, { 0, 0, -50 }), 0);
+  }
+
+  EXPECT_NEAR(frustum.distance(spgl::Frustum::Near, { 0, 0, -1 }), 0, 1e-9);
+  EXPECT_NEAR(frustum.distance(spgl::Frustum::Far, { 0, 0, -100 }), 0, 1e-9);
+  EXPECT_NEAR(frustum.distance(spgl::Frustum::Left, { -10, 0, -10 }), 0, 1e-9);
+  EXPECT_NEAR(frustum.distance(spgl::Frustum::Top, { 0, 10, -10 }), 0, 1e-9);
+}
+
+TEST(Frustum, contains)
+{
+  const spgl::Frustum frustum = testFrustum();
+  EXPECT_TRUE(frustum.contains({ 0, 0, -2 }));
+  EXPECT_TRUE(frustum.contains({ 9, -9, -10 }));
+  EXPECT_FALSE(frustum.contains({ 0, 0, 2 }));      // behind
+  EXPECT_FALSE(frustum.contains({ 0, 0, -0.5 }));   // before near plane
+  EXPECT_FALSE(frustum.contains({ 0, 0, -101 }));   // beyond far plane
+  EXPECT_FALSE(frustum.contains({ 11, 0, -10 }));   // right
+  EXPECT_FALSE(frustum.contains({ 0, -11, -10 }));  // below
+}
+
+TEST(Frustum, sphere)
+{
+  const spgl::Frustum frustum = testFrustum();
+  EXPECT_EQ(frustum.test({ 0, 0, -50 }, 1), spgl::Visibility::Inside);
+  EXPECT_EQ(frustum.test({ 0, 0, -100 }, 1), spgl::Visibility::Intersect);
+  EXPECT_EQ(frustum.test({ 0, 0, 5 }, 1), spgl::Visibility::Outside);
+  EXPECT_EQ(frustum.test({ 20, 0, -10 }, 1), spgl::Visibility::Outside);
+}
+
+TEST(Frustum, box)
+{
+  const spgl::Frustum frustum = testFrustum();
+  EXPECT_EQ(frustum.test(spgl::BoundingBox({ 0, 0, -50 }, { 1, 2, 3 })),
+            spgl::Visibility::Inside);
+  EXPECT_EQ(frustum.test(spgl::BoundingBox({ 10, 0, -10 }, { 1, 1, 1 })),
+            spgl::Visibility::Intersect);
+  EXPECT_EQ(frustum.test(spgl::BoundingBox({ 0, 0, 10 }, { 1, 1, 1 })),
+            spgl::Visibility::Outside);
+  EXPECT_EQ(frustum.test(spgl::BoundingCube({ 0, 0, -50 }, 200)),
+            spgl::Visibility::Intersect);
+  EXPECT_EQ(frustum.test(spgl::BoundingCube({ 0, 50, -10 }, 5)),
+            spgl::Visibility::Outside);
+
+  // Default frustum: everything inside
+  EXPECT_EQ(spgl::Frustum().test(spgl::BoundingCube({ 1, 2, 3 }, 4)),
+            spgl::Visibility::Inside);
+}
+
+TEST(Frustum, batched)
+{
+  const spgl::Frustum frustum =
+    spgl::Frustum(spgl::Matrix4::perspective(1.0, 1.5, 0.5, 80.0) *
+                  spgl::Matrix4::rotation(0.2, 0.4, -0.1));
+
+  // Grid of boxes and cubes (odd count to exercise the scalar tail)
+  std::vector<spgl::BoundingBox> boxes;
+  std::vector<spgl::BoundingCube> cubes;
+  for (int x = -10; x <= 10; x++) {
+    for (int y = -10; y <= 10; y++) {
+      for (int z = -20; z <= 2; z += 2) {
+        const spgl::Vector3 center(x * 5, y * 5, z * 5);
+        boxes.emplace_back(center, spgl::Vector3(1 + (x & 3), 2, 3));
+        cubes.emplace_back(center, 1.0 + (y & 3));
+      }
+    }
+  }
+
+  size_t counts[3] = { 0, 0, 0 };
+  const spgl::SimdLevel levels[] = { spgl::SimdLevel::None,
+                                     spgl::SimdLevel::SSE2,
+                                     spgl::SimdLevel::AVX };
+  for (spgl::SimdLevel level : levels) {
+    spgl::setSimdLevel(level);
+    const std::vector<spgl::Visibility> boxResult = frustum.test(boxes);
+    const std::vector<spgl::Visibility> cubeResult = frustum.test(cubes);
+    for (size_t i = 0; i < boxes.size(); i++) {
+      EXPECT_EQ(frustum.test(boxes[i]), boxResult[i]);
+      EXPECT_EQ(frustum.test(cubes[i]), cubeResult[i]);
+      counts[static_cast<size_t>(boxResult[i])]++;
+    }
+  }
+  spgl::setSimdLevel(spgl::supportedSimdLevel());
+
+  // All cases occur
+  EXPECT_GT(counts[0], 0);
+  EXPECT_GT(counts[1], 0);
+  EXPECT_GT(counts[2], 0);
+}
@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+
+#include <spatiumgl/LruCache.hpp>
+
+#include <string>
+#include <vector>
+
+TEST(LruCache, insertGet)
+{
+  spgl::LruCache<int, std::string> cache(100);
+  cache.insert(1, "one", 10);
+  cache.insert(2, "two", 20);
+  EXPECT_EQ(cache.count(), 2u);
+  EXPECT_EQ(cache.size(), 30u);
+  EXPECT_TRUE(cache.contains(1));
+  EXPECT_FALSE(cache.contains(3));
+  ASSERT_NE(cache.get(2), nullptr);
+  EXPECT_EQ(*cache.get(2), "two");
+  EXPECT_EQ(cache.get(3), nullptr);
+
+  // Replace
+  cache.insert(1, "uno", 5);
+  EXPECT_EQ(cache.count(), 2u);
+  EXPECT_EQ(cache.size(), 25u);
+  EXPECT_EQ(*cache.get(1), "uno");
+
+  EXPECT_TRUE(cache.erase(1));
+  EXPECT_FALSE(cache.erase(1));
+  EXPECT_EQ(cache.size(), 20u);
+}
+
+TEST(LruCache, trim)
+{
+  spgl::LruCache<int, int> cache(30);
+  cache.insert(1, 1, 10);
+  cache.insert(2, 2, 10);
+  cache.insert(3, 3, 10);
+  cache.nextFrame();
+  cache.get(1); // 2 is least recently used
+  cache.insert(4, 4, 10);
+
+  std::vector<spgl::LruCache<int, int>::Entry> evicted;
+  EXPECT_EQ(cache.trim(&evicted), 1u);
+  ASSERT_EQ(evicted.size(), 1u);
+  EXPECT_EQ(evicted[0].first, 2);
+  EXPECT_EQ(cache.size(), 30u);
+  EXPECT_TRUE(cache.contains(1));
+  EXPECT_TRUE(cache.contains(3));
+  EXPECT_TRUE(cache.contains(4));
+
+  // Entries used in the current frame are kept, even beyond the budget
+  cache.setBudget(10);
+  cache.get(3);
+  evicted.clear();
+  EXPECT_EQ(cache.trim(&evicted), 0u);
+  EXPECT_EQ(cache.count(), 3u);
+
+  cache.nextFrame();
+  cache.get(4);
+  EXPECT_EQ(cache.trim(), 2u);
+  EXPECT_EQ(cache.count(), 1u);
+  EXPECT_TRUE(cache.contains(4));
+
+  cache.clear(&evicted);
+  EXPECT_EQ(cache.count(), 0u);
+  EXPECT_EQ(cache.size(), 0u);
+  EXPECT_EQ(evicted.back().first, 4);
+}
@@ -0,0 +1,165 @@
+#include <gtest/gtest.h>
+
+#include <spatiumgl/Matrix.hpp>
+#include <spatiumgl/PointTransform.hpp>
+#include <spatiumgl/Simd.hpp>
+
+#include <vector>
+
+namespace {
+
+const spgl::SimdLevel levels[] = { spgl::SimdLevel::None,
+                                   spgl::SimdLevel::SSE2,
+                                   spgl::SimdLevel::AVX };
+
+spgl::Matrix4
+testMatrix()
+{
+  return spgl::Matrix4::translation(1.5, -2, 3) *
+         spgl::Matrix4::rotation(0.3, -0.7, 1.1) *
+         spgl::Matrix4::scaling(2, 0.5, 3);
+}
+
+/// Generate count deterministic points (odd counts exercise the scalar tail).
+std::vector<spgl::Vector3f>
+testPoints(size_t count)
+{
+  std::vector<spgl::Vector3f> points(count);
+  for (size_t i = 0; i < count; i++) {
+    const float f = static_cast<float>(i);
+    points[i] = { f * 0.5f - 7, 3 - f * 0.25f, f * 0.125f };
+  }
+  return points;
+}
+
+} // namespace
+
+TEST(PointTransform, simdLevel)
+{
+  const spgl::SimdLevel supported = spgl::supportedSimdLevel();
+  EXPECT_EQ(spgl::SimdLevel::None, spgl::setSimdLevel(spgl::SimdLevel::None));
+  EXPECT_EQ(spgl::SimdLevel::None, spgl::simdLevel());
+  EXPECT_EQ(supported, spgl::setSimdLevel(spgl::SimdLevel::AVX));
+  EXPECT_EQ(supported, spgl::simdLevel());
+}
+
+TEST(PointTransform, transformFloat)
+{
+  const spgl::Matrix4 matrix = testMatrix();
+  const std::vector<spgl::Vector3f> points = testPoints(37);
+
+  for (spgl::SimdLevel level : levels) {
+    spgl::setSimdLevel(level);
+    const std::vector<spgl::Vector3f> result =
+      spgl::transformPoints(matrix, points);
+    ASSERT_EQ(points.size(), result.size());
+    for (size_t i = 0; i < points.size(); i++) {
+      const spgl::Vector4 correct =
+        matrix * spgl::Vector4(points[i].x(), points[i].y(), points[i].z(), 1);
+      EXPECT_NEAR(correct.x(), result[i].x(), 1e-4);
+      EXPECT_NEAR(correct.y(), result[i].y(), 1e-4);
+      EXPECT_NEAR(correct.z(), result[i].z(), 1e-4);
+    }
+  }
+  spgl::setSimdLevel(spgl::supportedSimdLevel());
+}
+
+TEST(PointTransform, transformDouble)
+{
+  const spgl::Matrix4 matrix = testMatrix();
+  const std::vector<spgl::Vector3f> pointsf = testPoints(11);
+  std::vector<spgl::Vector3> points;
+  for (const spgl::Vector3f& p : pointsf) {
+    points.push_back(p.staticCast<double>());
+  }
+
+  for (spgl::SimdLevel level : levels) {
+    spgl::setSimdLevel(level);
+    const std::vector<spgl::Vector3> result =
+      spgl::transformPoints(matrix, points);
+    for (size_t i = 0; i < points.size(); i++) {
+      const spgl::Vector4 correct =
+        matrix * spgl::Vector4(points[i].x(), points[i].y(), points[i].z(), 1);
+      EXPECT_NEAR(correct.x(), result[i].x(), 1e-12);
+      EXPECT_NEAR(correct.y(), result[i].y(), 1e-12);
+      EXPECT_NEAR(correct.z(), result[i].z(), 1e-12);
+    }
+  }
+  spgl::setSimdLevel(spgl::supportedSimdLevel());
+}
+
+TEST(PointTransform, transformInPlace)
+{
+  const spgl::Matrix4 matrix = spgl::Matrix4::translation(1, 2, 3);
+  std::vector<spgl::Vector3f> points = testPoints(9);
+  const std::vector<spgl::Vector3f> original = points;
+
+  spgl::transformPoints(matrix, points.data(), points.size(), points.data());
+  for (size_t i = 0; i < points.size(); i++) {
+    EXPECT_FLOAT_EQ(original[i].x() + 1, points[i].x());
+    EXPECT_FLOAT_EQ(original[i].y() + 2, points[i].y());
+    EXPECT_FLOAT_EQ(original[i].z() + 3, points[i].z());
+  }
+}
+
+TEST(PointTransform, empty)
+{
+  // No points: pointers are not dereferenced
+  const spgl::Matrix4 matrix = testMatrix();
+  for (spgl::SimdLevel level : levels) {
+    spgl::setSimdLevel(level);
+    spgl::transformPoints(
+      matrix, static_cast<const spgl::Vector3f*>(nullptr), 0, nullptr);
+    spgl::transformPoints(
+      matrix, static_cast<const spgl::Vector3*>(nullptr), 0, nullptr);
+    spgl::projectPoints(matrix, nullptr, 0, nullptr);
+    EXPECT_TRUE(
+      spgl::projectPoints(matrix, std::vector<spgl::Vector3f>()).empty());
+  }
+  spgl::setSimdLevel(spgl::supportedSimdLevel());
+}
+
+TEST(PointTransform, project)
+{
+  const spgl::Matrix4 matrix =
+    spgl::Matrix4::perspective(1.0, 1.5, 0.1, 100.0) * testMatrix();
+  const std::vector<spgl::Vector3f> points = testPoints(21);
+
+  std::vector<float> x, y, z;
+  for (const spgl::Vector3f& p : points) {
+    x.push_back(p.x());
+    y.push_back(p.y());
+    z.push_back(p.z());
+  }
+
+  for (spgl::SimdLevel level : levels) {
+    spgl::setSimdLevel(level);
+    const std::vector<spgl::Vector4f> result =
+      spgl::projectPoints(matrix, points);
+
+    std::vector<float> rx(x.size()), ry(x.size()), rz(x.size()), rw(x.size());
+    spgl::projectPoints(matrix,
+                        x.data(),
+                        y.data(),
+                        z.data(),
+                        x.size(),
+                        rx.data(),
+                        ry.data(),
+                        rz.data(),
+                        rw.data());
+
+    for (size_t i = 0; i < points.size(); i++) {
+      const spgl::Vector4 correct =
+        matrix * spgl::Vector4(points[i].x(), points[i].y(), points[i].z(), 1);
+      EXPECT_NEAR(correct.x(), result[i].x(), 1e-3);
+      EXPECT_NEAR(correct.y(), result[i].y(), 1e-3);
+      EXPECT_NEAR(correct.z(), result[i].z(), 1e-3);
+      EXPECT_NEAR(correct.w(), result[i].w(), 1e-3);
+      EXPECT_FLOAT_EQ(result[i].x(), rx[i]);
+      EXPECT_FLOAT_EQ(result[i].y(), ry[i]);
+      EXPECT_FLOAT_EQ(result[i].z(), rz[i]);
+      EXPECT_FLOAT_EQ(result[i].w(), rw[i]);
+    }
+  }
+  spgl::setSimdLevel(spgl::supportedSimdLevel());
+}
@@ -118,3 +118,32 @@ TEST(Vector, accessElements)
   EXPECT_EQ(z4_const, 3);
   EXPECT_EQ(w4_const, 4);
 }
+
+TEST(Vector, compoundAssignment)
+{
+  spgl::Vector<double, 5> vec{ 1, 2, 3, 4, 5 };
+
+  vec += spgl::Vector<double, 5>{ 1, 1, 1, 1, 1 };
+  EXPECT_EQ(vec, (spgl::Vector<double, 5>{ 2, 3, 4, 5, 6 }));
+
+  vec -= spgl::Vector<double, 5>{ 2, 2, 2, 2, 2 };
+  EXPECT_EQ(vec, (spgl::Vector<double, 5>{ 0, 1, 2, 3, 4 }));
+
+  vec *= 2;
+  EXPECT_EQ(vec, (spgl::Vector<double, 5>{ 0, 2, 4, 6, 8 }));
+
+  vec /= 4;
+  EXPECT_EQ(vec, (spgl::Vector<double, 5>{ 0, 0.5, 1, 1.5, 2 }));
+}
+
+TEST(Vector, compoundExpression)
+{
+  const spgl::Vector3i index(3, -2, 7);
+  const double spacing = 0.25;
+
+  const spgl::Vector3 result =
+    (index.staticCast<double>() * spacing) + spgl::Vector3(0.5 * spacing);
+  EXPECT_DOUBLE_EQ(result.x(), 0.875);
+  EXPECT_DOUBLE_EQ(result.y(), -0.375);
+  EXPECT_DOUBLE_EQ(result.z(), 1.875);
+}
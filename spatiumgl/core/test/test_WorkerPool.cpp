@@ -0,0 +1,48 @@
+#include <gtest/gtest.h>
+
+#include <spatiumgl/WorkerPool.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+TEST(WorkerPool, submitWait)
+{
+  spgl::WorkerPool pool(3);
+  EXPECT_EQ(pool.threadCount(), 3u);
+
+  std::atomic<int> sum(0);
+  for (int i = 1; i <= 100; i++) {
+    pool.submit([&sum, i]() { sum += i; });
+  }
+  pool.wait();
+  EXPECT_EQ(sum.load(), 5050);
+  EXPECT_EQ(pool.pendingCount(), 0u);
+  EXPECT_EQ(pool.activeCount(), 0u);
+}
+
+TEST(WorkerPool, clear)
+{
+  spgl::WorkerPool pool(1);
+
+  // Block the only thread, so the other tasks stay pending
+  std::atomic<bool> release(false);
+  std::atomic<int> count(0);
+  pool.submit([&release]() {
+    while (!release) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  });
+  for (int i = 0; i < 10; i++) {
+    pool.submit([&count]() { count++; });
+  }
+  while (pool.activeCount() == 0) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(pool.pendingCount(), 10u);
+  EXPECT_EQ(pool.clear(), 10u);
+
+  release = true;
+  pool.wait();
+  EXPECT_EQ(count.load(), 0);
+}
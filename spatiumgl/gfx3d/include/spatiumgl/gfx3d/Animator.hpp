@@ -24,14 +24,29 @@ class SPATIUMGL_EXPORT Animator
 public:
   Animator(RenderObject* renderObject)
     : m_renderObject(renderObject)
+    , m_active(true)
   {}
 
   virtual ~Animator() = default;
 
+  /// Set boolean indicator if the animator is active.
+  ///
+  /// The render window redraws continuously while any animator is active,
+  /// and only animates active animators.
+  ///
+  /// \param[in] active True if active, false otherwise
+  void setActive(bool active) { m_active = active; }
+
+  /// Get boolean indicator if the animator is active.
+  ///
+  /// \return True if active (default), false otherwise
+  bool isActive() const { return m_active; }
+
   virtual void animate(double deltaTime) = 0;
 
 protected:
   RenderObject* m_renderObject;
+  bool m_active;
 };
 
 } // namespace gfx3d
@@ -15,6 +15,7 @@
 
 #include "SceneObject.hpp"
 #include "spatiumgl/Bounds.hpp"
+#include "spatiumgl/Frustum.hpp"
 #include "spatiumglexport.hpp"
 
 namespace spgl {
@@ -75,6 +76,21 @@ public:
   /// \return Projection matrix
   virtual Matrix4 projectionMatrix(double aspect) const = 0;
 
+  /// Get the view matrix.
+  ///
+  /// The view matrix transforms from world space to view (camera) space.
+  ///
+  /// \return View matrix
+  /// \throw std::out_of_range Camera transformation is singular
+  Matrix4 viewMatrix() const;
+
+  /// Get the view frustum in world space.
+  ///
+  /// \param[in] aspect Aspect ratio (w/h)
+  /// \return View frustum
+  /// \throw std::out_of_range Camera transformation is singular
+  Frustum frustum(double aspect) const;
+
   //virtual Vector3 worldToViewportPoint(const Vector3& point,
   //                                    double aspect) const = 0;
   //virtual Vector3 worldToScreenPoint(const Vector3& point,
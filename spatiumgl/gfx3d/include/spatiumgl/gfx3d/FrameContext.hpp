@@ -0,0 +1,56 @@
+/*
+ * Program: Spatium Graphics Library
+ *
+ * Copyright (C) Martijn Koopman
+ * All Rights Reserved
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.
+ *
+ */
+
+#ifndef SPATIUMGL_GFX3D_FRAMECONTEXT_H
+#define SPATIUMGL_GFX3D_FRAMECONTEXT_H
+
+#include "Camera.hpp"
+#include "spatiumgl/Matrix.hpp"
+#include "spatiumgl/Vector.hpp"
+#include "spatiumglexport.hpp"
+
+namespace spgl {
+namespace gfx3d {
+
+/// \struct FrameContext
+/// \brief Camera state of a frame, shared by all renderers.
+///
+/// Computed once per frame by the render window, so renderers do not need
+/// to invert the camera transformation or compute the projection themselves.
+struct SPATIUMGL_EXPORT FrameContext
+{
+  Vector2i size;          ///< Render image size
+  double aspect;          ///< Aspect ratio (w/h)
+  Matrix4 view;           ///< View matrix (world to view space)
+  Matrix4 projection;     ///< Projection matrix
+  Matrix4 viewProjection; ///< Projection * view
+  Vector3 cameraPosition; ///< Camera position (world space)
+  double distanceScreen;  ///< Pixels per unit at distance 1 (size.y * P11)
+  bool perspective;       ///< Perspective (true) or orthographic projection
+  double frameTime;       ///< Duration of the previous frame (0 = unknown)
+  bool interacting;       ///< View changed since the previous frame
+
+  /// Create context from camera.
+  ///
+  /// The frame time and interaction are unknown (0 and false).
+  ///
+  /// \param[in] camera Camera
+  /// \param[in] size Render image size
+  /// \return Frame context
+  /// \throw std::out_of_range Camera transformation is singular
+  static FrameContext fromCamera(const Camera& camera, const Vector2i& size);
+};
+
+} // namespace gfx3d
+} // namespace spgl
+
+#endif // SPATIUMGL_GFX3D_FRAMECONTEXT_H
@@ -0,0 +1,199 @@
+/*
+ * Program: Spatium Graphics Library
+ *
+ * Copyright (C) Martijn Koopman
+ * All Rights Reserved
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.
+ *
+ */
+
+#ifndef SPATIUMGL_GFX3D_NODELOADSCHEDULER_H
+#define SPATIUMGL_GFX3D_NODELOADSCHEDULER_H
+
+#include "PointCloud.hpp"
+#include "PointCloudLod.hpp"
+#include "spatiumgl/WorkerPool.hpp"
+#include "spatiumglexport.hpp"
+
+#include <chrono>        // std::chrono::steady_clock
+#include <functional>    // std::function
+#include <memory>        // std::shared_ptr
+#include <mutex>         // std::mutex
+#include <unordered_map> // std::unordered_map
+#include <vector>        // std::vector
+
+namespace spgl {
+namespace gfx3d {
+
+/// \struct NodeLoadRequest
+/// \brief Request to load a node.
+///
+/// Requests are ordered by decreasing priority (screen-space error), then
+/// by increasing distance to the camera.
+struct SPATIUMGL_EXPORT NodeLoadRequest
+{
+  LodNodeKey key;  ///< Key of node
+  double priority; ///< Projected point spacing (pixels)
+  double distance; ///< Distance from camera to node
+
+  /// Compare order.
+  ///
+  /// \param[in] other Other request
+  /// \return True if this request is served before the other one
+  bool before(const NodeLoadRequest& other) const
+  {
+    return priority > other.priority ||
+           (priority == other.priority && distance < other.distance);
+  }
+};
+
+/// \struct NodeLoadResult
+/// \brief Loaded node.
+struct SPATIUMGL_EXPORT NodeLoadResult
+{
+  LodNodeKey key;                       ///< Key of node
+  std::shared_ptr<PointCloudData> data; ///< Points, nullptr if loading failed
+};
+
+/// \struct NodeLoadMetrics
+/// \brief Counters of a NodeLoadScheduler.
+struct SPATIUMGL_EXPORT NodeLoadMetrics
+{
+  size_t queueDepth = 0;        ///< Requests waiting for a loading thread
+  size_t inFlight = 0;          ///< Nodes being loaded
+  size_t ready = 0;             ///< Loaded nodes waiting for upload budget
+  size_t loaded = 0;            ///< Loaded nodes handed out (total)
+  size_t failed = 0;            ///< Nodes that failed to load (total)
+  size_t cancelled = 0;         ///< Requests cancelled before loading (total)
+  size_t wasted = 0;            ///< Loaded nodes no longer wanted (total)
+  size_t uploadedBytes = 0;     ///< Bytes handed out in the last frame
+  double uploadLatencyMean = 0; ///< Mean time from request to hand out (s)
+  double uploadLatencyMax = 0;  ///< Max time from request to hand out (s)
+};
+
+/// \class NodeLoadScheduler
+/// \brief Prioritized, cancellable queue of node load requests.
+///
+/// Every frame the complete set of wanted nodes is passed to request(). The
+/// queue is replaced and re-sorted: requests that are no longer wanted are
+/// cancelled before their loading starts. At most maxInFlight nodes are
+/// loaded at the same time, each on a thread of a worker pool; a thread takes
+/// the most important request when it finishes a node.
+///
+/// Loaded nodes are handed out by takeFinished(), at most uploadBudget bytes
+/// per frame so uploading them never stalls a frame. Nodes that finish
+/// loading after they were dropped from the requests are discarded, and
+/// counted as wasted.
+///
+/// All functions must be called from the same (render) thread.
+class SPATIUMGL_EXPORT NodeLoadScheduler
+{
+public:
+  /// Node loader. Called on a worker thread.
+  /// Returns nullptr if the node could not be loaded.
+  using Loader = std::function<std::shared_ptr<PointCloudData>(LodNodeKey)>;
+
+  /// Constructor.
+  ///
+  /// \param[in] loader Node loader
+  /// \param[in] maxInFlight Maximum number of nodes loaded at the same time
+  NodeLoadScheduler(Loader loader, size_t maxInFlight = 2);
+
+  /// Copy constructor. (deleted)
+  NodeLoadScheduler(const NodeLoadScheduler& other) = delete;
+
+  /// Copy assignment operator. (deleted)
+  NodeLoadScheduler& operator=(const NodeLoadScheduler& other) = delete;
+
+  /// Destructor.
+  ///
+  /// Cancels queued requests and waits for nodes being loaded.
+  ~NodeLoadScheduler();
+
+  /// Get maximum number of nodes loaded at the same time.
+  ///
+  /// \return Number of nodes (= number of threads)
+  size_t maxInFlight() const { return m_workers.threadCount(); }
+
+  /// Set maximum number of bytes handed out per frame.
+  ///
+  /// At least one node is handed out per frame, even if larger.
+  ///
+  /// \param[in] bytes Budget
+  void setUploadBudget(size_t bytes) { m_uploadBudget = bytes; }
+
+  /// Get maximum number of bytes handed out per frame.
+  ///
+  /// \return Budget (bytes)
+  size_t uploadBudget() const { return m_uploadBudget; }
+
+  /// Set wanted nodes.
+  ///
+  /// Replaces all queued requests. Nodes being loaded or waiting to be handed
+  /// out are not requested again.
+  ///
+  /// \param[in] requests Wanted nodes (any order)
+  void request(const std::vector<NodeLoadRequest>& requests);
+
+  /// Check whether a node is queued, being loaded or waiting to be handed out.
+  ///
+  /// \param[in] key Key of node
+  /// \return True if pending, false otherwise
+  bool isPending(LodNodeKey key) const;
+
+  /// Get number of nodes queued, being loaded or waiting to be handed out.
+  ///
+  /// \return Number of nodes
+  size_t pendingCount() const;
+
+  /// Take loaded nodes, within the upload budget.
+  ///
+  /// Call once per frame.
+  ///
+  /// \return Loaded (or failed) nodes, most important first
+  std::vector<NodeLoadResult> takeFinished();
+
+  /// Wait until all queued requests are loaded.
+  void wait();
+
+  /// Get metrics.
+  ///
+  /// \return Metrics
+  NodeLoadMetrics metrics() const;
+
+protected:
+  using Clock = std::chrono::steady_clock;
+
+  /// Load queued requests until the queue is empty. (worker thread)
+  void work();
+
+  /// Move loaded nodes from the workers to the ready list.
+  void collect();
+
+  Loader m_loader;
+  size_t m_uploadBudget;
+
+  // Shared with the workers
+  mutable std::mutex m_mutex;
+  std::vector<NodeLoadRequest> m_queue; // Most important last
+  size_t m_inFlight;
+  std::vector<NodeLoadResult> m_finished;
+  size_t m_activeWorkers;
+
+  // Render thread only
+  std::unordered_map<LodNodeKey, NodeLoadRequest> m_requests; // Wanted
+  std::unordered_map<LodNodeKey, Clock::time_point> m_pending;
+  std::vector<NodeLoadResult> m_ready;
+  NodeLoadMetrics m_metrics;
+  double m_uploadLatencySum;
+
+  WorkerPool m_workers; // Last member: joined before the others are destroyed
+};
+
+} // namespace gfx3d
+} // namespace spgl
+
+#endif // SPATIUMGL_GFX3D_NODELOADSCHEDULER_H
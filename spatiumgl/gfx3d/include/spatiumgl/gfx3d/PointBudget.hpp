@@ -0,0 +1,63 @@
+/*
+ * Program: Spatium Graphics Library
+ *
+ * Copyright (C) Martijn Koopman
+ * All Rights Reserved
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.
+ *
+ */
+
+#ifndef SPATIUMGL_GFX3D_POINTBUDGET_H
+#define SPATIUMGL_GFX3D_POINTBUDGET_H
+
+#include "FrameContext.hpp"
+#include "spatiumgl/Vector.hpp"
+#include "spatiumglexport.hpp"
+
+#include <vector> // std::vector
+
+namespace spgl {
+namespace gfx3d {
+
+/// \struct PointBudgetRequest
+/// \brief Chunk of points competing for a share of a point budget.
+struct SPATIUMGL_EXPORT PointBudgetRequest
+{
+  size_t pointCount; ///< Number of points in the chunk
+  double weight;     ///< Weight of the chunk (e.g. projectedCoverage())
+};
+
+/// Distribute a point budget over chunks.
+///
+/// Every chunk gets a share of the budget proportional to its weight, but
+/// not more than its number of points. The budget left over by chunks with
+/// fewer points than their share is distributed over the other chunks.
+/// Chunks without weight get no points, unless all points fit the budget.
+///
+/// \param[in] requests Chunks
+/// \param[in] budget Maximum number of points
+/// \return Number of points per chunk (in order of requests)
+SPATIUMGL_EXPORT std::vector<size_t>
+distributePointBudget(const std::vector<PointBudgetRequest>& requests,
+                      size_t budget);
+
+/// Compute the area on screen covered by the bounding sphere of a chunk.
+///
+/// Distant chunks cover less area, so they get fewer points of a budget.
+///
+/// \param[in] frame Frame context
+/// \param[in] center Center of chunk (world space)
+/// \param[in] radius Radius of the bounding sphere of the chunk
+/// \return Area (pixels), at most the render image size
+SPATIUMGL_EXPORT double
+projectedCoverage(const FrameContext& frame,
+                  const Vector3& center,
+                  double radius);
+
+} // namespace gfx3d
+} // namespace spgl
+
+#endif // SPATIUMGL_GFX3D_POINTBUDGET_H
@@ -0,0 +1,88 @@
+/*
+ * Program: Spatium Graphics Library
+ *
+ * Copyright (C) Martijn Koopman
+ * All Rights Reserved
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.
+ *
+ */
+
+#ifndef SPATIUMGL_GFX3D_POINTBUDGETCONTROLLER_H
+#define SPATIUMGL_GFX3D_POINTBUDGETCONTROLLER_H
+
+#include "spatiumglexport.hpp"
+
+#include <cstddef> // size_t
+
+namespace spgl {
+namespace gfx3d {
+
+/// \class PointBudgetController
+/// \brief Adapts the number of points drawn per frame to a target frame time.
+///
+/// The throughput (points per second) is estimated from the frame time and
+/// the number of points drawn in recent frames. The budget is the number of
+/// points that can be drawn in the target frame time at that throughput.
+///
+/// Frame times are bounded below by the display refresh interval (vertical
+/// sync), so the target frame time should exceed it.
+class SPATIUMGL_EXPORT PointBudgetController
+{
+public:
+  /// Constructor.
+  ///
+  /// \param[in] targetFrameTime Target frame time (seconds)
+  /// \param[in] minBudget Minimum budget (points)
+  PointBudgetController(double targetFrameTime = 1.0 / 30,
+                        size_t minBudget = 100000);
+
+  /// Set target frame time.
+  ///
+  /// \param[in] seconds Target frame time
+  void setTargetFrameTime(double seconds) { m_targetFrameTime = seconds; }
+
+  /// Get target frame time.
+  ///
+  /// \return Target frame time (seconds)
+  double targetFrameTime() const { return m_targetFrameTime; }
+
+  /// Set minimum budget.
+  ///
+  /// \param[in] points Minimum budget
+  void setMinBudget(size_t points) { m_minBudget = points; }
+
+  /// Get minimum budget.
+  ///
+  /// \return Minimum budget (points)
+  size_t minBudget() const { return m_minBudget; }
+
+  /// Update with a measured frame.
+  ///
+  /// Frames without a frame time or points are ignored.
+  ///
+  /// \param[in] frameTime Frame time (seconds)
+  /// \param[in] drawnPoints Number of points drawn in the frame
+  void update(double frameTime, size_t drawnPoints);
+
+  /// Get budget.
+  ///
+  /// \return Maximum number of points per frame (unlimited until the first
+  ///         update)
+  size_t budget() const;
+
+  /// Forget the measured throughput.
+  void reset() { m_throughput = 0; }
+
+protected:
+  double m_targetFrameTime;
+  size_t m_minBudget;
+  double m_throughput; // Points per second, 0 if unknown
+};
+
+} // namespace gfx3d
+} // namespace spgl
+
+#endif // SPATIUMGL_GFX3D_POINTBUDGETCONTROLLER_H
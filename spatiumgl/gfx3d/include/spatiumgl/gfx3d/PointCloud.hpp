@@ -13,6 +13,7 @@
 #ifndef SPATIUMGL_GFX3D_POINTCLOUD_H
 #define SPATIUMGL_GFX3D_POINTCLOUD_H
 
+#include "spatiumgl/gfx3d/PointQuantization.hpp"
 #include "spatiumgl/gfx3d/Scalars.hpp"
 #include "spatiumgl/Bounds.hpp"
 #include "spatiumgl/Vector.hpp"
@@ -42,9 +43,76 @@ public:
                  Scalars<float>&& scalars = Scalars<float>())
     : m_positions(std::move(positions))
     , m_colors(std::move(colors))
+    , m_packedColors()
     , m_scalars(std::move(scalars))
   {}
 
+  /// Constructor with packed colors.
+  ///
+  /// Packed colors take 4 bytes per point instead of 12, and are uploaded to
+  /// GPU memory as is.
+  ///
+  /// \param[in] positions Point positions
+  /// \param[in] colors Point colors (RGBA, 8 bits per channel)
+  /// \param[in] scalars Point scalars (optional)
+  PointCloudData(std::vector<Vector3f>&& positions,
+                 std::vector<Rgba8>&& colors,
+                 Scalars<float>&& scalars = Scalars<float>())
+    : m_positions(std::move(positions))
+    , m_colors()
+    , m_packedColors(std::move(colors))
+    , m_scalars(std::move(scalars))
+  {}
+
+  /// Append points.
+  ///
+  /// Appends the positions, colors and scalars of other points (moved from).
+  /// Reserve capacity in advance (e.g. by constructing with reserved vectors)
+  /// to append without reallocations.
+  ///
+  /// \param[in] other Points to append
+  void append(PointCloudData&& other)
+  {
+    m_positions.insert(m_positions.end(),
+                       other.m_positions.begin(),
+                       other.m_positions.end());
+    m_colors.insert(
+      m_colors.end(), other.m_colors.begin(), other.m_colors.end());
+    m_packedColors.insert(m_packedColors.end(),
+                          other.m_packedColors.begin(),
+                          other.m_packedColors.end());
+    if (m_scalars.name().empty()) {
+      m_scalars.setName(other.m_scalars.name());
+    }
+    for (float value : other.m_scalars.values()) {
+      m_scalars.addValue(value);
+    }
+    other.clear();
+  }
+
+  /// Reorder points.
+  ///
+  /// Positions, colors and scalars are reordered alike.
+  ///
+  /// \param[in] order Index of the point to put at every position (a
+  ///                  permutation, see computePointOrder())
+  void reorder(const std::vector<size_t>& order)
+  {
+    if (order.size() != m_positions.size()) {
+      return;
+    }
+    reorder(m_positions, order);
+    reorder(m_colors, order);
+    reorder(m_packedColors, order);
+    if (m_scalars.values().size() == order.size()) {
+      Scalars<float> scalars(order.size(), m_scalars.name());
+      for (size_t index : order) {
+        scalars.addValue(m_scalars.values()[index]);
+      }
+      m_scalars = std::move(scalars);
+    }
+  }
+
   /// Clear all data.
   ///
   /// Clears points, colors and scalars.
@@ -52,6 +120,7 @@ public:
   {
     std::vector<Vector3f>().swap(m_positions);
     std::vector<Vector3f>().swap(m_colors);
+    std::vector<Rgba8>().swap(m_packedColors);
     m_scalars.clear();
   }
 
@@ -65,6 +134,21 @@ public:
   /// \return Point colors
   const std::vector<Vector3f>& colors() const { return m_colors; }
 
+  /// Get packed point colors (by const reference)
+  ///
+  /// \return Packed point colors
+  const std::vector<Rgba8>& packedColors() const { return m_packedColors; }
+
+  /// Has colors (packed or not) for every point?
+  ///
+  /// \return True if every point has a color, false otherwise
+  bool hasColors() const
+  {
+    const size_t count = m_positions.size();
+    return count > 0 &&
+           (m_colors.size() == count || m_packedColors.size() == count);
+  }
+
   /// Get point scalars (by const reference)
   ///
   /// \return Point scalars
@@ -77,12 +161,32 @@ public:
   {
     return m_positions.capacity() * sizeof(Vector3f) +
            m_scalars.values().capacity() * sizeof(float) +
-           m_colors.capacity() * sizeof(Vector3f);
+           m_colors.capacity() * sizeof(Vector3f) +
+           m_packedColors.capacity() * sizeof(Rgba8);
   }
 
 protected:
+  /// Reorder values, if there is one for every point.
+  ///
+  /// \param[in,out] values Values
+  /// \param[in] order Index of the value to put at every position
+  template<typename T>
+  static void reorder(std::vector<T>& values, const std::vector<size_t>& order)
+  {
+    if (values.size() != order.size()) {
+      return;
+    }
+    std::vector<T> result;
+    result.reserve(order.size());
+    for (size_t index : order) {
+      result.push_back(values[index]);
+    }
+    values.swap(result);
+  }
+
   std::vector<Vector3f> m_positions;
   std::vector<Vector3f> m_colors;
+  std::vector<Rgba8> m_packedColors;
   Scalars<float> m_scalars;
 };
 
@@ -116,33 +220,20 @@ public:
   /// the provided constructor instead of this function.
   ///
   /// \param[in] data Point cloud data
+  /// \param[in] threads Maximum number of threads (0 = hardware concurrency)
   /// \return Point cloud header
-  static PointCloudHeader constructFromData(const PointCloudData& data)
+  static PointCloudHeader constructFromData(const PointCloudData& data,
+                                            size_t threads = 0)
   {
     const size_t count = data.positions().size();
-    const bool hasColors = data.colors().size() == count && count > 0;
+    const bool hasColors = data.hasColors();
     const bool hasScalars = data.scalars().values().size() == count && count > 0;
 
-    // Compute extent
-    auto computeExtent =
-      [&](const std::vector<Vector3f>& positions) -> BoundingBox {
-      if (positions.size() < 1) {
-        return {};
-      } else {
-        // Set initial extent
-        BoundingBox extent(positions[0].staticCast<double>(), {});
-
-        // Iterate points and update extent
-        for (size_t i = 1; i < positions.size(); i++) {
-          extent.include(positions[i].staticCast<double>());
-        }
-        return extent;
-      }
-    };
+    // Compute extent (parallel)
+    const BoundingBox extent =
+      BoundingBox::fromPoints(data.positions(), threads);
 
-    return {
-      count, hasColors, hasScalars, computeExtent(data.positions())
-    };
+    return { count, hasColors, hasScalars, extent };
   }
 
   // Compare operators
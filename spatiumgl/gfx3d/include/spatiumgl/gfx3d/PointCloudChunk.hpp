@@ -0,0 +1,79 @@
+/*
+ * Program: Spatium Graphics Library
+ *
+ * Copyright (C) Martijn Koopman
+ * All Rights Reserved
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.
+ *
+ */
+
+#ifndef SPATIUMGL_GFX3D_POINTCLOUDCHUNK_H
+#define SPATIUMGL_GFX3D_POINTCLOUDCHUNK_H
+
+#include "spatiumgl/Bounds.hpp"
+#include "spatiumgl/Vector.hpp"
+#include "spatiumglexport.hpp"
+
+#include <utility> // std::pair
+#include <vector>  // std::vector
+
+namespace spgl {
+namespace gfx3d {
+
+/// \struct PointCloudChunk
+/// \brief Range of consecutive points of a point cloud.
+///
+/// Large point clouds are rendered in chunks, so they can be uploaded over
+/// multiple frames and culled separately. Points are not reordered: chunks
+/// are only spatially compact if the points are (e.g. in acquisition order).
+struct SPATIUMGL_EXPORT PointCloudChunk
+{
+  size_t first;       ///< Index of first point
+  size_t count;       ///< Number of points
+  BoundingBox bounds; ///< Bounds of the points (model space)
+
+  /// Split points in chunks.
+  ///
+  /// \param[in] positions Point positions
+  /// \param[in] chunkSize Maximum number of points per chunk (> 0)
+  /// \param[in] threads Number of threads to compute bounds with (0 = all)
+  /// \return Chunks, in order
+  static std::vector<PointCloudChunk> split(
+    const std::vector<Vector3f>& positions,
+    size_t chunkSize,
+    size_t threads = 1);
+
+  /// Extend chunks with points appended to the positions.
+  ///
+  /// The last chunk is filled up to chunkSize points first, then new chunks
+  /// are added. Points already in chunks are not visited again.
+  ///
+  /// \param[in,out] chunks Chunks of the positions before they were appended
+  /// \param[in] positions Point positions
+  /// \param[in] chunkSize Maximum number of points per chunk (> 0)
+  /// \param[in] threads Number of threads to compute bounds with (0 = all)
+  /// \return Index of the first changed chunk (chunks.size() if none)
+  static size_t extend(std::vector<PointCloudChunk>& chunks,
+                       const std::vector<Vector3f>& positions,
+                       size_t chunkSize,
+                       size_t threads = 1);
+
+  /// Find the chunks that contain a range of points.
+  ///
+  /// \param[in] chunks Chunks (see split())
+  /// \param[in] first Index of first point
+  /// \param[in] count Number of points
+  /// \return Indices of first chunk and one past the last chunk
+  static std::pair<size_t, size_t> overlapping(
+    const std::vector<PointCloudChunk>& chunks,
+    size_t first,
+    size_t count);
+};
+
+} // namespace gfx3d
+} // namespace spgl
+
+#endif // SPATIUMGL_GFX3D_POINTCLOUDCHUNK_H
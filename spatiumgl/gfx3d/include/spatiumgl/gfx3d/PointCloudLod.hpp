@@ -0,0 +1,174 @@
+/*
+ * Program: Spatium Graphics Library
+ *
+ * Copyright (C) Martijn Koopman
+ * All Rights Reserved
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.
+ *
+ */
+
+#ifndef SPATIUMGL_GFX3D_POINTCLOUDLOD_H
+#define SPATIUMGL_GFX3D_POINTCLOUDLOD_H
+
+#include "Camera.hpp"
+#include "FrameContext.hpp"
+#include "spatiumgl/Frustum.hpp"
+#include "spatiumgl/Vector.hpp"
+#include "spatiumgl/idx/Octree.hpp"
+#include "spatiumglexport.hpp"
+
+#include <cstdint> // std::uint64_t
+#include <string>  // std::string
+#include <vector>  // std::vector
+
+namespace spgl {
+namespace gfx3d {
+
+/// Key of a node in a level of detail octree.
+///
+/// The key is the path from the root (3 bits per level, see NTreeEntry)
+/// prefixed with a 1 bit that marks the depth. The root has key 1.
+using LodNodeKey = std::uint64_t;
+
+/// Compute key of a node.
+///
+/// \param[in] depth Depth of node (max 21)
+/// \param[in] path Path from the root (see NTreeEntry)
+/// \return Key
+inline LodNodeKey
+lodNodeKey(size_t depth, std::uint64_t path)
+{
+  return (static_cast<LodNodeKey>(1) << (3 * depth)) | path;
+}
+
+/// Compute name of a node: 'r' followed by the child index of every level.
+///
+/// This matches the file names written by the lasoctree tool (r.las,
+/// r0.las, r07.las, ...).
+///
+/// \param[in] key Key
+/// \return Name
+SPATIUMGL_EXPORT std::string
+lodNodeName(LodNodeKey key);
+
+/// \struct LodView
+/// \brief View of a level of detail octree, in its model space.
+///
+/// The model matrix is assumed not to scale, so that distances in model space
+/// equal distances in world space.
+struct SPATIUMGL_EXPORT LodView
+{
+  Frustum frustum;     ///< View frustum (model space)
+  Vector3 position;    ///< Camera position (model space)
+  double screenScale;  ///< Pixels per unit (at distance 1 if perspective)
+  bool perspective;    ///< Perspective (true) or orthographic projection
+
+  /// Create view from camera.
+  ///
+  /// \param[in] camera Camera
+  /// \param[in] modelMatrix Model matrix of the octree
+  /// \param[in] size Render image size
+  /// \return View
+  static LodView fromCamera(const Camera& camera,
+                            const Matrix4& modelMatrix,
+                            const Vector2i& size);
+
+  /// Create view from the frame context of a render window.
+  ///
+  /// \param[in] frame Frame context
+  /// \param[in] modelMatrix Model matrix of the octree
+  /// \return View
+  static LodView fromFrameContext(const FrameContext& frame,
+                                  const Matrix4& modelMatrix);
+
+  /// Compute distance from the camera to the bounding sphere of a cube.
+  ///
+  /// \param[in] bounds Bounding cube
+  /// \return Distance (negative if the camera is inside the sphere)
+  double distance(const BoundingCube& bounds) const;
+
+  /// Compute size on screen of a distance within a bounding cube.
+  ///
+  /// Uses the distance from the camera to the bounding sphere of the cube.
+  /// Cubes containing the camera are considered at a minimal distance.
+  ///
+  /// \param[in] bounds Bounding cube
+  /// \param[in] size Size in model space
+  /// \return Size in pixels
+  double projectedSize(const BoundingCube& bounds, double size) const;
+};
+
+/// \struct LodSelection
+/// \brief Node selected for rendering.
+struct SPATIUMGL_EXPORT LodSelection
+{
+  LodNodeKey key;              ///< Key of node
+  const idx::OctreeNode* node; ///< Node in the hierarchy
+  BoundingCube bounds;         ///< Bounds of node
+  size_t depth;                ///< Depth of node
+  double priority;             ///< Projected point spacing (pixels)
+  double distance;             ///< Distance from camera (see LodView)
+};
+
+/// \class LodSelector
+/// \brief Selects the nodes of a level of detail octree to render.
+///
+/// Every node holds a subsample of the points with a spacing of
+/// rootSpacing / 2^depth. Nodes are visited in order of decreasing projected
+/// spacing. A node is refined (its children visited) while its projected
+/// spacing exceeds the threshold. Nodes outside the view frustum are skipped.
+class SPATIUMGL_EXPORT LodSelector
+{
+public:
+  /// Constructor.
+  ///
+  /// \param[in] hierarchy Octree hierarchy (not owned; must outlive selector)
+  /// \param[in] rootSpacing Point spacing of the root node
+  LodSelector(const idx::Octree* hierarchy, double rootSpacing);
+
+  /// Set threshold of projected spacing above which nodes are refined.
+  ///
+  /// \param[in] pixels Threshold (pixels)
+  void setSpacingThreshold(double pixels) { m_spacingThreshold = pixels; }
+
+  /// Get threshold of projected spacing above which nodes are refined.
+  ///
+  /// \return Threshold (pixels)
+  double spacingThreshold() const { return m_spacingThreshold; }
+
+  /// Set maximum number of selected nodes.
+  ///
+  /// \param[in] count Maximum number of nodes
+  void setMaxNodeCount(size_t count) { m_maxNodeCount = count; }
+
+  /// Get maximum number of selected nodes.
+  ///
+  /// \return Maximum number of nodes
+  size_t maxNodeCount() const { return m_maxNodeCount; }
+
+  /// Get point spacing of the root node.
+  ///
+  /// \return Spacing
+  double rootSpacing() const { return m_rootSpacing; }
+
+  /// Select nodes to render.
+  ///
+  /// \param[in] view View
+  /// \return Selected nodes, in order of decreasing priority (parents before
+  ///         children)
+  std::vector<LodSelection> select(const LodView& view) const;
+
+protected:
+  const idx::Octree* m_hierarchy;
+  double m_rootSpacing;
+  double m_spacingThreshold;
+  size_t m_maxNodeCount;
+};
+
+} // namespace gfx3d
+} // namespace spgl
+
+#endif // SPATIUMGL_GFX3D_POINTCLOUDLOD_H
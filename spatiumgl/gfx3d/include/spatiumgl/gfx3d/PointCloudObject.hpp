@@ -32,8 +32,10 @@ public:
   PointCloudObject(PointCloud&& pointCloud)
     : m_pointCloud(std::move(pointCloud))
   {
-    m_bounds = m_pointCloud.header().extent();
-    m_transform.translate(m_bounds.min());
+    // Model space is relative to the minimum of the extent
+    const BoundingBox extent = m_pointCloud.header().extent();
+    m_bounds = BoundingBox(extent.center() - extent.min(), extent.radii());
+    m_transform.translate(extent.min());
   }
 
   /// Get point cloud.
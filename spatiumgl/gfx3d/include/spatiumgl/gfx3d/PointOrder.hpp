@@ -0,0 +1,59 @@
+/*
+ * Program: Spatium Graphics Library
+ *
+ * Copyright (C) Martijn Koopman
+ * All Rights Reserved
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.
+ *
+ */
+
+#ifndef SPATIUMGL_GFX3D_POINTORDER_H
+#define SPATIUMGL_GFX3D_POINTORDER_H
+
+#include "spatiumgl/Vector.hpp"
+#include "spatiumglexport.hpp"
+
+#include <cstdint> // std::uint32_t
+#include <vector>  // std::vector
+
+namespace spgl {
+namespace gfx3d {
+
+/// \enum PointOrder
+/// \brief Order of the points within blocks of a point cloud.
+enum class PointOrder : unsigned char
+{
+  Original,        ///< Keep order (e.g. acquisition order)
+  Shuffled,        ///< Random order: every prefix is a random subsample
+  MortonStratified ///< Bit-reversed Z-order: every prefix is spread evenly
+};
+
+/// Compute an order of points in which every prefix of a block is a uniform
+/// subsample of the block.
+///
+/// Blocks are consecutive ranges of blockSize points. With the chunk size as
+/// block size, blocks match the chunks of PointCloudChunk::split(), so a
+/// renderer can draw a prefix of every chunk to draw fewer points.
+///
+/// MortonStratified sorts the points of a block along the Z-order curve and
+/// visits them in bit-reversed order, so the points of a prefix are spread
+/// evenly over the curve (and space), without clusters or gaps.
+///
+/// \param[in] positions Point positions
+/// \param[in] blockSize Number of points per block (0 = one block)
+/// \param[in] order Order within blocks
+/// \param[in] seed Seed of the random order
+/// \return Index of the point to put at every position (a permutation)
+SPATIUMGL_EXPORT std::vector<size_t>
+computePointOrder(const std::vector<Vector3f>& positions,
+                  size_t blockSize,
+                  PointOrder order,
+                  std::uint32_t seed = 0);
+
+} // namespace gfx3d
+} // namespace spgl
+
+#endif // SPATIUMGL_GFX3D_POINTORDER_H
@@ -0,0 +1,236 @@
+/*
+ * Program: Spatium Graphics Library
+ *
+ * Copyright (C) Martijn Koopman
+ * All Rights Reserved
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.
+ *
+ */
+
+#ifndef SPATIUMGL_GFX3D_POINTQUANTIZATION_H
+#define SPATIUMGL_GFX3D_POINTQUANTIZATION_H
+
+#include "spatiumgl/Bounds.hpp"
+#include "spatiumgl/Vector.hpp"
+#include "spatiumglexport.hpp"
+
+#include <array>       // std::array
+#include <cmath>       // std::lround
+#include <cstdint>     // std::uint8_t, std::uint16_t, std::uint32_t
+#include <limits>      // std::numeric_limits
+#include <type_traits> // std::is_unsigned
+#include <vector>      // std::vector
+
+namespace spgl {
+namespace gfx3d {
+
+/// \enum PointPositionFormat
+/// \brief Vertex format of point positions.
+enum class PointPositionFormat : unsigned char
+{
+  Float32, ///< 3 x 32 bit float (12 bytes)
+  UInt16,  ///< 4 x 16 bit normalized, relative to chunk bounds (8 bytes)
+  UInt10   ///< 10-10-10-2 bit normalized, relative to chunk bounds (4 bytes)
+};
+
+/// \enum PointScalarFormat
+/// \brief Vertex format of point scalars.
+enum class PointScalarFormat : unsigned char
+{
+  Float32, ///< 32 bit float (4 bytes)
+  UInt16,  ///< 16 bit normalized over the scalar range (2 bytes)
+  UInt8    ///< 8 bit normalized over the scalar range (1 byte)
+};
+
+/// Get size of a point position.
+///
+/// \param[in] format Format
+/// \return Size (bytes)
+inline size_t
+positionSize(PointPositionFormat format)
+{
+  return format == PointPositionFormat::UInt16
+           ? 8
+           : (format == PointPositionFormat::UInt10 ? 4 : 12);
+}
+
+/// Get size of a point scalar.
+///
+/// \param[in] format Format
+/// \return Size (bytes)
+inline size_t
+scalarSize(PointScalarFormat format)
+{
+  return format == PointScalarFormat::UInt16
+           ? 2
+           : (format == PointScalarFormat::UInt8 ? 1 : 4);
+}
+
+/// RGBA color with 8 bits per channel (4 bytes instead of 12 for float RGB).
+using Rgba8 = std::array<std::uint8_t, 4>;
+
+/// Pack an RGB color to 8 bits per channel. Alpha is set to 255.
+///
+/// \param[in] color Color (channels in range [0, 1])
+/// \return Packed color
+SPATIUMGL_EXPORT Rgba8
+packColor(const Vector3f& color);
+
+/// Unpack an RGB color with 8 bits per channel.
+///
+/// \param[in] color Packed color
+/// \return Color (channels in range [0, 1])
+SPATIUMGL_EXPORT Vector3f
+unpackColor(const Rgba8& color);
+
+/// Pack RGB colors to 8 bits per channel.
+///
+/// \param[in] colors Colors (channels in range [0, 1])
+/// \return Packed colors
+SPATIUMGL_EXPORT std::vector<Rgba8>
+packColors(const std::vector<Vector3f>& colors);
+
+/// \struct PositionQuantization
+/// \brief Maps positions within bounds to normalized unsigned integers.
+///
+/// A position is stored as offset + value * scale, with every component of
+/// value in [0, 1] (normalized integer). Positions are typically quantized
+/// relative to the bounds of a small chunk of points, so 16 bits (or even 10)
+/// per component suffice.
+struct SPATIUMGL_EXPORT PositionQuantization
+{
+  Vector3f offset; ///< Position of value 0 (minimum of bounds)
+  Vector3f scale;  ///< Size of bounds, position of value 1 minus offset
+
+  /// Create quantization of bounds.
+  ///
+  /// \param[in] bounds Bounds of positions
+  /// \return Quantization
+  static PositionQuantization fromBounds(const BoundingBox& bounds);
+
+  /// Quantize positions to 16 bits per component.
+  ///
+  /// Four components are written per position (the last one is 0), to keep
+  /// vertices 4 byte aligned (8 bytes instead of 12).
+  ///
+  /// \param[in] positions Positions
+  /// \param[in] count Number of positions
+  /// \param[out] result Quantized positions (4 * count values)
+  void quantize16(const Vector3f* positions,
+                  size_t count,
+                  std::uint16_t* result) const;
+
+  /// Quantize positions to 10 bits per component, packed in 32 bits.
+  ///
+  /// The layout matches GL_UNSIGNED_INT_2_10_10_10_REV: x in the lowest bits.
+  ///
+  /// \param[in] positions Positions
+  /// \param[in] count Number of positions
+  /// \param[out] result Quantized positions (count values)
+  void quantize1010102(const Vector3f* positions,
+                       size_t count,
+                       std::uint32_t* result) const;
+
+  /// Dequantize a position of 16 bits per component.
+  ///
+  /// \param[in] value Quantized position (3 values)
+  /// \return Position
+  Vector3f dequantize16(const std::uint16_t* value) const;
+
+  /// Dequantize a position of 10 bits per component.
+  ///
+  /// \param[in] value Quantized position
+  /// \return Position
+  Vector3f dequantize1010102(std::uint32_t value) const;
+
+  /// Quantize a single component.
+  ///
+  /// \param[in] position Position
+  /// \param[in] axis Component index
+  /// \param[in] maxValue Maximum quantized value
+  /// \return Quantized value in [0, maxValue]
+  std::uint32_t quantize(const Vector3f& position,
+                         size_t axis,
+                         std::uint32_t maxValue) const;
+};
+
+/// Quantize scalars linearly to unsigned integers (8 or 16 bits).
+///
+/// Value min maps to 0, max to the maximum of U. Values outside the range
+/// are clamped.
+///
+/// \param[in] values Scalar values
+/// \param[in] count Number of values
+/// \param[in] min Value mapped to 0
+/// \param[in] max Value mapped to the maximum of U
+/// \param[out] result Quantized values (count values)
+template<typename U>
+void
+quantizeScalars(const float* values,
+                size_t count,
+                float min,
+                float max,
+                U* result)
+{
+  static_assert(std::is_unsigned<U>::value, "U must be an unsigned integer");
+  const float maxValue = static_cast<float>(std::numeric_limits<U>::max());
+  const float factor = (max > min ? maxValue / (max - min) : 0.0f);
+  for (size_t i = 0; i < count; i++) {
+    float value = (values[i] - min) * factor;
+    value = (value < 0 ? 0 : (value > maxValue ? maxValue : value));
+    result[i] = static_cast<U>(std::lround(value));
+  }
+}
+
+/// Dequantize a scalar quantized with quantizeScalars().
+///
+/// \param[in] value Quantized value
+/// \param[in] min Value mapped to 0
+/// \param[in] max Value mapped to the maximum of U
+/// \return Scalar value
+template<typename U>
+float
+dequantizeScalar(U value, float min, float max)
+{
+  return min + (max - min) * static_cast<float>(value) /
+                 static_cast<float>(std::numeric_limits<U>::max());
+}
+
+/// Widen a scalar quantization range to include a range of values.
+///
+/// The width at least doubles, so values whose range keeps widening (e.g.
+/// GPS time while a point cloud is read) are quantized again only a
+/// logarithmic number of times. This costs at most one bit of precision.
+///
+/// \param[in] current Current quantization range (empty if min >= max)
+/// \param[in] range Range of values
+/// \return Quantization range (current if it includes range)
+inline std::array<float, 2>
+widenScalarRange(const std::array<float, 2>& current,
+                 const std::array<float, 2>& range)
+{
+  if (range[0] >= current[0] && range[1] <= current[1]) {
+    return current;
+  }
+  if (!(current[1] > current[0])) {
+    return range;
+  }
+  const float min = (range[0] < current[0] ? range[0] : current[0]);
+  const float max = (range[1] > current[1] ? range[1] : current[1]);
+  const float doubled = 2 * (current[1] - current[0]);
+  const float extra = (max - min < doubled ? doubled - (max - min) : 0.0f);
+  if (range[0] < current[0] && range[1] > current[1]) {
+    return { { min - extra / 2, max + extra / 2 } };
+  } else if (range[0] < current[0]) {
+    return { { min - extra, max } };
+  }
+  return { { min, max + extra } };
+}
+
+} // namespace gfx3d
+} // namespace spgl
+
+#endif // SPATIUMGL_GFX3D_POINTQUANTIZATION_H
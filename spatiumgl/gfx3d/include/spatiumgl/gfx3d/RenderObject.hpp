@@ -23,26 +23,48 @@ namespace gfx3d {
 /// \class RenderObject
 /// \brief Scene object that can be rendered.
 ///
-/// A RenderObject has a certain size (boundaries). It is up to the derived
-/// class to keep these updated.
+/// A RenderObject has a certain size (boundaries) in model space. It is up
+/// to the derived class to keep these updated.
 class SPATIUMGL_EXPORT RenderObject : public SceneObject
 {
 public:
   /// Constructor.
   ///
-  /// \param[in] bounds Boundaries (optional)
+  /// \param[in] bounds Boundaries in model space (optional)
   RenderObject(const BoundingBox& bounds = BoundingBox())
     : SceneObject()
     , m_bounds(bounds)
   {}
 
-  /// Get boundaries of the object (axis aligned bounding box).
+  /// Get boundaries of the object in world space.
+  ///
+  /// The axis aligned bounding box of the model space boundaries,
+  /// transformed by the current transformation.
+  ///
+  /// \return Boundaries
+  BoundingBox bounds() const
+  {
+    const Vector3 min = m_bounds.min();
+    const Vector3 max = m_bounds.max();
+    BoundingBox result(m_transform.objectPointToWorldPoint(min),
+                       Vector3(0, 0, 0));
+    for (size_t corner = 1; corner < 8; corner++) {
+      result.include(m_transform.objectPointToWorldPoint(
+        { (corner & 1) != 0 ? max[0] : min[0],
+          (corner & 2) != 0 ? max[1] : min[1],
+          (corner & 4) != 0 ? max[2] : min[2] }));
+    }
+    return result;
+  }
+
+  /// Get boundaries of the object in model space (axis aligned bounding
+  /// box).
   ///
   /// \return Boundaries
-  BoundingBox bounds() const { return m_bounds; }
+  BoundingBox modelBounds() const { return m_bounds; }
 
 protected:
-  BoundingBox m_bounds;
+  BoundingBox m_bounds; // Model space
 };
 
 } // namespace gfx3d
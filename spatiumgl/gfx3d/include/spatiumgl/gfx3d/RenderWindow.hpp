@@ -16,6 +16,7 @@
 #include "spatiumgl/Vector.hpp"
 #include "spatiumgl/gfx3d/Animator.hpp"
 #include "spatiumgl/gfx3d/Camera.hpp"
+#include "spatiumgl/gfx3d/FrameContext.hpp"
 #include "spatiumgl/gfx3d/RenderWindowInteractor.hpp"
 #include "spatiumgl/gfx3d/Renderer.hpp"
 #include "spatiumglexport.hpp"
@@ -73,6 +74,71 @@ public:
 
   Vector2i framebufferSize() const;
 
+  /// Enable or disable view frustum culling of render objects.
+  ///
+  /// Enabled by default.
+  ///
+  /// \param[in] enabled True to enable, false to disable
+  void setFrustumCulling(bool enabled);
+
+  /// Get boolean indicator if view frustum culling is enabled.
+  ///
+  /// \return True if enabled, false otherwise
+  bool frustumCulling() const;
+
+  /// Set maximum number of points drawn per frame, by all renderers.
+  ///
+  /// The budget is distributed over the chunks of all renderers in view,
+  /// weighted by their area on screen (see pointBudgetRequests() of
+  /// Renderer, and distributePointBudget()). Renderers that support it draw
+  /// a prefix of their chunks. Unlimited (0) by default.
+  ///
+  /// \param[in] points Maximum number of points (0 = unlimited)
+  void setPointBudget(size_t points);
+
+  /// Get maximum number of points drawn per frame, by all renderers.
+  ///
+  /// \return Maximum number of points (0 = unlimited)
+  size_t pointBudget() const;
+
+  /// Enable or disable rendering on demand.
+  ///
+  /// When enabled, frames are only rendered when needed (see needsRedraw()),
+  /// and the window waits for events otherwise. When disabled, frames are
+  /// rendered continuously. Enabled by default.
+  ///
+  /// \param[in] enabled True to enable, false to disable
+  void setRenderOnDemand(bool enabled);
+
+  /// Get boolean indicator if rendering on demand is enabled.
+  ///
+  /// \return True if enabled, false otherwise
+  bool renderOnDemand() const;
+
+  /// Request a new frame, after changing the scene.
+  ///
+  /// Changes of the camera and framebuffer size are detected automatically.
+  void requestRedraw();
+
+  /// Get boolean indicator if the view changed since the last frame.
+  ///
+  /// \return True if the camera or framebuffer size changed, false otherwise
+  bool viewChanged() const;
+
+  /// Get boolean indicator if a new frame needs to be rendered.
+  ///
+  /// A new frame is needed if rendering on demand is disabled, a redraw was
+  /// requested, the camera or framebuffer size changed since the last frame,
+  /// an animator is active, or a renderer needs another frame.
+  ///
+  /// \return True if a new frame is needed, false otherwise
+  bool needsRedraw() const;
+
+  /// Get the counters of the last rendered frame.
+  ///
+  /// \return Statistics
+  const RenderStatistics& renderStatistics() const;
+
   // Pure virtual functions to be implemented by subclasses.
 
   /// Initialize the library responsible for window and OpenGL
@@ -106,15 +172,38 @@ public:
   virtual void show() = 0;
 
 protected:
+  /// Mark the current state as drawn: clear the redraw request and remember
+  /// the camera and framebuffer size. Called by render(), and by subclasses
+  /// when drawing a frame without rendering (e.g. without camera).
+  void markDrawn();
+
+  /// Render all renderers.
+  ///
+  /// Renderers whose object bounds are outside the camera view frustum are
+  /// skipped. The others get the frame context, the frustum in model space
+  /// of their object to cull chunks with, and their share of the point
+  /// budget. To be called by subclasses when drawing a frame.
+  ///
+  /// \param[in] frame Frame context of the camera (see FrameContext)
+  void render(const FrameContext& frame);
+
   RenderWindowInteractor* m_interactor;
   Camera* m_camera;
   std::vector<Renderer*> m_renderers;
   std::vector<Animator*> m_animators;
 
-  BoundingBox m_bounds;
-
   Vector2i m_framebufferSize;
   bool m_debug;
+
+  bool m_frustumCulling;
+  RenderStatistics m_renderStatistics;
+  size_t m_pointBudget;
+
+  bool m_renderOnDemand;
+  bool m_redrawRequested;
+  Matrix4 m_renderedCamera;     // Camera transformation of the last frame
+  Matrix4 m_renderedProjection; // Projection of the last frame
+  Vector2i m_renderedSize;      // Framebuffer size of the last frame
 };
 
 } // namespace gfx3d
@@ -14,18 +14,39 @@
 #define SPATIUMGL_GFX3D_RENDERER_H
 
 #include "Camera.hpp"
+#include "FrameContext.hpp"
+#include "PointBudget.hpp"
 #include "RenderObject.hpp"
+#include "spatiumgl/Frustum.hpp"
 #include "spatiumglexport.hpp"
 
+#include <cmath>  // std::sqrt
+#include <vector> // std::vector
+
 namespace spgl {
 namespace gfx3d {
 
+/// \struct RenderStatistics
+/// \brief Counters of the last rendered frame.
+struct SPATIUMGL_EXPORT RenderStatistics
+{
+  size_t drawnObjects = 0;  ///< Renderers whose object was (partly) visible
+  size_t culledObjects = 0; ///< Renderers whose object was outside the view
+  size_t drawnChunks = 0;   ///< Chunks drawn by renderers (see isChunkVisible)
+  size_t culledChunks = 0;  ///< Chunks culled by renderers
+};
+
 class SPATIUMGL_EXPORT Renderer
 {
 public:
   Renderer(const RenderObject* renderObject)
     : m_renderObject(renderObject)
     , m_valid(false)
+    , m_cullingFrustum()
+    , m_statistics(nullptr)
+    , m_frame(nullptr)
+    , m_pointAllocation()
+    , m_pointBudgetActive(false)
   {}
 
   virtual ~Renderer() = default;
@@ -43,6 +64,77 @@ public:
   /// \return Render object
   const RenderObject& renderObject() const { return *m_renderObject; }
 
+  /// Get boolean indicator if the render object can be culled by its bounds.
+  ///
+  /// Renderers without render object, or with an object without bounds, are
+  /// always rendered.
+  ///
+  /// \return True if cullable, false otherwise
+  virtual bool isCullable() const
+  {
+    return m_renderObject != nullptr &&
+           m_renderObject->modelBounds().radii() != Vector3(0, 0, 0);
+  }
+
+  /// Get boolean indicator if the renderer needs another frame, for example
+  /// because its data is still being loaded or uploaded.
+  ///
+  /// Render windows that render on demand keep redrawing while any renderer
+  /// needs another frame.
+  ///
+  /// \return True if another frame is needed, false otherwise
+  virtual bool needsRedraw() const { return false; }
+
+  /// Set the view frustum used for culling chunks in the next render().
+  ///
+  /// This function should be called by the RenderWindow.
+  ///
+  /// \param[in] frustum View frustum in model space of the render object
+  /// \param[in] statistics Statistics to count chunks in (optional)
+  void setCullingFrustum(const Frustum& frustum,
+                         RenderStatistics* statistics = nullptr)
+  {
+    m_cullingFrustum = frustum;
+    m_statistics = statistics;
+  }
+
+  /// Set the frame context for the next render().
+  ///
+  /// This function should be called by the RenderWindow.
+  ///
+  /// \param[in] frame Frame context (not owned), or nullptr
+  void setFrameContext(const FrameContext* frame) { m_frame = frame; }
+
+  /// Get the chunks to draw in the next render(), competing for the point
+  /// budget of the render window (see RenderWindow::setPointBudget()).
+  ///
+  /// This function is called by the RenderWindow before render(), with the
+  /// same culling frustum and frame context. Renderers without a point
+  /// budget return no chunks, and draw all their points.
+  ///
+  /// \return Point counts and weights of chunks
+  virtual std::vector<PointBudgetRequest> pointBudgetRequests()
+  {
+    return std::vector<PointBudgetRequest>();
+  }
+
+  /// Set the number of points to draw per chunk in the next render().
+  ///
+  /// This function should be called by the RenderWindow.
+  ///
+  /// \param[in] active True if a point budget applies: chunks that were not
+  ///                   requested (e.g. uploaded since) get no points. False
+  ///                   to draw all points.
+  /// \param[in] allocation Number of points per chunk, in order of
+  ///                       pointBudgetRequests()
+  void setPointAllocation(
+    bool active,
+    std::vector<size_t> allocation = std::vector<size_t>())
+  {
+    m_pointBudgetActive = active;
+    m_pointAllocation = std::move(allocation);
+  }
+
   /// Render the render object.
   ///
   /// This function should be called by the RenderWindow.
@@ -53,8 +145,96 @@ public:
   virtual void render(Camera* camera, const Vector2i &size) = 0;
 
 protected:
+  /// Test whether a chunk of the render object is visible.
+  ///
+  /// Renderers that split their data in chunks (nodes, tiles, ...) call this
+  /// from render() to skip chunks outside the view frustum.
+  ///
+  /// \param[in] bounds Bounds of chunk (model space)
+  /// \return True if (partly) visible, false otherwise
+  bool isChunkVisible(const BoundingBox& bounds)
+  {
+    return countChunk(m_cullingFrustum.test(bounds) != Visibility::Outside);
+  }
+
+  /// Test whether a chunk of the render object is visible.
+  ///
+  /// \param[in] bounds Bounds of chunk (model space)
+  /// \return True if (partly) visible, false otherwise
+  bool isChunkVisible(const BoundingCube& bounds)
+  {
+    return countChunk(m_cullingFrustum.test(bounds) != Visibility::Outside);
+  }
+
+  /// Test whether a chunk of the render object is visible, without
+  /// counting it in the statistics.
+  ///
+  /// \param[in] bounds Bounds of chunk (model space)
+  /// \return True if (partly) visible, false otherwise
+  bool testChunk(const BoundingBox& bounds) const
+  {
+    return m_cullingFrustum.test(bounds) != Visibility::Outside;
+  }
+
+  /// Test whether a chunk of the render object is visible, without
+  /// counting it in the statistics.
+  ///
+  /// \param[in] bounds Bounds of chunk (model space)
+  /// \return True if (partly) visible, false otherwise
+  bool testChunk(const BoundingCube& bounds) const
+  {
+    return m_cullingFrustum.test(bounds) != Visibility::Outside;
+  }
+
+  /// Compute the weight of a chunk for the point budget: its area on screen.
+  ///
+  /// Requires a frame context. The model matrix is assumed not to scale.
+  ///
+  /// \param[in] bounds Bounds of chunk (model space)
+  /// \return Weight (see projectedCoverage()), 0 without frame context
+  double chunkWeight(const BoundingBox& bounds) const
+  {
+    return chunkWeight(bounds.center(), bounds.radii().magnitude());
+  }
+
+  /// Compute the weight of a chunk for the point budget: its area on screen.
+  ///
+  /// \param[in] bounds Bounds of chunk (model space)
+  /// \return Weight (see projectedCoverage()), 0 without frame context
+  double chunkWeight(const BoundingCube& bounds) const
+  {
+    return chunkWeight(bounds.center(), bounds.radius() * std::sqrt(3.0));
+  }
+
   const RenderObject* m_renderObject;
   bool m_valid;
+  Frustum m_cullingFrustum;
+  RenderStatistics* m_statistics;
+  const FrameContext* m_frame; // Set during render() by the RenderWindow
+  std::vector<size_t> m_pointAllocation; // Points per chunk (see above)
+  bool m_pointBudgetActive;              // Allocation applies
+
+private:
+  double chunkWeight(const Vector3& center, double radius) const
+  {
+    if (m_frame == nullptr) {
+      return 0;
+    }
+    Vector4 world(center, 1.0);
+    if (m_renderObject != nullptr) {
+      world = m_renderObject->transform().matrix() * world;
+    }
+    return projectedCoverage(
+      *m_frame, { world[0], world[1], world[2] }, radius);
+  }
+
+  bool countChunk(bool visible)
+  {
+    if (m_statistics != nullptr) {
+      (visible ? m_statistics->drawnChunks : m_statistics->culledChunks)++;
+    }
+    return visible;
+  }
 };
 
 } // namespace gfx3d
@@ -0,0 +1,160 @@
+/*
+ * Program: Spatium Graphics Library
+ *
+ * Copyright (C) Martijn Koopman
+ * All Rights Reserved
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.
+ *
+ */
+
+#ifndef SPATIUMGL_GFX3D_STREAMINGPOINTCLOUDOBJECT_H
+#define SPATIUMGL_GFX3D_STREAMINGPOINTCLOUDOBJECT_H
+
+#include "NodeLoadScheduler.hpp"
+#include "PointCloud.hpp"
+#include "PointCloudLod.hpp"
+#include "RenderObject.hpp"
+#include "spatiumgl/LruCache.hpp"
+#include "spatiumgl/idx/Octree.hpp"
+#include "spatiumglexport.hpp"
+
+#include <memory>        // std::shared_ptr
+#include <unordered_set> // std::unordered_set
+#include <vector>        // std::vector
+
+namespace spgl {
+namespace gfx3d {
+
+/// \struct StreamingNode
+/// \brief Loaded node of a streaming point cloud.
+struct SPATIUMGL_EXPORT StreamingNode
+{
+  LodNodeKey key;                             ///< Key of node
+  std::shared_ptr<const PointCloudData> data; ///< Points of node
+  BoundingCube bounds;                        ///< Bounds of node
+  size_t depth;                               ///< Depth of node
+};
+
+/// \class StreamingPointCloudObject
+/// \brief Point cloud render object that loads nodes of a level of detail
+///        octree on demand.
+///
+/// Only the hierarchy is kept in memory. Every update, the nodes required
+/// for the view are selected (see LodSelector). Nodes that are not loaded
+/// yet are requested from a NodeLoadScheduler, which loads them
+/// asynchronously with a user supplied loader. Loaded nodes are kept in a
+/// cache; the least recently used nodes are evicted when it exceeds its
+/// memory budget.
+///
+/// Nodes are additive: a node only holds points that are not in its
+/// ancestors. Positions are in model space (see transform()).
+class SPATIUMGL_EXPORT StreamingPointCloudObject : public RenderObject
+{
+public:
+  /// Node loader. Called on a worker thread.
+  /// Returns nullptr if the node could not be loaded.
+  using Loader = NodeLoadScheduler::Loader;
+
+  /// Constructor.
+  ///
+  /// \param[in] hierarchy Octree hierarchy (moved)
+  /// \param[in] rootSpacing Point spacing of the root node
+  /// \param[in] loader Node loader
+  /// \param[in] memoryBudget Memory budget of loaded nodes (bytes)
+  /// \param[in] maxInFlight Maximum number of nodes loaded at the same time
+  /// \param[in] origin Translation from model space to world space
+  StreamingPointCloudObject(idx::Octree&& hierarchy,
+                            double rootSpacing,
+                            Loader loader,
+                            size_t memoryBudget = 512 * 1024 * 1024,
+                            size_t maxInFlight = 2,
+                            const Vector3& origin = Vector3(0, 0, 0));
+
+  /// Copy constructor. (deleted)
+  StreamingPointCloudObject(const StreamingPointCloudObject& other) = delete;
+
+  /// Copy assignment operator. (deleted)
+  StreamingPointCloudObject& operator=(const StreamingPointCloudObject& other) =
+    delete;
+
+  /// Get octree hierarchy.
+  ///
+  /// \return Hierarchy
+  const idx::Octree& hierarchy() const { return m_hierarchy; }
+
+  /// Get node selector, to change its options.
+  ///
+  /// \return Selector
+  LodSelector& selector() { return m_selector; }
+
+  /// Get node selector.
+  ///
+  /// \return Selector
+  const LodSelector& selector() const { return m_selector; }
+
+  /// Get load scheduler, to change its options or read its metrics.
+  ///
+  /// \return Scheduler
+  NodeLoadScheduler& scheduler() { return m_scheduler; }
+
+  /// Get load scheduler.
+  ///
+  /// \return Scheduler
+  const NodeLoadScheduler& scheduler() const { return m_scheduler; }
+
+  /// Set memory budget of loaded nodes.
+  ///
+  /// \param[in] bytes Budget
+  void setMemoryBudget(size_t bytes) { m_cache.setBudget(bytes); }
+
+  /// Get memory budget of loaded nodes.
+  ///
+  /// \return Budget (bytes)
+  size_t memoryBudget() const { return m_cache.budget(); }
+
+  /// Get memory usage of loaded nodes.
+  ///
+  /// \return Memory usage (bytes)
+  size_t memoryUsage() const { return m_cache.size(); }
+
+  /// Get number of loaded nodes.
+  ///
+  /// \return Number of nodes
+  size_t loadedNodeCount() const { return m_cache.count(); }
+
+  /// Get number of nodes being loaded.
+  ///
+  /// \return Number of nodes
+  size_t loadingNodeCount() const { return m_scheduler.pendingCount(); }
+
+  /// Update for a view.
+  ///
+  /// Collects loaded nodes, selects the nodes for the view, requests those
+  /// that are not loaded (cancelling stale requests) and evicts nodes beyond
+  /// the memory budget.
+  ///
+  /// \param[in] view View (model space)
+  /// \return Loaded nodes to render
+  std::vector<StreamingNode> update(const LodView& view);
+
+  /// Wait until all requested nodes are loaded.
+  void wait();
+
+protected:
+  /// Move loaded nodes into the cache.
+  void collect();
+
+  idx::Octree m_hierarchy;
+  LodSelector m_selector;
+  LruCache<LodNodeKey, StreamingNode> m_cache;
+  std::unordered_set<LodNodeKey> m_failed;
+  NodeLoadScheduler m_scheduler;
+};
+
+} // namespace gfx3d
+} // namespace spgl
+
+#endif // SPATIUMGL_GFX3D_STREAMINGPOINTCLOUDOBJECT_H
@@ -101,6 +101,18 @@ Camera::orthogonalizeViewUp()
   m_transform.setMatrix(M);
 }
 
+Matrix4
+Camera::viewMatrix() const
+{
+  return m_transform.matrix().inverse();
+}
+
+Frustum
+Camera::frustum(double aspect) const
+{
+  return Frustum(projectionMatrix(aspect) * viewMatrix());
+}
+
 void
 Camera::setNearAndFarFromBounds(const BoundingBox& bounds)
 {
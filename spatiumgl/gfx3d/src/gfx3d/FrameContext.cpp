@@ -0,0 +1,37 @@
+/*
+ * Program: Spatium Graphics Library
+ *
+ * Copyright (C) Martijn Koopman
+ * All Rights Reserved
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.
+ *
+ */
+
+#include "spatiumgl/gfx3d/FrameContext.hpp"
+
+namespace spgl {
+namespace gfx3d {
+
+FrameContext
+FrameContext::fromCamera(const Camera& camera, const Vector2i& size)
+{
+  FrameContext frame;
+  frame.size = size;
+  frame.aspect =
+    size.y() > 0 ? static_cast<double>(size.x()) / size.y() : 1.0;
+  frame.view = camera.viewMatrix();
+  frame.projection = camera.projectionMatrix(frame.aspect);
+  frame.viewProjection = frame.projection * frame.view;
+  frame.cameraPosition = camera.transform().translation();
+  frame.distanceScreen = size.y() * frame.projection[1][1];
+  frame.perspective = (frame.projection[3][3] == 0);
+  frame.frameTime = 0;
+  frame.interacting = false;
+  return frame;
+}
+
+} // namespace gfx3d
+} // namespace spgl
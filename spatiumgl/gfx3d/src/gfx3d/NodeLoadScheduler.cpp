@@ -0,0 +1,214 @@
+/*
+ * Program: Spatium Graphics Library
+ *
+ * Copyright (C) Martijn Koopman
+ * All Rights Reserved
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.
+ *
+ */
+
+#include "spatiumgl/gfx3d/NodeLoadScheduler.hpp"
+
+#include <algorithm>     // std::sort, std::min, std::max
+#include <unordered_set> // std::unordered_set
+
+namespace spgl {
+namespace gfx3d {
+
+NodeLoadScheduler::NodeLoadScheduler(Loader loader, size_t maxInFlight)
+  : m_loader(std::move(loader))
+  , m_uploadBudget(64 << 20)
+  , m_mutex()
+  , m_queue()
+  , m_inFlight(0)
+  , m_finished()
+  , m_activeWorkers(0)
+  , m_requests()
+  , m_pending()
+  , m_ready()
+  , m_metrics()
+  , m_uploadLatencySum(0)
+  , m_workers(std::max<size_t>(maxInFlight, 1))
+{}
+
+NodeLoadScheduler::~NodeLoadScheduler()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_queue.clear();
+  }
+  m_workers.wait();
+}
+
+void
+NodeLoadScheduler::request(const std::vector<NodeLoadRequest>& requests)
+{
+  m_requests.clear();
+  for (const NodeLoadRequest& request : requests) {
+    m_requests[request.key] = request;
+  }
+
+  size_t workers = 0;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Cancel queued requests that are no longer wanted
+    std::unordered_set<LodNodeKey> queued;
+    for (const NodeLoadRequest& request : m_queue) {
+      if (m_requests.count(request.key) == 0) {
+        m_pending.erase(request.key);
+        m_metrics.cancelled++;
+      } else {
+        queued.insert(request.key);
+      }
+    }
+
+    // Queue wanted nodes, except those being loaded or loaded already
+    const Clock::time_point now = Clock::now();
+    m_queue.clear();
+    for (const NodeLoadRequest& request : requests) {
+      if (queued.count(request.key) == 0 &&
+          !m_pending.emplace(request.key, now).second) {
+        continue;
+      }
+      m_queue.push_back(request);
+    }
+    std::sort(m_queue.begin(),
+              m_queue.end(),
+              [](const NodeLoadRequest& a, const NodeLoadRequest& b) {
+                return b.before(a);
+              });
+
+    // Start workers for the new requests
+    workers = std::min(m_workers.threadCount() - m_activeWorkers,
+                       m_queue.size());
+    m_activeWorkers += workers;
+  }
+  for (size_t i = 0; i < workers; i++) {
+    m_workers.submit([this]() { work(); });
+  }
+}
+
+bool
+NodeLoadScheduler::isPending(LodNodeKey key) const
+{
+  return m_pending.count(key) != 0;
+}
+
+size_t
+NodeLoadScheduler::pendingCount() const
+{
+  return m_pending.size();
+}
+
+std::vector<NodeLoadResult>
+NodeLoadScheduler::takeFinished()
+{
+  collect();
+
+  // Most important first
+  std::vector<std::pair<NodeLoadRequest, NodeLoadResult*>> ready;
+  ready.reserve(m_ready.size());
+  for (NodeLoadResult& result : m_ready) {
+    const auto it = m_requests.find(result.key);
+    if (it == m_requests.end()) {
+      if (result.data == nullptr) {
+        m_metrics.failed++;
+      } else {
+        m_metrics.wasted++; // No longer wanted
+      }
+      m_pending.erase(result.key);
+      continue;
+    }
+    ready.push_back({ it->second, &result });
+  }
+  std::sort(ready.begin(),
+            ready.end(),
+            [](const std::pair<NodeLoadRequest, NodeLoadResult*>& a,
+               const std::pair<NodeLoadRequest, NodeLoadResult*>& b) {
+              return a.first.before(b.first);
+            });
+
+  // Hand out within budget
+  std::vector<NodeLoadResult> results;
+  std::vector<NodeLoadResult> remaining;
+  size_t bytes = 0;
+  const Clock::time_point now = Clock::now();
+  for (const auto& item : ready) {
+    NodeLoadResult& result = *item.second;
+    if (result.data == nullptr) {
+      m_metrics.failed++;
+    } else {
+      const size_t size = result.data->computeSize();
+      if (bytes > 0 && bytes + size > m_uploadBudget) {
+        remaining.push_back(std::move(result));
+        continue;
+      }
+      bytes += size;
+
+      const double latency =
+        std::chrono::duration<double>(now - m_pending[result.key]).count();
+      m_uploadLatencySum += latency;
+      m_metrics.loaded++;
+      m_metrics.uploadLatencyMean = m_uploadLatencySum / m_metrics.loaded;
+      m_metrics.uploadLatencyMax =
+        std::max(m_metrics.uploadLatencyMax, latency);
+    }
+    m_pending.erase(result.key);
+    results.push_back(std::move(result));
+  }
+  m_ready.swap(remaining);
+  m_metrics.uploadedBytes = bytes;
+  return results;
+}
+
+void
+NodeLoadScheduler::wait()
+{
+  m_workers.wait();
+  collect();
+}
+
+NodeLoadMetrics
+NodeLoadScheduler::metrics() const
+{
+  NodeLoadMetrics metrics = m_metrics;
+  std::lock_guard<std::mutex> lock(m_mutex);
+  metrics.queueDepth = m_queue.size();
+  metrics.inFlight = m_inFlight;
+  metrics.ready = m_ready.size() + m_finished.size();
+  return metrics;
+}
+
+void
+NodeLoadScheduler::work()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (!m_queue.empty()) {
+    const LodNodeKey key = m_queue.back().key;
+    m_queue.pop_back();
+    m_inFlight++;
+    lock.unlock();
+    std::shared_ptr<PointCloudData> data = m_loader(key);
+    lock.lock();
+    m_inFlight--;
+    m_finished.push_back({ key, std::move(data) });
+  }
+  m_activeWorkers--;
+}
+
+void
+NodeLoadScheduler::collect()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for (NodeLoadResult& result : m_finished) {
+    m_ready.push_back(std::move(result));
+  }
+  m_finished.clear();
+}
+
+} // namespace gfx3d
+} // namespace spgl
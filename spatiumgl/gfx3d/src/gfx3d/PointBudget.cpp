@@ -0,0 +1,86 @@
+/*
+ * Program: Spatium Graphics Library
+ *
+ * Copyright (C) Martijn Koopman
+ * All Rights Reserved
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.
+ *
+ */
+
+#include "spatiumgl/gfx3d/PointBudget.hpp"
+#include "spatiumgl/Math.hpp"
+
+#include <algorithm> // std::max, std::min, std::sort
+
+namespace spgl {
+namespace gfx3d {
+
+std::vector<size_t>
+distributePointBudget(const std::vector<PointBudgetRequest>& requests,
+                      size_t budget)
+{
+  std::vector<size_t> result(requests.size(), 0);
+
+  // Everything if all points fit
+  size_t total = 0;
+  double totalWeight = 0;
+  for (const PointBudgetRequest& request : requests) {
+    total += request.pointCount;
+    totalWeight += std::max(request.weight, 0.0);
+  }
+  if (total <= budget) {
+    for (size_t i = 0; i < requests.size(); i++) {
+      result[i] = requests[i].pointCount;
+    }
+    return result;
+  }
+
+  // Visit chunks in order of increasing points per weight: chunks that need
+  // fewer points than their share come first, and leave the rest of their
+  // share to the others
+  std::vector<size_t> order;
+  for (size_t i = 0; i < requests.size(); i++) {
+    if (requests[i].weight > 0) {
+      order.push_back(i);
+    }
+  }
+  std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return requests[a].pointCount * requests[b].weight <
+           requests[b].pointCount * requests[a].weight;
+  });
+
+  double remaining = static_cast<double>(budget);
+  for (size_t i : order) {
+    const double share = remaining * requests[i].weight / totalWeight;
+    const size_t count = std::min(requests[i].pointCount,
+                                  static_cast<size_t>(std::max(share, 0.0)));
+    result[i] = count;
+    remaining -= static_cast<double>(count);
+    totalWeight -= requests[i].weight;
+  }
+  return result;
+}
+
+double
+projectedCoverage(const FrameContext& frame,
+                  const Vector3& center,
+                  double radius)
+{
+  // Pixels per unit (see LodView)
+  double scale = frame.distanceScreen * 0.5;
+  if (frame.perspective) {
+    const double distance = frame.cameraPosition.distance(center) - radius;
+    scale /= std::max(distance, radius);
+  }
+
+  const double pixels = radius * scale;
+  const double area = PI<double>() * pixels * pixels;
+  const double screen = static_cast<double>(frame.size.x()) * frame.size.y();
+  return std::min(area, screen);
+}
+
+} // namespace gfx3d
+} // namespace spgl
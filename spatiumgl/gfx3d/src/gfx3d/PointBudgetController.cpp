@@ -0,0 +1,58 @@
+/*
+ * Program: Spatium Graphics Library
+ *
+ * Copyright (C) Martijn Koopman
+ * All Rights Reserved
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.
+ *
+ */
+
+#include "spatiumgl/gfx3d/PointBudgetController.hpp"
+
+#include <limits> // std::numeric_limits
+
+namespace spgl {
+namespace gfx3d {
+
+PointBudgetController::PointBudgetController(double targetFrameTime,
+                                             size_t minBudget)
+  : m_targetFrameTime(targetFrameTime)
+  , m_minBudget(minBudget)
+  , m_throughput(0)
+{}
+
+void
+PointBudgetController::update(double frameTime, size_t drawnPoints)
+{
+  if (frameTime <= 0 || drawnPoints == 0) {
+    return;
+  }
+
+  // Exponential moving average, to smooth out frame time jitter
+  const double throughput = static_cast<double>(drawnPoints) / frameTime;
+  m_throughput = (m_throughput > 0 ? 0.5 * (m_throughput + throughput)
+                                   : throughput);
+}
+
+size_t
+PointBudgetController::budget() const
+{
+  if (m_throughput <= 0) {
+    return std::numeric_limits<size_t>::max();
+  }
+
+  const double budget = m_throughput * m_targetFrameTime;
+  if (budget < static_cast<double>(m_minBudget)) {
+    return m_minBudget;
+  }
+  if (budget >= static_cast<double>(std::numeric_limits<size_t>::max())) {
+    return std::numeric_limits<size_t>::max();
+  }
+  return static_cast<size_t>(budget);
+}
+
+} // namespace gfx3d
+} // namespace spgl
@@ -0,0 +1,97 @@
+/*
+ * Program: Spatium Graphics Library
+ *
+ * Copyright (C) Martijn Koopman
+ * All Rights Reserved
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.
+ *
+ */
+
+#include "spatiumgl/gfx3d/PointCloudChunk.hpp"
+
+#include <algorithm> // std::min, std::max, std::partition_point
+
+namespace spgl {
+namespace gfx3d {
+
+std::vector<PointCloudChunk>
+PointCloudChunk::split(const std::vector<Vector3f>& positions,
+                       size_t chunkSize,
+                       size_t threads)
+{
+  std::vector<PointCloudChunk> chunks;
+  extend(chunks, positions, chunkSize, threads);
+  return chunks;
+}
+
+size_t
+PointCloudChunk::extend(std::vector<PointCloudChunk>& chunks,
+                        const std::vector<Vector3f>& positions,
+                        size_t chunkSize,
+                        size_t threads)
+{
+  size_t changed = chunks.size();
+  size_t first = chunks.empty() ? 0 : chunks.back().first + chunks.back().count;
+  if (chunkSize == 0 || positions.size() <= first) {
+    return changed;
+  }
+
+  // Fill up the last chunk
+  if (!chunks.empty() && chunks.back().count < chunkSize) {
+    PointCloudChunk& chunk = chunks.back();
+    const size_t count =
+      std::min(chunkSize - chunk.count, positions.size() - first);
+    const BoundingBox bounds =
+      BoundingBox::fromPoints(positions.data() + first, count, threads);
+    Vector3 min = chunk.bounds.min();
+    Vector3 max = chunk.bounds.max();
+    for (size_t i = 0; i < 3; i++) {
+      min[i] = std::min(min[i], bounds.min()[i]);
+      max[i] = std::max(max[i], bounds.max()[i]);
+    }
+    chunk.bounds = BoundingBox::fromMinMax(min, max);
+    chunk.count += count;
+    first += count;
+    changed--;
+  }
+
+  // Add new chunks
+  chunks.reserve(chunks.size() +
+                 (positions.size() - first + chunkSize - 1) / chunkSize);
+  for (; first < positions.size(); first += chunkSize) {
+    const size_t count = std::min(chunkSize, positions.size() - first);
+    chunks.push_back(
+      { first,
+        count,
+        BoundingBox::fromPoints(positions.data() + first, count, threads) });
+  }
+  return changed;
+}
+
+std::pair<size_t, size_t>
+PointCloudChunk::overlapping(const std::vector<PointCloudChunk>& chunks,
+                             size_t first,
+                             size_t count)
+{
+  // Chunks are ordered and consecutive
+  const auto begin = std::partition_point(
+    chunks.begin(), chunks.end(), [first](const PointCloudChunk& chunk) {
+      return chunk.first + chunk.count <= first;
+    });
+  if (count == 0) {
+    return { static_cast<size_t>(begin - chunks.begin()),
+             static_cast<size_t>(begin - chunks.begin()) };
+  }
+  const auto end = std::partition_point(
+    begin, chunks.end(), [first, count](const PointCloudChunk& chunk) {
+      return chunk.first < first + count;
+    });
+  return { static_cast<size_t>(begin - chunks.begin()),
+           static_cast<size_t>(end - chunks.begin()) };
+}
+
+} // namespace gfx3d
+} // namespace spgl
@@ -0,0 +1,140 @@
+/*
+ * Program: Spatium Graphics Library
+ *
+ * Copyright (C) Martijn Koopman
+ * All Rights Reserved
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.
+ *
+ */
+
+#include "spatiumgl/gfx3d/PointCloudLod.hpp"
+
+#include <algorithm> // std::max, std::reverse
+#include <cmath>     // std::sqrt
+#include <queue>     // std::priority_queue
+
+namespace spgl {
+namespace gfx3d {
+
+std::string
+lodNodeName(LodNodeKey key)
+{
+  std::string name;
+  while (key > 1) {
+    name.push_back(static_cast<char>('0' + (key & 7)));
+    key >>= 3;
+  }
+  name.push_back('r');
+  std::reverse(name.begin(), name.end());
+  return name;
+}
+
+LodView
+LodView::fromCamera(const Camera& camera,
+                    const Matrix4& modelMatrix,
+                    const Vector2i& size)
+{
+  return fromFrameContext(FrameContext::fromCamera(camera, size), modelMatrix);
+}
+
+LodView
+LodView::fromFrameContext(const FrameContext& frame, const Matrix4& modelMatrix)
+{
+  const Vector4 position =
+    modelMatrix.inverse() * Vector4(frame.cameraPosition, 1.0);
+
+  LodView view;
+  view.frustum = Frustum(frame.viewProjection * modelMatrix);
+  view.position = { position[0], position[1], position[2] };
+  view.screenScale = frame.distanceScreen * 0.5;
+  view.perspective = frame.perspective;
+  return view;
+}
+
+double
+LodView::distance(const BoundingCube& bounds) const
+{
+  return position.distance(bounds.center()) - bounds.radius() * std::sqrt(3.0);
+}
+
+double
+LodView::projectedSize(const BoundingCube& bounds, double size) const
+{
+  if (!perspective) {
+    return size * screenScale;
+  }
+
+  // At least the size itself, so nodes around the camera get a large but
+  // finite priority
+  return size / std::max(distance(bounds), size) * screenScale;
+}
+
+LodSelector::LodSelector(const idx::Octree* hierarchy, double rootSpacing)
+  : m_hierarchy(hierarchy)
+  , m_rootSpacing(rootSpacing)
+  , m_spacingThreshold(2)
+  , m_maxNodeCount(10000)
+{}
+
+/// Candidate node, ordered by priority.
+struct LodCandidate
+{
+  idx::OctreeEntry entry;
+  double priority;
+
+  bool operator<(const LodCandidate& other) const
+  {
+    return priority < other.priority;
+  }
+};
+
+std::vector<LodSelection>
+LodSelector::select(const LodView& view) const
+{
+  std::vector<LodSelection> result;
+  if (m_hierarchy == nullptr || m_hierarchy->root() == nullptr) {
+    return result;
+  }
+
+  std::priority_queue<LodCandidate> candidates;
+  const idx::OctreeEntry root = m_hierarchy->rootEntry();
+  if (view.frustum.test(root.bounds) != Visibility::Outside) {
+    candidates.push({ root, view.projectedSize(root.bounds, m_rootSpacing) });
+  }
+
+  while (!candidates.empty() && result.size() < m_maxNodeCount) {
+    const LodCandidate candidate = candidates.top();
+    candidates.pop();
+    const idx::OctreeEntry& entry = candidate.entry;
+    result.push_back({ lodNodeKey(entry.depth, entry.path),
+                       entry.node,
+                       entry.bounds,
+                       entry.depth,
+                       candidate.priority,
+                       view.distance(entry.bounds) });
+
+    if (candidate.priority <= m_spacingThreshold) {
+      continue; // Dense enough
+    }
+    const double childSpacing =
+      m_rootSpacing / static_cast<double>(1ull << (entry.depth + 1));
+    for (size_t i = 0; i < 8; i++) {
+      const idx::OctreeNode* child = entry.node->child(i);
+      if (child == nullptr) {
+        continue;
+      }
+      const idx::OctreeEntry childEntry = entry.childEntry(child, i);
+      if (view.frustum.test(childEntry.bounds) != Visibility::Outside) {
+        candidates.push(
+          { childEntry, view.projectedSize(childEntry.bounds, childSpacing) });
+      }
+    }
+  }
+  return result;
+}
+
+} // namespace gfx3d
+} // namespace spgl
@@ -0,0 +1,122 @@
+/*
+ * Program: Spatium Graphics Library
+ *
+ * Copyright (C) Martijn Koopman
+ * All Rights Reserved
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.
+ *
+ */
+
+#include "spatiumgl/gfx3d/PointOrder.hpp"
+#include "spatiumgl/Bounds.hpp"
+#include "spatiumgl/idx/Morton.hpp"
+
+#include <algorithm> // std::min, std::shuffle, std::sort
+#include <numeric>   // std::iota
+#include <random>    // std::mt19937
+#include <utility>   // std::pair
+
+namespace spgl {
+namespace gfx3d {
+
+/// Reverse the lower bits of a value.
+///
+/// \param[in] value Value
+/// \param[in] bits Number of bits
+/// \return Reversed value
+static size_t
+reverseBits(size_t value, unsigned int bits)
+{
+  size_t result = 0;
+  for (unsigned int i = 0; i < bits; i++) {
+    result = (result << 1) | ((value >> i) & 1);
+  }
+  return result;
+}
+
+/// Append the Morton stratified order of a block of points.
+///
+/// \param[in] positions Point positions
+/// \param[in] first Index of first point of block
+/// \param[in] count Number of points in block
+/// \param[in,out] result Order
+static void
+appendMortonStratified(const std::vector<Vector3f>& positions,
+                       size_t first,
+                       size_t count,
+                       std::vector<size_t>& result)
+{
+  // Sort along the Z-order curve, on a grid over the bounds of the block
+  const BoundingBox bounds =
+    BoundingBox::fromPoints(positions.data() + first, count);
+  const Vector3 min = bounds.min();
+  const double cells = static_cast<double>((1u << idx::MortonMaxDepth) - 1);
+  Vector3 scale;
+  for (size_t i = 0; i < 3; i++) {
+    const double size = bounds.max()[i] - min[i];
+    scale[i] = (size > 0 ? cells / size : 0);
+  }
+  std::vector<std::pair<std::uint64_t, size_t>> codes;
+  codes.reserve(count);
+  for (size_t i = first; i < first + count; i++) {
+    std::uint32_t cell[3];
+    for (size_t axis = 0; axis < 3; axis++) {
+      // Invalid (NaN) coordinates in the first cell: never cast NaN
+      const double value = (positions[i][axis] - min[axis]) * scale[axis];
+      cell[axis] =
+        static_cast<std::uint32_t>(value >= 0 ? std::min(value, cells) : 0);
+    }
+    codes.emplace_back(idx::mortonEncode(cell[0], cell[1], cell[2]), i);
+  }
+  std::sort(codes.begin(), codes.end());
+
+  // Visit in bit-reversed order: 0, n/2, n/4, 3n/4, ...
+  unsigned int bits = 0;
+  while ((static_cast<size_t>(1) << bits) < count) {
+    bits++;
+  }
+  for (size_t i = 0; i < (static_cast<size_t>(1) << bits); i++) {
+    const size_t index = reverseBits(i, bits);
+    if (index < count) {
+      result.push_back(codes[index].second);
+    }
+  }
+}
+
+std::vector<size_t>
+computePointOrder(const std::vector<Vector3f>& positions,
+                  size_t blockSize,
+                  PointOrder order,
+                  std::uint32_t seed)
+{
+  std::vector<size_t> result;
+  result.reserve(positions.size());
+  if (order != PointOrder::MortonStratified) {
+    result.resize(positions.size());
+    std::iota(result.begin(), result.end(), static_cast<size_t>(0));
+  }
+  if (order == PointOrder::Original) {
+    return result;
+  }
+
+  // A single block if no block size
+  const size_t size = (blockSize > 0 ? blockSize : positions.size());
+  std::mt19937 random(seed);
+  for (size_t first = 0; first < positions.size(); first += size) {
+    const size_t count = std::min(size, positions.size() - first);
+    if (order == PointOrder::Shuffled) {
+      std::shuffle(result.begin() + first,
+                   result.begin() + first + count,
+                   random);
+    } else {
+      appendMortonStratified(positions, first, count, result);
+    }
+  }
+  return result;
+}
+
+} // namespace gfx3d
+} // namespace spgl
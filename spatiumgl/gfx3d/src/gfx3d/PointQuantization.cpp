@@ -0,0 +1,119 @@
+/*
+ * Program: Spatium Graphics Library
+ *
+ * Copyright (C) Martijn Koopman
+ * All Rights Reserved
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.
+ *
+ */
+
+#include "spatiumgl/gfx3d/PointQuantization.hpp"
+
+namespace spgl {
+namespace gfx3d {
+
+Rgba8
+packColor(const Vector3f& color)
+{
+  Rgba8 result{ 0, 0, 0, 255 };
+  for (size_t i = 0; i < 3; i++) {
+    const float value = color[i] < 0 ? 0 : (color[i] > 1 ? 1 : color[i]);
+    result[i] = static_cast<std::uint8_t>(std::lround(value * 255));
+  }
+  return result;
+}
+
+Vector3f
+unpackColor(const Rgba8& color)
+{
+  return { color[0] / 255.0f, color[1] / 255.0f, color[2] / 255.0f };
+}
+
+std::vector<Rgba8>
+packColors(const std::vector<Vector3f>& colors)
+{
+  std::vector<Rgba8> result;
+  result.reserve(colors.size());
+  for (const Vector3f& color : colors) {
+    result.push_back(packColor(color));
+  }
+  return result;
+}
+
+PositionQuantization
+PositionQuantization::fromBounds(const BoundingBox& bounds)
+{
+  return { bounds.min().staticCast<float>(),
+           (bounds.max() - bounds.min()).staticCast<float>() };
+}
+
+std::uint32_t
+PositionQuantization::quantize(const Vector3f& position,
+                               size_t axis,
+                               std::uint32_t maxValue) const
+{
+  if (scale[axis] <= 0) {
+    return 0; // Flat bounds
+  }
+  const float value = (position[axis] - offset[axis]) / scale[axis] * maxValue;
+  if (value <= 0) {
+    return 0;
+  }
+  if (value >= maxValue) {
+    return maxValue;
+  }
+  return static_cast<std::uint32_t>(std::lround(value));
+}
+
+void
+PositionQuantization::quantize16(const Vector3f* positions,
+                                 size_t count,
+                                 std::uint16_t* result) const
+{
+  for (size_t i = 0; i < count; i++) {
+    for (size_t axis = 0; axis < 3; axis++) {
+      result[4 * i + axis] =
+        static_cast<std::uint16_t>(quantize(positions[i], axis, 0xFFFF));
+    }
+    result[4 * i + 3] = 0;
+  }
+}
+
+void
+PositionQuantization::quantize1010102(const Vector3f* positions,
+                                      size_t count,
+                                      std::uint32_t* result) const
+{
+  for (size_t i = 0; i < count; i++) {
+    result[i] = quantize(positions[i], 0, 0x3FF) |
+                (quantize(positions[i], 1, 0x3FF) << 10) |
+                (quantize(positions[i], 2, 0x3FF) << 20);
+  }
+}
+
+Vector3f
+PositionQuantization::dequantize16(const std::uint16_t* value) const
+{
+  Vector3f result;
+  for (size_t axis = 0; axis < 3; axis++) {
+    result[axis] = offset[axis] + scale[axis] * value[axis] / 65535.0f;
+  }
+  return result;
+}
+
+Vector3f
+PositionQuantization::dequantize1010102(std::uint32_t value) const
+{
+  Vector3f result;
+  for (size_t axis = 0; axis < 3; axis++) {
+    const std::uint32_t component = (value >> (10 * axis)) & 0x3FF;
+    result[axis] = offset[axis] + scale[axis] * component / 1023.0f;
+  }
+  return result;
+}
+
+} // namespace gfx3d
+} // namespace spgl
@@ -13,6 +13,8 @@
 #include "spatiumgl/gfx3d/RenderWindow.hpp"
 #include "spatiumgl/gfx3d/PivotInteractor.hpp"
 
+#include <utility> // std::pair
+
 namespace spgl {
 namespace gfx3d {
 RenderWindow::RenderWindow(bool debug)
@@ -22,6 +24,14 @@ RenderWindow::RenderWindow(bool debug)
   , m_animators()
   , m_framebufferSize{ 0, 0 }
   , m_debug(debug)
+  , m_frustumCulling(true)
+  , m_renderStatistics()
+  , m_pointBudget(0)
+  , m_renderOnDemand(true)
+  , m_redrawRequested(true)
+  , m_renderedCamera()
+  , m_renderedProjection()
+  , m_renderedSize{ 0, 0 }
 {}
 
 void
@@ -52,18 +62,22 @@ void
 RenderWindow::addRenderer(Renderer* renderer)
 {
   m_renderers.push_back(renderer);
-
-  if (m_renderers.size() == 1) {
-    m_bounds = renderer->renderObject().bounds();
-  } else {
-    m_bounds.include(renderer->renderObject().bounds());
-  }
+  m_redrawRequested = true;
 }
 
 BoundingBox
 RenderWindow::bounds() const
 {
-  return m_bounds;
+  // Objects may have been transformed since they were added
+  BoundingBox bounds;
+  for (size_t i = 0; i < m_renderers.size(); i++) {
+    if (i == 0) {
+      bounds = m_renderers[i]->renderObject().bounds();
+    } else {
+      bounds.include(m_renderers[i]->renderObject().bounds());
+    }
+  }
+  return bounds;
 }
 
 void
@@ -77,5 +91,170 @@ RenderWindow::framebufferSize() const
 {
   return m_framebufferSize;
 }
+
+void
+RenderWindow::setFrustumCulling(bool enabled)
+{
+  m_frustumCulling = enabled;
+}
+
+bool
+RenderWindow::frustumCulling() const
+{
+  return m_frustumCulling;
+}
+
+void
+RenderWindow::setPointBudget(size_t points)
+{
+  m_pointBudget = points;
+  m_redrawRequested = true;
+}
+
+size_t
+RenderWindow::pointBudget() const
+{
+  return m_pointBudget;
+}
+
+void
+RenderWindow::setRenderOnDemand(bool enabled)
+{
+  m_renderOnDemand = enabled;
+}
+
+bool
+RenderWindow::renderOnDemand() const
+{
+  return m_renderOnDemand;
+}
+
+void
+RenderWindow::requestRedraw()
+{
+  m_redrawRequested = true;
+}
+
+bool
+RenderWindow::viewChanged() const
+{
+  if (m_framebufferSize != m_renderedSize) {
+    return true;
+  }
+  if (m_camera != nullptr) {
+    const double aspect =
+      m_framebufferSize.y() > 0
+        ? static_cast<double>(m_framebufferSize.x()) / m_framebufferSize.y()
+        : 1.0;
+    if (m_camera->transform().matrix() != m_renderedCamera ||
+        m_camera->projectionMatrix(aspect) != m_renderedProjection) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool
+RenderWindow::needsRedraw() const
+{
+  if (!m_renderOnDemand || m_redrawRequested || viewChanged()) {
+    return true;
+  }
+
+  for (const Animator* animator : m_animators) {
+    if (animator->isActive()) {
+      return true;
+    }
+  }
+  for (const Renderer* renderer : m_renderers) {
+    if (renderer->needsRedraw()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+const RenderStatistics&
+RenderWindow::renderStatistics() const
+{
+  return m_renderStatistics;
+}
+
+void
+RenderWindow::markDrawn()
+{
+  m_redrawRequested = false;
+  m_renderedSize = m_framebufferSize;
+  if (m_camera != nullptr) {
+    m_renderedCamera = m_camera->transform().matrix();
+  }
+}
+
+void
+RenderWindow::render(const FrameContext& frame)
+{
+  m_renderStatistics = RenderStatistics();
+  const Frustum frustum(frame.viewProjection);
+
+  // Remember what was rendered, to detect changes
+  markDrawn();
+  m_renderedSize = frame.size;
+  m_renderedProjection = frame.projection;
+
+  // Find renderers in view, with their frustum in model space
+  std::vector<std::pair<Renderer*, Frustum>> visible;
+  for (Renderer* renderer : m_renderers) {
+    if (m_frustumCulling && renderer->isCullable()) {
+      // Bounds of render objects are in model space, so they are tested
+      // with the current transformation of the object
+      const Matrix4& modelMatrix =
+        renderer->renderObject().transform().matrix();
+      const Frustum modelFrustum(frame.viewProjection * modelMatrix);
+      if (modelFrustum.test(renderer->renderObject().modelBounds()) ==
+          Visibility::Outside) {
+        m_renderStatistics.culledObjects++;
+        continue;
+      }
+      visible.emplace_back(renderer, modelFrustum);
+    } else {
+      visible.emplace_back(renderer, Frustum());
+    }
+  }
+
+  // Distribute the point budget over the chunks of all renderers
+  std::vector<std::vector<size_t>> allocations(visible.size());
+  if (m_pointBudget > 0) {
+    std::vector<PointBudgetRequest> requests;
+    std::vector<size_t> offsets;
+    for (const std::pair<Renderer*, Frustum>& entry : visible) {
+      entry.first->setCullingFrustum(entry.second);
+      entry.first->setFrameContext(&frame);
+      const std::vector<PointBudgetRequest> chunks =
+        entry.first->pointBudgetRequests();
+      entry.first->setFrameContext(nullptr);
+      offsets.push_back(requests.size());
+      requests.insert(requests.end(), chunks.begin(), chunks.end());
+    }
+    offsets.push_back(requests.size());
+
+    const std::vector<size_t> allocation =
+      distributePointBudget(requests, m_pointBudget);
+    for (size_t i = 0; i < visible.size(); i++) {
+      allocations[i].assign(allocation.begin() + offsets[i],
+                            allocation.begin() + offsets[i + 1]);
+    }
+  }
+
+  for (size_t i = 0; i < visible.size(); i++) {
+    Renderer* renderer = visible[i].first;
+    renderer->setCullingFrustum(visible[i].second, &m_renderStatistics);
+    renderer->setPointAllocation(m_pointBudget > 0, std::move(allocations[i]));
+
+    m_renderStatistics.drawnObjects++;
+    renderer->setFrameContext(&frame);
+    renderer->render(m_camera, m_framebufferSize);
+    renderer->setFrameContext(nullptr);
+  }
+}
 } // namespace gfx3d
 } // namespace spgl
@@ -0,0 +1,97 @@
+/*
+ * Program: Spatium Graphics Library
+ *
+ * Copyright (C) Martijn Koopman
+ * All Rights Reserved
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.
+ *
+ */
+
+#include "spatiumgl/gfx3d/StreamingPointCloudObject.hpp"
+
+namespace spgl {
+namespace gfx3d {
+
+StreamingPointCloudObject::StreamingPointCloudObject(idx::Octree&& hierarchy,
+                                                     double rootSpacing,
+                                                     Loader loader,
+                                                     size_t memoryBudget,
+                                                     size_t maxInFlight,
+                                                     const Vector3& origin)
+  : RenderObject()
+  , m_hierarchy(std::move(hierarchy))
+  , m_selector(&m_hierarchy, rootSpacing)
+  , m_cache(memoryBudget)
+  , m_failed()
+  , m_scheduler(std::move(loader), maxInFlight)
+{
+  const BoundingCube& cube = m_hierarchy.bounds();
+  m_bounds =
+    BoundingBox(cube.center(), { cube.radius(), cube.radius(), cube.radius() });
+  m_transform.translate(origin);
+}
+
+std::vector<StreamingNode>
+StreamingPointCloudObject::update(const LodView& view)
+{
+  collect();
+
+  const std::vector<LodSelection> selection = m_selector.select(view);
+  std::vector<StreamingNode> result;
+  std::vector<NodeLoadRequest> requests;
+  result.reserve(selection.size());
+  m_cache.nextFrame();
+  for (const LodSelection& node : selection) {
+    const StreamingNode* loaded = m_cache.get(node.key);
+    if (loaded != nullptr) {
+      result.push_back(*loaded);
+    } else if (m_failed.count(node.key) == 0) {
+      requests.push_back({ node.key, node.priority, node.distance });
+    }
+  }
+  m_scheduler.request(requests);
+
+  m_cache.trim();
+  return result;
+}
+
+void
+StreamingPointCloudObject::wait()
+{
+  m_scheduler.wait();
+  collect();
+}
+
+void
+StreamingPointCloudObject::collect()
+{
+  for (NodeLoadResult& load : m_scheduler.takeFinished()) {
+    if (load.data == nullptr) {
+      m_failed.insert(load.key);
+      continue;
+    }
+
+    // Derive bounds and depth from the key
+    LodNodeKey key = load.key;
+    size_t depth = 0;
+    while (key > 1) {
+      key >>= 3;
+      depth++;
+    }
+    BoundingCube bounds = m_hierarchy.bounds();
+    for (size_t level = depth; level > 0; level--) {
+      const size_t childIndex = (load.key >> (3 * (level - 1))) & 7;
+      bounds = idx::Octree::computeChildBounds(bounds, childIndex);
+    }
+
+    const size_t size = load.data->computeSize();
+    m_cache.insert(
+      load.key, { load.key, std::move(load.data), bounds, depth }, size);
+  }
+}
+
+} // namespace gfx3d
+} // namespace spgl
@@ -51,4 +51,21 @@ TEST(Camera, orthographicProjection)
   const spgl::gfx3d::OrthographicCamera camera(size, near, far);
 
   const spgl::Matrix4 matrix = camera.projectionMatrix(aspect);
-}
\ No newline at end of file
+}
+
+TEST(Camera, frustum)
+{
+  spgl::gfx3d::OrthographicCamera camera(10, 1, 100);
+  camera.lookAt({ 0, 0, 0 }, { 0, 1, 0 }, { 0, 0, 50 });
+
+  const spgl::Frustum frustum = camera.frustum(2.0);
+  EXPECT_TRUE(frustum.contains({ 0, 0, 0 }));
+  EXPECT_TRUE(frustum.contains({ 9, 4, 0 }));
+  EXPECT_FALSE(frustum.contains({ 11, 0, 0 }));
+  EXPECT_FALSE(frustum.contains({ 0, 6, 0 }));
+  EXPECT_FALSE(frustum.contains({ 0, 0, 60 }));
+  EXPECT_EQ(frustum.test(spgl::BoundingCube({ 0, 0, -20 }, 1)),
+            spgl::Visibility::Inside);
+  EXPECT_EQ(frustum.test(spgl::BoundingCube({ 0, 0, -60 }, 1)),
+            spgl::Visibility::Outside);
+}
@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+
+#include <spatiumgl/gfx3d/NodeLoadScheduler.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+TEST(NodeLoadScheduler, priorityCancel)
+{
+  // The first load blocks until released; the others load immediately
+  std::atomic<bool> release(false);
+  std::mutex mutex;
+  std::vector<spgl::gfx3d::LodNodeKey> order;
+  auto loader = [&](spgl::gfx3d::LodNodeKey key) {
+    while (!release) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      order.push_back(key);
+    }
+    std::vector<spgl::Vector3f> positions(10);
+    return std::make_shared<spgl::gfx3d::PointCloudData>(std::move(positions));
+  };
+  spgl::gfx3d::NodeLoadScheduler scheduler(loader, 1);
+  EXPECT_EQ(scheduler.maxInFlight(), 1u);
+
+  scheduler.request({ { 1, 1, 0 }, { 2, 3, 0 }, { 3, 2, 5 }, { 4, 2, 1 } });
+  while (scheduler.metrics().inFlight == 0) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(scheduler.metrics().queueDepth, 3u);
+  EXPECT_TRUE(scheduler.isPending(2));
+
+  // Camera moved: node 1 is cancelled, node 2 (loading) is no longer wanted
+  scheduler.request({ { 3, 2, 5 }, { 4, 2, 1 }, { 5, 10, 0 } });
+  EXPECT_EQ(scheduler.metrics().cancelled, 1u);
+  EXPECT_FALSE(scheduler.isPending(1));
+  EXPECT_EQ(scheduler.pendingCount(), 4u);
+
+  release = true;
+  scheduler.wait();
+  ASSERT_EQ(order.size(), 4u);
+  EXPECT_EQ(order[0], 2u);
+  EXPECT_EQ(order[1], 5u); // Highest priority
+  EXPECT_EQ(order[2], 4u); // Equal priority, nearest first
+  EXPECT_EQ(order[3], 3u);
+
+  // Hand out within upload budget: one node per frame
+  scheduler.setUploadBudget(1);
+  std::vector<spgl::gfx3d::NodeLoadResult> results = scheduler.takeFinished();
+  ASSERT_EQ(results.size(), 1u);
+  EXPECT_EQ(results[0].key, 5u);
+  spgl::gfx3d::NodeLoadMetrics metrics = scheduler.metrics();
+  EXPECT_EQ(metrics.wasted, 1u);
+  EXPECT_EQ(metrics.ready, 2u);
+  EXPECT_EQ(metrics.loaded, 1u);
+  EXPECT_EQ(metrics.uploadedBytes, results[0].data->computeSize());
+  EXPECT_GT(metrics.uploadLatencyMean, 0.0);
+  EXPECT_GE(metrics.uploadLatencyMax, metrics.uploadLatencyMean);
+
+  scheduler.setUploadBudget(1 << 20);
+  results = scheduler.takeFinished();
+  ASSERT_EQ(results.size(), 2u);
+  EXPECT_EQ(results[0].key, 4u);
+  EXPECT_EQ(results[1].key, 3u);
+  EXPECT_EQ(scheduler.pendingCount(), 0u);
+  EXPECT_EQ(scheduler.metrics().loaded, 3u);
+
+  // Loaded nodes are requested again only after they were handed out
+  scheduler.request({ { 3, 2, 5 } });
+  EXPECT_TRUE(scheduler.isPending(3));
+  scheduler.wait();
+  EXPECT_EQ(scheduler.takeFinished().size(), 1u);
+}
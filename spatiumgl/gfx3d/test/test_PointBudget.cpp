@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+
+#include <spatiumgl/gfx3d/PerspectiveCamera.hpp>
+#include <spatiumgl/gfx3d/PointBudget.hpp>
+
+TEST(PointBudget, distribute)
+{
+  // Everything fits
+  std::vector<size_t> result = spgl::gfx3d::distributePointBudget(
+    { { 100, 1 }, { 200, 0 } }, 1000);
+  ASSERT_EQ(result.size(), 2u);
+  EXPECT_EQ(result[0], 100u);
+  EXPECT_EQ(result[1], 200u);
+
+  // Proportional to weight
+  result = spgl::gfx3d::distributePointBudget(
+    { { 1000, 1 }, { 1000, 3 }, { 1000, 0 } }, 400);
+  EXPECT_EQ(result[0], 100u);
+  EXPECT_EQ(result[1], 300u);
+  EXPECT_EQ(result[2], 0u);
+
+  // Budget left over by small chunks goes to the others
+  result = spgl::gfx3d::distributePointBudget(
+    { { 1000, 1 }, { 50, 2 }, { 1000, 1 } }, 450);
+  EXPECT_EQ(result[0], 200u);
+  EXPECT_EQ(result[1], 50u);
+  EXPECT_EQ(result[2], 200u);
+
+  // No chunks
+  EXPECT_TRUE(spgl::gfx3d::distributePointBudget({}, 100).empty());
+}
+
+TEST(PointBudget, projectedCoverage)
+{
+  spgl::gfx3d::PerspectiveCamera camera(0.7853981634, 1, 1000);
+  camera.lookAt({ 0, 0, 0 }, { 0, 1, 0 }, { 0, 0, 50 });
+  const spgl::gfx3d::FrameContext frame =
+    spgl::gfx3d::FrameContext::fromCamera(camera, { 800, 600 });
+
+  // Distant chunks cover less area
+  const double near =
+    spgl::gfx3d::projectedCoverage(frame, { 0, 0, 0 }, 1);
+  const double far =
+    spgl::gfx3d::projectedCoverage(frame, { 0, 0, -50 }, 1);
+  EXPECT_GT(near, 0);
+  EXPECT_NEAR(far / near, 49.0 * 49.0 / (99.0 * 99.0), 1e-9);
+
+  // At most the render image
+  EXPECT_DOUBLE_EQ(
+    spgl::gfx3d::projectedCoverage(frame, { 0, 0, 45 }, 10), 800.0 * 600);
+}
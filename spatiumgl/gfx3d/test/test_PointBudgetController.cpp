@@ -0,0 +1,33 @@
+#include <gtest/gtest.h>
+
+#include <spatiumgl/gfx3d/PointBudgetController.hpp>
+
+#include <limits> // std::numeric_limits
+
+TEST(PointBudgetController, budget)
+{
+  spgl::gfx3d::PointBudgetController controller(0.02, 1000);
+
+  // Unlimited until a frame was measured
+  EXPECT_EQ(controller.budget(), std::numeric_limits<size_t>::max());
+
+  // Invalid frames are ignored
+  controller.update(0, 1000000);
+  controller.update(0.01, 0);
+  EXPECT_EQ(controller.budget(), std::numeric_limits<size_t>::max());
+
+  // 1M points in 10 ms: 2M points in the target frame time
+  controller.update(0.01, 1000000);
+  EXPECT_EQ(controller.budget(), 2000000u);
+
+  // Smoothed: 100M and 50M points/s average to 75M points/s
+  controller.update(0.02, 1000000);
+  EXPECT_EQ(controller.budget(), 1500000u);
+
+  controller.reset();
+  EXPECT_EQ(controller.budget(), std::numeric_limits<size_t>::max());
+
+  // At least the minimum
+  controller.update(10, 1);
+  EXPECT_EQ(controller.budget(), 1000u);
+}
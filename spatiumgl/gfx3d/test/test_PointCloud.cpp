@@ -114,3 +114,58 @@ TEST(PointCloud, moveAssignment)
   EXPECT_EQ(pointCloud.data().positions().size(), 0);
   EXPECT_EQ(pointCloudMoved.data().positions().size(), 3);
 }
+
+TEST(PointCloud, append)
+{
+  std::vector<spgl::Vector3f> positions = { { 1, 2, 3 } };
+  std::vector<spgl::Vector3f> colors = { { 1, 0, 0 } };
+  spgl::gfx3d::Scalars<float> scalars(1, "intensity");
+  scalars.addValue(5);
+  spgl::gfx3d::PointCloudData data(
+    std::move(positions), std::move(colors), std::move(scalars));
+
+  std::vector<spgl::Vector3f> morePositions = { { 4, 5, 6 }, { 7, 8, 9 } };
+  std::vector<spgl::Vector3f> moreColors = { { 0, 1, 0 }, { 0, 0, 1 } };
+  spgl::gfx3d::Scalars<float> moreScalars(2, "intensity");
+  moreScalars.addValue(-1);
+  moreScalars.addValue(3);
+  spgl::gfx3d::PointCloudData more(
+    std::move(morePositions), std::move(moreColors), std::move(moreScalars));
+
+  data.append(std::move(more));
+  EXPECT_EQ(more.positions().size(), 0u);
+  ASSERT_EQ(data.positions().size(), 3u);
+  EXPECT_EQ(data.positions()[2], spgl::Vector3f(7, 8, 9));
+  EXPECT_EQ(data.colors()[1], spgl::Vector3f(0, 1, 0));
+  EXPECT_TRUE(data.hasColors());
+  ASSERT_EQ(data.scalars().values().size(), 3u);
+  EXPECT_EQ(data.scalars().range()[0], -1);
+  EXPECT_EQ(data.scalars().range()[1], 5);
+}
+
+TEST(PointCloud, reorder)
+{
+  std::vector<spgl::Vector3f> positions = { { 1, 0, 0 },
+                                            { 2, 0, 0 },
+                                            { 3, 0, 0 } };
+  std::vector<spgl::Vector3f> colors = { { 1, 0, 0 },
+                                         { 0, 1, 0 },
+                                         { 0, 0, 1 } };
+  spgl::gfx3d::Scalars<float> scalars(3, "intensity");
+  scalars.addValue(10);
+  scalars.addValue(20);
+  scalars.addValue(30);
+  spgl::gfx3d::PointCloudData data(
+    std::move(positions), std::move(colors), std::move(scalars));
+
+  data.reorder({ 2, 0, 1 });
+  EXPECT_EQ(data.positions()[0], spgl::Vector3f(3, 0, 0));
+  EXPECT_EQ(data.positions()[1], spgl::Vector3f(1, 0, 0));
+  EXPECT_EQ(data.colors()[2], spgl::Vector3f(0, 1, 0));
+  EXPECT_EQ(data.scalars().values()[0], 30);
+  EXPECT_EQ(data.scalars().name(), "intensity");
+
+  // Order of a different size is ignored
+  data.reorder({ 0 });
+  EXPECT_EQ(data.positions()[0], spgl::Vector3f(3, 0, 0));
+}
@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+
+#include <spatiumgl/gfx3d/PointCloudChunk.hpp>
+
+TEST(PointCloudChunk, split)
+{
+  std::vector<spgl::Vector3f> positions;
+  for (size_t i = 0; i < 10; i++) {
+    positions.emplace_back(static_cast<float>(i), 0.0f, -1.0f * i);
+  }
+
+  const std::vector<spgl::gfx3d::PointCloudChunk> chunks =
+    spgl::gfx3d::PointCloudChunk::split(positions, 4);
+  ASSERT_EQ(chunks.size(), 3u);
+  EXPECT_EQ(chunks[0].first, 0u);
+  EXPECT_EQ(chunks[0].count, 4u);
+  EXPECT_EQ(chunks[2].first, 8u);
+  EXPECT_EQ(chunks[2].count, 2u);
+  EXPECT_EQ(chunks[1].bounds.min(), spgl::Vector3(4, 0, -7));
+  EXPECT_EQ(chunks[1].bounds.max(), spgl::Vector3(7, 0, -4));
+
+  // Single chunk, no chunks
+  EXPECT_EQ(spgl::gfx3d::PointCloudChunk::split(positions, 10).size(), 1u);
+  EXPECT_TRUE(spgl::gfx3d::PointCloudChunk::split({}, 4).empty());
+}
+
+TEST(PointCloudChunk, extend)
+{
+  std::vector<spgl::Vector3f> positions;
+  for (size_t i = 0; i < 6; i++) {
+    positions.emplace_back(static_cast<float>(i), 0.0f, 0.0f);
+  }
+  std::vector<spgl::gfx3d::PointCloudChunk> chunks =
+    spgl::gfx3d::PointCloudChunk::split(positions, 4);
+  ASSERT_EQ(chunks.size(), 2u);
+
+  // Nothing appended
+  EXPECT_EQ(spgl::gfx3d::PointCloudChunk::extend(chunks, positions, 4), 2u);
+
+  // Last chunk is filled up first
+  for (size_t i = 6; i < 11; i++) {
+    positions.emplace_back(static_cast<float>(i), 0.0f, 0.0f);
+  }
+  EXPECT_EQ(spgl::gfx3d::PointCloudChunk::extend(chunks, positions, 4), 1u);
+  ASSERT_EQ(chunks.size(), 3u);
+  EXPECT_EQ(chunks[1].count, 4u);
+  EXPECT_EQ(chunks[1].bounds.min(), spgl::Vector3(4, 0, 0));
+  EXPECT_EQ(chunks[1].bounds.max(), spgl::Vector3(7, 0, 0));
+  EXPECT_EQ(chunks[2].first, 8u);
+  EXPECT_EQ(chunks[2].count, 3u);
+
+  // Last chunk is filled, the remainder goes in a new chunk
+  positions.emplace_back(11.0f, 0.0f, 0.0f);
+  positions.emplace_back(12.0f, 0.0f, 0.0f);
+  EXPECT_EQ(spgl::gfx3d::PointCloudChunk::extend(chunks, positions, 4), 2u);
+  ASSERT_EQ(chunks.size(), 4u);
+  EXPECT_EQ(chunks[3].first, 12u);
+  EXPECT_EQ(chunks[3].count, 1u);
+}
+
+TEST(PointCloudChunk, overlapping)
+{
+  std::vector<spgl::Vector3f> positions(10);
+  const std::vector<spgl::gfx3d::PointCloudChunk> chunks =
+    spgl::gfx3d::PointCloudChunk::split(positions, 4);
+
+  using Range = std::pair<size_t, size_t>;
+  EXPECT_EQ(spgl::gfx3d::PointCloudChunk::overlapping(chunks, 0, 10),
+            Range(0, 3));
+  EXPECT_EQ(spgl::gfx3d::PointCloudChunk::overlapping(chunks, 3, 2),
+            Range(0, 2));
+  EXPECT_EQ(spgl::gfx3d::PointCloudChunk::overlapping(chunks, 4, 4),
+            Range(1, 2));
+  EXPECT_EQ(spgl::gfx3d::PointCloudChunk::overlapping(chunks, 9, 100),
+            Range(2, 3));
+  EXPECT_EQ(spgl::gfx3d::PointCloudChunk::overlapping(chunks, 5, 0),
+            Range(1, 1));
+}
@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+
+#include <spatiumgl/gfx3d/PerspectiveCamera.hpp>
+#include <spatiumgl/gfx3d/PointCloudLod.hpp>
+#include <spatiumgl/gfx3d/StreamingPointCloudObject.hpp>
+
+#include <atomic>
+#include <unordered_set>
+
+namespace {
+
+/// Complete octree of 3 levels below the root (585 nodes), radius 8.
+spgl::idx::Octree
+testHierarchy()
+{
+  spgl::idx::Octree octree(spgl::BoundingCube({ 0, 0, 0 }, 8));
+  std::vector<spgl::idx::OctreeNode*> nodes{ octree.root() };
+  for (size_t depth = 0; depth < 3; depth++) {
+    std::vector<spgl::idx::OctreeNode*> children;
+    for (spgl::idx::OctreeNode* node : nodes) {
+      for (size_t i = 0; i < 8; i++) {
+        node->createChild(i);
+        children.push_back(node->child(i));
+      }
+    }
+    nodes.swap(children);
+  }
+  return octree;
+}
+
+/// View from a camera on the positive Z axis, looking at the origin.
+spgl::gfx3d::LodView
+testView(double distance, double lookZ = 0)
+{
+  spgl::gfx3d::PerspectiveCamera camera(0.7853981634, 1, 1000);
+  camera.lookAt({ 0, 0, lookZ }, { 0, 1, 0 }, { 0, 0, distance });
+  return spgl::gfx3d::LodView::fromCamera(
+    camera, spgl::gfx3d::Transform().matrix(), spgl::Vector2i(800, 600));
+}
+
+} // namespace
+
+TEST(PointCloudLod, nodeKey)
+{
+  EXPECT_EQ(spgl::gfx3d::lodNodeKey(0, 0), 1u);
+  EXPECT_EQ(spgl::gfx3d::lodNodeName(1), "r");
+  EXPECT_EQ(spgl::gfx3d::lodNodeName(spgl::gfx3d::lodNodeKey(1, 5)), "r5");
+  EXPECT_EQ(spgl::gfx3d::lodNodeName(spgl::gfx3d::lodNodeKey(2, 7)), "r07");
+  EXPECT_EQ(spgl::gfx3d::lodNodeName(spgl::gfx3d::lodNodeKey(3, 0123)),
+            "r123");
+}
+
+TEST(PointCloudLod, select)
+{
+  const spgl::idx::Octree octree = testHierarchy();
+  spgl::gfx3d::LodSelector selector(&octree, 4);
+  selector.setSpacingThreshold(8);
+
+  // Parents before children, priorities decreasing
+  const std::vector<spgl::gfx3d::LodSelection> near =
+    selector.select(testView(30));
+  ASSERT_FALSE(near.empty());
+  EXPECT_EQ(near[0].key, 1u);
+  std::unordered_set<spgl::gfx3d::LodNodeKey> keys;
+  for (size_t i = 0; i < near.size(); i++) {
+    if (i > 0) {
+      EXPECT_EQ(keys.count(near[i].key >> 3), 1u);
+      EXPECT_LE(near[i].priority, near[i - 1].priority);
+    }
+    keys.insert(near[i].key);
+  }
+
+  // Farther away: fewer nodes
+  const std::vector<spgl::gfx3d::LodSelection> far =
+    selector.select(testView(300));
+  EXPECT_LT(far.size(), near.size());
+
+  // Threshold
+  selector.setSpacingThreshold(1e9);
+  EXPECT_EQ(selector.select(testView(30)).size(), 1u);
+  selector.setSpacingThreshold(0);
+  EXPECT_EQ(selector.select(testView(30)).size(), octree.nodeCount());
+  selector.setMaxNodeCount(10);
+  EXPECT_EQ(selector.select(testView(30)).size(), 10u);
+
+  // Looking away: nothing visible
+  EXPECT_TRUE(selector.select(testView(30, 60)).empty());
+}
+
+TEST(PointCloudLod, streaming)
+{
+  std::atomic<int> loadCount(0);
+  auto loader = [&loadCount](spgl::gfx3d::LodNodeKey key) {
+    loadCount++;
+    if (key == 8) {
+      return std::shared_ptr<spgl::gfx3d::PointCloudData>(); // Failure
+    }
+    std::vector<spgl::Vector3f> positions(100);
+    return std::make_shared<spgl::gfx3d::PointCloudData>(std::move(positions));
+  };
+  spgl::gfx3d::StreamingPointCloudObject object(
+    testHierarchy(), 4, loader, 1024 * 1024, 2);
+  object.selector().setSpacingThreshold(0);
+
+  // First update only requests nodes
+  EXPECT_TRUE(object.update(testView(30)).empty());
+  EXPECT_EQ(object.loadingNodeCount(), 585u);
+  object.wait();
+  EXPECT_EQ(object.loadingNodeCount(), 0u);
+  EXPECT_EQ(object.loadedNodeCount(), 584u);
+  EXPECT_EQ(loadCount.load(), 585);
+
+  // Loaded nodes are rendered; failed nodes are not requested again
+  const std::vector<spgl::gfx3d::StreamingNode> nodes =
+    object.update(testView(30));
+  EXPECT_EQ(nodes.size(), 584u);
+  EXPECT_EQ(object.loadingNodeCount(), 0u);
+  for (const spgl::gfx3d::StreamingNode& node : nodes) {
+    EXPECT_EQ(node.data->positions().size(), 100u);
+    EXPECT_EQ(node.bounds.radius(), 8.0 / (1u << node.depth));
+  }
+
+  // Evict nodes beyond the budget, except those in view
+  object.setMemoryBudget(0);
+  EXPECT_EQ(object.update(testView(30)).size(), 584u);
+  EXPECT_EQ(object.loadedNodeCount(), 584u);
+  EXPECT_TRUE(object.update(testView(30, 60)).empty());
+  EXPECT_EQ(object.loadedNodeCount(), 0u);
+  EXPECT_EQ(object.memoryUsage(), 0u);
+}
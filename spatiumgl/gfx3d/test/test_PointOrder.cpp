@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+
+#include <spatiumgl/gfx3d/PointOrder.hpp>
+
+#include <algorithm> // std::sort
+#include <limits>    // std::numeric_limits
+
+namespace {
+
+/// Grid of n x n points in the XY plane.
+std::vector<spgl::Vector3f>
+grid(size_t n)
+{
+  std::vector<spgl::Vector3f> positions;
+  for (size_t y = 0; y < n; y++) {
+    for (size_t x = 0; x < n; x++) {
+      positions.push_back(
+        { static_cast<float>(x), static_cast<float>(y), 0.0f });
+    }
+  }
+  return positions;
+}
+
+/// Check that the indices of a range of the order are a permutation of
+/// the same range.
+void
+expectPermutation(std::vector<size_t> order, size_t first, size_t count)
+{
+  std::sort(order.begin() + first, order.begin() + first + count);
+  for (size_t i = first; i < first + count; i++) {
+    EXPECT_EQ(order[i], i);
+  }
+}
+
+} // namespace
+
+TEST(PointOrder, original)
+{
+  const std::vector<size_t> order = spgl::gfx3d::computePointOrder(
+    grid(4), 5, spgl::gfx3d::PointOrder::Original);
+  ASSERT_EQ(order.size(), 16u);
+  for (size_t i = 0; i < order.size(); i++) {
+    EXPECT_EQ(order[i], i);
+  }
+}
+
+TEST(PointOrder, blocks)
+{
+  // Points stay within their block; the last block is partial
+  for (spgl::gfx3d::PointOrder pointOrder :
+       { spgl::gfx3d::PointOrder::Shuffled,
+         spgl::gfx3d::PointOrder::MortonStratified }) {
+    const std::vector<size_t> order =
+      spgl::gfx3d::computePointOrder(grid(10), 30, pointOrder, 7);
+    ASSERT_EQ(order.size(), 100u);
+    expectPermutation(order, 0, 30);
+    expectPermutation(order, 30, 30);
+    expectPermutation(order, 60, 30);
+    expectPermutation(order, 90, 10);
+  }
+
+  // One block
+  const std::vector<size_t> order = spgl::gfx3d::computePointOrder(
+    grid(10), 0, spgl::gfx3d::PointOrder::MortonStratified);
+  ASSERT_EQ(order.size(), 100u);
+  expectPermutation(order, 0, 100);
+}
+
+TEST(PointOrder, mortonStratified)
+{
+  // Every quadrant of the grid is visited before any quadrant is visited
+  // twice
+  const std::vector<spgl::Vector3f> positions = grid(8);
+  const std::vector<size_t> order = spgl::gfx3d::computePointOrder(
+    positions, 0, spgl::gfx3d::PointOrder::MortonStratified);
+  ASSERT_EQ(order.size(), 64u);
+  bool quadrants[4] = { false, false, false, false };
+  for (size_t i = 0; i < 4; i++) {
+    const spgl::Vector3f& position = positions[order[i]];
+    quadrants[(position[0] < 4 ? 0 : 1) + (position[1] < 4 ? 0 : 2)] = true;
+  }
+  EXPECT_TRUE(quadrants[0] && quadrants[1] && quadrants[2] && quadrants[3]);
+}
+
+TEST(PointOrder, invalidPositions)
+{
+  std::vector<spgl::Vector3f> positions = grid(4);
+  positions[5][0] = std::numeric_limits<float>::quiet_NaN();
+  const std::vector<size_t> order = spgl::gfx3d::computePointOrder(
+    positions, 0, spgl::gfx3d::PointOrder::MortonStratified);
+  ASSERT_EQ(order.size(), 16u);
+  expectPermutation(order, 0, 16);
+}
@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+
+#include <spatiumgl/gfx3d/PointCloud.hpp>
+#include <spatiumgl/gfx3d/PointQuantization.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+TEST(PointQuantization, colors)
+{
+  const spgl::gfx3d::Rgba8 packed =
+    spgl::gfx3d::packColor({ 0.0f, 0.5f, 1.0f });
+  EXPECT_EQ(packed[0], 0);
+  EXPECT_EQ(packed[1], 128);
+  EXPECT_EQ(packed[2], 255);
+  EXPECT_EQ(packed[3], 255);
+
+  // Out of range is clamped
+  EXPECT_EQ(spgl::gfx3d::packColor({ -1.0f, 2.0f, 0.0f })[0], 0);
+  EXPECT_EQ(spgl::gfx3d::packColor({ -1.0f, 2.0f, 0.0f })[1], 255);
+
+  // Round trip within half a step
+  const spgl::Vector3f color(0.1f, 0.7f, 0.33f);
+  const spgl::Vector3f unpacked =
+    spgl::gfx3d::unpackColor(spgl::gfx3d::packColor(color));
+  for (size_t i = 0; i < 3; i++) {
+    EXPECT_NEAR(unpacked[i], color[i], 0.5 / 255 + 1e-6);
+  }
+
+  EXPECT_EQ(sizeof(spgl::gfx3d::Rgba8), 4u);
+  EXPECT_EQ(spgl::gfx3d::packColors({ color, color }).size(), 2u);
+}
+
+TEST(PointQuantization, positions16)
+{
+  const spgl::BoundingBox bounds =
+    spgl::BoundingBox::fromMinMax({ 10, 20, 30 }, { 20, 20, 130 });
+  const spgl::gfx3d::PositionQuantization quantization =
+    spgl::gfx3d::PositionQuantization::fromBounds(bounds);
+  EXPECT_EQ(quantization.offset, spgl::Vector3f(10, 20, 30));
+  EXPECT_EQ(quantization.scale, spgl::Vector3f(10, 0, 100));
+
+  const std::vector<spgl::Vector3f> positions = { { 10, 20, 30 },
+                                                  { 20, 20, 130 },
+                                                  { 12.345f, 20, 77.7f },
+                                                  { 0, 20, 200 } };
+  std::vector<std::uint16_t> values(4 * positions.size());
+  quantization.quantize16(positions.data(), positions.size(), values.data());
+
+  // Minimum and maximum of bounds, flat axis and padding are exact
+  EXPECT_EQ(values[0], 0);
+  EXPECT_EQ(values[2], 0);
+  EXPECT_EQ(values[4], 65535);
+  EXPECT_EQ(values[6], 65535);
+  EXPECT_EQ(values[1], 0);
+  EXPECT_EQ(values[3], 0);
+
+  // Within half a step of the original position
+  const spgl::Vector3f position = quantization.dequantize16(&values[8]);
+  EXPECT_NEAR(position[0], 12.345, 0.5 * 10 / 65535 + 1e-5);
+  EXPECT_FLOAT_EQ(position[1], 20);
+  EXPECT_NEAR(position[2], 77.7, 0.5 * 100 / 65535 + 1e-5);
+
+  // Outside bounds is clamped
+  EXPECT_EQ(values[12], 0);
+  EXPECT_EQ(values[14], 65535);
+}
+
+TEST(PointQuantization, positions1010102)
+{
+  const spgl::gfx3d::PositionQuantization quantization =
+    spgl::gfx3d::PositionQuantization::fromBounds(
+      spgl::BoundingBox({ 0, 0, 0 }, { 1, 1, 1 }));
+
+  const std::vector<spgl::Vector3f> positions = { { -1, 0, 1 },
+                                                  { 0.25f, -0.5f, 0.9f } };
+  std::vector<std::uint32_t> values(positions.size());
+  quantization.quantize1010102(
+    positions.data(), positions.size(), values.data());
+
+  // x in the lowest bits, w (highest 2 bits) is 0
+  EXPECT_EQ(values[0], 0u | (512u << 10) | (1023u << 20));
+  EXPECT_EQ(values[1] >> 30, 0u);
+
+  const spgl::Vector3f position = quantization.dequantize1010102(values[1]);
+  for (size_t i = 0; i < 3; i++) {
+    EXPECT_NEAR(position[i], positions[1][i], 0.5 * 2 / 1023 + 1e-5);
+  }
+}
+
+TEST(PointQuantization, scalars)
+{
+  const std::vector<float> values = { -10, 0, 10, 20 };
+
+  std::vector<std::uint8_t> values8(values.size());
+  spgl::gfx3d::quantizeScalars(
+    values.data(), values.size(), -10.0f, 10.0f, values8.data());
+  EXPECT_EQ(values8[0], 0);
+  EXPECT_EQ(values8[1], 128);
+  EXPECT_EQ(values8[2], 255);
+  EXPECT_EQ(values8[3], 255); // Clamped
+
+  std::vector<std::uint16_t> values16(values.size());
+  spgl::gfx3d::quantizeScalars(
+    values.data(), values.size(), -10.0f, 20.0f, values16.data());
+  EXPECT_EQ(values16[0], 0);
+  EXPECT_EQ(values16[3], 65535);
+  EXPECT_NEAR(spgl::gfx3d::dequantizeScalar(values16[1], -10.0f, 20.0f),
+              0,
+              0.5 * 30 / 65535);
+
+  // Empty range
+  spgl::gfx3d::quantizeScalars(
+    values.data(), values.size(), 5.0f, 5.0f, values8.data());
+  EXPECT_EQ(values8[3], 0);
+}
+
+TEST(PointQuantization, widenScalarRange)
+{
+  // Included: unchanged
+  std::array<float, 2> range = { { 0, 10 } };
+  EXPECT_EQ(spgl::gfx3d::widenScalarRange(range, { { 2, 8 } }), range);
+
+  // Empty: the values
+  EXPECT_EQ(spgl::gfx3d::widenScalarRange({ { 0, 0 } }, { { 2, 8 } }),
+            (std::array<float, 2>{ { 2, 8 } }));
+
+  // Doubled in the direction of the values
+  EXPECT_EQ(spgl::gfx3d::widenScalarRange(range, { { 0, 11 } }),
+            (std::array<float, 2>{ { 0, 20 } }));
+  EXPECT_EQ(spgl::gfx3d::widenScalarRange(range, { { -1, 10 } }),
+            (std::array<float, 2>{ { -10, 10 } }));
+  EXPECT_EQ(spgl::gfx3d::widenScalarRange(range, { { -1, 11 } }),
+            (std::array<float, 2>{ { -5, 15 } }));
+  EXPECT_EQ(spgl::gfx3d::widenScalarRange(range, { { 0, 50 } }),
+            (std::array<float, 2>{ { 0, 50 } }));
+
+  // Monotonically growing values (e.g. GPS time while reading)
+  size_t changes = 0;
+  range = { { 0, 0 } };
+  for (int i = 1; i <= 100000; i++) {
+    const std::array<float, 2> widened = spgl::gfx3d::widenScalarRange(
+      range, { { 0, static_cast<float>(i) } });
+    changes += (widened != range ? 1 : 0);
+    range = widened;
+  }
+  EXPECT_LE(changes, 18u);
+  EXPECT_GE(range[1], 100000.0f);
+}
+
+TEST(PointQuantization, packedColorsData)
+{
+  std::vector<spgl::Vector3f> positions = { { 0, 0, 0 }, { 1, 1, 1 } };
+  std::vector<spgl::gfx3d::Rgba8> colors = { { { 255, 0, 0, 255 } },
+                                             { { 0, 255, 0, 255 } } };
+  spgl::gfx3d::PointCloudData data(std::move(positions), std::move(colors));
+
+  EXPECT_TRUE(data.hasColors());
+  EXPECT_TRUE(data.colors().empty());
+  EXPECT_EQ(data.packedColors().size(), 2u);
+  EXPECT_EQ(data.computeSize(),
+            2 * sizeof(spgl::Vector3f) + 2 * sizeof(spgl::gfx3d::Rgba8));
+  EXPECT_TRUE(
+    spgl::gfx3d::PointCloudHeader::constructFromData(data).hasColors());
+}
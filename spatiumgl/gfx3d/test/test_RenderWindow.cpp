@@ -0,0 +1,346 @@
+#include <gtest/gtest.h>
+
+#include <spatiumgl/gfx3d/PerspectiveCamera.hpp>
+#include <spatiumgl/gfx3d/RenderWindow.hpp>
+
+namespace {
+
+/// Render window without window system.
+class TestRenderWindow : public spgl::gfx3d::RenderWindow
+{
+public:
+  bool init() override { return true; }
+  void terminate() const override {}
+  bool createWindow(int width, int height) override { return true; }
+  void destroyWindow() override {}
+  void show() override {}
+  using RenderWindow::markDrawn;
+  using RenderWindow::render;
+};
+
+/// Renderer that counts renders and tests a single chunk.
+class TestRenderer : public spgl::gfx3d::Renderer
+{
+public:
+  TestRenderer(const spgl::gfx3d::RenderObject* renderObject,
+               const spgl::BoundingCube& chunk)
+    : Renderer(renderObject)
+    , renderCount(0)
+    , chunkVisible(false)
+    , loading(false)
+    , m_chunk(chunk)
+  {}
+
+  bool needsRedraw() const override { return loading; }
+
+  std::vector<spgl::gfx3d::PointBudgetRequest> pointBudgetRequests() override
+  {
+    if (!budgeted || !testChunk(m_chunk)) {
+      return {};
+    }
+    return { { 1000, chunkWeight(m_chunk) } };
+  }
+
+  void render(spgl::gfx3d::Camera* camera, const spgl::Vector2i& size) override
+  {
+    renderCount++;
+    chunkVisible = isChunkVisible(m_chunk);
+    pointAllocation = m_pointAllocation;
+    pointBudgetActive = m_pointBudgetActive;
+  }
+
+  size_t renderCount;
+  bool chunkVisible;
+  bool loading;
+  bool budgeted = false;
+  std::vector<size_t> pointAllocation;
+  bool pointBudgetActive = false;
+
+private:
+  spgl::BoundingCube m_chunk;
+};
+
+/// Renderer that uploads its chunk in the first frame, like the point cloud
+/// renderers: the chunk only gets a share of the point budget in the next.
+class TestUploadRenderer : public spgl::gfx3d::Renderer
+{
+public:
+  TestUploadRenderer(const spgl::gfx3d::RenderObject* renderObject)
+    : Renderer(renderObject)
+    , uploaded(false)
+    , drawnPointCount(0)
+    , m_unbudgeted(false)
+  {}
+
+  bool needsRedraw() const override { return m_unbudgeted; }
+
+  std::vector<spgl::gfx3d::PointBudgetRequest> pointBudgetRequests() override
+  {
+    if (!uploaded) {
+      return {};
+    }
+    return { { 1000, 1 } };
+  }
+
+  void render(spgl::gfx3d::Camera* camera, const spgl::Vector2i& size) override
+  {
+    const bool requested = uploaded;
+    uploaded = true;
+    m_unbudgeted = m_pointBudgetActive && !requested;
+    drawnPointCount = 1000;
+    if (m_pointBudgetActive) {
+      drawnPointCount = requested ? m_pointAllocation[0] : 0;
+    }
+  }
+
+  bool uploaded;
+  size_t drawnPointCount;
+
+private:
+  bool m_unbudgeted;
+};
+
+/// Animator that does nothing.
+class TestAnimator : public spgl::gfx3d::Animator
+{
+public:
+  TestAnimator()
+    : Animator(nullptr)
+  {}
+
+  void animate(double deltaTime) override {}
+};
+
+} // namespace
+
+TEST(RenderWindow, frameContext)
+{
+  spgl::gfx3d::PerspectiveCamera camera(0.7853981634, 1, 1000);
+  camera.lookAt({ 0, 0, 0 }, { 0, 1, 0 }, { 0, 0, 50 });
+  const spgl::gfx3d::FrameContext frame =
+    spgl::gfx3d::FrameContext::fromCamera(camera, { 800, 600 });
+
+  EXPECT_DOUBLE_EQ(frame.aspect, 800.0 / 600.0);
+  EXPECT_EQ(frame.cameraPosition, spgl::Vector3(0, 0, 50));
+  EXPECT_TRUE(frame.perspective);
+  EXPECT_DOUBLE_EQ(frame.distanceScreen, 600 * frame.projection[1][1]);
+  EXPECT_EQ(frame.frameTime, 0);
+  EXPECT_FALSE(frame.interacting);
+
+  // Origin is 50 units in front of the camera
+  const spgl::Vector4 view = frame.view * spgl::Vector4(0, 0, 0, 1);
+  EXPECT_NEAR(view[2], -50, 1e-9);
+  const spgl::Vector4 clip = frame.viewProjection * spgl::Vector4(0, 0, 0, 1);
+  EXPECT_NEAR(clip[0], 0, 1e-9);
+  EXPECT_NEAR(clip[1], 0, 1e-9);
+}
+
+TEST(RenderWindow, frustumCulling)
+{
+  // Camera on the positive Z axis, looking at the origin
+  spgl::gfx3d::PerspectiveCamera camera(0.7853981634, 1, 1000);
+  camera.lookAt({ 0, 0, 0 }, { 0, 1, 0 }, { 0, 0, 50 });
+  const spgl::gfx3d::FrameContext frame =
+    spgl::gfx3d::FrameContext::fromCamera(camera, { 800, 600 });
+
+  // Bounds and chunks are in model space
+  spgl::gfx3d::RenderObject inView(
+    spgl::BoundingBox({ -50, 0, 0 }, { 51, 1, 1 }));
+  inView.transform().translate({ 100, 0, 0 });
+  spgl::gfx3d::RenderObject behind(
+    spgl::BoundingBox({ 0, 0, 100 }, { 1, 1, 1 }));
+  spgl::gfx3d::RenderObject unbounded;
+
+  TestRenderer visibleChunk(&inView, spgl::BoundingCube({ -100, 0, 0 }, 1));
+  TestRenderer culledChunk(&inView, spgl::BoundingCube({ 0, 0, 0 }, 1));
+  TestRenderer culledObject(&behind, spgl::BoundingCube({ 0, 0, 100 }, 1));
+  TestRenderer alwaysDrawn(&unbounded, spgl::BoundingCube({ 0, 0, 100 }, 1));
+
+  TestRenderWindow window;
+  window.setCamera(&camera);
+  window.addRenderer(&visibleChunk);
+  window.addRenderer(&culledChunk);
+  window.addRenderer(&culledObject);
+  window.addRenderer(&alwaysDrawn);
+  EXPECT_TRUE(window.frustumCulling());
+
+  window.render(frame);
+  EXPECT_EQ(visibleChunk.renderCount, 1u);
+  EXPECT_TRUE(visibleChunk.chunkVisible);
+  EXPECT_EQ(culledChunk.renderCount, 1u);
+  EXPECT_FALSE(culledChunk.chunkVisible);
+  EXPECT_EQ(culledObject.renderCount, 0u);
+  EXPECT_EQ(alwaysDrawn.renderCount, 1u);
+  EXPECT_TRUE(alwaysDrawn.chunkVisible);
+
+  const spgl::gfx3d::RenderStatistics& statistics = window.renderStatistics();
+  EXPECT_EQ(statistics.drawnObjects, 3u);
+  EXPECT_EQ(statistics.culledObjects, 1u);
+  EXPECT_EQ(statistics.drawnChunks, 2u);
+  EXPECT_EQ(statistics.culledChunks, 1u);
+
+  // Disabled: everything is drawn
+  window.setFrustumCulling(false);
+  window.render(frame);
+  EXPECT_EQ(culledObject.renderCount, 1u);
+  EXPECT_TRUE(culledChunk.chunkVisible);
+  EXPECT_EQ(window.renderStatistics().culledObjects, 0u);
+  EXPECT_EQ(window.renderStatistics().culledChunks, 0u);
+}
+
+TEST(RenderWindow, frustumCullingTransformed)
+{
+  spgl::gfx3d::PerspectiveCamera camera(0.7853981634, 1, 1000);
+  camera.lookAt({ 0, 0, 0 }, { 0, 1, 0 }, { 0, 0, 50 });
+  const spgl::gfx3d::FrameContext frame =
+    spgl::gfx3d::FrameContext::fromCamera(camera, { 800, 600 });
+
+  spgl::gfx3d::RenderObject object(
+    spgl::BoundingBox({ 100, 0, 0 }, { 1, 1, 1 }));
+  TestRenderer renderer(&object, spgl::BoundingCube({ 100, 0, 0 }, 1));
+  TestRenderWindow window;
+  window.setCamera(&camera);
+  window.addRenderer(&renderer);
+
+  window.render(frame);
+  EXPECT_EQ(renderer.renderCount, 0u);
+
+  // Moved into view after it was added (e.g. by an animator)
+  object.transform().translate({ -100, 0, 0 });
+  EXPECT_EQ(object.bounds().center(), spgl::Vector3(0, 0, 0));
+  EXPECT_EQ(window.bounds().center(), spgl::Vector3(0, 0, 0));
+  window.render(frame);
+  EXPECT_EQ(renderer.renderCount, 1u);
+  EXPECT_TRUE(renderer.chunkVisible);
+}
+
+TEST(RenderWindow, renderOnDemand)
+{
+  spgl::gfx3d::PerspectiveCamera camera(0.7853981634, 1, 1000);
+  camera.lookAt({ 0, 0, 0 }, { 0, 1, 0 }, { 0, 0, 50 });
+  spgl::gfx3d::RenderObject object(spgl::BoundingBox({ 0, 0, 0 }, { 1, 1, 1 }));
+  TestRenderer renderer(&object, spgl::BoundingCube({ 0, 0, 0 }, 1));
+  TestAnimator animator;
+  animator.setActive(false);
+
+  TestRenderWindow window;
+  window.setCamera(&camera);
+  window.addRenderer(&renderer);
+  window.addAnimator(&animator);
+  EXPECT_TRUE(window.renderOnDemand());
+  EXPECT_TRUE(window.needsRedraw()); // First frame
+
+  // Nothing changed since the last frame
+  window.render(spgl::gfx3d::FrameContext::fromCamera(
+    camera, window.framebufferSize()));
+  EXPECT_FALSE(window.needsRedraw());
+
+  // Camera moved
+  EXPECT_FALSE(window.viewChanged());
+  camera.transform().translate({ 1, 0, 0 });
+  EXPECT_TRUE(window.viewChanged());
+  EXPECT_TRUE(window.needsRedraw());
+  window.render(spgl::gfx3d::FrameContext::fromCamera(
+    camera, window.framebufferSize()));
+  EXPECT_FALSE(window.needsRedraw());
+
+  // Explicit request
+  window.requestRedraw();
+  EXPECT_TRUE(window.needsRedraw());
+  window.render(spgl::gfx3d::FrameContext::fromCamera(
+    camera, window.framebufferSize()));
+  EXPECT_FALSE(window.needsRedraw());
+
+  // Active animator or renderer that needs another frame
+  animator.setActive(true);
+  EXPECT_TRUE(window.needsRedraw());
+  animator.setActive(false);
+  renderer.loading = true;
+  EXPECT_TRUE(window.needsRedraw());
+  renderer.loading = false;
+
+  // Continuous
+  window.setRenderOnDemand(false);
+  EXPECT_TRUE(window.needsRedraw());
+
+  // Without camera nothing is rendered, but the frame is drawn
+  TestRenderWindow emptyWindow;
+  EXPECT_TRUE(emptyWindow.needsRedraw());
+  emptyWindow.markDrawn();
+  EXPECT_FALSE(emptyWindow.needsRedraw());
+}
+
+TEST(RenderWindow, pointBudget)
+{
+  spgl::gfx3d::PerspectiveCamera camera(0.7853981634, 1, 1000);
+  camera.lookAt({ 0, 0, 0 }, { 0, 1, 0 }, { 0, 0, 50 });
+  const spgl::gfx3d::FrameContext frame =
+    spgl::gfx3d::FrameContext::fromCamera(camera, { 800, 600 });
+
+  // Two chunks of 1000 points; the distant one covers less of the screen
+  spgl::gfx3d::RenderObject object(
+    spgl::BoundingBox({ 0, 0, -25 }, { 1, 1, 26 }));
+  TestRenderer nearRenderer(&object, spgl::BoundingCube({ 0, 0, 0 }, 1));
+  TestRenderer farRenderer(&object, spgl::BoundingCube({ 0, 0, -50 }, 1));
+  TestRenderer otherRenderer(&object, spgl::BoundingCube({ 0, 0, 0 }, 1));
+  nearRenderer.budgeted = true;
+  farRenderer.budgeted = true;
+
+  TestRenderWindow window;
+  window.setCamera(&camera);
+  window.addRenderer(&nearRenderer);
+  window.addRenderer(&farRenderer);
+  window.addRenderer(&otherRenderer);
+  EXPECT_EQ(window.pointBudget(), 0u);
+
+  // Unlimited
+  window.render(frame);
+  EXPECT_FALSE(nearRenderer.pointBudgetActive);
+  EXPECT_TRUE(nearRenderer.pointAllocation.empty());
+
+  // Shared by the chunks, weighted by their area on screen
+  window.setPointBudget(1000);
+  window.render(frame);
+  ASSERT_EQ(nearRenderer.pointAllocation.size(), 1u);
+  ASSERT_EQ(farRenderer.pointAllocation.size(), 1u);
+  EXPECT_GT(nearRenderer.pointAllocation[0], farRenderer.pointAllocation[0]);
+  EXPECT_LE(nearRenderer.pointAllocation[0] + farRenderer.pointAllocation[0],
+            1000u);
+  EXPECT_GT(farRenderer.pointAllocation[0], 0u);
+  EXPECT_TRUE(nearRenderer.pointBudgetActive);
+  EXPECT_TRUE(farRenderer.pointBudgetActive);
+
+  // A renderer without requests gets no points, not all of them
+  EXPECT_TRUE(otherRenderer.pointBudgetActive);
+  EXPECT_TRUE(otherRenderer.pointAllocation.empty());
+
+  // Budget requests are not counted in the statistics
+  EXPECT_EQ(window.renderStatistics().drawnChunks, 3u);
+}
+
+TEST(RenderWindow, pointBudgetUpload)
+{
+  spgl::gfx3d::PerspectiveCamera camera(0.7853981634, 1, 1000);
+  camera.lookAt({ 0, 0, 0 }, { 0, 1, 0 }, { 0, 0, 50 });
+  spgl::gfx3d::RenderObject object(spgl::BoundingBox({ 0, 0, 0 }, { 1, 1, 1 }));
+  TestUploadRenderer renderer(&object);
+
+  TestRenderWindow window;
+  window.setCamera(&camera);
+  window.addRenderer(&renderer);
+  window.setPointBudget(500);
+
+  // Uploaded after the budget was distributed: nothing drawn yet, so the
+  // next frame is needed even though nothing else changed
+  window.render(spgl::gfx3d::FrameContext::fromCamera(
+    camera, window.framebufferSize()));
+  EXPECT_TRUE(renderer.uploaded);
+  EXPECT_EQ(renderer.drawnPointCount, 0u);
+  EXPECT_TRUE(window.needsRedraw());
+
+  // Drawn within the budget
+  window.render(spgl::gfx3d::FrameContext::fromCamera(
+    camera, window.framebufferSize()));
+  EXPECT_EQ(renderer.drawnPointCount, 500u);
+  EXPECT_FALSE(window.needsRedraw());
+}
@@ -17,6 +17,8 @@
 #include "spatiumgl/gfx3d/OctreeObject.hpp"
 #include "spatiumglexport.hpp"
 
+#include <vector> // std::vector
+
 namespace spgl {
 namespace gfx3d {
 
@@ -44,12 +46,32 @@ public:
 
   /// Render the octree cloud.
   ///
+  /// Subtrees outside the view frustum are culled (see isChunkVisible()).
+  ///
   /// \param[in] camera Camera
   /// \param[in] size Render image size
   void render(Camera* camera, const Vector2i& size) override;
 
 protected:
+  /// Range of cubes of a subtree, in depth-first order.
+  struct Chunk
+  {
+    BoundingCube bounds;
+    size_t first;
+    size_t count;
+  };
+
+  /// Maximum depth of the roots of chunks (8^3 = 512 subtrees)
+  static const size_t s_chunkDepth = 3;
+
+  /// Draw a range of cubes. The instance VBO must be bound.
+  ///
+  /// \param[in] first Index of first cube
+  /// \param[in] count Number of cubes
+  void drawCubes(size_t first, size_t count);
+
   size_t m_cubeCount;
+  std::vector<Chunk> m_chunks;
   unsigned int m_ebo; // Element Buffer Object (GLuint)
   unsigned int m_instanceVbo; // Instance Vertex Buffer Object (GLuint)
 };
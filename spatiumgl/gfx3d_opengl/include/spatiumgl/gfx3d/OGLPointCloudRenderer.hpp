@@ -15,7 +15,14 @@
 
 #include "spatiumglexport.hpp"
 #include "OGLRenderer.hpp"
+#include "spatiumgl/gfx3d/PointCloudChunk.hpp"
+#include "spatiumgl/gfx3d/PointBudgetController.hpp"
 #include "spatiumgl/gfx3d/PointCloudObject.hpp"
+#include "spatiumgl/gfx3d/PointQuantization.hpp"
+#include "spatiumgl/ColorLut.hpp"
+
+#include <array>  // std::array
+#include <vector> // std::vector
 
 namespace spgl {
 namespace gfx3d {
@@ -33,6 +40,13 @@ struct SPATIUMGL_EXPORT PointCloudRenderOptions
   bool pointScaleWorld = false;
   PointCloudRenderingColorMethod colorMethod = Fixed;
   Vector3 color = { 1, 1, 1 };
+  size_t chunkSize = 1 << 21;     // Points per vertex buffer
+  size_t uploadBudget = 64 << 20; // Bytes uploaded per frame
+  PointPositionFormat positionFormat = PointPositionFormat::Float32;
+  bool packColors = false; // RGBA8 colors (always if data has packed colors)
+  PointScalarFormat scalarFormat = PointScalarFormat::Float32;
+  bool adaptivePointBudget = false; // Draw chunk prefixes while interacting
+  double targetFrameTime = 1.0 / 30; // Seconds, with adaptive point budget
 };
 
 class SPATIUMGL_EXPORT OGLPointCloudRenderer : public OGLRenderer
@@ -58,14 +72,128 @@ public:
   /// \return Point cloud render object
   const PointCloudObject* pointCloudObject() const;
 
+  /// Get chunks the point cloud is split in.
+  ///
+  /// \return Chunks
+  const std::vector<PointCloudChunk>& chunks() const { return m_chunks; }
+
+  /// Get number of chunks with up to date vertex buffers.
+  ///
+  /// \return Number of chunks
+  size_t uploadedChunkCount() const;
+
+  /// Upload a changed range of points again.
+  ///
+  /// The chunks containing the points are uploaded again in the next frames.
+  /// Bounds of chunks are not updated.
+  ///
+  /// \param[in] first Index of first point
+  /// \param[in] count Number of points
+  void updatePoints(size_t first, size_t count);
+
+  /// Get boolean indicator if another frame is needed.
+  ///
+  /// \return True while chunks wait to be uploaded or to get a share of the
+  ///         point budget, or if the last frame was drawn with a reduced
+  ///         point budget
+  bool needsRedraw() const override;
+
+  /// Get number of points drawn in the last frame.
+  ///
+  /// \return Number of points
+  size_t drawnPointCount() const { return m_drawnPointCount; }
+
+  /// Get point budget controller (see adaptivePointBudget).
+  ///
+  /// \return Point budget controller
+  PointBudgetController& pointBudgetController() { return m_budgetController; }
+
+  /// Get the uploaded chunks in view, competing for the point budget of the
+  /// render window.
+  ///
+  /// \return Point counts and weights (area on screen) of chunks
+  std::vector<PointBudgetRequest> pointBudgetRequests() override;
+
+  /// Get memory usage of vertex buffers (once all chunks are uploaded).
+  ///
+  /// \return Memory usage (bytes)
+  size_t gpuMemoryUsage() const;
+
   /// Render the point cloud.
   ///
+  /// Chunks are uploaded over multiple frames, at most uploadBudget bytes
+  /// per frame. Chunks outside the view frustum are culled.
+  ///
+  /// Points appended to the point cloud data (see PointCloudData::append())
+  /// are added to the chunks, so a point cloud can be displayed while it is
+  /// being read. The header determines which attributes are rendered.
+  ///
+  /// With adaptivePointBudget, only a prefix of every visible chunk is drawn
+  /// while the view changes, sized to the budget of the point budget
+  /// controller. All points are drawn in the next frame without changes.
+  /// Likewise, chunks are cut to their share of the point budget of the
+  /// render window (see RenderWindow::setPointBudget()).
+  /// Order the points in advance (see computePointOrder(), with the chunk
+  /// size as block size) so that prefixes are uniform subsamples.
+  ///
+  /// Positions, colors and scalars are converted to the formats in the render
+  /// options while uploading. Quantized positions are relative to the bounds
+  /// of their chunk; quantized scalars to the scalar range.
+  ///
   /// \param[in] camera Camera
   /// \param[in] size Render image size
   void render(Camera* camera, const Vector2i& size) override;
 
 protected:
+  /// Vertex buffers of a chunk
+  struct ChunkBuffer
+  {
+    unsigned int vao; // Vertex Array Object (GLuint), 0 if not uploaded
+    unsigned int vbo; // Vertex Buffer Object (GLuint)
+    size_t count;     // Number of points in vertex buffer
+    bool dirty;       // Needs to be uploaded
+    bool filled;      // Color or scalar attribute written (else constant)
+    PositionQuantization quantization; // Of positions in vertex buffer
+  };
+
+  /// Vertex attribute next to the positions
+  enum class Attribute
+  {
+    None,
+    Colors,       // 3 x float
+    PackedColors, // RGBA8
+    Scalars       // Scalar format of render options
+  };
+
+  /// Get size of the vertex attribute next to the positions.
+  ///
+  /// \return Size per point (bytes)
+  size_t attributeSize() const;
+
+  /// Add chunks for points appended to the data, and mark them dirty.
+  void extendChunks();
+
+  /// Set the constant color or scalar attribute, for chunks without one.
+  void setConstantAttribute() const;
+
+  /// Upload chunk to the GPU, (re)allocating its vertex buffers if needed.
+  ///
+  /// \param[in] chunk Chunk
+  /// \param[in,out] buffer Vertex buffers of chunk
+  void upload(const PointCloudChunk& chunk, ChunkBuffer& buffer);
+
   PointCloudRenderOptions m_renderOptions;
+  ColorLut m_colorLut; // Cached color ramp colors for scalar coloring
+  std::vector<PointCloudChunk> m_chunks;
+  std::vector<ChunkBuffer> m_buffers; // One per chunk
+  Attribute m_attribute;
+  std::array<float, 2> m_scalarRange; // Quantization range of scalars
+  PointBudgetController m_budgetController;
+  size_t m_drawnPointCount;
+  bool m_reduced;    // Last frame was drawn with a reduced point budget
+  bool m_unbudgeted; // Chunks were uploaded after the budget was distributed
+  size_t m_dirtyChunkCount;
+  std::vector<size_t> m_budgetChunks; // Chunks of pointBudgetRequests()
 };
 
 } // namespace gfx3d
@@ -15,7 +15,8 @@
 
 #include "spatiumglexport.hpp"
 
-#include <string> // std::string
+#include <string>        // std::string
+#include <unordered_map> // std::unordered_map
 
 namespace spgl {
 namespace gfx3d {
@@ -69,6 +70,15 @@ public:
   /// Delete from current OpenGL context.
   void free();
 
+  /// Get the location of a uniform.
+  ///
+  /// Locations are looked up once, when the program is linked. Arrays can be
+  /// looked up with and without "[0]".
+  ///
+  /// \param[in] name Uniform name
+  /// \return Location, -1 if the uniform is not active
+  int uniformLocation(const std::string& name) const;
+
   /// Get the vertex shader ID.
   ///
   /// \return Vertex shader ID
@@ -102,6 +112,7 @@ protected:
   unsigned int m_fragmentShaderId;
   unsigned int m_geometryShaderId;
   unsigned int m_shaderProgramId;
+  std::unordered_map<std::string, int> m_uniformLocations;
 };
 
 } // namespace gfx3d
@@ -0,0 +1,131 @@
+/*
+ * Program: Spatium Graphics Library
+ *
+ * Copyright (C) Martijn Koopman
+ * All Rights Reserved
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.
+ *
+ */
+
+#ifndef SPATIUMGL_GFX3D_OGLSTREAMINGPOINTCLOUDRENDERER_H
+#define SPATIUMGL_GFX3D_OGLSTREAMINGPOINTCLOUDRENDERER_H
+
+#include "OGLRenderer.hpp"
+#include "spatiumgl/LruCache.hpp"
+#include "spatiumgl/gfx3d/PointQuantization.hpp"
+#include "spatiumgl/gfx3d/StreamingPointCloudObject.hpp"
+#include "spatiumglexport.hpp"
+
+namespace spgl {
+namespace gfx3d {
+
+struct SPATIUMGL_EXPORT StreamingPointCloudRenderOptions
+{
+  float pointSize = 1;
+  Vector3 color = { 1, 1, 1 };          // Color of nodes without colors
+  size_t gpuMemoryBudget = 512 << 20;   // Bytes of vertex buffers
+  size_t uploadBudget = 16 << 20;       // Bytes uploaded per frame
+  PointPositionFormat positionFormat = PointPositionFormat::Float32;
+  bool packColors = false; // RGBA8 colors (always if nodes have packed colors)
+};
+
+/// \class OGLStreamingPointCloudRenderer
+/// \brief Renders a streaming point cloud, with a vertex buffer per node.
+///
+/// Every frame the object is updated for the camera. Loaded nodes are
+/// uploaded to the GPU, at most uploadBudget bytes per frame to avoid
+/// stalls; the remaining nodes are uploaded in the next frames. Vertex
+/// buffers of the least recently rendered nodes are deleted when they
+/// exceed gpuMemoryBudget.
+///
+/// Quantized positions are relative to the bounds of their node.
+class SPATIUMGL_EXPORT OGLStreamingPointCloudRenderer : public OGLRenderer
+{
+public:
+  /// Constructor
+  ///
+  /// \param[in] object Streaming point cloud object (updated while rendering)
+  /// \param[in] renderOptions Render options
+  OGLStreamingPointCloudRenderer(
+    StreamingPointCloudObject* object,
+    const StreamingPointCloudRenderOptions& renderOptions);
+
+  /// Copy constructor. (deleted)
+  OGLStreamingPointCloudRenderer(const OGLStreamingPointCloudRenderer& other) =
+    delete;
+
+  /// Copy assignment operator. (deleted)
+  OGLStreamingPointCloudRenderer& operator=(
+    const OGLStreamingPointCloudRenderer& other) = delete;
+
+  /// Destructor
+  virtual ~OGLStreamingPointCloudRenderer() override;
+
+  /// Get streaming point cloud render object.
+  ///
+  /// \return Streaming point cloud render object
+  const StreamingPointCloudObject* streamingPointCloudObject() const;
+
+  /// Get number of nodes rendered in the last frame.
+  ///
+  /// \return Number of nodes
+  size_t renderedNodeCount() const { return m_renderedNodeCount; }
+
+  /// Get memory usage of vertex buffers.
+  ///
+  /// \return Memory usage (bytes)
+  size_t gpuMemoryUsage() const { return m_buffers.size(); }
+
+  /// Get boolean indicator if another frame is needed.
+  ///
+  /// \return True while nodes are being loaded or wait to be uploaded
+  bool needsRedraw() const override;
+
+  /// Render the loaded nodes visible to the camera.
+  ///
+  /// \param[in] camera Camera
+  /// \param[in] size Render image size
+  void render(Camera* camera, const Vector2i& size) override;
+
+protected:
+  /// Vertex buffers of a node
+  struct NodeBuffer
+  {
+    unsigned int vao; // Vertex Array Object (GLuint)
+    unsigned int vbo; // Vertex Buffer Object (GLuint)
+    size_t pointCount;
+    bool hasColors;
+    PositionQuantization quantization; // Of positions in vertex buffer
+  };
+
+  /// Get size of the colors of a node in GPU memory.
+  ///
+  /// \param[in] node Node
+  /// \return Size per point (bytes), 0 if the node has no colors
+  size_t colorSize(const StreamingNode& node) const;
+
+  /// Upload node to the GPU.
+  ///
+  /// \param[in] node Node
+  /// \return Vertex buffers
+  NodeBuffer upload(const StreamingNode& node) const;
+
+  /// Delete vertex buffers.
+  ///
+  /// \param[in] buffers Evicted vertex buffers
+  static void release(std::vector<std::pair<LodNodeKey, NodeBuffer>>& buffers);
+
+  StreamingPointCloudObject* m_object;
+  StreamingPointCloudRenderOptions m_renderOptions;
+  LruCache<LodNodeKey, NodeBuffer> m_buffers;
+  size_t m_renderedNodeCount;
+  bool m_uploadPending; // Nodes skipped in the last frame (upload budget)
+};
+
+} // namespace gfx3d
+} // namespace spgl
+
+#endif // SPATIUMGL_GFX3D_OGLSTREAMINGPOINTCLOUDRENDERER_H
@@ -11,6 +11,7 @@
  */
 
 #include "GlfwRenderWindowImpl.hpp"
+#include "OGLFrameUniforms.hpp"
 
 #include <GL/glew.h>    // Include GLEW *always* just before GLFW.
 #include <GLFW/glfw3.h> // GLFWwindow
@@ -80,10 +81,15 @@ opengl_error_callback(GLenum source,
 GlfwRenderWindowImpl::GlfwRenderWindowImpl(GlfwRenderWindow* parent, bool debug)
   : m_parent(parent)
   , m_window(nullptr)
+  , m_frameUbo(0)
   , m_drawTime(0)
+  , m_drawTimeValid(false)
   , prevMouseState(GLFW_RELEASE)
   , prevMouseX(0)
   , prevMouseY(0)
+  , m_mouseDeltaX(0)
+  , m_mouseDeltaY(0)
+  , m_scrollDelta(0)
 {}
 
 bool
@@ -133,6 +139,14 @@ GlfwRenderWindowImpl::createWindow(int width, int height)
   // Enable depth buffer
   glEnable(GL_DEPTH_TEST);
 
+  // Create uniform buffer of the frame context, shared by all shaders
+  glGenBuffers(1, &m_frameUbo);
+  glBindBuffer(GL_UNIFORM_BUFFER, m_frameUbo);
+  glBufferData(
+    GL_UNIFORM_BUFFER, sizeof(OGLFrameUniforms), nullptr, GL_DYNAMIC_DRAW);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+  glBindBufferBase(GL_UNIFORM_BUFFER, frameUniformBinding, m_frameUbo);
+
   // Print OpenGL version in use
   std::cout << "OpenGL version: "
             << reinterpret_cast<char const*>(glGetString(GL_VERSION))
@@ -154,6 +168,12 @@ GlfwRenderWindowImpl::createWindow(int width, int height)
       ->glfw_framebuffer_size_callback(win, w, h);
   });
 
+  // Capture window refresh event (contents damaged, e.g. uncovered)
+  glfwSetWindowRefreshCallback(m_window, [](GLFWwindow* win) {
+    static_cast<GlfwRenderWindowImpl*>(glfwGetWindowUserPointer(win))
+      ->glfw_window_refresh_callback(win);
+  });
+
   // Get current frame buffer size
   glfwGetFramebufferSize(
     m_window, &m_parent->m_framebufferSize[0], &m_parent->m_framebufferSize[1]);
@@ -198,6 +218,8 @@ void
 GlfwRenderWindowImpl::destroyWindow()
 {
   // Destroy window and OpenGL context
+  glDeleteBuffers(1, &m_frameUbo);
+  m_frameUbo = 0;
   glfwDestroyWindow(m_window);
 
   m_window = nullptr;
@@ -213,12 +235,25 @@ void
 GlfwRenderWindowImpl::show()
 {
   // Keep running as long as window shouldn't be closed
+  m_drawTime = glfwGetTime();
   while (!glfwWindowShouldClose(m_window)) {
-    // Draw frame
-    draw();
+    // Apply all input received during the last frame at once
+    processInput();
+
+    if (m_parent->needsRedraw()) {
+      // Draw frame (waits for vertical sync)
+      draw();
+
+      // Process events
+      glfwPollEvents();
+    } else {
+      // Nothing changed: sleep until the next event
+      glfwWaitEvents();
 
-    // Process events
-    glfwPollEvents();
+      // Animations continue from now, not from the last frame
+      m_drawTime = glfwGetTime();
+      m_drawTimeValid = false;
+    }
   }
 }
 
@@ -232,22 +267,59 @@ GlfwRenderWindowImpl::draw()
   const double deltaTime = drawTime - m_drawTime;
   m_drawTime = drawTime;
 
-  // Trigger all animators
+  // Trigger all active animators
   for (Animator* animator : m_parent->m_animators) {
-    animator->animate(deltaTime);
+    if (animator->isActive()) {
+      animator->animate(deltaTime);
+    }
   }
 
   // Clear color buffer (dark gray)
   glClearColor(0.227f, 0.227f, 0.227f, 1.0f);
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-  // Trigger all renderers
-  for (Renderer* renderer : m_parent->m_renderers) {
-    renderer->render(m_parent->m_camera, m_parent->m_framebufferSize);
+  if (m_parent->m_camera != nullptr) {
+    // Compute camera state once and upload it for all shaders
+    FrameContext frame = FrameContext::fromCamera(
+      *m_parent->m_camera, m_parent->m_framebufferSize);
+    frame.frameTime = (m_drawTimeValid ? deltaTime : 0);
+    frame.interacting = m_parent->viewChanged();
+    const OGLFrameUniforms uniforms = OGLFrameUniforms::fromFrameContext(frame);
+    glBindBuffer(GL_UNIFORM_BUFFER, m_frameUbo);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(uniforms), &uniforms);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    // Trigger all visible renderers
+    m_parent->render(frame);
+  } else {
+    // Nothing to render until a camera is set: wait for events
+    m_parent->markDrawn();
   }
 
   // Swap front and back buffer (front = displayed, back = rendered)
   glfwSwapBuffers(m_window);
+  m_drawTimeValid = true;
+}
+
+void
+GlfwRenderWindowImpl::processInput()
+{
+  if (m_parent->m_interactor == nullptr) {
+    m_mouseDeltaX = 0;
+    m_mouseDeltaY = 0;
+    m_scrollDelta = 0;
+    return;
+  }
+
+  if (m_mouseDeltaX != 0 || m_mouseDeltaY != 0) {
+    m_parent->m_interactor->OnMouseMoved(m_mouseDeltaX, m_mouseDeltaY);
+    m_mouseDeltaX = 0;
+    m_mouseDeltaY = 0;
+  }
+  if (m_scrollDelta != 0) {
+    m_parent->m_interactor->OnMouseWheelScrolled(m_scrollDelta);
+    m_scrollDelta = 0;
+  }
 }
 
 // GLFW callback functions:
@@ -264,10 +336,18 @@ GlfwRenderWindowImpl::glfw_framebuffer_size_callback(GLFWwindow* window,
   // Set viewport size
   glViewport(0, 0, width, height);
 
-  // Draw during window resize
+  // Draw during window resize (the event loop is blocked on some platforms)
+  processInput();
   draw();
 }
 
+void
+GlfwRenderWindowImpl::glfw_window_refresh_callback(GLFWwindow* window)
+{
+  // Contents must be drawn again, even if nothing changed
+  m_parent->requestRedraw();
+}
+
 void
 GlfwRenderWindowImpl::glfw_mouse_button_callback(GLFWwindow* window,
                                                  int button,
@@ -275,6 +355,8 @@ GlfwRenderWindowImpl::glfw_mouse_button_callback(GLFWwindow* window,
                                                  int mods)
 {
   if (m_parent->m_interactor != nullptr) {
+    // Apply movements before the button changes
+    processInput();
 
     enum RenderWindowInteractor::MouseButton b;
     if (button == GLFW_MOUSE_BUTTON_LEFT) {
@@ -291,8 +373,6 @@ GlfwRenderWindowImpl::glfw_mouse_button_callback(GLFWwindow* window,
     } else {
       m_parent->m_interactor->OnMouseButtonReleased(b, 0, 0);
     }
-
-    draw();
   }
 }
 
@@ -301,15 +381,11 @@ GlfwRenderWindowImpl::glfw_cursor_pos_callback(GLFWwindow* window,
                                                double xpos,
                                                double ypos)
 {
-  if (m_parent->m_interactor != nullptr) {
-    double deltaX = xpos - prevMouseX;
-    double deltaY = ypos - prevMouseY;
-    prevMouseX = xpos;
-    prevMouseY = ypos;
-    m_parent->m_interactor->OnMouseMoved(deltaX, deltaY);
-
-    draw();
-  }
+  // Accumulate until the next frame (see processInput())
+  m_mouseDeltaX += xpos - prevMouseX;
+  m_mouseDeltaY += ypos - prevMouseY;
+  prevMouseX = xpos;
+  prevMouseY = ypos;
 }
 
 void
@@ -317,11 +393,8 @@ GlfwRenderWindowImpl::glfw_scroll_callback(GLFWwindow* window,
                                            double xOffset,
                                            double yOffset)
 {
-  if (m_parent->m_interactor != nullptr) {
-    m_parent->m_interactor->OnMouseWheelScrolled(yOffset);
-
-    draw();
-  }
+  // Accumulate until the next frame (see processInput())
+  m_scrollDelta += yOffset;
 }
 
 void
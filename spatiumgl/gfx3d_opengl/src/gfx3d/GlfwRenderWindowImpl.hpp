@@ -46,12 +46,18 @@ public:
 
 protected:
   void draw();
-  // void processUserInput();
+
+  /// Pass input accumulated since the last call to the interactor.
+  ///
+  /// Mouse movements and scrolls are accumulated by the callbacks, so that
+  /// all events received during a frame result in a single camera update.
+  void processInput();
 
   // GLFW callback functions
   void glfw_framebuffer_size_callback(GLFWwindow* window,
                                       int width,
                                       int height);
+  void glfw_window_refresh_callback(GLFWwindow* window);
   void glfw_mouse_button_callback(GLFWwindow* window,
                                   int button,
                                   int action,
@@ -67,9 +73,13 @@ protected:
 
   GlfwRenderWindow* m_parent;
   GLFWwindow* m_window;
+  GLuint m_frameUbo; // Uniform Buffer Object of the frame context
   double m_drawTime;
+  bool m_drawTimeValid; // Previous frame was drawn right before (no waiting)
   int prevMouseState = GLFW_RELEASE;
   double prevMouseX, prevMouseY;
+  double m_mouseDeltaX, m_mouseDeltaY; // Accumulated mouse movement
+  double m_scrollDelta;                // Accumulated scroll offset
 };
 
 } // namespace gfx3d
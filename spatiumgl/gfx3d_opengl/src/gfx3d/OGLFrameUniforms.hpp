@@ -0,0 +1,86 @@
+/*
+ * Program: Spatium Graphics Library
+ *
+ * Copyright (C) Martijn Koopman
+ * All Rights Reserved
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.
+ *
+ */
+
+#ifndef SPATIUMGL_GFX3D_OGLFRAMEUNIFORMS_H
+#define SPATIUMGL_GFX3D_OGLFRAMEUNIFORMS_H
+
+#include "spatiumgl/gfx3d/FrameContext.hpp"
+
+#include <cstring> // std::memcpy
+
+namespace spgl {
+namespace gfx3d {
+
+/// GLSL declaration of the uniform block with the frame context.
+///
+/// Insert in shader sources after the version directive. The block is bound
+/// to frameUniformBinding by OGLShaderProgram at link time.
+#define SPATIUMGL_GLSL_FRAME_BLOCK                                            \
+  "layout(std140) uniform Frame\n"                                            \
+  "{\n"                                                                       \
+  "  mat4 view;\n"                                                            \
+  "  mat4 projection;\n"                                                      \
+  "  vec4 cameraPosition;\n"                                                  \
+  "  vec2 viewportSize;\n"                                                    \
+  "  float distanceScreen;\n"                                                 \
+  "};\n"
+
+/// Name of the frame uniform block
+static const char* const frameUniformBlock = "Frame";
+
+/// Uniform buffer binding point of the frame uniform block
+static const unsigned int frameUniformBinding = 0;
+
+/// \struct OGLFrameUniforms
+/// \brief Contents of the frame uniform block (std140 layout).
+struct OGLFrameUniforms
+{
+  float view[16];
+  float projection[16];
+  float cameraPosition[4];
+  float viewportSize[2];
+  float distanceScreen;
+  float padding;
+
+  /// Create from frame context.
+  ///
+  /// \param[in] frame Frame context
+  /// \return Uniforms
+  static OGLFrameUniforms fromFrameContext(const FrameContext& frame)
+  {
+    OGLFrameUniforms uniforms;
+    const Matrix4f view = frame.view.staticCast<float>();
+    const Matrix4f projection = frame.projection.staticCast<float>();
+    std::memcpy(uniforms.view, view.data(), sizeof(uniforms.view));
+    std::memcpy(
+      uniforms.projection, projection.data(), sizeof(uniforms.projection));
+    for (size_t i = 0; i < 3; i++) {
+      uniforms.cameraPosition[i] = static_cast<float>(frame.cameraPosition[i]);
+    }
+    uniforms.cameraPosition[3] = 1;
+    uniforms.viewportSize[0] = static_cast<float>(frame.size.x());
+    uniforms.viewportSize[1] = static_cast<float>(frame.size.y());
+    // Points are only scaled with distance in perspective projection
+    uniforms.distanceScreen =
+      frame.perspective ? static_cast<float>(frame.distanceScreen) : 0.0f;
+    uniforms.padding = 0;
+    return uniforms;
+  }
+};
+
+static_assert(sizeof(OGLFrameUniforms) == 160,
+              "OGLFrameUniforms does not match the std140 layout");
+
+} // namespace gfx3d
+} // namespace spgl
+
+#endif // SPATIUMGL_GFX3D_OGLFRAMEUNIFORMS_H
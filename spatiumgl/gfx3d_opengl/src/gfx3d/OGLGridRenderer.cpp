@@ -12,6 +12,7 @@
 
 #include <GL/glew.h>
 
+#include "OGLFrameUniforms.hpp"
 #include "spatiumgl/gfx3d/OGLGridRenderer.hpp"
 
 #include <iostream>
@@ -25,11 +26,9 @@ OGLGridRenderer::OGLGridRenderer(const Grid* grid)
   , m_ebo(0)
 {
   std::string vertexShaderSrc =
-    "#version 330 core\n"
+    "#version 330 core\n" SPATIUMGL_GLSL_FRAME_BLOCK
     "layout(location = 0) in vec3 aPos;\n"
     "uniform mat4 model;\n"
-    "uniform mat4 view;\n"
-    "uniform mat4 projection;\n"
     "void main()\n"
     "{\n"
     "gl_Position = projection * view * model * vec4(aPos.xyz, 1.0);\n"
@@ -157,34 +156,13 @@ OGLGridRenderer::render(spgl::gfx3d::Camera* camera, const Vector2i& size)
   m_shaderProgram.use();
 
   {
-    // Set model matrix
-    const spgl::Matrix4 modelMatrix = m_renderObject->transform().matrix();
-    int modelMatrixLoc =
-      glGetUniformLocation(m_shaderProgram.shaderProgamId(), "model");
-    const spgl::Matrix4f modelMatrixF = modelMatrix.staticCast<float>();
-    glUniformMatrix4fv(modelMatrixLoc, 1, GL_FALSE, modelMatrixF.data());
-  }
-
-  {
-    // Set view matrix
-    const spgl::Matrix4 viewMatrix =
-      camera->transform().matrix().inverse(); // MAY THROW EXCEPTION!
-    int viewMatrixLoc =
-      glGetUniformLocation(m_shaderProgram.shaderProgamId(), "view");
-    const spgl::Matrix4f viewMatrixF = viewMatrix.staticCast<float>();
-    glUniformMatrix4fv(viewMatrixLoc, 1, GL_FALSE, viewMatrixF.data());
-  }
-
-  {
-    // Set projection matrix
-    const spgl::Matrix4 projectionMatrix =
-      camera->projectionMatrix(static_cast<double>(size.x()) / size.y());
-    int projectionMatrixLoc =
-      glGetUniformLocation(m_shaderProgram.shaderProgamId(), "projection");
-    const spgl::Matrix4f projectionMatrixF =
-      projectionMatrix.staticCast<float>();
-    glUniformMatrix4fv(
-      projectionMatrixLoc, 1, GL_FALSE, projectionMatrixF.data());
+    // Set model matrix (view and projection are in the frame uniform block)
+    const Matrix4f modelMatrix =
+      m_renderObject->transform().matrix().staticCast<float>();
+    glUniformMatrix4fv(m_shaderProgram.uniformLocation("model"),
+                       1,
+                       GL_FALSE,
+                       modelMatrix.data());
   }
 
   // Bind vertex array object
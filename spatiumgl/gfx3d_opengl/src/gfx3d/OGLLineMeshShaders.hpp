@@ -10,16 +10,17 @@
  *
  */
 
+#include "OGLFrameUniforms.hpp"
+
 namespace spgl {
 namespace gfx3d {
 
 const char* vertexShaderSrc = R"(
 #version 330 core
+)" SPATIUMGL_GLSL_FRAME_BLOCK R"(
 layout(location = 0) in vec3 aPos;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
 
 void main()
 {
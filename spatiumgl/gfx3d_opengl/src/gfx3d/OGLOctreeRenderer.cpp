@@ -19,15 +19,15 @@
 
 #include <array> // std::array
 #include <iostream>
-#include <queue> // std::queue
 #include <string>
-#include <utility> // std::pair
 
 namespace spgl {
 namespace gfx3d {
 
 OGLOctreeRenderer::OGLOctreeRenderer(const OctreeObject* octObj)
   : OGLRenderer(octObj)
+  , m_cubeCount(0)
+  , m_chunks()
   , m_ebo(0)
   , m_instanceVbo(0)
 {
@@ -78,28 +78,21 @@ OGLOctreeRenderer::OGLOctreeRenderer(const OctreeObject* octObj)
   std::vector<float> radii;
   const idx::Octree& octree = octObj->octree();
 
-  // Traverse octree tree breadth-first (queue)
-  // Push root node + bounds onto queue
-  std::queue<std::pair<const idx::OctreeNode*, BoundingCube>> queue;
-  queue.push({ octree.root(), octree.bounds() });
-  while (!queue.empty()) {
-    // Pop node + bounds from queue
-    const idx::OctreeNode* node = queue.front().first;
-    const BoundingCube bounds = queue.front().second;
-    queue.pop();
+  // Traverse octree depth-first; bounds are derived from the parent.
+  // In depth-first order the subtree of a node is contiguous. Every node up
+  // to the chunk depth starts a chunk, that holds its subtree below the chunk
+  // depth.
+  offsets.reserve(octree.nodeCount());
+  radii.reserve(octree.nodeCount());
+  for (const idx::OctreeEntry& entry : octree.depthFirst()) {
+    if (entry.depth <= s_chunkDepth) {
+      m_chunks.push_back({ entry.bounds, offsets.size(), 0 });
+    }
+    m_chunks.back().count++;
 
     // Get offset and radius for instance of cube rendering
-    offsets.push_back(bounds.center().staticCast<float>());
-    radii.push_back(bounds.radius());
-
-    // Push children on the queue (if any)
-    for (size_t i = 0; i < 8; i++) {
-      const idx::OctreeNode* child = node->child(i);
-      if (child != nullptr) {
-		// Compute bounds for child
-        queue.push({ child, idx::Octree::computeChildBounds(bounds, i) });
-	  }
-	}
+    offsets.push_back(entry.bounds.center().staticCast<float>());
+    radii.push_back(static_cast<float>(entry.bounds.radius()));
   }
   m_cubeCount = offsets.size();
 
@@ -164,45 +157,69 @@ OGLOctreeRenderer::render(Camera* camera, const Vector2i& size)
   m_shaderProgram.use();
 
   {
-    // Set model matrix
-    const Matrix4 modelMatrix = m_renderObject->transform().matrix();
-    int modelMatrixLoc =
-      glGetUniformLocation(m_shaderProgram.shaderProgamId(), "model");
-    const Matrix4f modelMatrixF = modelMatrix.staticCast<float>();
-    glUniformMatrix4fv(modelMatrixLoc, 1, GL_FALSE, modelMatrixF.data());
-  }
-
-  {
-    // Set view matrix
-    const Matrix4 viewMatrix =
-      camera->transform().matrix().inverse(); // MAY THROW EXCEPTION!
-    int viewMatrixLoc =
-      glGetUniformLocation(m_shaderProgram.shaderProgamId(), "view");
-    const Matrix4f viewMatrixF = viewMatrix.staticCast<float>();
-    glUniformMatrix4fv(viewMatrixLoc, 1, GL_FALSE, viewMatrixF.data());
-  }
-
-  {
-    // Set projection matrix
-    const Matrix4 projectionMatrix =
-      camera->projectionMatrix(static_cast<double>(size.x()) / size.y());
-    int projectionMatrixLoc =
-      glGetUniformLocation(m_shaderProgram.shaderProgamId(), "projection");
-    const Matrix4f projectionMatrixF = projectionMatrix.staticCast<float>();
-    glUniformMatrix4fv(
-      projectionMatrixLoc, 1, GL_FALSE, projectionMatrixF.data());
+    // Set model matrix (view and projection are in the frame uniform block)
+    const Matrix4f modelMatrix =
+      m_renderObject->transform().matrix().staticCast<float>();
+    glUniformMatrix4fv(m_shaderProgram.uniformLocation("model"),
+                       1,
+                       GL_FALSE,
+                       modelMatrix.data());
   }
 
   // Bind vertex array object
   glBindVertexArray(m_vao);
 
-  // Draw
-  glDrawElementsInstanced(
-    GL_LINES, 24, GL_UNSIGNED_INT, nullptr, m_cubeCount);
+  // Draw visible chunks; consecutive visible chunks in a single draw call
+  glBindBuffer(GL_ARRAY_BUFFER, m_instanceVbo);
+  size_t first = 0;
+  size_t count = 0;
+  for (const Chunk& chunk : m_chunks) {
+    if (!isChunkVisible(chunk.bounds)) {
+      drawCubes(first, count);
+      count = 0;
+      continue;
+    }
+    if (count == 0) {
+      first = chunk.first;
+    }
+    count += chunk.count;
+  }
+  drawCubes(first, count);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
 
   // Unbind vertex array object
   glBindVertexArray(0);
 }
 
+void
+OGLOctreeRenderer::drawCubes(size_t first, size_t count)
+{
+  if (count == 0) {
+    return;
+  }
+
+  // Point the instance attributes at the first cube (no base instance in
+  // OpenGL 4.0)
+  glVertexAttribPointer(1,
+                        3,
+                        GL_FLOAT,
+                        GL_FALSE,
+                        3 * sizeof(float),
+                        (void*)(sizeof(float) * 3 * first));
+  glVertexAttribPointer(
+    2,
+    1,
+    GL_FLOAT,
+    GL_FALSE,
+    sizeof(float),
+    (void*)(sizeof(float) * (3 * m_cubeCount + first)));
+
+  glDrawElementsInstanced(GL_LINES,
+                          24,
+                          GL_UNSIGNED_INT,
+                          nullptr,
+                          static_cast<GLsizei>(count));
+}
+
 } // namespace gfx3d
 } // namespace spgl
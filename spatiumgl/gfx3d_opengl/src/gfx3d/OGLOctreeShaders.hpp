@@ -10,6 +10,8 @@
  *
  */
 
+#include "OGLFrameUniforms.hpp"
+
 namespace spgl {
 namespace gfx3d {
 
@@ -17,13 +19,12 @@ namespace gfx3d {
 // layout(location = 2) in float aRadius;
 const char* octreeVertexShader = R"(
 #version 330 core
+)" SPATIUMGL_GLSL_FRAME_BLOCK R"(
 layout(location = 0) in vec3 aPos;
 layout(location = 1) in vec3 aOffset;
 layout(location = 2) in float aRadius;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
 
 void main()
 {
@@ -13,11 +13,14 @@
 #include <GL/glew.h>
 
 #include "OGLPointCloudShaders.hpp"
+#include "OGLPointFormats.hpp"
 #include "spatiumgl/gfx3d/OGLPointCloudRenderer.hpp"
 #include "spatiumgl/gfx3d/PerspectiveCamera.hpp"
-#include "spatiumgl/Color.hpp"
 
+#include <algorithm> // std::max
+#include <cmath>     // std::ceil
 #include <iostream>
+#include <limits> // std::numeric_limits
 #include <string>
 
 namespace spgl {
@@ -28,13 +31,28 @@ OGLPointCloudRenderer::OGLPointCloudRenderer(
   const PointCloudRenderOptions& renderOptions)
   : OGLRenderer(pcObj)
   , m_renderOptions(renderOptions)
+  , m_colorLut()
+  , m_chunks()
+  , m_buffers()
+  , m_attribute(Attribute::None)
+  , m_scalarRange()
+  , m_budgetController(renderOptions.targetFrameTime)
+  , m_drawnPointCount(0)
+  , m_reduced(false)
+  , m_unbudgeted(false)
+  , m_dirtyChunkCount(0)
+  , m_budgetChunks()
 {
   std::string vertexShaderSrc;
   std::string fragmentShaderSrc;
 
+  const PointCloudData& data = pcObj->pointCloud().data();
   if (m_renderOptions.colorMethod == RGB &&
       pcObj->pointCloud().header().hasColors()) {
     // Color by RGB
+    m_attribute = (m_renderOptions.packColors || !data.packedColors().empty())
+                    ? Attribute::PackedColors
+                    : Attribute::Colors;
     if (m_renderOptions.pointScaleWorld) {
       vertexShaderSrc = std::string(vertexShaderWorldSizeRGB);
     } else {
@@ -44,6 +62,8 @@ OGLPointCloudRenderer::OGLPointCloudRenderer(
   } else if (m_renderOptions.colorMethod == Scalar &&
              pcObj->pointCloud().header().hasScalars()) {
     // Color by scalar
+    m_attribute = Attribute::Scalars;
+    m_scalarRange = data.scalars().range();
     if (m_renderOptions.pointScaleWorld) {
       vertexShaderSrc = std::string(vertexShaderWorldSizeScalar);
     } else {
@@ -72,93 +92,8 @@ OGLPointCloudRenderer::OGLPointCloudRenderer(
     return;
   }
 
-  // Create vertex array object (VAO) and bind
-  glGenVertexArrays(1, &m_vao);
-  glBindVertexArray(m_vao);
-
-  // Create vertex buffer object (VBO) and bind
-  glGenBuffers(1, &m_vbo);
-  glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-
-  const size_t pointCount = pcObj->pointCloud().data().positions().size();
-  // Allocate vertex attributes buffer
-  const size_t pointBufferSize = pointCount * sizeof(float) * 3;
-  if (m_renderOptions.colorMethod == RGB &&
-      pcObj->pointCloud().data().colors().size() == pointCount) {
-
-    // Allocate vertex attributes buffer for points positions + colors
-    glBufferData(GL_ARRAY_BUFFER, 2 * pointBufferSize, nullptr, GL_STATIC_DRAW);
-
-    // Fill vertex attributes buffer with positions
-    glBufferSubData(GL_ARRAY_BUFFER,
-                    0,
-                    pointBufferSize,
-                    (void*)pcObj->pointCloud().data().positions().data());
-    // Fill vertex attributes buffer with colors
-    glBufferSubData(GL_ARRAY_BUFFER,
-                    pointBufferSize,
-                    pointBufferSize,
-                    (void*)pcObj->pointCloud().data().colors().data());
-
-    // Specify vertex attribute format for point position, and enable
-    glVertexAttribPointer(
-      0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)nullptr);
-    glEnableVertexAttribArray(0);
-
-    // Specify vertex attribute format for point color, and enable
-    glVertexAttribPointer(
-      1, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)(pointBufferSize));
-    glEnableVertexAttribArray(1);
-  } else if (m_renderOptions.colorMethod == Scalar &&
-             pcObj->pointCloud().data().scalars().values().size() ==
-               pointCount) {
-
-    const size_t scalarsBufferSize = pointCount * sizeof(float);
-
-    // Allocate vertex attributes buffer for point positions + scalars
-    glBufferData(GL_ARRAY_BUFFER,
-                 pointBufferSize + scalarsBufferSize,
-                 nullptr,
-                 GL_STATIC_DRAW);
-
-    // Fill vertex attributes buffer with positions
-    glBufferSubData(GL_ARRAY_BUFFER,
-                    0,
-                    pointBufferSize,
-                    (void*)pcObj->pointCloud().data().positions().data());
-    // Fill vertex attributes buffer with scalars
-    glBufferSubData(
-      GL_ARRAY_BUFFER,
-      pointBufferSize,
-      scalarsBufferSize,
-      (void*)pcObj->pointCloud().data().scalars().values().data());
-
-    // Specify vertex attribute format for point position, and enable
-    glVertexAttribPointer(
-      0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)nullptr);
-    glEnableVertexAttribArray(0);
-
-    // Specify vertex attribute format for point color, and enable
-    glVertexAttribPointer(
-      1, 1, GL_FLOAT, GL_FALSE, sizeof(float), (void*)(pointBufferSize));
-    glEnableVertexAttribArray(1);
-
-  } else {
-    // Allocate vertex attributes buffer for point positions
-    glBufferData(GL_ARRAY_BUFFER,
-                 pointBufferSize,
-                 pcObj->pointCloud().data().positions().data(),
-                 GL_STATIC_DRAW);
-
-    // Specify strucutre of a single vertex attribute, and enable
-    glVertexAttribPointer(
-      0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)nullptr);
-    glEnableVertexAttribArray(0);
-  }
-
-  // Unbind for now to prevent unintended overwriting
-  glBindBuffer(GL_ARRAY_BUFFER, 0);
-  glBindVertexArray(0);
+  // Split in chunks; vertex buffers are created and filled in render()
+  extendChunks();
 
   if (m_renderOptions.pointScaleWorld) {
     glEnable(GL_PROGRAM_POINT_SIZE);
@@ -169,8 +104,10 @@ OGLPointCloudRenderer::OGLPointCloudRenderer(
 
 OGLPointCloudRenderer::~OGLPointCloudRenderer()
 {
-  glDeleteVertexArrays(1, &m_vao);
-  glDeleteBuffers(1, &m_vbo);
+  for (const ChunkBuffer& buffer : m_buffers) {
+    glDeleteVertexArrays(1, &buffer.vao);
+    glDeleteBuffers(1, &buffer.vbo);
+  }
 }
 
 const PointCloudObject*
@@ -179,86 +116,369 @@ OGLPointCloudRenderer::pointCloudObject() const
   return static_cast<const PointCloudObject*>(m_renderObject);
 }
 
+size_t
+OGLPointCloudRenderer::uploadedChunkCount() const
+{
+  return m_chunks.size() - m_dirtyChunkCount;
+}
+
+void
+OGLPointCloudRenderer::updatePoints(size_t first, size_t count)
+{
+  const std::pair<size_t, size_t> range =
+    PointCloudChunk::overlapping(m_chunks, first, count);
+  for (size_t i = range.first; i < range.second; i++) {
+    if (!m_buffers[i].dirty) {
+      m_buffers[i].dirty = true;
+      m_dirtyChunkCount++;
+    }
+  }
+}
+
+bool
+OGLPointCloudRenderer::needsRedraw() const
+{
+  return m_dirtyChunkCount > 0 || m_reduced || m_unbudgeted;
+}
+
+std::vector<PointBudgetRequest>
+OGLPointCloudRenderer::pointBudgetRequests()
+{
+  std::vector<PointBudgetRequest> requests;
+  m_budgetChunks.clear();
+  for (size_t i = 0; i < m_buffers.size(); i++) {
+    if (m_buffers[i].vao != 0 && testChunk(m_chunks[i].bounds)) {
+      requests.push_back(
+        { m_buffers[i].count, chunkWeight(m_chunks[i].bounds) });
+      m_budgetChunks.push_back(i);
+    }
+  }
+  return requests;
+}
+
+size_t
+OGLPointCloudRenderer::gpuMemoryUsage() const
+{
+  const size_t pointCount =
+    m_chunks.empty() ? 0 : m_chunks.back().first + m_chunks.back().count;
+  return pointCount *
+         (positionSize(m_renderOptions.positionFormat) + attributeSize());
+}
+
+size_t
+OGLPointCloudRenderer::attributeSize() const
+{
+  switch (m_attribute) {
+    case Attribute::Colors:
+      return 3 * sizeof(float);
+    case Attribute::PackedColors:
+      return sizeof(Rgba8);
+    case Attribute::Scalars:
+      return scalarSize(m_renderOptions.scalarFormat);
+    default:
+      return 0;
+  }
+}
+
 void
 OGLPointCloudRenderer::render(Camera* camera, const Vector2i& size)
 {
+  extendChunks();
+
   m_shaderProgram.use();
 
   {
-    // Set model matrix
-    const Matrix4 modelMatrix = m_renderObject->transform().matrix();
-    int modelMatrixLoc =
-      glGetUniformLocation(m_shaderProgram.shaderProgamId(), "model");
-    const Matrix4f modelMatrixF = modelMatrix.staticCast<float>();
-    glUniformMatrix4fv(modelMatrixLoc, 1, GL_FALSE, modelMatrixF.data());
+    // Set model matrix (view and projection are in the frame uniform block)
+    const Matrix4f modelMatrix =
+      m_renderObject->transform().matrix().staticCast<float>();
+    glUniformMatrix4fv(m_shaderProgram.uniformLocation("model"),
+                       1,
+                       GL_FALSE,
+                       modelMatrix.data());
   }
 
-  {
-    // Set view matrix
-    const Matrix4 viewMatrix =
-      camera->transform().matrix().inverse(); // MAY THROW EXCEPTION!
-    int viewMatrixLoc =
-      glGetUniformLocation(m_shaderProgram.shaderProgamId(), "view");
-    const Matrix4f viewMatrixF = viewMatrix.staticCast<float>();
-    glUniformMatrix4fv(viewMatrixLoc, 1, GL_FALSE, viewMatrixF.data());
+  if (m_renderOptions.pointScaleWorld) {
+    // Distance to screen is in the frame uniform block
+    glUniform1f(m_shaderProgram.uniformLocation("pointSize"),
+                m_renderOptions.pointSize);
+  } else {
+    glPointSize(m_renderOptions.pointSize);
   }
 
-  {
-    // Set projection matrix
-    const Matrix4 projectionMatrix =
-      camera->projectionMatrix(static_cast<double>(size.x()) / size.y());
-    int projectionMatrixLoc =
-      glGetUniformLocation(m_shaderProgram.shaderProgamId(), "projection");
-    const Matrix4f projectionMatrixF = projectionMatrix.staticCast<float>();
-    glUniformMatrix4fv(
-      projectionMatrixLoc, 1, GL_FALSE, projectionMatrixF.data());
+  if (m_renderOptions.colorMethod == Scalar) {
+    // Set color ramp range
+    const int colorRampRangeLoc =
+      m_shaderProgram.uniformLocation("colorramp_range");
+    std::array<float, 2> range =
+      pointCloudObject()->pointCloud().data().scalars().range();
+    if (m_renderOptions.scalarFormat == PointScalarFormat::Float32) {
+      glUniform1fv(colorRampRangeLoc, 2, range.data());
+    } else {
+      // Quantized scalars are normalized over the quantization range. It is
+      // widened geometrically while points are appended, so all points are
+      // quantized again only a logarithmic number of times.
+      const std::array<float, 2> widened =
+        widenScalarRange(m_scalarRange, range);
+      if (widened != m_scalarRange) {
+        m_scalarRange = widened;
+        updatePoints(0, std::numeric_limits<size_t>::max()); // All points
+      }
+      std::array<float, 2> normalized = { { 0, 1 } };
+      const float width = m_scalarRange[1] - m_scalarRange[0];
+      if (width > 0) {
+        normalized[0] = (range[0] - m_scalarRange[0]) / width;
+        normalized[1] = (range[1] - m_scalarRange[0]) / width;
+      }
+      glUniform1fv(colorRampRangeLoc, 2, normalized.data());
+    }
 
-    if (m_renderOptions.pointScaleWorld) {
+    // Rebuild color lookup table only if the range changed
+    if (m_colorLut.size() == 0 || m_colorLut.min() != range[0] ||
+        m_colorLut.max() != range[1]) {
+      m_colorLut = ColorLut(ColorRampT<float>::spectral(range[0], range[1]),
+                            32); // Number of colors must match shader
+    }
 
-      const PerspectiveCamera* perspectiveCamera =
-        dynamic_cast<PerspectiveCamera*>(camera);
+    // Set color ramp colors
+    const int colorRampColorsLoc =
+      m_shaderProgram.uniformLocation("colorramp_colors");
+    glUniform4fv(colorRampColorsLoc,
+                 static_cast<GLsizei>(m_colorLut.size()),
+                 m_colorLut.colors().data()->data());
+  }
 
-      if (perspectiveCamera != nullptr) {
-        float distanceScreen = size.y() * projectionMatrix[1][1]; // 1/tan(a/2)
-        int distanceScreenLoc = glGetUniformLocation(
-          m_shaderProgram.shaderProgamId(), "distanceScreen");
-        glUniform1f(distanceScreenLoc, distanceScreen);
-      }
+  // Upload changed chunks, within the budget (at least one per frame)
+  const size_t vertexSize =
+    positionSize(m_renderOptions.positionFormat) + attributeSize();
+  size_t uploaded = 0;
+  for (size_t i = 0; i < m_chunks.size() && m_dirtyChunkCount > 0; i++) {
+    if (!m_buffers[i].dirty) {
+      continue;
+    }
+    const size_t bytes = m_chunks[i].count * vertexSize;
+    if (uploaded > 0 && uploaded + bytes > m_renderOptions.uploadBudget) {
+      break; // Next frame
+    }
+    upload(m_chunks[i], m_buffers[i]);
+    uploaded += bytes;
+  }
 
-      {
-        int pointSizeLoc =
-          glGetUniformLocation(m_shaderProgram.shaderProgamId(), "pointSize");
-        glUniform1f(pointSizeLoc, m_renderOptions.pointSize);
-      }
-    } else {
-      glPointSize(m_renderOptions.pointSize);
+  // Share of the point budget of the render window per chunk. Chunks
+  // uploaded after the budget was distributed wait for the next frame, which
+  // is requested even if no chunks are left to upload.
+  m_unbudgeted = m_pointBudgetActive && uploaded > 0;
+  std::vector<size_t> counts(m_buffers.size(), 0);
+  if (!m_pointBudgetActive) {
+    for (size_t i = 0; i < m_buffers.size(); i++) {
+      counts[i] = m_buffers[i].count;
+    }
+  } else if (m_pointAllocation.size() == m_budgetChunks.size()) {
+    for (size_t i = 0; i < m_budgetChunks.size(); i++) {
+      counts[m_budgetChunks[i]] = m_pointAllocation[i];
     }
   }
 
-  if (m_renderOptions.colorMethod == Scalar) {
-	// Set color ramp range
-    int colorRampRangeLoc =
-      glGetUniformLocation(m_shaderProgram.shaderProgamId(), "colorramp_range");
-    std::array<float, 2> range =
-      pointCloudObject()->pointCloud().data().scalars().range();
-    glUniform1fv(colorRampRangeLoc, 2, range.data());
+  // Find uploaded chunks in view
+  std::vector<size_t> visible;
+  size_t visiblePointCount = 0;
+  for (size_t i = 0; i < m_chunks.size(); i++) {
+    if (m_buffers[i].vao != 0 && isChunkVisible(m_chunks[i].bounds)) {
+      visible.push_back(i);
+      visiblePointCount += counts[i];
+    }
+  }
 
-	// Set color ramp colors
-    ColorRampT<float> ramp = ColorRampT<float>::spectral(range[0], range[1]);
-    int colorRampColorsLoc =
-      glGetUniformLocation(m_shaderProgram.shaderProgamId(), "colorramp_colors");
-    glUniform4fv(colorRampColorsLoc, 32, ramp.toArray<32>().data()->data()); // Number of colors must match shader
+  // Adapt the point budget to the frame time, and apply it while
+  // interacting: draw the same fraction of every chunk
+  double fraction = 1;
+  if (m_renderOptions.adaptivePointBudget && m_frame != nullptr) {
+    m_budgetController.update(m_frame->frameTime, m_drawnPointCount);
+    const size_t budget = m_budgetController.budget();
+    if (m_frame->interacting && visiblePointCount > budget) {
+      fraction = static_cast<double>(budget) / visiblePointCount;
+    }
+  }
+  m_reduced = (fraction < 1);
+
+  // Draw chunks (prefixes)
+  m_drawnPointCount = 0;
+  for (size_t i : visible) {
+    const size_t count =
+      m_reduced ? static_cast<size_t>(std::ceil(counts[i] * fraction))
+                : counts[i];
+    if (m_attribute != Attribute::None && !m_buffers[i].filled) {
+      setConstantAttribute();
+    }
+    setPositionUniforms(m_shaderProgram, m_buffers[i].quantization);
+    glBindVertexArray(m_buffers[i].vao);
+    glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(count));
+    m_drawnPointCount += count;
   }
 
-  // Bind vertex array object
-  glBindVertexArray(m_vao);
+  // Unbind vertex array object
+  glBindVertexArray(0);
+}
 
-  // Draw
-  glDrawArrays(
-    GL_POINTS, 0, pointCloudObject()->pointCloud().header().pointCount());
+void
+OGLPointCloudRenderer::setConstantAttribute() const
+{
+  if (m_attribute == Attribute::Scalars) {
+    // Lower bound of the color ramp (quantized scalars are normalized)
+    const float value =
+      m_renderOptions.scalarFormat == PointScalarFormat::Float32
+        ? pointCloudObject()->pointCloud().data().scalars().range()[0]
+        : 0.0f;
+    glVertexAttrib1f(1, value);
+  } else {
+    glVertexAttrib3f(1,
+                     static_cast<float>(m_renderOptions.color[0]),
+                     static_cast<float>(m_renderOptions.color[1]),
+                     static_cast<float>(m_renderOptions.color[2]));
+  }
+}
 
-  // Unbind vertex array object
+void
+OGLPointCloudRenderer::extendChunks()
+{
+  const PointCloudData& data = pointCloudObject()->pointCloud().data();
+  const size_t changed =
+    PointCloudChunk::extend(m_chunks,
+                            data.positions(),
+                            std::max<size_t>(m_renderOptions.chunkSize, 1),
+                            0);
+  if (changed == m_chunks.size()) {
+    return;
+  }
+
+  m_buffers.resize(m_chunks.size(),
+                   { 0, 0, 0, false, false, PositionQuantization() });
+  for (size_t i = changed; i < m_chunks.size(); i++) {
+    if (!m_buffers[i].dirty) {
+      m_buffers[i].dirty = true;
+      m_dirtyChunkCount++;
+    }
+  }
+}
+
+void
+OGLPointCloudRenderer::upload(const PointCloudChunk& chunk,
+                              ChunkBuffer& buffer)
+{
+  const PointCloudData& data = pointCloudObject()->pointCloud().data();
+  const PointPositionFormat positionFormat = m_renderOptions.positionFormat;
+  const size_t pointBufferSize = chunk.count * positionSize(positionFormat);
+  const size_t attributeBufferSize = chunk.count * attributeSize();
+
+  if (buffer.vao == 0) {
+    // Create vertex array object (VAO) and vertex buffer object (VBO)
+    glGenVertexArrays(1, &buffer.vao);
+    glGenBuffers(1, &buffer.vbo);
+  }
+  glBindVertexArray(buffer.vao);
+  glBindBuffer(GL_ARRAY_BUFFER, buffer.vbo);
+
+  if (buffer.count != chunk.count) {
+    // Allocate, or reallocate if the chunk grew
+    glBufferData(GL_ARRAY_BUFFER,
+                 pointBufferSize + attributeBufferSize,
+                 nullptr,
+                 GL_STATIC_DRAW);
+    buffer.count = chunk.count;
+
+    // Specify vertex attribute format for point position, and enable
+    positionAttribute(positionFormat, 0);
+
+    // Specify vertex attribute format for point color or scalar (enabled
+    // once filled)
+    const GLsizei stride = static_cast<GLsizei>(attributeSize());
+    if (m_attribute == Attribute::Colors) {
+      glVertexAttribPointer(
+        1, 3, GL_FLOAT, GL_FALSE, stride, (void*)(pointBufferSize));
+    } else if (m_attribute == Attribute::PackedColors) {
+      glVertexAttribPointer(
+        1, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, (void*)(pointBufferSize));
+    } else if (m_attribute == Attribute::Scalars) {
+      const PointScalarFormat scalarFormat = m_renderOptions.scalarFormat;
+      const GLenum type =
+        scalarFormat == PointScalarFormat::UInt16
+          ? GL_UNSIGNED_SHORT
+          : (scalarFormat == PointScalarFormat::UInt8 ? GL_UNSIGNED_BYTE
+                                                      : GL_FLOAT);
+      glVertexAttribPointer(1,
+                            1,
+                            type,
+                            type == GL_FLOAT ? GL_FALSE : GL_TRUE,
+                            stride,
+                            (void*)(pointBufferSize));
+    }
+  }
+
+  // Quantize relative to the current bounds of the chunk
+  buffer.quantization = positionQuantization(positionFormat, chunk.bounds);
+
+  // Fill vertex attributes buffer with positions
+  uploadPositions(positionFormat,
+                  buffer.quantization,
+                  data.positions().data() + chunk.first,
+                  chunk.count,
+                  0);
+
+  // Fill vertex attributes buffer with colors or scalars (skipped if the
+  // data lacks them, e.g. when appended without)
+  const size_t end = chunk.first + chunk.count;
+  const void* attributes = nullptr;
+  std::vector<Rgba8> packedColors;
+  std::vector<std::uint16_t> scalars16;
+  std::vector<std::uint8_t> scalars8;
+  if (m_attribute == Attribute::Colors && data.colors().size() >= end) {
+    attributes = data.colors().data() + chunk.first;
+  } else if (m_attribute == Attribute::PackedColors) {
+    if (data.packedColors().size() >= end) {
+      attributes = data.packedColors().data() + chunk.first;
+    } else if (data.colors().size() >= end) {
+      packedColors.reserve(chunk.count);
+      for (size_t i = chunk.first; i < end; i++) {
+        packedColors.push_back(packColor(data.colors()[i]));
+      }
+      attributes = packedColors.data();
+    }
+  } else if (m_attribute == Attribute::Scalars &&
+             data.scalars().values().size() >= end) {
+    const float* values = data.scalars().values().data() + chunk.first;
+    const float min = m_scalarRange[0];
+    const float max = m_scalarRange[1];
+    if (m_renderOptions.scalarFormat == PointScalarFormat::UInt16) {
+      scalars16.resize(chunk.count);
+      quantizeScalars(values, chunk.count, min, max, scalars16.data());
+      attributes = scalars16.data();
+    } else if (m_renderOptions.scalarFormat == PointScalarFormat::UInt8) {
+      scalars8.resize(chunk.count);
+      quantizeScalars(values, chunk.count, min, max, scalars8.data());
+      attributes = scalars8.data();
+    } else {
+      attributes = values;
+    }
+  }
+  if (attributes != nullptr) {
+    glBufferSubData(
+      GL_ARRAY_BUFFER, pointBufferSize, attributeBufferSize, attributes);
+  }
+
+  // Never read an attribute that was not written: the constant attribute
+  // set in render() is used instead
+  buffer.filled = (attributes != nullptr);
+  if (buffer.filled) {
+    glEnableVertexAttribArray(1);
+  } else {
+    glDisableVertexAttribArray(1);
+  }
   glBindVertexArray(0);
+
+  // Unbind for now to prevent unintended overwriting
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  buffer.dirty = false;
+  m_dirtyChunkCount--;
 }
 
 } // namespace gfx3d
@@ -10,77 +10,89 @@
  *
  */
 
+#include "OGLFrameUniforms.hpp"
+
 namespace spgl {
 namespace gfx3d {
 
-// Vertex shaders 
+// Vertex shaders
+//
+// Positions are positionOffset + position * positionScale, so the same shaders
+// draw float positions (offset 0, scale 1) and quantized positions (see
+// OGLPointFormats.hpp).
 
-const char* vertexShaderScreenSizeNoColor = R"(
+static const char* vertexShaderScreenSizeNoColor = R"(
 #version 330 core
+)" SPATIUMGL_GLSL_FRAME_BLOCK R"(
 layout(location = 0) in vec3 aPos;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+uniform vec3 positionOffset; // Position of quantized 0
+uniform vec3 positionScale;  // Size of quantized range [0, 1]
 
 void main()
 {
-  gl_Position = projection * view * model * vec4(aPos, 1.0);
+  vec3 position = positionOffset + aPos * positionScale;
+  gl_Position = projection * view * model * vec4(position, 1.0);
 }
 )";
 
-const char* vertexShaderWorldSizeNoColor = R"(
-#version 330 core 
+static const char* vertexShaderWorldSizeNoColor = R"(
+#version 330 core
+)" SPATIUMGL_GLSL_FRAME_BLOCK R"(
 layout (location = 0) in vec3 pos; 
 uniform mat4 model; 
-uniform mat4 view; 
+uniform vec3 positionOffset; // Position of quantized 0
+uniform vec3 positionScale;  // Size of quantized range [0, 1]
 
-uniform mat4 projection; 
-uniform float distanceScreen; 
 uniform float pointSize; 
 
 void main() 
 { 
-  gl_Position = view * model * vec4(pos.xyz, 1.0); 
+  vec3 position = positionOffset + pos * positionScale;
+  gl_Position = view * model * vec4(position, 1.0); 
   gl_PointSize = max(1, pointSize * distanceScreen / -gl_Position.z); 
   gl_Position = projection * gl_Position; 
 }
 )";
 
-const char* vertexShaderScreenSizeScalar = R"(
+static const char* vertexShaderScreenSizeScalar = R"(
 #version 330 core
+)" SPATIUMGL_GLSL_FRAME_BLOCK R"(
 layout(location = 0) in vec3 aPos;
 layout(location = 1) in float scalar; 
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+uniform vec3 positionOffset; // Position of quantized 0
+uniform vec3 positionScale;  // Size of quantized range [0, 1]
 
 out float vertexScalar;
 
 void main()
 {
-  gl_Position = projection * view * model * vec4(aPos, 1.0);
+  vec3 position = positionOffset + aPos * positionScale;
+  gl_Position = projection * view * model * vec4(position, 1.0);
   vertexScalar = scalar;
 }
 )";
 
-const char* vertexShaderWorldSizeScalar = R"(
-#version 330 core 
+static const char* vertexShaderWorldSizeScalar = R"(
+#version 330 core
+)" SPATIUMGL_GLSL_FRAME_BLOCK R"(
 layout (location = 0) in vec3 pos;
 layout(location = 1) in float scalar; 
 uniform mat4 model; 
-uniform mat4 view; 
+uniform vec3 positionOffset; // Position of quantized 0
+uniform vec3 positionScale;  // Size of quantized range [0, 1]
 
-uniform mat4 projection; 
-uniform float distanceScreen; 
 uniform float pointSize; 
 
 out float vertexScalar;
 
 void main() 
 { 
-  gl_Position = view * model * vec4(pos.xyz, 1.0); 
+  vec3 position = positionOffset + pos * positionScale;
+  gl_Position = view * model * vec4(position, 1.0); 
   gl_PointSize = max(1, pointSize * distanceScreen / -gl_Position.z); 
   gl_Position = projection * gl_Position;
 
@@ -88,40 +100,43 @@ void main()
 }
 )";
 
-const char* vertexShaderScreenSizeRGB = R"(
+static const char* vertexShaderScreenSizeRGB = R"(
 #version 330 core
+)" SPATIUMGL_GLSL_FRAME_BLOCK R"(
 layout(location = 0) in vec3 aPos;
 layout(location = 1) in vec3 color; 
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+uniform vec3 positionOffset; // Position of quantized 0
+uniform vec3 positionScale;  // Size of quantized range [0, 1]
 
 out vec3 vertexColor;
 
 void main()
 {
-  gl_Position = projection * view * model * vec4(aPos, 1.0);
+  vec3 position = positionOffset + aPos * positionScale;
+  gl_Position = projection * view * model * vec4(position, 1.0);
   vertexColor = color;
 }
 )";
 
-const char* vertexShaderWorldSizeRGB = R"(
-#version 330 core 
+static const char* vertexShaderWorldSizeRGB = R"(
+#version 330 core
+)" SPATIUMGL_GLSL_FRAME_BLOCK R"(
 layout (location = 0) in vec3 pos; 
 layout (location = 1) in vec3 color; 
 uniform mat4 model; 
-uniform mat4 view; 
+uniform vec3 positionOffset; // Position of quantized 0
+uniform vec3 positionScale;  // Size of quantized range [0, 1]
 
-uniform mat4 projection; 
-uniform float distanceScreen; 
 uniform float pointSize; 
 
 out vec3 vertexColor; 
 
 void main() 
 { 
-  gl_Position = view * model * vec4(pos.xyz, 1.0); 
+  vec3 position = positionOffset + pos * positionScale;
+  gl_Position = view * model * vec4(position, 1.0); 
   gl_PointSize = max(1, pointSize * distanceScreen / -gl_Position.z); 
   gl_Position = projection * gl_Position; 
   vertexColor = color; 
@@ -130,7 +145,7 @@ void main()
 
 // Fragment shaders
 
-const char* fragmentShaderNoColor = R"(
+static const char* fragmentShaderNoColor = R"(
 #version 330 core
 out vec4 FragColor;
 
@@ -140,7 +155,7 @@ void main()
 }
 )";
 
-const char* fragmentShaderScalar = R"(
+static const char* fragmentShaderScalar = R"(
 #version 330 core
 
 in float vertexScalar;
@@ -156,7 +171,7 @@ void main()
 }
 )";
 
-const char* fragmentShaderRGB = R"(
+static const char* fragmentShaderRGB = R"(
 #version 330 core
 
 in vec3 vertexColor;
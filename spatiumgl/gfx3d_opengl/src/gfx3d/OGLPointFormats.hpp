@@ -0,0 +1,110 @@
+/*
+ * Program: Spatium Graphics Library
+ *
+ * Copyright (C) Martijn Koopman
+ * All Rights Reserved
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.
+ *
+ */
+
+#ifndef SPATIUMGL_GFX3D_OGLPOINTFORMATS_H
+#define SPATIUMGL_GFX3D_OGLPOINTFORMATS_H
+
+#include <GL/glew.h>
+
+#include "spatiumgl/gfx3d/OGLShaderProgram.hpp"
+#include "spatiumgl/gfx3d/PointQuantization.hpp"
+
+#include <cstdint> // std::uint16_t, std::uint32_t
+#include <vector>  // std::vector
+
+namespace spgl {
+namespace gfx3d {
+
+/// Get quantization of positions within bounds.
+///
+/// Float positions are not quantized: offset 0 and scale 1.
+///
+/// \param[in] format Position format
+/// \param[in] bounds Bounds of positions
+/// \return Quantization
+inline PositionQuantization
+positionQuantization(PointPositionFormat format, const BoundingBox& bounds)
+{
+  if (format == PointPositionFormat::Float32) {
+    return { Vector3f(0, 0, 0), Vector3f(1, 1, 1) };
+  }
+  return PositionQuantization::fromBounds(bounds);
+}
+
+/// Specify vertex attribute 0 for positions in the bound array buffer.
+///
+/// \param[in] format Position format
+/// \param[in] offset Offset of positions in buffer (bytes)
+inline void
+positionAttribute(PointPositionFormat format, size_t offset)
+{
+  const GLsizei stride = static_cast<GLsizei>(positionSize(format));
+  if (format == PointPositionFormat::UInt16) {
+    glVertexAttribPointer(
+      0, 4, GL_UNSIGNED_SHORT, GL_TRUE, stride, (void*)(offset));
+  } else if (format == PointPositionFormat::UInt10) {
+    glVertexAttribPointer(
+      0, 4, GL_UNSIGNED_INT_2_10_10_10_REV, GL_TRUE, stride, (void*)(offset));
+  } else {
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)(offset));
+  }
+  glEnableVertexAttribArray(0);
+}
+
+/// Fill the bound array buffer with positions, quantized to a format.
+///
+/// \param[in] format Position format
+/// \param[in] quantization Quantization (see positionQuantization())
+/// \param[in] positions Positions
+/// \param[in] count Number of positions
+/// \param[in] offset Offset in buffer (bytes)
+inline void
+uploadPositions(PointPositionFormat format,
+                const PositionQuantization& quantization,
+                const Vector3f* positions,
+                size_t count,
+                size_t offset)
+{
+  const GLsizeiptr size =
+    static_cast<GLsizeiptr>(count * positionSize(format));
+  if (format == PointPositionFormat::UInt16) {
+    std::vector<std::uint16_t> values(4 * count);
+    quantization.quantize16(positions, count, values.data());
+    glBufferSubData(GL_ARRAY_BUFFER, offset, size, (void*)values.data());
+  } else if (format == PointPositionFormat::UInt10) {
+    std::vector<std::uint32_t> values(count);
+    quantization.quantize1010102(positions, count, values.data());
+    glBufferSubData(GL_ARRAY_BUFFER, offset, size, (void*)values.data());
+  } else {
+    glBufferSubData(GL_ARRAY_BUFFER, offset, size, (void*)positions);
+  }
+}
+
+/// Set uniforms positionOffset and positionScale of a point shader program.
+///
+/// \param[in] program Shader program (in use)
+/// \param[in] quantization Quantization of the positions being drawn
+inline void
+setPositionUniforms(const OGLShaderProgram& program,
+                    const PositionQuantization& quantization)
+{
+  glUniform3fv(program.uniformLocation("positionOffset"),
+               1,
+               quantization.offset.data());
+  glUniform3fv(
+    program.uniformLocation("positionScale"), 1, quantization.scale.data());
+}
+
+} // namespace gfx3d
+} // namespace spgl
+
+#endif // SPATIUMGL_GFX3D_OGLPOINTFORMATS_H
@@ -11,9 +11,12 @@
  */
 
 #include "spatiumgl/gfx3d/OGLShaderProgram.hpp"
+#include "OGLFrameUniforms.hpp"
 
 #include <GL/glew.h>
 
+#include <vector> // std::vector
+
 namespace spgl {
 namespace gfx3d {
 
@@ -22,11 +25,17 @@ OGLShaderProgram::OGLShaderProgram()
   , m_fragmentShaderId(0)
   , m_geometryShaderId(0)
   , m_shaderProgramId(0)
+  , m_uniformLocations()
 {}
 
 OGLShaderProgram::OGLShaderProgram(const std::string& vertexShaderSource,
                                    const std::string& fragmentShaderSource,
                                    const std::string& geometryShaderSource)
+  : m_vertexShaderId(0)
+  , m_fragmentShaderId(0)
+  , m_geometryShaderId(0)
+  , m_shaderProgramId(0)
+  , m_uniformLocations()
 {
   createShaderProgram(
     vertexShaderSource, fragmentShaderSource, geometryShaderSource);
@@ -98,9 +107,17 @@ OGLShaderProgram::use()
   glUseProgram(m_shaderProgramId);
 }
 
+int
+OGLShaderProgram::uniformLocation(const std::string& name) const
+{
+  const auto it = m_uniformLocations.find(name);
+  return it != m_uniformLocations.end() ? it->second : -1;
+}
+
 void
 OGLShaderProgram::free()
 {
+  m_uniformLocations.clear();
   if (m_shaderProgramId > 0) {
     glDeleteProgram(m_shaderProgramId);
     m_shaderProgramId = 0;
@@ -150,6 +167,55 @@ OGLShaderProgram::createShaderProgram(const std::string& vertexShaderSource,
   glDeleteShader(m_vertexShaderId);
   glDeleteShader(m_geometryShaderId);
   glDeleteShader(m_fragmentShaderId);
+
+  int linked = 0;
+  glGetProgramiv(m_shaderProgramId, GL_LINK_STATUS, &linked);
+  if (linked == 0) {
+    return; // Reported by validate()
+  }
+
+  // Bind frame uniform block (if used)
+  const GLuint blockIndex =
+    glGetUniformBlockIndex(m_shaderProgramId, frameUniformBlock);
+  if (blockIndex != GL_INVALID_INDEX) {
+    glUniformBlockBinding(m_shaderProgramId, blockIndex, frameUniformBinding);
+  }
+
+  // Cache uniform locations
+  int uniformCount = 0;
+  int maxNameLength = 0;
+  glGetProgramiv(m_shaderProgramId, GL_ACTIVE_UNIFORMS, &uniformCount);
+  glGetProgramiv(
+    m_shaderProgramId, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+  std::vector<char> nameBuffer(static_cast<size_t>(maxNameLength) + 1);
+  for (int i = 0; i < uniformCount; i++) {
+    GLsizei length = 0;
+    GLint size = 0;
+    GLenum type = 0;
+    glGetActiveUniform(m_shaderProgramId,
+                       static_cast<GLuint>(i),
+                       static_cast<GLsizei>(nameBuffer.size()),
+                       &length,
+                       &size,
+                       &type,
+                       nameBuffer.data());
+    const std::string name(nameBuffer.data(), static_cast<size_t>(length));
+    const int location = glGetUniformLocation(m_shaderProgramId, name.c_str());
+    if (location < 0) {
+      continue; // Member of a uniform block
+    }
+    m_uniformLocations[name] = location;
+
+    // Arrays are reported as "name[0]"
+    const std::string arraySuffix("[0]");
+    if (name.size() > arraySuffix.size() &&
+        name.compare(name.size() - arraySuffix.size(),
+                     arraySuffix.size(),
+                     arraySuffix) == 0) {
+      m_uniformLocations[name.substr(0, name.size() - arraySuffix.size())] =
+        location;
+    }
+  }
 }
 
 } // namespace gfx3d
@@ -0,0 +1,217 @@
+/*
+ * Program: Spatium Graphics Library
+ *
+ * Copyright (C) Martijn Koopman
+ * All Rights Reserved
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.
+ *
+ */
+
+#include <GL/glew.h>
+
+#include "OGLPointCloudShaders.hpp"
+#include "OGLPointFormats.hpp"
+#include "spatiumgl/gfx3d/OGLStreamingPointCloudRenderer.hpp"
+
+#include <iostream>
+#include <string>
+
+namespace spgl {
+namespace gfx3d {
+
+OGLStreamingPointCloudRenderer::OGLStreamingPointCloudRenderer(
+  StreamingPointCloudObject* object,
+  const StreamingPointCloudRenderOptions& renderOptions)
+  : OGLRenderer(object)
+  , m_object(object)
+  , m_renderOptions(renderOptions)
+  , m_buffers(renderOptions.gpuMemoryBudget)
+  , m_renderedNodeCount(0)
+  , m_uploadPending(false)
+{
+  // Nodes without colors use a constant color attribute
+  m_shaderProgram.setShaderSources(std::string(vertexShaderScreenSizeRGB),
+                                   std::string(fragmentShaderRGB));
+
+  // Validate shader program
+  std::string errorMessage;
+  if (!m_shaderProgram.validate(errorMessage)) {
+    std::cerr << "[ERROR] fragment shader compilation: " << errorMessage
+              << std::endl;
+    m_valid = false;
+    return;
+  }
+
+  m_valid = true;
+}
+
+OGLStreamingPointCloudRenderer::~OGLStreamingPointCloudRenderer()
+{
+  std::vector<std::pair<LodNodeKey, NodeBuffer>> buffers;
+  m_buffers.clear(&buffers);
+  release(buffers);
+}
+
+const StreamingPointCloudObject*
+OGLStreamingPointCloudRenderer::streamingPointCloudObject() const
+{
+  return m_object;
+}
+
+bool
+OGLStreamingPointCloudRenderer::needsRedraw() const
+{
+  return m_uploadPending || m_object->loadingNodeCount() > 0;
+}
+
+void
+OGLStreamingPointCloudRenderer::render(Camera* camera, const Vector2i& size)
+{
+  const Matrix4 modelMatrix = m_object->transform().matrix();
+  const std::vector<StreamingNode> nodes = m_object->update(
+    m_frame != nullptr ? LodView::fromFrameContext(*m_frame, modelMatrix)
+                       : LodView::fromCamera(*camera, modelMatrix, size));
+
+  m_shaderProgram.use();
+
+  {
+    // Set model matrix (view and projection are in the frame uniform block)
+    const Matrix4f modelMatrixF = modelMatrix.staticCast<float>();
+    glUniformMatrix4fv(m_shaderProgram.uniformLocation("model"),
+                       1,
+                       GL_FALSE,
+                       modelMatrixF.data());
+  }
+
+  glPointSize(m_renderOptions.pointSize);
+
+  // Upload (within budget) and draw nodes
+  m_buffers.nextFrame();
+  m_renderedNodeCount = 0;
+  m_uploadPending = false;
+  size_t uploaded = 0;
+  for (const StreamingNode& node : nodes) {
+    const NodeBuffer* buffer = m_buffers.get(node.key);
+    if (buffer == nullptr) {
+      const size_t bytes =
+        node.data->positions().size() *
+        (positionSize(m_renderOptions.positionFormat) + colorSize(node));
+      if (uploaded > 0 && uploaded + bytes > m_renderOptions.uploadBudget) {
+        m_uploadPending = true;
+        continue; // Next frame
+      }
+      uploaded += bytes;
+      buffer = m_buffers.insert(node.key, upload(node), bytes);
+    }
+
+    if (!buffer->hasColors) {
+      glVertexAttrib3f(1,
+                       static_cast<float>(m_renderOptions.color[0]),
+                       static_cast<float>(m_renderOptions.color[1]),
+                       static_cast<float>(m_renderOptions.color[2]));
+    }
+    setPositionUniforms(m_shaderProgram, buffer->quantization);
+    glBindVertexArray(buffer->vao);
+    glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(buffer->pointCount));
+    m_renderedNodeCount++;
+  }
+  glBindVertexArray(0);
+
+  // Delete vertex buffers of nodes not rendered recently
+  std::vector<std::pair<LodNodeKey, NodeBuffer>> evicted;
+  m_buffers.trim(&evicted);
+  release(evicted);
+}
+
+size_t
+OGLStreamingPointCloudRenderer::colorSize(const StreamingNode& node) const
+{
+  const size_t count = node.data->positions().size();
+  if (node.data->packedColors().size() == count ||
+      (m_renderOptions.packColors && node.data->colors().size() == count)) {
+    return sizeof(Rgba8);
+  }
+  return node.data->colors().size() == count ? 3 * sizeof(float) : 0;
+}
+
+OGLStreamingPointCloudRenderer::NodeBuffer
+OGLStreamingPointCloudRenderer::upload(const StreamingNode& node) const
+{
+  const PointPositionFormat positionFormat = m_renderOptions.positionFormat;
+  const std::vector<Vector3f>& positions = node.data->positions();
+  const size_t colorBytes = colorSize(node);
+
+  const BoundingBox bounds(
+    node.bounds.center(),
+    { node.bounds.radius(), node.bounds.radius(), node.bounds.radius() });
+  NodeBuffer buffer{ 0,
+                     0,
+                     positions.size(),
+                     colorBytes > 0,
+                     positionQuantization(positionFormat, bounds) };
+
+  // Create vertex array object (VAO) and vertex buffer object (VBO)
+  glGenVertexArrays(1, &buffer.vao);
+  glBindVertexArray(buffer.vao);
+  glGenBuffers(1, &buffer.vbo);
+  glBindBuffer(GL_ARRAY_BUFFER, buffer.vbo);
+
+  const size_t pointBufferSize =
+    positions.size() * positionSize(positionFormat);
+  glBufferData(GL_ARRAY_BUFFER,
+               pointBufferSize + positions.size() * colorBytes,
+               nullptr,
+               GL_STATIC_DRAW);
+  uploadPositions(positionFormat,
+                  buffer.quantization,
+                  positions.data(),
+                  positions.size(),
+                  0);
+  positionAttribute(positionFormat, 0);
+
+  if (colorBytes == sizeof(Rgba8)) {
+    std::vector<Rgba8> packedColors;
+    const Rgba8* colors = node.data->packedColors().data();
+    if (node.data->packedColors().size() != positions.size()) {
+      packedColors = packColors(node.data->colors());
+      colors = packedColors.data();
+    }
+    glBufferSubData(GL_ARRAY_BUFFER,
+                    pointBufferSize,
+                    positions.size() * colorBytes,
+                    (void*)colors);
+    glVertexAttribPointer(
+      1, 4, GL_UNSIGNED_BYTE, GL_TRUE, 4, (void*)(pointBufferSize));
+    glEnableVertexAttribArray(1);
+  } else if (colorBytes > 0) {
+    glBufferSubData(GL_ARRAY_BUFFER,
+                    pointBufferSize,
+                    positions.size() * colorBytes,
+                    (void*)node.data->colors().data());
+    glVertexAttribPointer(
+      1, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)(pointBufferSize));
+    glEnableVertexAttribArray(1);
+  }
+
+  // Unbind to prevent unintended overwriting
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glBindVertexArray(0);
+  return buffer;
+}
+
+void
+OGLStreamingPointCloudRenderer::release(
+  std::vector<std::pair<LodNodeKey, NodeBuffer>>& buffers)
+{
+  for (std::pair<LodNodeKey, NodeBuffer>& buffer : buffers) {
+    glDeleteVertexArrays(1, &buffer.second.vao);
+    glDeleteBuffers(1, &buffer.second.vbo);
+  }
+  buffers.clear();
+}
+
+} // namespace gfx3d
+} // namespace spgl
@@ -12,6 +12,7 @@
 
 #include <GL/glew.h>
 
+#include "OGLFrameUniforms.hpp"
 #include "spatiumgl/gfx3d/OGLTriangleRenderer.hpp"
 
 #include <iostream>
@@ -24,10 +25,8 @@ OGLTriangleRenderer::OGLTriangleRenderer()
 {
   // Shader
   std::string vertexShaderSrc(
-    "#version 330 core\n"
+    "#version 330 core\n" SPATIUMGL_GLSL_FRAME_BLOCK
     "layout(location = 0) in vec3 aPos;\n"
-    "uniform mat4 view;\n"
-    "uniform mat4 projection;\n"
     "void main()\n"
     "{\n"
     "gl_Position = projection * view * vec4(aPos, 1.0);\n"
@@ -85,22 +84,7 @@ OGLTriangleRenderer::render(spgl::gfx3d::Camera* camera, const Vector2i& size)
 {
   m_shaderProgram.use();
 
-  // Set view matrix
-  const spgl::Matrix4 viewMatrix =
-    camera->transform().matrix().inverse(); // MAY THROW EXCEPTION!
-  int viewMatrixLoc =
-    glGetUniformLocation(m_shaderProgram.shaderProgamId(), "view");
-  const spgl::Matrix4f viewMatrixF = viewMatrix.staticCast<float>();
-  glUniformMatrix4fv(viewMatrixLoc, 1, GL_FALSE, viewMatrixF.data());
-
-  // Set projection matrix
-  const spgl::Matrix4 projectionMatrix =
-    camera->projectionMatrix(static_cast<double>(size.x()) / size.y());
-  int projectionMatrixLoc =
-    glGetUniformLocation(m_shaderProgram.shaderProgamId(), "projection");
-  const spgl::Matrix4f projectionMatrixF = projectionMatrix.staticCast<float>();
-  glUniformMatrix4fv(
-    projectionMatrixLoc, 1, GL_FALSE, projectionMatrixF.data());
+  // View and projection matrix are in the frame uniform block
 
   // Bind vertex array object
   glBindVertexArray(m_vao);
@@ -0,0 +1,121 @@
+#include <spatiumgl/idx/KdTree.hpp>
+#include <spatiumgl/idx/Octree.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Compare the kd-tree against the octree: build time and k nearest neighbor
+// queries per second on synthetic point clouds.
+//  - Airborne: 1 x 1 km terrain, points spread evenly in XY.
+//  - Mobile mapping: 2 km corridor of 20 m wide, with facades.
+//
+// Usage: idx_bench_kdtree [point_count] [k] [threads]
+
+namespace {
+
+template<typename Function>
+double
+measure(Function function)
+{
+  const auto start = std::chrono::steady_clock::now();
+  function();
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(end - start).count();
+}
+
+class Random
+{
+public:
+  float operator()()
+  {
+    m_seed = m_seed * 1103515245 + 12345;
+    return static_cast<float>((m_seed >> 8) % 1000000) / 1000000;
+  }
+
+private:
+  unsigned int m_seed = 12345;
+};
+
+std::vector<spgl::Vector3f>
+airborne(size_t count)
+{
+  Random random;
+  std::vector<spgl::Vector3f> points(count);
+  for (spgl::Vector3f& point : points) {
+    const float x = random() * 1000;
+    const float y = random() * 1000;
+    point = { x, y, 10 * std::sin(x / 100) + 5 * std::cos(y / 50) };
+  }
+  return points;
+}
+
+std::vector<spgl::Vector3f>
+mobileMapping(size_t count)
+{
+  Random random;
+  std::vector<spgl::Vector3f> points(count);
+  for (spgl::Vector3f& point : points) {
+    const float x = random() * 2000;
+    if (random() < 0.5f) {
+      // Road surface
+      point = { x, random() * 20 - 10, 0.02f * random() };
+    } else {
+      // Facades on both sides
+      const float side = (random() < 0.5f ? -10.0f : 10.0f);
+      point = { x, side + 0.05f * random(), random() * 15 };
+    }
+  }
+  return points;
+}
+
+void
+compare(const std::string& name,
+        const std::vector<spgl::Vector3f>& points,
+        size_t k,
+        size_t threads)
+{
+  std::cout << name << " (" << points.size() << " points, k = " << k
+            << ")" << std::endl;
+  std::vector<spgl::idx::OctreeNeighbor> result(points.size() * k);
+
+  spgl::idx::Octree octree({});
+  const double octreeBuild = measure(
+    [&]() { octree = spgl::idx::Octree::build(points, 32, threads); });
+  const double octreeKnn = measure([&]() {
+    octree.knn(points.data(), points.size(), k, result.data(), threads);
+  });
+  std::cout << "  Octree: build " << octreeBuild * 1000 << " ms, "
+            << static_cast<double>(points.size()) / octreeKnn << " queries/s"
+            << std::endl;
+
+  spgl::idx::KdTree3f kdTree;
+  const double kdTreeBuild = measure(
+    [&]() { kdTree = spgl::idx::KdTree3f::build(points, 16, threads); });
+  const double kdTreeKnn = measure([&]() {
+    kdTree.knn(points.data(), points.size(), k, result.data(), threads);
+  });
+  std::cout << "  KdTree: build " << kdTreeBuild * 1000 << " ms, "
+            << static_cast<double>(points.size()) / kdTreeKnn << " queries/s"
+            << std::endl;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  const size_t count =
+    (argc > 1 ? static_cast<size_t>(std::atol(argv[1])) : 1000000);
+  const size_t k = (argc > 2 ? static_cast<size_t>(std::atol(argv[2])) : 16);
+  const size_t threads =
+    (argc > 3 ? static_cast<size_t>(std::atol(argv[3])) : 0);
+
+  compare("Airborne", airborne(count), k, threads);
+  compare("Mobile mapping", mobileMapping(count), k, threads);
+
+  return 0;
+}
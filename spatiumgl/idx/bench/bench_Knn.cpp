@@ -0,0 +1,53 @@
+#include <spatiumgl/Parallel.hpp>
+#include <spatiumgl/idx/Octree.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+// Measure k nearest neighbor queries per second, for an increasing number
+// of threads. Every point is used as query position, as for normal
+// estimation.
+//
+// Usage: idx_bench_knn [point_count] [k] [max_points_per_leaf]
+
+int
+main(int argc, char* argv[])
+{
+  const size_t count =
+    (argc > 1 ? static_cast<size_t>(std::atol(argv[1])) : 1000000);
+  const size_t k = (argc > 2 ? static_cast<size_t>(std::atol(argv[2])) : 16);
+  const size_t maxPointsPerLeaf =
+    (argc > 3 ? static_cast<size_t>(std::atol(argv[3])) : 64);
+
+  std::vector<spgl::Vector3f> points(count);
+  unsigned int seed = 12345;
+  for (size_t i = 0; i < count; i++) {
+    float coordinates[3];
+    for (size_t axis = 0; axis < 3; axis++) {
+      seed = seed * 1103515245 + 12345;
+      coordinates[axis] = static_cast<float>((seed >> 8) % 100000) / 100;
+    }
+    points[i] = { coordinates[0], coordinates[1], coordinates[2] / 100 };
+  }
+
+  const spgl::idx::Octree octree =
+    spgl::idx::Octree::build(points, maxPointsPerLeaf);
+  std::cout << "Points: " << count << ", k: " << k
+            << ", nodes: " << octree.nodeCount() << std::endl;
+
+  std::vector<spgl::idx::OctreeNeighbor> result(count * k);
+  const size_t maxThreads = spgl::resolveThreadCount(0);
+  for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+    const auto start = std::chrono::steady_clock::now();
+    octree.knn(points.data(), count, k, result.data(), threads);
+    const auto end = std::chrono::steady_clock::now();
+    const double seconds = std::chrono::duration<double>(end - start).count();
+    std::cout << "Octree::knn (" << threads << " threads): "
+              << static_cast<double>(count) / seconds << " queries/s"
+              << std::endl;
+  }
+
+  return 0;
+}
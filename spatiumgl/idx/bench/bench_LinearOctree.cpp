@@ -0,0 +1,124 @@
+#include <spatiumgl/idx/LinearOctree.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <queue>
+
+// Compare the pointer-based octree against the linear octree: memory usage,
+// depth-first traversal and destruction.
+//
+// Usage: idx_bench_linearoctree [node_count]
+
+namespace {
+
+template<typename Function>
+double
+measure(Function function, int repetitions)
+{
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < repetitions; i++) {
+    function();
+  }
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count() /
+         repetitions;
+}
+
+/// Build a sparse octree breadth-first: every node gets the children
+/// selected by a simple pseudo random mask until the node count is reached.
+spgl::idx::Octree
+buildOctree(size_t nodeCount)
+{
+  spgl::idx::Octree octree(spgl::BoundingCube({ 0, 0, 0 }, 1024));
+  std::queue<spgl::idx::OctreeNode*> queue;
+  queue.push(octree.root());
+  size_t count = 1;
+  unsigned int seed = 12345;
+  while (!queue.empty() && count < nodeCount) {
+    spgl::idx::OctreeNode* node = queue.front();
+    queue.pop();
+    seed = seed * 1103515245 + 12345;
+    const unsigned int mask = ((seed >> 16) & 0xff) | 0x01;
+    for (size_t i = 0; i < 8 && count < nodeCount; i++) {
+      if ((mask & (1u << i)) != 0 && node->createChild(i)) {
+        queue.push(node->child(i));
+        count++;
+      }
+    }
+  }
+  return octree;
+}
+
+/// Depth-first traversal of the pointer-based octree with bounds.
+size_t
+traverseOctree(const spgl::idx::Octree& octree)
+{
+  size_t count = 0;
+  std::vector<std::pair<const spgl::idx::OctreeNode*, spgl::BoundingCube>>
+    stack;
+  stack.push_back({ octree.root(), octree.bounds() });
+  while (!stack.empty()) {
+    const auto entry = stack.back();
+    stack.pop_back();
+    count++;
+    for (size_t i = 8; i-- > 0;) {
+      const spgl::idx::OctreeNode* child = entry.first->child(i);
+      if (child != nullptr) {
+        stack.push_back(
+          { child, spgl::idx::Octree::computeChildBounds(entry.second, i) });
+      }
+    }
+  }
+  return count;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  const size_t nodeCount =
+    (argc > 1 ? static_cast<size_t>(std::atol(argv[1])) : 10000000);
+  const int repetitions = 5;
+
+  spgl::idx::Octree octree = buildOctree(nodeCount);
+  const spgl::idx::LinearOctree linear =
+    spgl::idx::LinearOctree::fromOctree(octree);
+  const size_t nodes = linear.nodeCount();
+
+  std::cout << "Nodes: " << nodes << std::endl;
+  std::cout << "Memory Octree: "
+            << nodes * sizeof(spgl::idx::OctreeNode) / 1024 << " KiB"
+            << " (excluding allocator overhead)" << std::endl;
+  std::cout << "Memory LinearOctree: " << linear.memoryUsage() / 1024
+            << " KiB" << std::endl;
+
+  size_t visited = 0;
+  const double traversal =
+    measure([&]() { visited += traverseOctree(octree); }, repetitions);
+  std::cout << "Traverse Octree: " << traversal << " ms" << std::endl;
+
+  const double linearTraversal = measure(
+    [&]() {
+      linear.traverse([&](spgl::idx::LinearOctree::NodeIndex,
+                          const spgl::BoundingCube&,
+                          size_t) {
+        visited++;
+        return true;
+      });
+    },
+    repetitions);
+  std::cout << "Traverse LinearOctree: " << linearTraversal << " ms"
+            << std::endl;
+
+  const auto start = std::chrono::steady_clock::now();
+  octree = spgl::idx::Octree(spgl::BoundingCube({ 0, 0, 0 }, 1));
+  const auto end = std::chrono::steady_clock::now();
+  std::cout << "Destroy Octree: "
+            << std::chrono::duration<double, std::milli>(end - start).count()
+            << " ms" << std::endl;
+
+  // Prevent the traversals from being optimized away
+  return (visited == 0 ? 1 : 0);
+}
@@ -0,0 +1,63 @@
+#include <spatiumgl/Parallel.hpp>
+#include <spatiumgl/idx/Octree.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// Measure octree construction and voxelization from points with Morton codes
+// and a parallel radix sort, for an increasing number of threads.
+//
+// Usage: idx_bench_octreebuild [point_count] [max_points_per_leaf]
+
+int
+main(int argc, char* argv[])
+{
+  const size_t count =
+    (argc > 1 ? static_cast<size_t>(std::atol(argv[1])) : 10000000);
+  const size_t maxPointsPerLeaf =
+    (argc > 2 ? static_cast<size_t>(std::atol(argv[2])) : 10000);
+
+  std::vector<spgl::Vector3f> points(count);
+  unsigned int seed = 12345;
+  for (size_t i = 0; i < count; i++) {
+    float coordinates[3];
+    for (size_t axis = 0; axis < 3; axis++) {
+      seed = seed * 1103515245 + 12345;
+      coordinates[axis] = static_cast<float>((seed >> 8) % 100000) / 100;
+    }
+    // Terrain-like: z depends on x and y
+    const float z =
+      (coordinates[0] + coordinates[1]) / 20 + coordinates[2] / 100;
+    points[i] = { coordinates[0], coordinates[1], z };
+  }
+
+  std::cout << "Points: " << count << std::endl;
+
+  const size_t maxThreads = spgl::resolveThreadCount(0);
+  for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+    const auto start = std::chrono::steady_clock::now();
+    const spgl::idx::Octree octree =
+      spgl::idx::Octree::build(points, maxPointsPerLeaf, threads);
+    const auto end = std::chrono::steady_clock::now();
+    std::cout << "Octree::build (" << threads << " threads): "
+              << std::chrono::duration<double, std::milli>(end - start).count()
+              << " ms, " << octree.nodeCount() << " nodes" << std::endl;
+  }
+
+  // Occupancy octree with voxels of 1 x 1 x 1
+  const spgl::BoundingCube bounds({ 500, 500, 500 }, 512);
+  for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+    const auto start = std::chrono::steady_clock::now();
+    const spgl::idx::Octree octree =
+      spgl::idx::Octree::fromPoints(points, bounds, 10, threads);
+    const auto end = std::chrono::steady_clock::now();
+    std::cout << "Octree::fromPoints (" << threads << " threads): "
+              << std::chrono::duration<double, std::milli>(end - start).count()
+              << " ms, " << octree.nodeCount() << " nodes" << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,101 @@
+#include <spatiumgl/idx/OctreeHierarchyFile.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <queue>
+
+// Compare reading the breadth-first octree file against opening the paged
+// hierarchy file and accessing one leaf, and loading it entirely.
+//
+// Usage: idx_bench_hierarchyfile [node_count]
+
+namespace {
+
+template<typename Function>
+double
+measure(Function function)
+{
+  const auto start = std::chrono::steady_clock::now();
+  function();
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+/// Build a sparse octree breadth-first until the node count is reached.
+spgl::idx::Octree
+buildOctree(size_t nodeCount)
+{
+  spgl::idx::Octree octree(spgl::BoundingCube({ 0, 0, 0 }, 1024));
+  std::queue<spgl::idx::OctreeNode*> queue;
+  queue.push(octree.root());
+  size_t count = 1;
+  unsigned int seed = 12345;
+  while (!queue.empty() && count < nodeCount) {
+    spgl::idx::OctreeNode* node = queue.front();
+    queue.pop();
+    seed = seed * 1103515245 + 12345;
+    const unsigned int mask = ((seed >> 16) & 0xff) | 0x01;
+    for (size_t i = 0; i < 8 && count < nodeCount; i++) {
+      if ((mask & (1u << i)) != 0 && node->createChild(i)) {
+        queue.push(node->child(i));
+        count++;
+      }
+    }
+  }
+  return octree;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  const size_t nodeCount =
+    (argc > 1 ? static_cast<size_t>(std::atol(argv[1])) : 10000000);
+
+  const spgl::idx::Octree octree = buildOctree(nodeCount);
+  std::cout << "Nodes: " << octree.nodeCount() << std::endl;
+
+  const double write = measure(
+    [&]() { spgl::idx::Octree::writeToFile(octree, "bench_octree.idx"); });
+  const double writePaged = measure([&]() {
+    spgl::idx::OctreeHierarchyFile::write(octree, "bench_octree_paged.idx");
+  });
+  std::cout << "Write: " << write << " ms, paged: " << writePaged << " ms"
+            << std::endl;
+
+  const double read = measure([&]() {
+    spgl::idx::Octree result({});
+    spgl::idx::Octree::readFromFile("bench_octree.idx", result);
+  });
+  std::cout << "Octree::readFromFile: " << read << " ms" << std::endl;
+
+  spgl::idx::OctreeHierarchyFile file;
+  const double open = measure([&]() {
+    file.open("bench_octree_paged.idx");
+    spgl::idx::OctreeHierarchyFile::Node node = file.root();
+    while (file.childMask(node) != 0) {
+      size_t i = 0;
+      while (((file.childMask(node) >> i) & 1) == 0) {
+        i++;
+      }
+      file.child(node, i, node);
+    }
+  });
+  std::cout << "OctreeHierarchyFile open + first leaf: " << open << " ms ("
+            << file.loadedPageCount() << " pages)" << std::endl;
+
+  const double readPaged = measure([&]() {
+    spgl::idx::Octree result({});
+    file.readOctree(result);
+  });
+  std::cout << "OctreeHierarchyFile::readOctree: " << readPaged << " ms"
+            << std::endl;
+
+  file.close();
+  std::remove("bench_octree.idx");
+  std::remove("bench_octree_paged.idx");
+  return 0;
+}
@@ -0,0 +1,113 @@
+#include <spatiumgl/idx/SparseVoxelDag.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+// Compress the occupancy octree of a voxelized, synthetic city block
+// (ground, building facades and roofs) to a sparse voxel DAG and report the
+// memory before and after.
+//
+// Usage: idx_bench_svdag [voxels_per_axis]
+
+namespace {
+
+template<typename Function>
+double
+measure(Function function)
+{
+  const auto start = std::chrono::steady_clock::now();
+  function();
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+/// Pseudo-random hash of a cell.
+unsigned int
+hash(int x, int y)
+{
+  unsigned int h = static_cast<unsigned int>(x) * 73856093u ^
+                   static_cast<unsigned int>(y) * 19349663u;
+  h ^= h >> 13;
+  h *= 0x5bd1e995u;
+  return h ^ (h >> 15);
+}
+
+/// Voxel centers of a city block: buildings on a grid of 64 voxels with
+/// varying footprints and heights, and street clutter (cars, poles, trees).
+std::vector<spgl::Vector3f>
+cityBlock(int size)
+{
+  std::vector<spgl::Vector3f> points;
+  for (int x = 0; x < size; x++) {
+    for (int y = 0; y < size; y++) {
+      points.push_back({ x + 0.5f, y + 0.5f, 0.5f }); // Ground
+      const unsigned int building = hash(x / 64, y / 64);
+      const int margin = 6 + static_cast<int>(building % 11);
+      const int height = 12 + static_cast<int>((building >> 8) % 60);
+      const int bx = x % 64;
+      const int by = y % 64;
+      if (bx < margin || bx >= 64 - margin || by < margin ||
+          by >= 64 - margin) {
+        // Street
+        const unsigned int clutter = hash(x, y);
+        if (clutter % 100 == 0) {
+          for (int z = 1; z <= static_cast<int>(clutter >> 8) % 4 + 1; z++) {
+            points.push_back({ x + 0.5f, y + 0.5f, z + 0.5f });
+          }
+        }
+        continue;
+      }
+      const bool facade = (bx == margin || bx == 63 - margin ||
+                           by == margin || by == 63 - margin);
+      for (int z = (facade ? 1 : height); z <= height; z++) {
+        points.push_back({ x + 0.5f, y + 0.5f, z + 0.5f });
+      }
+    }
+  }
+  return points;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  const int size = (argc > 1 ? std::atoi(argv[1]) : 2048);
+
+  const std::vector<spgl::Vector3f> points = cityBlock(size);
+  std::cout << "Voxels: " << points.size() << std::endl;
+
+  spgl::idx::Octree octree({});
+  const double build =
+    measure([&]() { octree = spgl::idx::Octree::build(points, 1); });
+  std::cout << "Octree: " << octree.nodeCount() << " nodes, " << build
+            << " ms" << std::endl;
+
+  spgl::idx::SparseVoxelDag dag;
+  const double convert = measure(
+    [&]() { dag = spgl::idx::SparseVoxelDag::fromOctree(octree); });
+  std::cout << "DAG: " << dag.nodeCount() << " nodes, " << convert << " ms"
+            << std::endl;
+
+  const spgl::idx::LinearOctree linear =
+    spgl::idx::LinearOctree::fromOctree(octree);
+  const size_t pointerBytes =
+    octree.nodeCount() * sizeof(spgl::idx::OctreeNode);
+  std::cout << "Memory: Octree " << pointerBytes / 1048576.0
+            << " MiB, LinearOctree " << linear.memoryUsage() / 1048576.0
+            << " MiB, DAG " << dag.memoryUsage() / 1048576.0 << " MiB ("
+            << static_cast<double>(linear.memoryUsage()) / dag.memoryUsage()
+            << "x smaller than LinearOctree)" << std::endl;
+
+  size_t occupied = 0;
+  const double query = measure([&]() {
+    for (size_t i = 0; i < points.size(); i += 16) {
+      occupied += dag.contains(points[i].staticCast<double>()) ? 1 : 0;
+    }
+  });
+  std::cout << "Queries: " << occupied << " occupied, " << query << " ms"
+            << std::endl;
+  return 0;
+}
@@ -0,0 +1,444 @@
+/*
+ * Program: Spatium Graphics Library
+ *
+ * Copyright (C) Martijn Koopman
+ * All Rights Reserved
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.
+ *
+ */
+
+#ifndef SPATIUMGL_IDX_KDTREE_H
+#define SPATIUMGL_IDX_KDTREE_H
+
+#include "spatiumglexport.hpp"
+#include "spatiumgl/Parallel.hpp"
+#include "spatiumgl/Vector.hpp"
+#include "spatiumgl/idx/Neighbor.hpp"
+
+#include <algorithm> // std::nth_element, std::push_heap, std::pop_heap
+#include <array>     // std::array
+#include <cstdint>   // std::uint8_t, std::uint32_t
+#include <limits>    // std::numeric_limits
+#include <vector>    // std::vector
+
+namespace spgl {
+namespace idx {
+
+/// \class KdTree
+/// \brief Balanced kd-tree for a static set of points.
+///
+/// Every node splits its points at the median along the axis with the
+/// largest extent, so the tree adapts to anisotropic data. All leaves are at
+/// the same depth and hold at most maxPointsPerLeaf points.
+///
+/// The tree is stored implicitly: the children of node i are 2i+1 and 2i+2,
+/// and the points of a node are the range of its parent range halves. Only
+/// the split axis and value of the internal nodes are stored. The points
+/// are copied in leaf order, see points() and indices().
+///
+/// \tparam T Coordinate type (float or double)
+/// \tparam Dim Number of dimensions
+template<typename T, size_t Dim>
+class SPATIUMGL_EXPORT KdTree
+{
+public:
+  /// Point type
+  using Point = Vector<T, Dim>;
+
+  /// Nearest neighbor query result
+  using Neighbor = NeighborT<T>;
+
+  /// Constructor.
+  ///
+  /// Constructs an empty tree.
+  KdTree()
+    : m_depth(0)
+    , m_axes()
+    , m_splits()
+    , m_indices()
+    , m_points()
+  {}
+
+  /// Build tree from points.
+  ///
+  /// The nodes of every level are split in parallel. Within a node the
+  /// median is found with std::nth_element.
+  ///
+  /// \param[in] points Points
+  /// \param[in] count Number of points (< 2^32)
+  /// \param[in] maxPointsPerLeaf Maximum number of points per leaf
+  /// \param[in] threads Maximum number of threads (0 = hardware concurrency)
+  /// \return KdTree
+  static KdTree build(const Point* points,
+                      size_t count,
+                      size_t maxPointsPerLeaf = 16,
+                      size_t threads = 0)
+  {
+    KdTree tree;
+    maxPointsPerLeaf = (maxPointsPerLeaf > 0 ? maxPointsPerLeaf : 1);
+    while (count > 0 && tree.m_depth < 31 &&
+           ((count - 1) >> tree.m_depth) >= maxPointsPerLeaf) {
+      tree.m_depth++;
+    }
+
+    struct Item
+    {
+      Point point;
+      std::uint32_t index;
+    };
+    std::vector<Item> items(count);
+    parallelFor(count, threads, [&](size_t, size_t begin, size_t end) {
+      for (size_t i = begin; i < end; i++) {
+        items[i] = { points[i], static_cast<std::uint32_t>(i) };
+      }
+    });
+
+    // Split level by level. The nodes of a level are independent.
+    const size_t internalCount = (static_cast<size_t>(1) << tree.m_depth) - 1;
+    tree.m_axes.resize(internalCount);
+    tree.m_splits.resize(internalCount);
+    for (size_t level = 0; level < tree.m_depth; level++) {
+      const size_t first = (static_cast<size_t>(1) << level) - 1;
+      const size_t levelCount = static_cast<size_t>(1) << level;
+      parallelFor(
+        levelCount,
+        threads,
+        [&](size_t, size_t nodeBegin, size_t nodeEnd) {
+          for (size_t j = nodeBegin; j < nodeEnd; j++) {
+            const Range range = levelRange(count, level, j);
+            Item* begin = items.data() + range.begin;
+            Item* end = items.data() + range.end;
+            Item* mid = items.data() + range.mid();
+
+            // Axis with largest extent
+            Point min = begin->point;
+            Point max = begin->point;
+            for (const Item* item = begin; item != end; item++) {
+              for (size_t axis = 0; axis < Dim; axis++) {
+                min[axis] = std::min(min[axis], item->point[axis]);
+                max[axis] = std::max(max[axis], item->point[axis]);
+              }
+            }
+            size_t splitAxis = 0;
+            for (size_t axis = 1; axis < Dim; axis++) {
+              if (max[axis] - min[axis] > max[splitAxis] - min[splitAxis]) {
+                splitAxis = axis;
+              }
+            }
+
+            std::nth_element(
+              begin, mid, end, [splitAxis](const Item& a, const Item& b) {
+                return a.point[splitAxis] < b.point[splitAxis];
+              });
+            tree.m_axes[first + j] = static_cast<std::uint8_t>(splitAxis);
+            tree.m_splits[first + j] = mid->point[splitAxis];
+          }
+        },
+        1);
+    }
+
+    tree.m_indices.resize(count);
+    tree.m_points.resize(count);
+    parallelFor(count, threads, [&](size_t, size_t begin, size_t end) {
+      for (size_t i = begin; i < end; i++) {
+        tree.m_points[i] = items[i].point;
+        tree.m_indices[i] = items[i].index;
+      }
+    });
+    return tree;
+  }
+
+  /// Build tree from points.
+  ///
+  /// \param[in] points Points
+  /// \param[in] maxPointsPerLeaf Maximum number of points per leaf
+  /// \param[in] threads Maximum number of threads (0 = hardware concurrency)
+  /// \return KdTree
+  static KdTree build(const std::vector<Point>& points,
+                      size_t maxPointsPerLeaf = 16,
+                      size_t threads = 0)
+  {
+    return build(points.data(), points.size(), maxPointsPerLeaf, threads);
+  }
+
+  /// Get number of points.
+  ///
+  /// \return Number of points
+  size_t size() const { return m_points.size(); }
+
+  /// Get depth of the leaves.
+  ///
+  /// \return Depth (0 if the root is a leaf)
+  size_t depth() const { return m_depth; }
+
+  /// Get point indices, in leaf order.
+  ///
+  /// \return Point indices
+  const std::vector<std::uint32_t>& indices() const { return m_indices; }
+
+  /// Get points, in leaf order: points()[i] is point indices()[i].
+  ///
+  /// \return Points
+  const std::vector<Point>& points() const { return m_points; }
+
+  /// Find the k nearest points.
+  ///
+  /// The nearer child is visited first. The farther child is skipped when
+  /// the distance to the splitting plane exceeds the k-th nearest point.
+  /// Scratch memory is kept per thread, so repeated queries do not allocate.
+  ///
+  /// \param[in] query Query position
+  /// \param[in] k Number of neighbors
+  /// \param[out] result Neighbors sorted by distance (k elements)
+  /// \return Number of neighbors found (min(k, number of points)). Remaining
+  ///         elements get index Neighbor::InvalidIndex.
+  size_t knn(const Point& query, size_t k, Neighbor* result) const
+  {
+    static thread_local std::vector<Neighbor> neighbors;
+    neighbors.clear();
+
+    if (k > 0 && !m_points.empty()) {
+      traverse(
+        query,
+        [&]() {
+          return (neighbors.size() < k ? std::numeric_limits<T>::infinity()
+                                       : neighbors.front().distanceSquared);
+        },
+        [&](size_t i, T distance) {
+          if (neighbors.size() < k) {
+            neighbors.push_back({ m_indices[i], distance });
+            std::push_heap(neighbors.begin(), neighbors.end(), nearer<T>);
+          } else if (distance < neighbors.front().distanceSquared) {
+            std::pop_heap(neighbors.begin(), neighbors.end(), nearer<T>);
+            neighbors.back() = { m_indices[i], distance };
+            std::push_heap(neighbors.begin(), neighbors.end(), nearer<T>);
+          }
+        });
+    }
+
+    std::sort_heap(neighbors.begin(), neighbors.end(), nearer<T>);
+    std::copy(neighbors.begin(), neighbors.end(), result);
+    for (size_t i = neighbors.size(); i < k; i++) {
+      result[i] = { Neighbor::InvalidIndex,
+                    std::numeric_limits<T>::infinity() };
+    }
+    return neighbors.size();
+  }
+
+  /// Find the k nearest points.
+  ///
+  /// \param[in] query Query position
+  /// \param[in] k Number of neighbors
+  /// \return Neighbors sorted by distance (at most k)
+  std::vector<Neighbor> knn(const Point& query, size_t k) const
+  {
+    std::vector<Neighbor> result(k);
+    result.resize(knn(query, k, result.data()));
+    return result;
+  }
+
+  /// Find the k nearest points of many query positions. (parallel)
+  ///
+  /// \param[in] queries Query positions
+  /// \param[in] count Number of query positions
+  /// \param[in] k Number of neighbors
+  /// \param[out] result Neighbors (k elements per query, see knn())
+  /// \param[in] threads Maximum number of threads (0 = hardware concurrency)
+  void knn(const Point* queries,
+           size_t count,
+           size_t k,
+           Neighbor* result,
+           size_t threads = 0) const
+  {
+    parallelFor(
+      count,
+      threads,
+      [&](size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+          knn(queries[i], k, result + i * k);
+        }
+      },
+      256);
+  }
+
+  /// Find the k nearest points of many query positions. (parallel)
+  ///
+  /// \param[in] queries Query positions
+  /// \param[in] k Number of neighbors
+  /// \param[in] threads Maximum number of threads (0 = hardware concurrency)
+  /// \return Neighbors (k elements per query, see knn())
+  std::vector<Neighbor> knn(const std::vector<Point>& queries,
+                            size_t k,
+                            size_t threads = 0) const
+  {
+    std::vector<Neighbor> result(queries.size() * k);
+    knn(queries.data(), queries.size(), k, result.data(), threads);
+    return result;
+  }
+
+  /// Visit all points within a radius of a position.
+  ///
+  /// \param[in] center Center of sphere
+  /// \param[in] radius Radius of sphere
+  /// \param[in] visitor Function (object) called as visitor(index) for
+  ///                    every point (index of point, see indices())
+  template<typename Visitor>
+  void visitRadius(const Point& center, T radius, Visitor visitor) const
+  {
+    if (m_points.empty()) {
+      return;
+    }
+    const T radiusSquared = radius * radius;
+    traverse(center,
+             [radiusSquared]() { return radiusSquared; },
+             [&](size_t i, T distance) {
+               if (distance <= radiusSquared) {
+                 visitor(m_indices[i]);
+               }
+             });
+  }
+
+  /// Find all points within a radius of a position.
+  ///
+  /// \param[in] center Center of sphere
+  /// \param[in] radius Radius of sphere
+  /// \param[out] result Point indices (cleared first; reuse to avoid
+  ///                    allocations)
+  /// \return Number of points found
+  size_t radiusQuery(const Point& center,
+                     T radius,
+                     std::vector<std::uint32_t>& result) const
+  {
+    result.clear();
+    visitRadius(center, radius, [&](std::uint32_t index) {
+      result.push_back(index);
+    });
+    return result.size();
+  }
+
+  /// Find all points within a radius of many positions. (parallel)
+  ///
+  /// \param[in] centers Centers of spheres
+  /// \param[in] count Number of spheres
+  /// \param[in] radius Radius of spheres
+  /// \param[out] results Point indices per sphere (count elements)
+  /// \param[in] threads Maximum number of threads (0 = hardware concurrency)
+  void radiusQuery(const Point* centers,
+                   size_t count,
+                   T radius,
+                   std::vector<std::uint32_t>* results,
+                   size_t threads = 0) const
+  {
+    parallelFor(
+      count,
+      threads,
+      [&](size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+          radiusQuery(centers[i], radius, results[i]);
+        }
+      },
+      64);
+  }
+
+protected:
+  /// Range of points [begin, end) of a node.
+  struct Range
+  {
+    size_t begin;
+    size_t end;
+
+    size_t mid() const { return begin + (end - begin) / 2; }
+  };
+
+  /// Compute range of the j-th node of a level.
+  static Range levelRange(size_t count, size_t level, size_t j)
+  {
+    Range range = { 0, count };
+    for (size_t bit = level; bit-- > 0;) {
+      if (((j >> bit) & 1) == 0) {
+        range.end = range.mid();
+      } else {
+        range.begin = range.mid();
+      }
+    }
+    return range;
+  }
+
+  /// Visit leaves depth-first, nearer child first.
+  ///
+  /// \param[in] query Query position
+  /// \param[in] bound Function returning the current maximum squared
+  ///                  distance of interest (nodes farther are skipped)
+  /// \param[in] visit Function called as visit(i, squaredDistance) for every
+  ///                  point i of visited leaves
+  template<typename Bound, typename Visit>
+  void traverse(const Point& query, Bound bound, Visit visit) const
+  {
+    struct Entry
+    {
+      size_t node;
+      Range range;
+      T distanceSquared; // Lower bound of distance to node
+    };
+    std::array<Entry, 64> stack;
+    size_t size = 0;
+
+    const size_t internalCount = m_axes.size();
+    stack[size++] = { 0, { 0, m_points.size() }, 0 };
+    while (size > 0) {
+      const Entry entry = stack[--size];
+      if (entry.distanceSquared > bound()) {
+        continue;
+      }
+
+      if (entry.node >= internalCount) {
+        for (size_t i = entry.range.begin; i < entry.range.end; i++) {
+          T distance = 0;
+          for (size_t axis = 0; axis < Dim; axis++) {
+            const T delta = m_points[i][axis] - query[axis];
+            distance += delta * delta;
+          }
+          visit(i, distance);
+        }
+        continue;
+      }
+
+      const size_t axis = m_axes[entry.node];
+      const T offset = query[axis] - m_splits[entry.node];
+      const Range lower = { entry.range.begin, entry.range.mid() };
+      const Range upper = { entry.range.mid(), entry.range.end };
+      const T planeDistance = std::max(entry.distanceSquared, offset * offset);
+      const size_t left = 2 * entry.node + 1;
+      const size_t right = 2 * entry.node + 2;
+
+      // Push farther child first, so the nearer child is visited first
+      if (offset < 0) {
+        stack[size++] = { right, upper, planeDistance };
+        stack[size++] = { left, lower, entry.distanceSquared };
+      } else {
+        stack[size++] = { left, lower, planeDistance };
+        stack[size++] = { right, upper, entry.distanceSquared };
+      }
+    }
+  }
+
+  size_t m_depth;
+  std::vector<std::uint8_t> m_axes;
+  std::vector<T> m_splits;
+  std::vector<std::uint32_t> m_indices;
+  std::vector<Point> m_points;
+};
+
+/// 2D kd-tree (single precision)
+using KdTree2f = KdTree<float, 2>;
+
+/// 3D kd-tree (single precision)
+using KdTree3f = KdTree<float, 3>;
+
+} // namespace idx
+} // namespace spgl
+
+#endif // SPATIUMGL_IDX_KDTREE_H
@@ -0,0 +1,220 @@
+/*
+ * Program: Spatium Graphics Library
+ *
+ * Copyright (C) Martijn Koopman
+ * All Rights Reserved
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.
+ *
+ */
+
+#ifndef SPATIUMGL_IDX_LINEAROCTREE_H
+#define SPATIUMGL_IDX_LINEAROCTREE_H
+
+#include "spatiumglexport.hpp"
+#include "spatiumgl/Bounds.hpp"
+#include "spatiumgl/idx/Octree.hpp"
+
+#include <cstdint> // std::uint8_t, std::uint32_t
+#include <vector>  // std::vector
+
+namespace spgl {
+namespace idx {
+
+/// \class LinearOctree
+/// \brief Pointerless octree stored as contiguous arrays.
+///
+/// Nodes are stored in breadth-first order and the children of a node are
+/// stored consecutively in child index order. Every level of the tree is
+/// therefore sorted in Morton order. Per node only a child mask (1 bit per
+/// child, bit i = child i) and the index of the first child are stored:
+/// 5 bytes per node instead of 8 pointers.
+///
+/// Nodes are identified by their index; the root node has index 0.
+/// Child bounds follow Octree::computeChildBounds().
+///
+/// The tree is built top-down with addChildren(), in breadth-first order.
+class SPATIUMGL_EXPORT LinearOctree
+{
+public:
+  /// Node index
+  using NodeIndex = std::uint32_t;
+
+  /// Invalid node index (no node)
+  static const NodeIndex InvalidNode = 0xffffffff;
+
+  /// Constructor.
+  ///
+  /// Constructs an octree with only a root node.
+  ///
+  /// \param[in] bounds Bounds of entire octree
+  explicit LinearOctree(const BoundingCube& bounds = BoundingCube());
+
+  /// Convert pointer-based octree.
+  ///
+  /// \param[in] octree Octree
+  /// \return Linear octree
+  static LinearOctree fromOctree(const Octree& octree);
+
+  /// Convert to pointer-based octree.
+  ///
+  /// \return Octree
+  Octree toOctree() const;
+
+  /// Get bounds of entire octree. (cubical)
+  ///
+  /// \return Bounds
+  const BoundingCube& bounds() const { return m_bounds; }
+
+  /// Get number of nodes.
+  ///
+  /// \return Number of nodes (>= 1)
+  size_t nodeCount() const { return m_childMasks.size(); }
+
+  /// Get root node.
+  ///
+  /// \return Root node index (0)
+  NodeIndex root() const { return 0; }
+
+  /// Get child mask of node.
+  ///
+  /// \param[in] node Node index
+  /// \return Child mask (bit i set if child i exists)
+  std::uint8_t childMask(NodeIndex node) const { return m_childMasks[node]; }
+
+  /// Check whether node has no children.
+  ///
+  /// \param[in] node Node index
+  /// \return True if leaf, false otherwise
+  bool isLeaf(NodeIndex node) const { return m_childMasks[node] == 0; }
+
+  /// Get number of children of node.
+  ///
+  /// \param[in] node Node index
+  /// \return Number of children (0-8)
+  size_t childCount(NodeIndex node) const
+  {
+    return bitCount(m_childMasks[node]);
+  }
+
+  /// Get child of node.
+  ///
+  /// \param[in] node Node index
+  /// \param[in] childIndex Child index (0-7)
+  /// \return Child node index or InvalidNode
+  NodeIndex child(NodeIndex node, size_t childIndex) const
+  {
+    const std::uint8_t mask = m_childMasks[node];
+    if (childIndex >= 8 || (mask & (1u << childIndex)) == 0) {
+      return InvalidNode;
+    }
+    const std::uint8_t lower =
+      static_cast<std::uint8_t>(mask & ((1u << childIndex) - 1));
+    return m_firstChild[node] + static_cast<NodeIndex>(bitCount(lower));
+  }
+
+  /// Compute child bounds. (see Octree::computeChildBounds)
+  ///
+  /// \param[in] parentBounds Bounds of parent node
+  /// \param[in] childIndex Child index (0-7)
+  /// \return Child bounds.
+  static BoundingCube computeChildBounds(const BoundingCube& parentBounds,
+                                         size_t childIndex)
+  {
+    return Octree::computeChildBounds(parentBounds, childIndex);
+  }
+
+  /// Add children to a node.
+  ///
+  /// The children are appended to the node arrays. Nodes must be expanded in
+  /// breadth-first order (increasing node index) and only once, otherwise
+  /// the child order is violated and false is returned.
+  ///
+  /// \param[in] node Node index (leaf)
+  /// \param[in] mask Child mask (bit i = child i)
+  /// \return True on success, false otherwise
+  bool addChildren(NodeIndex node, std::uint8_t mask);
+
+  /// Traverse the tree depth-first.
+  ///
+  /// The visitor is called as visitor(node, bounds, depth) and returns
+  /// whether to descend into the children of the node.
+  ///
+  /// \param[in] visitor Visitor function (object)
+  template<typename Visitor>
+  void traverse(Visitor visitor) const
+  {
+    struct Entry
+    {
+      NodeIndex node;
+      BoundingCube bounds;
+      size_t depth;
+    };
+    std::vector<Entry> stack;
+    stack.push_back({ root(), m_bounds, 0 });
+    while (!stack.empty()) {
+      const Entry entry = stack.back();
+      stack.pop_back();
+      if (!visitor(entry.node, entry.bounds, entry.depth) ||
+          isLeaf(entry.node)) {
+        continue;
+      }
+
+      // Push children in reverse to visit them in child index order
+      const std::uint8_t mask = m_childMasks[entry.node];
+      NodeIndex childNode =
+        m_firstChild[entry.node] + static_cast<NodeIndex>(bitCount(mask));
+      for (size_t i = 8; i-- > 0;) {
+        if ((mask & (1u << i)) != 0) {
+          stack.push_back({ --childNode,
+                            computeChildBounds(entry.bounds, i),
+                            entry.depth + 1 });
+        }
+      }
+    }
+  }
+
+  /// Compute memory usage of the node arrays.
+  ///
+  /// \return Size in bytes
+  size_t memoryUsage() const
+  {
+    return m_childMasks.capacity() * sizeof(std::uint8_t) +
+           m_firstChild.capacity() * sizeof(NodeIndex);
+  }
+
+  /// Reserve memory for nodes.
+  ///
+  /// \param[in] nodeCount Number of nodes
+  void reserve(size_t nodeCount)
+  {
+    m_childMasks.reserve(nodeCount);
+    m_firstChild.reserve(nodeCount);
+  }
+
+  /// Count set bits.
+  ///
+  /// \param[in] mask Mask
+  /// \return Number of set bits
+  static size_t bitCount(std::uint8_t mask)
+  {
+    size_t count = 0;
+    for (; mask != 0; mask &= static_cast<std::uint8_t>(mask - 1)) {
+      count++;
+    }
+    return count;
+  }
+
+protected:
+  BoundingCube m_bounds;
+  std::vector<std::uint8_t> m_childMasks;
+  std::vector<NodeIndex> m_firstChild;
+  NodeIndex m_lastExpanded;
+};
+
+} // namespace idx
+} // namespace spgl
+
+#endif // SPATIUMGL_IDX_LINEAROCTREE_H
@@ -0,0 +1,108 @@
+/*
+ * Program: Spatium Graphics Library
+ *
+ * Copyright (C) Martijn Koopman
+ * All Rights Reserved
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.
+ *
+ */
+
+#ifndef SPATIUMGL_IDX_MORTON_H
+#define SPATIUMGL_IDX_MORTON_H
+
+#include <cstdint> // std::uint32_t, std::uint64_t
+
+namespace spgl {
+namespace idx {
+
+// 3D Morton codes (Z-order curve).
+//
+// A 63-bit Morton code interleaves 21 bits per axis. Bit 3*i of the code is
+// bit i of X, bit 3*i+1 of Y and bit 3*i+2 of Z. This matches the octree
+// child index convention (bit 0: X, bit 1: Y, bit 2: Z, see
+// Octree::computeChildBounds), so the three bits at level l (from the top)
+// of a code are the child index of the node at that level.
+
+/// Maximum octree depth that fits in a 63-bit Morton code
+const unsigned int MortonMaxDepth = 21;
+
+/// Spread the lower 21 bits of a value to every third bit.
+///
+/// \param[in] value Value (21 bits)
+/// \return Spread value
+inline std::uint64_t
+mortonSpread(std::uint32_t value)
+{
+  std::uint64_t x = value & 0x1fffff;
+  x = (x | x << 32) & 0x1f00000000ffffULL;
+  x = (x | x << 16) & 0x1f0000ff0000ffULL;
+  x = (x | x << 8) & 0x100f00f00f00f00fULL;
+  x = (x | x << 4) & 0x10c30c30c30c30c3ULL;
+  x = (x | x << 2) & 0x1249249249249249ULL;
+  return x;
+}
+
+/// Compact every third bit to the lower 21 bits. (inverse of mortonSpread)
+///
+/// \param[in] value Spread value
+/// \return Value (21 bits)
+inline std::uint32_t
+mortonCompact(std::uint64_t value)
+{
+  std::uint64_t x = value & 0x1249249249249249ULL;
+  x = (x | x >> 2) & 0x10c30c30c30c30c3ULL;
+  x = (x | x >> 4) & 0x100f00f00f00f00fULL;
+  x = (x | x >> 8) & 0x1f0000ff0000ffULL;
+  x = (x | x >> 16) & 0x1f00000000ffffULL;
+  x = (x | x >> 32) & 0x1fffffULL;
+  return static_cast<std::uint32_t>(x);
+}
+
+/// Encode 3D grid coordinates as Morton code.
+///
+/// \param[in] x X coordinate (21 bits)
+/// \param[in] y Y coordinate (21 bits)
+/// \param[in] z Z coordinate (21 bits)
+/// \return Morton code (63 bits)
+inline std::uint64_t
+mortonEncode(std::uint32_t x, std::uint32_t y, std::uint32_t z)
+{
+  return mortonSpread(x) | (mortonSpread(y) << 1) | (mortonSpread(z) << 2);
+}
+
+/// Decode Morton code to 3D grid coordinates.
+///
+/// \param[in] code Morton code (63 bits)
+/// \param[out] x X coordinate
+/// \param[out] y Y coordinate
+/// \param[out] z Z coordinate
+inline void
+mortonDecode(std::uint64_t code,
+             std::uint32_t& x,
+             std::uint32_t& y,
+             std::uint32_t& z)
+{
+  x = mortonCompact(code);
+  y = mortonCompact(code >> 1);
+  z = mortonCompact(code >> 2);
+}
+
+/// Get octree child index at a level from a Morton code.
+///
+/// \param[in] code Morton code (63 bits)
+/// \param[in] level Level (1 = children of root, ..., MortonMaxDepth)
+/// \return Child index (0-7)
+inline unsigned int
+mortonChildIndex(std::uint64_t code, unsigned int level)
+{
+  return static_cast<unsigned int>((code >> (3 * (MortonMaxDepth - level))) &
+                                   0x7);
+}
+
+} // namespace idx
+} // namespace spgl
+
+#endif // SPATIUMGL_IDX_MORTON_H
@@ -15,8 +15,13 @@
 
 #include "spatiumglexport.hpp"
 #include "spatiumgl/Bounds.hpp"
+#include "spatiumgl/idx/NTreeIterator.hpp"
 #include "spatiumgl/idx/NTreeNode.hpp"
 
+#include <memory>      // std::unique_ptr
+#include <type_traits> // std::is_trivially_destructible
+#include <utility>     // std::swap
+
 namespace spgl {
 namespace idx {
 
@@ -26,15 +31,31 @@ struct SPATIUMGL_EXPORT NTreeBounds
   , public BoundsRadii<T, 1>
 {};
 
-template<size_t N>
+/// \class NTree
+/// \brief Tree with a fixed number of children per node.
+///
+/// All nodes are allocated from a slab allocator owned by the tree. This
+/// avoids a heap allocation per node, keeps nodes close in memory and
+/// destructs the whole tree by freeing the slabs (without visiting the nodes
+/// when the payload is trivially destructible).
+///
+/// \tparam N Number of children per node
+/// \tparam T Payload type of nodes (void for none)
+template<size_t N, typename T = void>
 class SPATIUMGL_EXPORT NTree
 {
 public:
+  /// Node type
+  using Node = NTreeNode<N, T>;
+
   /// Constructor.
   ///
-  /// \param[in] rootObject Object for root node
-  NTree()
-    : m_root(new NTreeNode<N>())
+  /// Constructs a tree with only a root node.
+  ///
+  /// \param[in] slabSize Number of nodes per allocated slab
+  explicit NTree(size_t slabSize = 1024)
+    : m_allocator(new typename Node::Allocator(slabSize))
+    , m_root(m_allocator->create(m_allocator.get()))
   {}
 
   /// Copy constructor.
@@ -42,8 +63,10 @@ public:
 
   /// Move constructor.
   NTree(NTree&& other)
-    : m_root(nullptr)
+    : m_allocator()
+    , m_root(nullptr)
   {
+    std::swap(m_allocator, other.m_allocator);
     std::swap(m_root, other.m_root);
   }
 
@@ -54,85 +77,81 @@ public:
   NTree& operator=(NTree&& other)
   {
     if (this != &other) {
-      delete m_root;
-      m_root = nullptr;
+      clear();
+      std::swap(m_allocator, other.m_allocator);
       std::swap(m_root, other.m_root);
     }
     return *this;
   }
 
   /// Destructor.
-  ~NTree() { delete m_root; }
+  ~NTree() { clear(); }
 
   /// Get root node.
   ///
   /// \return Root node
-  NTreeNode<N>* root() const { return m_root; }
-
-  /// Get iterator pointing to the beginning of the tree (root node).
-  ///
-  /// This iterator traverses the tree in DEPTH-FIRST order.
-  ///
-  /// \return Tree iterator
-  // NTreeIteratorDF<T, N> beginDF() { return NTreeIteratorDF<T,N>(*this); }
+  Node* root() const { return m_root; }
 
-  /// Get iterator pointing to the end of the tree.
+  /// Get number of nodes.
   ///
-  /// This iterator traverses the tree in DEPTH-FIRST order.
-  ///
-  /// \return Tree iterator
-  // NTreeIteratorDF<T, N> endDF() { return NTreeIteratorDF<T, N>(*this, true);
-  // }
+  /// \return Number of nodes
+  size_t nodeCount() const
+  {
+    return (m_allocator != nullptr ? m_allocator->size() : 0);
+  }
 
-  /// Get iterator pointing to the beginning of the tree (root node).
+  /// Traverse the tree depth-first (pre-order).
   ///
-  /// This iterator traverses the tree in BREADTH-FIRST order.
+  /// Usage: for (const auto& entry : tree.depthFirst()) { ... }
   ///
-  /// \return Tree iterator
-  // NTreeIteratorBF<T, N> beginBF() { return NTreeIteratorBF<T, N>(*this); }
+  /// \param[in] predicate Pruning predicate (see NTreeIteratorDF)
+  /// \return Range of NTreeEntry
+  template<typename Predicate = NTreeVisitAll>
+  NTreeRange<NTreeIteratorDF<N, T, NTreeNoBounds, Predicate>> depthFirst(
+    Predicate predicate = Predicate()) const
+  {
+    using Iterator = NTreeIteratorDF<N, T, NTreeNoBounds, Predicate>;
+    return NTreeRange<Iterator>(
+      Iterator({ m_root, NTreeNoBounds(), 0, 0 }, predicate),
+      Iterator(predicate));
+  }
 
-  /// Get iterator pointing to the end of the tree.
-  ///
-  /// This iterator traverses the tree in BREADTH-FIRST order.
+  /// Traverse the tree breadth-first.
   ///
-  /// \return Tree iterator
-  // NTreeIteratorBF<T, N> endBF() { return NTreeIteratorBF<T, N>(*this, true);
-  // }
+  /// \param[in] predicate Pruning predicate (see NTreeIteratorBF)
+  /// \return Range of NTreeEntry
+  template<typename Predicate = NTreeVisitAll>
+  NTreeRange<NTreeIteratorBF<N, T, NTreeNoBounds, Predicate>> breadthFirst(
+    Predicate predicate = Predicate()) const
+  {
+    using Iterator = NTreeIteratorBF<N, T, NTreeNoBounds, Predicate>;
+    return NTreeRange<Iterator>(
+      Iterator({ m_root, NTreeNoBounds(), 0, 0 }, N, predicate),
+      Iterator(predicate));
+  }
 
 protected:
-  NTreeNode<N>* m_root;
+  /// Destruct all nodes and free the slabs.
+  void clear()
+  {
+    if (m_allocator == nullptr) {
+      return;
+    }
+    if (!std::is_trivially_destructible<Node>::value) {
+      Node::destroy(m_allocator.get(), m_root);
+    }
+    m_allocator->release();
+    m_allocator.reset();
+    m_root = nullptr;
+  }
+
+  std::unique_ptr<typename Node::Allocator> m_allocator;
+  Node* m_root;
 };
 
-using OctreeNode = NTreeNode<8>;
 using QuadNode = NTreeNode<4>;
 using Quadtree = NTree<4>;
 
-/*
-/// \class NTreeIteratorDF
-/// \brief Depth-first NTree iterator.
-template<size_t N>
-class SPATIUMGL_EXPORT NTreeIteratorDF
-{
-  //...
-
-  /// Get tree node currently being pointed to.
-  ///
-  /// \return NTreeNode
-  const NTreeNode<T, N>* operator*() const { return m_stack.top(); }
-
-protected:
-  NTree<T, N>& m_tree;
-  bool m_end;
-  std::stack<NTreeNode<T, N>> m_stack;
-};
-
-/// \class NTreeIteratorBF
-/// \brief Breadth-first NTree iterator.
-template<typename T, size_t N>
-class SPATIUMGL_EXPORT NTreeIteratorBF
-{};
-*/
-
 } // namespace idx
 } // namespace spgl
 
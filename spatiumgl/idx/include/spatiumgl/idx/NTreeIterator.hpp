@@ -0,0 +1,458 @@
+/*
+ * Program: Spatium Graphics Library
+ *
+ * Copyright (C) Martijn Koopman
+ * All Rights Reserved
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.
+ *
+ */
+
+#ifndef SPATIUMGL_IDX_NTREEITERATOR_H
+#define SPATIUMGL_IDX_NTREEITERATOR_H
+
+#include "spatiumglexport.hpp"
+#include "spatiumgl/Parallel.hpp"
+#include "spatiumgl/idx/NTreeNode.hpp"
+
+#include <array>    // std::array
+#include <cstdint>  // std::uint64_t
+#include <iterator> // std::forward_iterator_tag
+#include <vector>   // std::vector
+
+namespace spgl {
+namespace idx {
+
+/// \struct NTreeNoBounds
+/// \brief Empty bounds, for trees without spatial extent.
+struct SPATIUMGL_EXPORT NTreeNoBounds
+{};
+
+/// \struct NTreeChildBounds
+/// \brief Computes the bounds of a child node from the bounds of its parent.
+///
+/// Specialize for every bounds type used with the NTree iterators, with a
+/// static function: Bounds compute(const Bounds& parent, size_t childIndex).
+///
+/// \tparam Bounds Bounds type
+/// \tparam N Number of children per node
+template<typename Bounds, size_t N>
+struct NTreeChildBounds;
+
+template<size_t N>
+struct NTreeChildBounds<NTreeNoBounds, N>
+{
+  static NTreeNoBounds compute(const NTreeNoBounds&, size_t) { return {}; }
+};
+
+/// \struct NTreeVisitAll
+/// \brief Pruning predicate that visits all nodes.
+struct SPATIUMGL_EXPORT NTreeVisitAll
+{
+  template<typename Entry>
+  bool operator()(const Entry&) const
+  {
+    return true;
+  }
+};
+
+/// \struct NTreeEntry
+/// \brief Node visited by an NTree iterator.
+///
+/// The bounds, depth and path are derived from those of the parent while
+/// traversing, never recomputed from the root.
+template<size_t N, typename T = void, typename Bounds = NTreeNoBounds>
+struct SPATIUMGL_EXPORT NTreeEntry
+{
+  const NTreeNode<N, T>* node;
+  Bounds bounds;
+  size_t depth; ///< Depth of node (root = 0)
+
+  /// Child indices from the root: path = parentPath * N + childIndex.
+  /// For octrees this is the Morton code of the node (valid up to depth 21).
+  std::uint64_t path;
+
+  /// Get entry of a child node.
+  ///
+  /// \param[in] child Child node
+  /// \param[in] childIndex Child index
+  /// \return Entry
+  NTreeEntry childEntry(const NTreeNode<N, T>* child, size_t childIndex) const
+  {
+    return { child,
+             NTreeChildBounds<Bounds, N>::compute(bounds, childIndex),
+             depth + 1,
+             path * N + childIndex };
+  }
+};
+
+/// \class NTreeIteratorDF
+/// \brief Depth-first (pre-order) NTree iterator.
+///
+/// The iterator only keeps the path from its start node to the current node,
+/// in a fixed size array: it never allocates. Nodes deeper than MaxDepth
+/// below the start node are not visited.
+///
+/// The predicate is called with the entry of every node before it is
+/// visited. A node for which it returns false is skipped, with its subtree.
+///
+/// \tparam N Number of children per node
+/// \tparam T Payload type of nodes
+/// \tparam Bounds Bounds type (see NTreeChildBounds)
+/// \tparam Predicate Pruning predicate: bool(const NTreeEntry&)
+template<size_t N,
+         typename T = void,
+         typename Bounds = NTreeNoBounds,
+         typename Predicate = NTreeVisitAll>
+class SPATIUMGL_EXPORT NTreeIteratorDF
+{
+public:
+  using Entry = NTreeEntry<N, T, Bounds>;
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = Entry;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const Entry*;
+  using reference = const Entry&;
+
+  /// Maximum depth below the start node
+  static const size_t MaxDepth = 32;
+
+  /// Constructor.
+  ///
+  /// Constructs an end iterator.
+  NTreeIteratorDF()
+    : m_predicate()
+    , m_size(0)
+  {}
+
+  /// Constructor.
+  ///
+  /// Constructs an end iterator.
+  ///
+  /// \param[in] predicate Pruning predicate
+  explicit NTreeIteratorDF(Predicate predicate)
+    : m_predicate(predicate)
+    , m_size(0)
+  {}
+
+  /// Constructor.
+  ///
+  /// \param[in] start Entry of start node (root of traversed subtree)
+  /// \param[in] predicate Pruning predicate
+  explicit NTreeIteratorDF(const Entry& start,
+                           Predicate predicate = Predicate())
+    : m_predicate(predicate)
+    , m_size(0)
+  {
+    if (start.node != nullptr && m_predicate(start)) {
+      m_stack[0] = start;
+      m_next[0] = 0;
+      m_size = 1;
+    }
+  }
+
+  /// Get entry of current node.
+  ///
+  /// \return Entry
+  const Entry& operator*() const { return m_stack[m_size - 1]; }
+
+  /// Get entry of current node.
+  ///
+  /// \return Entry
+  const Entry* operator->() const { return &m_stack[m_size - 1]; }
+
+  /// Advance to the next node.
+  ///
+  /// \return Reference to this
+  NTreeIteratorDF& operator++()
+  {
+    while (m_size > 0) {
+      const Entry& top = m_stack[m_size - 1];
+      unsigned char& next = m_next[m_size - 1];
+      while (next < N && m_size <= MaxDepth) {
+        const size_t childIndex = next++;
+        const NTreeNode<N, T>* child = top.node->child(childIndex);
+        if (child == nullptr) {
+          continue;
+        }
+        m_stack[m_size] = top.childEntry(child, childIndex);
+        if (m_predicate(m_stack[m_size])) {
+          m_next[m_size] = 0;
+          m_size++;
+          return *this;
+        }
+      }
+      m_size--;
+    }
+    return *this;
+  }
+
+  /// Do not descend into the children of the current node.
+  void skipChildren() { m_next[m_size - 1] = N; }
+
+  /// Check whether two iterators point to the same node.
+  ///
+  /// \param[in] other Other iterator
+  /// \return True if equal, false otherwise
+  bool operator==(const NTreeIteratorDF& other) const
+  {
+    return m_size == other.m_size &&
+           (m_size == 0 || (**this).node == (*other).node);
+  }
+
+  /// Check whether two iterators point to different nodes.
+  ///
+  /// \param[in] other Other iterator
+  /// \return True if not equal, false otherwise
+  bool operator!=(const NTreeIteratorDF& other) const
+  {
+    return !(*this == other);
+  }
+
+private:
+  Predicate m_predicate;
+  std::array<Entry, MaxDepth + 1> m_stack;
+  std::array<unsigned char, MaxDepth + 1> m_next; // Next child to try
+  size_t m_size;
+};
+
+template<size_t N, typename T, typename Bounds, typename Predicate>
+const size_t NTreeIteratorDF<N, T, Bounds, Predicate>::MaxDepth;
+
+/// \class NTreeIteratorBF
+/// \brief Breadth-first NTree iterator.
+///
+/// The queued entries are kept in a ring buffer. Visited entries are
+/// dropped, so the buffer holds the frontier of the traversal only (at most
+/// two levels), and grows geometrically to the widest frontier. Copying an
+/// iterator copies the frontier.
+///
+/// The predicate is called with the entry of every node before it is
+/// queued. A node for which it returns false is skipped, with its subtree.
+///
+/// \tparam N Number of children per node
+/// \tparam T Payload type of nodes
+/// \tparam Bounds Bounds type (see NTreeChildBounds)
+/// \tparam Predicate Pruning predicate: bool(const NTreeEntry&)
+template<size_t N,
+         typename T = void,
+         typename Bounds = NTreeNoBounds,
+         typename Predicate = NTreeVisitAll>
+class SPATIUMGL_EXPORT NTreeIteratorBF
+{
+public:
+  using Entry = NTreeEntry<N, T, Bounds>;
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = Entry;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const Entry*;
+  using reference = const Entry&;
+
+  /// Constructor.
+  ///
+  /// Constructs an end iterator.
+  NTreeIteratorBF()
+    : m_predicate()
+    , m_queue()
+    , m_head(0)
+    , m_count(0)
+    , m_skip(false)
+  {}
+
+  /// Constructor.
+  ///
+  /// Constructs an end iterator.
+  ///
+  /// \param[in] predicate Pruning predicate
+  explicit NTreeIteratorBF(Predicate predicate)
+    : m_predicate(predicate)
+    , m_queue()
+    , m_head(0)
+    , m_count(0)
+    , m_skip(false)
+  {}
+
+  /// Constructor.
+  ///
+  /// \param[in] start Entry of start node (root of traversed subtree)
+  /// \param[in] capacity Initial capacity of the queue (grows as needed)
+  /// \param[in] predicate Pruning predicate
+  NTreeIteratorBF(const Entry& start,
+                  size_t capacity = N,
+                  Predicate predicate = Predicate())
+    : m_predicate(predicate)
+    , m_queue()
+    , m_head(0)
+    , m_count(0)
+    , m_skip(false)
+  {
+    if (start.node != nullptr && m_predicate(start)) {
+      m_queue.resize(capacity > 0 ? capacity : 1);
+      push(start);
+    }
+  }
+
+  /// Get entry of current node.
+  ///
+  /// \return Entry
+  const Entry& operator*() const { return m_queue[m_head]; }
+
+  /// Get entry of current node.
+  ///
+  /// \return Entry
+  const Entry* operator->() const { return &m_queue[m_head]; }
+
+  /// Advance to the next node.
+  ///
+  /// \return Reference to this
+  NTreeIteratorBF& operator++()
+  {
+    // Copy: the queue may grow while adding children
+    const Entry entry = m_queue[m_head];
+    m_head = (m_head + 1 == m_queue.size() ? 0 : m_head + 1);
+    m_count--;
+    if (!m_skip) {
+      for (size_t i = 0; i < N; i++) {
+        const NTreeNode<N, T>* child = entry.node->child(i);
+        if (child != nullptr) {
+          const Entry childEntry = entry.childEntry(child, i);
+          if (m_predicate(childEntry)) {
+            push(childEntry);
+          }
+        }
+      }
+    }
+    m_skip = false;
+    return *this;
+  }
+
+  /// Do not queue the children of the current node.
+  void skipChildren() { m_skip = true; }
+
+  /// Get capacity of the queue.
+  ///
+  /// \return Number of entries the queue holds without growing
+  size_t queueCapacity() const { return m_queue.size(); }
+
+  /// Check whether two iterators point to the same node.
+  ///
+  /// \param[in] other Other iterator
+  /// \return True if equal, false otherwise
+  bool operator==(const NTreeIteratorBF& other) const
+  {
+    const bool end = (m_count == 0);
+    const bool otherEnd = (other.m_count == 0);
+    return (end || otherEnd ? end == otherEnd
+                            : (**this).node == (*other).node);
+  }
+
+  /// Check whether two iterators point to different nodes.
+  ///
+  /// \param[in] other Other iterator
+  /// \return True if not equal, false otherwise
+  bool operator!=(const NTreeIteratorBF& other) const
+  {
+    return !(*this == other);
+  }
+
+private:
+  /// Append an entry to the queue, doubling its capacity if full.
+  ///
+  /// \param[in] entry Entry
+  void push(const Entry& entry)
+  {
+    if (m_count == m_queue.size()) {
+      std::vector<Entry> queue(m_queue.size() * 2);
+      for (size_t i = 0; i < m_count; i++) {
+        queue[i] = m_queue[(m_head + i) % m_queue.size()];
+      }
+      m_queue.swap(queue);
+      m_head = 0;
+    }
+    m_queue[(m_head + m_count) % m_queue.size()] = entry;
+    m_count++;
+  }
+
+  Predicate m_predicate;
+  std::vector<Entry> m_queue; // Ring buffer (size = capacity)
+  size_t m_head;              // Index of current entry
+  size_t m_count;             // Number of queued entries
+  bool m_skip;
+};
+
+/// \class NTreeRange
+/// \brief Pair of iterators, for range-based for loops.
+template<typename Iterator>
+class SPATIUMGL_EXPORT NTreeRange
+{
+public:
+  /// Constructor.
+  ///
+  /// \param[in] begin Iterator to first node
+  /// \param[in] end End iterator
+  NTreeRange(const Iterator& begin, const Iterator& end)
+    : m_begin(begin)
+    , m_end(end)
+  {}
+
+  /// Get iterator to first node.
+  ///
+  /// \return Iterator
+  Iterator begin() const { return m_begin; }
+
+  /// Get end iterator.
+  ///
+  /// \return Iterator
+  Iterator end() const { return m_end; }
+
+private:
+  Iterator m_begin;
+  Iterator m_end;
+};
+
+/// Traverse the subtrees at a given depth in parallel.
+///
+/// The entries of the nodes at splitDepth (and of shallower leaves) are
+/// collected depth-first and distributed over threads. The function is
+/// called once per subtree, as function(entry), and typically traverses it
+/// with an NTreeIteratorDF started at the entry. The nodes above
+/// splitDepth are not passed to the function.
+///
+/// \param[in] root Entry of root node
+/// \param[in] splitDepth Depth of subtree roots, relative to root
+/// \param[in] threads Maximum number of threads (0 = hardware concurrency)
+/// \param[in] function Function (object) called per subtree
+/// \return Number of subtrees
+template<size_t N, typename T, typename Bounds, typename Function>
+size_t
+parallelForSubtrees(const NTreeEntry<N, T, Bounds>& root,
+                    size_t splitDepth,
+                    size_t threads,
+                    Function function)
+{
+  std::vector<NTreeEntry<N, T, Bounds>> subtrees;
+  for (NTreeIteratorDF<N, T, Bounds> it(root), end; it != end; ++it) {
+    if (it->depth == root.depth + splitDepth || it->node->isLeaf()) {
+      subtrees.push_back(*it);
+      it.skipChildren();
+    }
+  }
+
+  parallelFor(
+    subtrees.size(),
+    threads,
+    [&](size_t, size_t begin, size_t end) {
+      for (size_t i = begin; i < end; i++) {
+        function(subtrees[i]);
+      }
+    },
+    1);
+  return subtrees.size();
+}
+
+} // namespace idx
+} // namespace spgl
+
+#endif // SPATIUMGL_IDX_NTREEITERATOR_H
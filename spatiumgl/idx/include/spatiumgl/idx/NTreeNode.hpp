@@ -14,66 +14,93 @@
 #define SPATIUMGL_IDX_NTREENODE_H
 
 #include "spatiumglexport.hpp"
+#include "spatiumgl/idx/SlabAllocator.hpp"
 
-#include <array> // std::array
+#include <array>   // std::array
+#include <utility> // std::forward
+#include <vector>  // std::vector
 
 namespace spgl {
 namespace idx {
 
+/// \class NTreeNodeData
+/// \brief Payload of a tree node.
+template<typename T>
+class SPATIUMGL_EXPORT NTreeNodeData
+{
+public:
+  /// Constructor.
+  ///
+  /// \param[in] args Payload constructor arguments
+  template<typename... Args>
+  explicit NTreeNodeData(Args&&... args)
+    : m_data(std::forward<Args>(args)...)
+  {}
+
+  /// Get payload.
+  ///
+  /// \return Payload
+  T& data() { return m_data; }
+
+  /// Get payload.
+  ///
+  /// \return Payload
+  const T& data() const { return m_data; }
+
+protected:
+  T m_data;
+};
+
+/// \class NTreeNodeData
+/// \brief No payload.
+template<>
+class SPATIUMGL_EXPORT NTreeNodeData<void>
+{};
+
 /// \class NTreeNode
 /// \brief Node in a tree with a fixed number of children.
-template<size_t N>
-class SPATIUMGL_EXPORT NTreeNode
+///
+/// Nodes are allocated by the allocator of the tree they belong to (see
+/// NTree). Create and delete nodes with createChild() and deleteChild().
+///
+/// \tparam N Number of children
+/// \tparam T Payload type (void for none)
+template<size_t N, typename T = void>
+class SPATIUMGL_EXPORT NTreeNode : public NTreeNodeData<T>
 {
 public:
+  /// Allocator for nodes
+  using Allocator = SlabAllocator<NTreeNode<N, T>>;
+
   /// Constructor.
   ///
-  /// \param[in] object Object
-  NTreeNode()
-    : m_children()
+  /// \param[in] allocator Allocator for child nodes
+  /// \param[in] args Payload constructor arguments
+  template<typename... Args>
+  explicit NTreeNode(Allocator* allocator, Args&&... args)
+    : NTreeNodeData<T>(std::forward<Args>(args)...)
+    , m_children()
+    , m_allocator(allocator)
   {}
 
   /// Copy constructor.
   NTreeNode(const NTreeNode& other) = delete;
 
-  /// Move constructor.
-  NTreeNode(NTreeNode&& other)
-    : m_children()
-  {
-    m_children.swap(other.m_children);
-  }
-
   /// Copy assignment operator.
   NTreeNode& operator=(const NTreeNode& other) = delete;
 
-  /// Move assignment operator.
-  NTreeNode& operator=(NTreeNode&& other)
-  {
-    if (this != &other) {
-      for (size_t i = 0; i < N; i++) {
-        delete m_children[i];
-        m_children[i] = nullptr;
-      }
-      m_children.swap(other.m_children);
-    }
-    return *this;
-  }
-
   /// Destructor.
-  ~NTreeNode()
-  {
-    for (size_t i = 0; i < N; i++) {
-      delete m_children[i];
-      m_children[i] = nullptr;
-    }
-  }
+  ///
+  /// Children are NOT destructed. They are owned by the allocator.
+  ~NTreeNode() = default;
 
   /// Create a child.
   ///
   /// \param[in] index Child index
-  /// \param[in] object Object
+  /// \param[in] args Payload constructor arguments
   /// \return True if created, false if child already exists.
-  bool createChild(size_t index)
+  template<typename... Args>
+  bool createChild(size_t index, Args&&... args)
   {
     if (index >= N) {
       return false;
@@ -83,7 +110,8 @@ public:
       return false;
     }
 
-    m_children[index] = new NTreeNode<N>;
+    m_children[index] =
+      m_allocator->create(m_allocator, std::forward<Args>(args)...);
     return true;
   }
 
@@ -101,7 +129,7 @@ public:
       return false;
     }
 
-    delete m_children[index];
+    destroy(m_allocator, m_children[index]);
     m_children[index] = nullptr;
 
     return true;
@@ -111,7 +139,7 @@ public:
   ///
   /// \param[in] index Child index
   /// \return Child or nullptr
-  NTreeNode<N>* child(size_t index) const
+  NTreeNode<N, T>* child(size_t index) const
   {
     if (index >= N) {
       return nullptr;
@@ -121,11 +149,24 @@ public:
     return m_children[index];
   }
 
+  /// Check whether node has no children.
+  ///
+  /// \return True if leaf, false otherwise
+  bool isLeaf() const
+  {
+    for (size_t i = 0; i < N; i++) {
+      if (m_children[i] != nullptr) {
+        return false;
+      }
+    }
+    return true;
+  }
+
   /// Get child index.
   ///
   /// \param[in] node Child node
   /// \return Index if found, N otherwise.
-  size_t childIndex(const NTreeNode<N>* child) const
+  size_t childIndex(const NTreeNode<N, T>* child) const
   {
     if (child == nullptr) {
       return N;
@@ -140,8 +181,29 @@ public:
     return N;
   }
 
+  /// Destruct a node and all its descendants. (iteratively)
+  ///
+  /// \param[in] allocator Allocator of the nodes
+  /// \param[in] node Node
+  static void destroy(Allocator* allocator, NTreeNode<N, T>* node)
+  {
+    std::vector<NTreeNode<N, T>*> stack;
+    stack.push_back(node);
+    while (!stack.empty()) {
+      NTreeNode<N, T>* current = stack.back();
+      stack.pop_back();
+      for (NTreeNode<N, T>* child : current->m_children) {
+        if (child != nullptr) {
+          stack.push_back(child);
+        }
+      }
+      allocator->destroy(current);
+    }
+  }
+
 protected:
-  std::array<NTreeNode<N>*, N> m_children;
+  std::array<NTreeNode<N, T>*, N> m_children;
+  Allocator* m_allocator;
 };
 
 } // namespace idx
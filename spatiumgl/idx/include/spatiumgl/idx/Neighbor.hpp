@@ -0,0 +1,56 @@
+/*
+ * Program: Spatium Graphics Library
+ *
+ * Copyright (C) Martijn Koopman
+ * All Rights Reserved
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.
+ *
+ */
+
+#ifndef SPATIUMGL_IDX_NEIGHBOR_H
+#define SPATIUMGL_IDX_NEIGHBOR_H
+
+#include "spatiumglexport.hpp"
+
+#include <cstdint> // std::uint32_t
+
+namespace spgl {
+namespace idx {
+
+/// \struct NeighborT
+/// \brief Result of a nearest neighbor query.
+template<typename T>
+struct SPATIUMGL_EXPORT NeighborT
+{
+  /// Index of the point (InvalidIndex if there is no neighbor)
+  std::uint32_t index;
+
+  /// Squared distance to the query point
+  T distanceSquared;
+
+  /// Invalid point index
+  static const std::uint32_t InvalidIndex = 0xffffffff;
+};
+
+template<typename T>
+const std::uint32_t NeighborT<T>::InvalidIndex;
+
+/// Compare neighbors by distance.
+///
+/// \param[in] a Neighbor
+/// \param[in] b Neighbor
+/// \return True if a is nearer than b
+template<typename T>
+inline bool
+nearer(const NeighborT<T>& a, const NeighborT<T>& b)
+{
+  return a.distanceSquared < b.distanceSquared;
+}
+
+} // namespace idx
+} // namespace spgl
+
+#endif // SPATIUMGL_IDX_NEIGHBOR_H
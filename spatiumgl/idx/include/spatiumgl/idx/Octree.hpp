@@ -13,22 +13,345 @@
 #ifndef SPATIUMGL_IDX_OCTREE_H
 #define SPATIUMGL_IDX_OCTREE_H
 
+#include "spatiumgl/Frustum.hpp"
 #include "spatiumgl/idx/NTree.hpp"
+#include "spatiumgl/idx/Neighbor.hpp"
 
+#include <array>   // std::array
+#include <cmath>   // std::abs
+#include <cstdint> // std::uint32_t
 #include <fstream> // std::ofstream, std::ifstream
 #include <queue>   // std::queue
 #include <cstring> // std::memcmp
+#include <vector>  // std::vector
 
 namespace spgl {
 namespace idx {
 
-class SPATIUMGL_EXPORT Octree : public NTree<8>
+/// \struct OctreePointRange
+/// \brief Range [begin, end) of points in the point indices of an octree.
+struct SPATIUMGL_EXPORT OctreePointRange
+{
+  OctreePointRange(size_t begin = 0, size_t end = 0)
+    : begin(begin)
+    , end(end)
+  {}
+
+  /// Get number of points.
+  ///
+  /// \return Number of points
+  size_t size() const { return end - begin; }
+
+  size_t begin;
+  size_t end;
+};
+
+using OctreeNode = NTreeNode<8, OctreePointRange>;
+
+/// Result of a nearest neighbor query in an octree
+using OctreeNeighbor = NeighborT<float>;
+
+/// Bounds of octree child nodes.
+///
+/// Bit 0 of the child index is left/right (X), bit 1 front/back (Y) and
+/// bit 2 bottom/top (Z).
+template<>
+struct NTreeChildBounds<BoundingCube, 8>
+{
+  static BoundingCube compute(const BoundingCube& parent, size_t childIndex)
+  {
+    const double radius = parent.radius() / 2;
+    Vector3 center = parent.center();
+    center += Vector3((childIndex & 1) != 0 ? radius : -radius,
+                      (childIndex & 2) != 0 ? radius : -radius,
+                      (childIndex & 4) != 0 ? radius : -radius);
+    return { center, radius };
+  }
+};
+
+/// Node visited by an octree iterator, with its bounds
+using OctreeEntry = NTreeEntry<8, OctreePointRange, BoundingCube>;
+
+class SPATIUMGL_EXPORT Octree : public NTree<8, OctreePointRange>
 {
 public:
   Octree(const BoundingCube& bounds)
     : m_bounds(bounds)
+    , m_indices()
+    , m_points()
   {}
 
+  /// Build octree from points.
+  ///
+  /// The points are sorted along a Z-order curve: 63-bit Morton codes are
+  /// computed for all points and radix sorted, both in parallel. Nodes are
+  /// derived from the shared prefixes of the sorted codes. A node with more
+  /// than maxPointsPerLeaf points is subdivided, unless all its points share
+  /// the same Morton code (maximum depth 21).
+  ///
+  /// The points of every node (leaf or not) are a contiguous range in
+  /// indices(), see OctreeNode::data().
+  ///
+  /// \param[in] positions Point positions
+  /// \param[in] count Number of points (< 2^32)
+  /// \param[in] maxPointsPerLeaf Maximum number of points per leaf node
+  /// \param[in] threads Maximum number of threads (0 = hardware concurrency)
+  /// \return Octree
+  static Octree build(const Vector3f* positions,
+                      size_t count,
+                      size_t maxPointsPerLeaf,
+                      size_t threads = 0);
+
+  /// Build octree from points.
+  ///
+  /// \param[in] positions Point positions (for example PointCloudData)
+  /// \param[in] maxPointsPerLeaf Maximum number of points per leaf node
+  /// \param[in] threads Maximum number of threads (0 = hardware concurrency)
+  /// \return Octree
+  static Octree build(const std::vector<Vector3f>& positions,
+                      size_t maxPointsPerLeaf,
+                      size_t threads = 0)
+  {
+    return build(positions.data(), positions.size(), maxPointsPerLeaf, threads);
+  }
+
+  /// Voxelize points into an occupancy octree.
+  ///
+  /// Every occupied voxel of a regular grid of 2^maxDepth voxels per axis
+  /// becomes a leaf at depth maxDepth. The Morton codes of the voxels are
+  /// computed and radix sorted in parallel and duplicates are removed. The
+  /// nodes are then created in one sweep over the sorted codes: nodes shared
+  /// with the previous code are reused, so no point descends the tree.
+  ///
+  /// Points outside the bounds are ignored. The octree only holds topology:
+  /// indices(), points() and the point ranges of the nodes stay empty.
+  ///
+  /// \param[in] positions Point positions
+  /// \param[in] count Number of points
+  /// \param[in] bounds Bounds of the octree
+  /// \param[in] maxDepth Depth of the leaves (<= 21)
+  /// \param[in] threads Maximum number of threads (0 = hardware concurrency)
+  /// \return Octree
+  static Octree fromPoints(const Vector3f* positions,
+                           size_t count,
+                           const BoundingCube& bounds,
+                           size_t maxDepth,
+                           size_t threads = 0);
+
+  /// Voxelize points into an occupancy octree.
+  ///
+  /// \param[in] positions Point positions (for example PointCloudData)
+  /// \param[in] bounds Bounds of the octree
+  /// \param[in] maxDepth Depth of the leaves (<= 21)
+  /// \param[in] threads Maximum number of threads (0 = hardware concurrency)
+  /// \return Octree
+  static Octree fromPoints(const std::vector<Vector3f>& positions,
+                           const BoundingCube& bounds,
+                           size_t maxDepth,
+                           size_t threads = 0)
+  {
+    return fromPoints(
+      positions.data(), positions.size(), bounds, maxDepth, threads);
+  }
+
+  /// Get point indices.
+  ///
+  /// Indices of the points the octree was built from, sorted in Z-order.
+  /// Empty if the octree was not built from points.
+  ///
+  /// \return Point indices
+  const std::vector<std::uint32_t>& indices() const { return m_indices; }
+
+  /// Get point positions.
+  ///
+  /// Copy of the positions the octree was built from, in the order of
+  /// indices(): points()[i] is the position of point indices()[i].
+  ///
+  /// \return Point positions
+  const std::vector<Vector3f>& points() const { return m_points; }
+
+  /// Find the k nearest points.
+  ///
+  /// The nodes are visited best-first, nearest node first, until no node can
+  /// contain a point nearer than the k-th nearest point found. Scratch
+  /// memory is kept per thread, so repeated queries do not allocate.
+  ///
+  /// \param[in] query Query position
+  /// \param[in] k Number of neighbors
+  /// \param[out] result Neighbors sorted by distance (k elements)
+  /// \return Number of neighbors found (min(k, number of points)). Remaining
+  ///         elements get index OctreeNeighbor::InvalidIndex.
+  size_t knn(const Vector3f& query, size_t k, OctreeNeighbor* result) const;
+
+  /// Find the k nearest points.
+  ///
+  /// \param[in] query Query position
+  /// \param[in] k Number of neighbors
+  /// \return Neighbors sorted by distance (at most k)
+  std::vector<OctreeNeighbor> knn(const Vector3f& query, size_t k) const
+  {
+    std::vector<OctreeNeighbor> result(k);
+    result.resize(knn(query, k, result.data()));
+    return result;
+  }
+
+  /// Find the k nearest points of many query positions. (parallel)
+  ///
+  /// \param[in] queries Query positions
+  /// \param[in] count Number of query positions
+  /// \param[in] k Number of neighbors
+  /// \param[out] result Neighbors (k elements per query, see knn())
+  /// \param[in] threads Maximum number of threads (0 = hardware concurrency)
+  void knn(const Vector3f* queries,
+           size_t count,
+           size_t k,
+           OctreeNeighbor* result,
+           size_t threads = 0) const;
+
+  /// Find the k nearest points of many query positions. (parallel)
+  ///
+  /// \param[in] queries Query positions
+  /// \param[in] k Number of neighbors
+  /// \param[in] threads Maximum number of threads (0 = hardware concurrency)
+  /// \return Neighbors (k elements per query, see knn())
+  std::vector<OctreeNeighbor> knn(const std::vector<Vector3f>& queries,
+                                  size_t k,
+                                  size_t threads = 0) const
+  {
+    std::vector<OctreeNeighbor> result(queries.size() * k);
+    knn(queries.data(), queries.size(), k, result.data(), threads);
+    return result;
+  }
+
+  /// Visit all points within a radius of a position.
+  ///
+  /// Nodes are pruned by their bounds. Points of nodes completely inside the
+  /// sphere are visited without testing them one by one.
+  ///
+  /// \param[in] center Center of sphere
+  /// \param[in] radius Radius of sphere
+  /// \param[in] visitor Function (object) called as visitor(index) for
+  ///                    every point (index of point, see indices())
+  template<typename Visitor>
+  void visitRadius(const Vector3f& center, float radius, Visitor visitor) const
+  {
+    const float radiusSquared = radius * radius;
+    visitPoints(
+      [&](const BoundingCube& bounds) {
+        // Nearest and farthest distance from center to cube
+        double nearest = 0;
+        double farthest = 0;
+        for (size_t axis = 0; axis < 3; axis++) {
+          const double delta = std::abs(center[axis] - bounds.center()[axis]);
+          const double outside = delta - bounds.radius();
+          nearest += (outside > 0 ? outside * outside : 0);
+          farthest += (delta + bounds.radius()) * (delta + bounds.radius());
+        }
+        if (nearest > radiusSquared) {
+          return Visibility::Outside;
+        }
+        return (farthest <= radiusSquared ? Visibility::Inside
+                                          : Visibility::Intersect);
+      },
+      [&](const Vector3f& point) {
+        const Vector3f delta = point - center;
+        return delta[0] * delta[0] + delta[1] * delta[1] +
+                 delta[2] * delta[2] <=
+               radiusSquared;
+      },
+      visitor);
+  }
+
+  /// Visit all points inside a box.
+  ///
+  /// Nodes are pruned by their bounds. Points of nodes completely inside the
+  /// box are visited without testing them one by one.
+  ///
+  /// \param[in] box Box (inclusive)
+  /// \param[in] visitor Function (object) called as visitor(index) for
+  ///                    every point (index of point, see indices())
+  template<typename Visitor>
+  void visitBox(const BoundingBox& box, Visitor visitor) const
+  {
+    const Vector3 boxMin = box.min();
+    const Vector3 boxMax = box.max();
+    visitPoints(
+      [&](const BoundingCube& bounds) {
+        bool inside = true;
+        for (size_t axis = 0; axis < 3; axis++) {
+          const double min = bounds.center()[axis] - bounds.radius();
+          const double max = bounds.center()[axis] + bounds.radius();
+          if (max < boxMin[axis] || min > boxMax[axis]) {
+            return Visibility::Outside;
+          }
+          inside = inside && min >= boxMin[axis] && max <= boxMax[axis];
+        }
+        return (inside ? Visibility::Inside : Visibility::Intersect);
+      },
+      [&](const Vector3f& point) {
+        return point[0] >= boxMin[0] && point[0] <= boxMax[0] &&
+               point[1] >= boxMin[1] && point[1] <= boxMax[1] &&
+               point[2] >= boxMin[2] && point[2] <= boxMax[2];
+      },
+      visitor);
+  }
+
+  /// Find all points within a radius of a position.
+  ///
+  /// \param[in] center Center of sphere
+  /// \param[in] radius Radius of sphere
+  /// \param[out] result Point indices (cleared first; reuse to avoid
+  ///                    allocations)
+  /// \return Number of points found
+  size_t radiusQuery(const Vector3f& center,
+                     float radius,
+                     std::vector<std::uint32_t>& result) const
+  {
+    result.clear();
+    visitRadius(center, radius, [&](std::uint32_t index) {
+      result.push_back(index);
+    });
+    return result.size();
+  }
+
+  /// Find all points inside a box.
+  ///
+  /// \param[in] box Box (inclusive)
+  /// \param[out] result Point indices (cleared first; reuse to avoid
+  ///                    allocations)
+  /// \return Number of points found
+  size_t boxQuery(const BoundingBox& box,
+                  std::vector<std::uint32_t>& result) const
+  {
+    result.clear();
+    visitBox(box, [&](std::uint32_t index) { result.push_back(index); });
+    return result.size();
+  }
+
+  /// Find all points within a radius of many positions. (parallel)
+  ///
+  /// \param[in] centers Centers of spheres
+  /// \param[in] count Number of spheres
+  /// \param[in] radius Radius of spheres
+  /// \param[out] results Point indices per sphere (count elements)
+  /// \param[in] threads Maximum number of threads (0 = hardware concurrency)
+  void radiusQuery(const Vector3f* centers,
+                   size_t count,
+                   float radius,
+                   std::vector<std::uint32_t>* results,
+                   size_t threads = 0) const;
+
+  /// Find all points inside many boxes. (parallel)
+  ///
+  /// \param[in] boxes Boxes (inclusive)
+  /// \param[in] count Number of boxes
+  /// \param[out] results Point indices per box (count elements)
+  /// \param[in] threads Maximum number of threads (0 = hardware concurrency)
+  void boxQuery(const BoundingBox* boxes,
+                size_t count,
+                std::vector<std::uint32_t>* results,
+                size_t threads = 0) const;
+
   /// Get bounds of entire octree. (cubical)
   ///
   /// \return Bounds
@@ -42,71 +365,110 @@ public:
   static BoundingCube computeChildBounds(const BoundingCube& parentBounds,
                                          size_t childIndex);
 
+  /// Get entry of the root node, to start iterators and parallel traversal.
+  ///
+  /// \return Entry
+  OctreeEntry rootEntry() const { return { root(), m_bounds, 0, 0 }; }
+
+  /// Traverse the octree depth-first (pre-order), with node bounds.
+  ///
+  /// Usage: for (const OctreeEntry& entry : octree.depthFirst()) { ... }
+  ///
+  /// \param[in] predicate Pruning predicate (see NTreeIteratorDF)
+  /// \return Range of OctreeEntry
+  template<typename Predicate = NTreeVisitAll>
+  NTreeRange<NTreeIteratorDF<8, OctreePointRange, BoundingCube, Predicate>>
+  depthFirst(Predicate predicate = Predicate()) const
+  {
+    using Iterator =
+      NTreeIteratorDF<8, OctreePointRange, BoundingCube, Predicate>;
+    return NTreeRange<Iterator>(Iterator(rootEntry(), predicate),
+                                Iterator(predicate));
+  }
+
+  /// Traverse the octree breadth-first, with node bounds.
+  ///
+  /// \param[in] predicate Pruning predicate (see NTreeIteratorBF)
+  /// \return Range of OctreeEntry
+  template<typename Predicate = NTreeVisitAll>
+  NTreeRange<NTreeIteratorBF<8, OctreePointRange, BoundingCube, Predicate>>
+  breadthFirst(Predicate predicate = Predicate()) const
+  {
+    using Iterator =
+      NTreeIteratorBF<8, OctreePointRange, BoundingCube, Predicate>;
+    return NTreeRange<Iterator>(
+      Iterator(rootEntry(), 8, predicate), Iterator(predicate));
+  }
+
   /// Write octree to file.
   ///
   /// File format:
   /// 1. ASCII signature: SPATIUMGL_OCTREE\n
   /// 2. Extent: Xmin, Ymin, Zmin, Xmax, Ymax, Zmax (64-bit floating points)
   /// 3. Nodes: 1 byte (8 bits) per node. 1 bit for each child.
+  ///
+  /// The nodes are collected in memory and written at once.
+  ///
+  /// \param[in] octree Octree
+  /// \param[in] fileName Path to octree file. Should have file extension .idx
+  /// \return Number of bytes written (0 on failure)
   static size_t writeToFile(const Octree& octree, const std::string& fileName)
   {
-    size_t bytesWritten = 0;
     std::ofstream ofile(fileName, std::ios::out | std::ios::binary);
     if (!ofile.is_open()) {
-      return bytesWritten;
+      return 0;
     }
 
-    ofile.write("SPATIUMGL_OCTREE\n", 17);
-    bytesWritten += 17;
+    const char* signature = "SPATIUMGL_OCTREE\n";
+    std::vector<char> buffer(signature, signature + 17);
     // xmin, ymin, zmin
     // xmax, ymax, zmax
 
-    std::queue<const OctreeNode*> queue;
-    queue.push(octree.root());
-    while (!queue.empty()) {
-      // Pop front of queue
-      const OctreeNode* node = queue.front();
-      queue.pop();
-
-      // Iterate children
+    buffer.reserve(buffer.size() + octree.nodeCount());
+    for (const OctreeEntry& entry : octree.breadthFirst()) {
+      // 1 bit per child, first child in the most significant bit
       unsigned char bits = 0x00;
-      for (unsigned char i = 0; i < 8; i++) {
-        const OctreeNode* child = node->child(static_cast<size_t>(i));
-        if (child != nullptr) {
-          // Set bit to 1 for this child
-          unsigned char mask = static_cast<unsigned char>(0x01 << (7 - i));
-          bits |= mask;
-
-          // Add child to queue
-          queue.push(child);
+      for (size_t i = 0; i < 8; i++) {
+        if (entry.node->child(i) != nullptr) {
+          bits |= static_cast<unsigned char>(0x01 << (7 - i));
         }
       }
-
-      // Write current node to file
-      ofile.write(reinterpret_cast<const char*>(&bits), 1);
-      bytesWritten++;
+      buffer.push_back(static_cast<char>(bits));
     }
 
-    return bytesWritten;
+    ofile.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    return (ofile.good() ? buffer.size() : 0);
   }
 
   /// Read octree from file.
   ///
-  /// \param[in] path Path to octree file. Should have file extension .idx
+  /// The file is read with one bulk read.
+  ///
+  /// \param[in] fileName Path to octree file. Should have file extension .idx
   /// \param[out] octree Octree
   /// \return True on success, false otherwise
   static bool readFromFile(const std::string& fileName, Octree& octree)
   {
     // Open file
-    std::ifstream ifile(fileName, std::ios::in | std::ios::binary);
+    std::ifstream ifile(fileName,
+                        std::ios::in | std::ios::binary | std::ios::ate);
     if (!ifile.is_open()) {
       return false;
     }
 
-    // Read signature
-    char signature[17];
-    ifile.read(signature, 17);
-    if (std::memcmp(signature, "SPATIUMGL_OCTREE\n", 17) != 0) {
+    // Read entire file
+    const std::streamoff size = ifile.tellg();
+    if (size < 17) {
+      return false;
+    }
+    std::vector<char> buffer(static_cast<size_t>(size));
+    ifile.seekg(0);
+    if (!ifile.read(buffer.data(), size)) {
+      return false;
+    }
+
+    // Check signature
+    if (std::memcmp(buffer.data(), "SPATIUMGL_OCTREE\n", 17) != 0) {
       return false;
     }
 
@@ -118,16 +480,14 @@ public:
     // Traverse tree breadth-first with queue
     std::queue<OctreeNode*> queue;
     queue.push(octree.root());
-    while (!queue.empty() && !ifile.eof()) {
+    for (size_t offset = 17; offset < buffer.size() && !queue.empty();
+         offset++) {
       // Pop front of queue
       OctreeNode* node = queue.front();
       queue.pop();
 
-      // Read children bits from file
-      unsigned char bits;
-      ifile.read(reinterpret_cast<char*>(&bits), 1);
-
       // Iterate bits
+      const unsigned char bits = static_cast<unsigned char>(buffer[offset]);
       for (unsigned char i = 0; i < 8; i++) {
         unsigned char mask = static_cast<unsigned char>(0x01 << (7 - i));
         bool hasChild = ((bits & mask) > 0 ? true : false);
@@ -136,7 +496,6 @@ public:
           if (node->createChild(static_cast<size_t>(i))) {
             queue.push(node->child(static_cast<size_t>(i)));
           }
-          /// \TODO Check for allocation error
         }
       }
     }
@@ -145,7 +504,67 @@ public:
   }
 
 protected:
+  /// Visit points of nodes that pass a test.
+  ///
+  /// \param[in] nodeTest Function returning the Visibility of node bounds
+  /// \param[in] pointTest Function returning whether to visit a point of an
+  ///                      intersecting leaf node
+  /// \param[in] visitor Function called with the index of visited points
+  template<typename NodeTest, typename PointTest, typename Visitor>
+  void visitPoints(NodeTest nodeTest,
+                   PointTest pointTest,
+                   Visitor visitor) const
+  {
+    if (m_points.empty()) {
+      return;
+    }
+
+    // At most 7 siblings per level stay on the stack (depth <= 21)
+    struct Entry
+    {
+      const OctreeNode* node;
+      BoundingCube bounds;
+    };
+    std::array<Entry, 8 * 22> stack;
+    size_t size = 0;
+
+    // Points may be slightly outside their node due to rounding
+    const double slack = m_bounds.radius() * 1e-6;
+    stack[size++] = { root(), m_bounds };
+    while (size > 0) {
+      const Entry entry = stack[--size];
+      const BoundingCube bounds(entry.bounds.center(),
+                                entry.bounds.radius() + slack);
+      const Visibility visibility = nodeTest(bounds);
+      if (visibility == Visibility::Outside) {
+        continue;
+      }
+
+      const OctreePointRange& range = entry.node->data();
+      if (visibility == Visibility::Inside) {
+        for (size_t i = range.begin; i < range.end; i++) {
+          visitor(m_indices[i]);
+        }
+      } else if (entry.node->isLeaf()) {
+        for (size_t i = range.begin; i < range.end; i++) {
+          if (pointTest(m_points[i])) {
+            visitor(m_indices[i]);
+          }
+        }
+      } else {
+        for (size_t i = 8; i-- > 0;) {
+          const OctreeNode* child = entry.node->child(i);
+          if (child != nullptr) {
+            stack[size++] = { child, computeChildBounds(entry.bounds, i) };
+          }
+        }
+      }
+    }
+  }
+
   BoundingCube m_bounds;
+  std::vector<std::uint32_t> m_indices;
+  std::vector<Vector3f> m_points;
 };
 
 } // namespace idx
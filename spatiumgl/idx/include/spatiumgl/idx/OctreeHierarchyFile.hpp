@@ -0,0 +1,209 @@
+/*
+ * Program: Spatium Graphics Library
+ *
+ * Copyright (C) Martijn Koopman
+ * All Rights Reserved
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.
+ *
+ */
+
+#ifndef SPATIUMGL_IDX_OCTREEHIERARCHYFILE_H
+#define SPATIUMGL_IDX_OCTREEHIERARCHYFILE_H
+
+#include "spatiumglexport.hpp"
+#include "spatiumgl/Bounds.hpp"
+#include "spatiumgl/idx/Octree.hpp"
+
+#include <cstdint>       // std::uint8_t, std::uint32_t, std::uint64_t
+#include <string>        // std::string
+#include <unordered_map> // std::unordered_map
+#include <vector>        // std::vector
+
+namespace spgl {
+namespace idx {
+
+/// \class OctreeHierarchyFile
+/// \brief Octree hierarchy file, paged for random access.
+///
+/// The hierarchy is split in pages: subtrees of pageDepth levels. Every page
+/// stores the child masks of its nodes in breadth-first order, followed by
+/// the file offsets of the pages rooted at the children of its deepest
+/// level. Opening a file only maps it into memory and checks the header.
+/// Pages are parsed lazily, when a node in them is first accessed.
+///
+/// File format (little endian):
+/// 1. Header (80 bytes):
+///    - ASCII signature: SPATIUMGL_OCTREE_PAGED\n (23 bytes)
+///    - Version (uint8, 1)
+///    - Page depth (uint32)
+///    - Point spacing at the root (32-bit floating point, 0 = unknown)
+///    - Bounds: center X, Y, Z, radius (64-bit floating points)
+///    - Offset of root page (uint64)
+///    - Number of nodes (uint64)
+/// 2. Pages, each aligned to 8 bytes:
+///    - Number of nodes (uint32), number of child pages (uint32)
+///    - Child masks (uint8 per node, bit i = child i), padded to 8 bytes
+///    - Offsets of child pages (uint64 each), in breadth-first order
+///
+/// Navigation is not thread-safe: it may load pages.
+class SPATIUMGL_EXPORT OctreeHierarchyFile
+{
+public:
+  /// \struct Node
+  /// \brief Handle to a node in the hierarchy.
+  struct Node
+  {
+    std::uint32_t page;  ///< Index of loaded page
+    std::uint32_t index; ///< Index of node in page
+  };
+
+  /// Constructor.
+  OctreeHierarchyFile();
+
+  /// Copy constructor.
+  OctreeHierarchyFile(const OctreeHierarchyFile& other) = delete;
+
+  /// Copy assignment operator.
+  OctreeHierarchyFile& operator=(const OctreeHierarchyFile& other) = delete;
+
+  /// Destructor.
+  ///
+  /// Closes the file.
+  ~OctreeHierarchyFile();
+
+  /// Write octree hierarchy to file.
+  ///
+  /// Pages are written children first, each with a single write.
+  ///
+  /// \param[in] octree Octree
+  /// \param[in] fileName Path to file
+  /// \param[in] pageDepth Number of levels per page (>= 1)
+  /// \param[in] spacing Point spacing at the root (0 = unknown)
+  /// \return Number of bytes written (0 on failure)
+  static size_t write(const Octree& octree,
+                      const std::string& fileName,
+                      size_t pageDepth = 6,
+                      float spacing = 0);
+
+  /// Open file.
+  ///
+  /// Maps the file into memory, and reads the header and the root page.
+  /// Other pages are read on demand.
+  ///
+  /// \param[in] fileName Path to file
+  /// \return True on success, false otherwise (e.g. corrupt root page)
+  bool open(const std::string& fileName);
+
+  /// Close file.
+  void close();
+
+  /// Check whether a file is open.
+  ///
+  /// \return True if open, false otherwise
+  bool isOpen() const { return m_data != nullptr; }
+
+  /// Get bounds of entire octree.
+  ///
+  /// \return Bounds
+  const BoundingCube& bounds() const { return m_bounds; }
+
+  /// Get number of levels per page.
+  ///
+  /// \return Page depth
+  size_t pageDepth() const { return m_pageDepth; }
+
+  /// Get point spacing at the root.
+  ///
+  /// Nodes at depth d have a spacing of spacing() / 2^d.
+  ///
+  /// \return Spacing (0 = unknown)
+  float spacing() const { return m_spacing; }
+
+  /// Get number of nodes in the hierarchy.
+  ///
+  /// \return Number of nodes
+  size_t nodeCount() const { return m_nodeCount; }
+
+  /// Get number of pages loaded so far.
+  ///
+  /// \return Number of pages
+  size_t loadedPageCount() const { return m_pages.size(); }
+
+  /// Get root node.
+  ///
+  /// The file must be open.
+  ///
+  /// \return Root node
+  Node root();
+
+  /// Get child mask of a node.
+  ///
+  /// \param[in] node Node
+  /// \return Child mask (bit i set if child i exists)
+  std::uint8_t childMask(const Node& node) const
+  {
+    return m_pages[node.page].masks[node.index];
+  }
+
+  /// Get child of a node.
+  ///
+  /// Loads the page of the child if not loaded yet.
+  ///
+  /// \param[in] node Node
+  /// \param[in] childIndex Child index (0-7)
+  /// \param[out] result Child node
+  /// \return True if the child exists, false otherwise or if its page is
+  ///         invalid (e.g. it does not precede the page of the node)
+  bool child(const Node& node, size_t childIndex, Node& result);
+
+  /// Read entire hierarchy into an octree.
+  ///
+  /// \param[out] octree Octree (bounds are taken from the file)
+  /// \return True on success, false otherwise
+  bool readOctree(Octree& octree);
+
+private:
+  /// Parsed page
+  struct Page
+  {
+    const std::uint8_t* masks;
+    const unsigned char* childPageOffsets;
+    std::uint64_t offset; // File offset
+    std::uint32_t nodeCount;
+    std::uint32_t childPageCount;
+
+    /// First child per node: index in page, or in the child page offsets
+    /// for nodes of the deepest level (see lastLevelBegin).
+    std::vector<std::uint32_t> firstChild;
+    std::uint32_t lastLevelBegin;
+  };
+
+  /// Load page at file offset, if not loaded yet.
+  ///
+  /// \param[in] offset File offset
+  /// \param[out] page Page index
+  /// \return True on success, false if the page is invalid
+  bool loadPage(std::uint64_t offset, std::uint32_t& page);
+
+  const unsigned char* m_data;
+  size_t m_size;
+#if defined(_WIN32)
+  void* m_fileHandle;
+  void* m_mappingHandle;
+#endif
+  BoundingCube m_bounds;
+  size_t m_pageDepth;
+  float m_spacing;
+  size_t m_nodeCount;
+  std::uint64_t m_rootOffset;
+  std::vector<Page> m_pages;
+  std::unordered_map<std::uint64_t, std::uint32_t> m_pageIndices;
+};
+
+} // namespace idx
+} // namespace spgl
+
+#endif // SPATIUMGL_IDX_OCTREEHIERARCHYFILE_H
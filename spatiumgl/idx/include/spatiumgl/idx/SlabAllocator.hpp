@@ -0,0 +1,129 @@
+/*
+ * Program: Spatium Graphics Library
+ *
+ * Copyright (C) Martijn Koopman
+ * All Rights Reserved
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.
+ *
+ */
+
+#ifndef SPATIUMGL_IDX_SLABALLOCATOR_H
+#define SPATIUMGL_IDX_SLABALLOCATOR_H
+
+#include "spatiumglexport.hpp"
+
+#include <memory>      // std::unique_ptr
+#include <new>         // placement new
+#include <type_traits> // std::aligned_storage
+#include <utility>     // std::forward
+#include <vector>      // std::vector
+
+namespace spgl {
+namespace idx {
+
+/// \class SlabAllocator
+/// \brief Allocator for objects of one type, in slabs of many objects.
+///
+/// Objects are constructed in large, contiguous slabs instead of with a heap
+/// allocation each. Destroyed objects are recycled by later create() calls.
+///
+/// The slabs are freed all at once when the allocator is destructed or
+/// released, WITHOUT calling the destructors of objects that are still alive.
+/// Destroy objects with non-trivial destructors first.
+template<typename T>
+class SPATIUMGL_EXPORT SlabAllocator
+{
+public:
+  /// Constructor.
+  ///
+  /// \param[in] slabSize Number of objects per slab
+  explicit SlabAllocator(size_t slabSize = 1024)
+    : m_slabs()
+    , m_freeList()
+    , m_slabSize(slabSize > 0 ? slabSize : 1)
+    , m_used(0)
+    , m_size(0)
+  {}
+
+  /// Copy constructor.
+  SlabAllocator(const SlabAllocator& other) = delete;
+
+  /// Copy assignment operator.
+  SlabAllocator& operator=(const SlabAllocator& other) = delete;
+
+  /// Construct an object.
+  ///
+  /// \param[in] args Constructor arguments
+  /// \return Object
+  template<typename... Args>
+  T* create(Args&&... args)
+  {
+    void* memory = nullptr;
+    if (!m_freeList.empty()) {
+      memory = m_freeList.back();
+      m_freeList.pop_back();
+    } else {
+      if (m_slabs.empty() || m_used == m_slabSize) {
+        m_slabs.emplace_back(new Storage[m_slabSize]);
+        m_used = 0;
+      }
+      memory = &m_slabs.back()[m_used++];
+    }
+    T* object = new (memory) T(std::forward<Args>(args)...);
+    m_size++;
+    return object;
+  }
+
+  /// Destruct an object.
+  ///
+  /// Its memory is reused by a next call to create().
+  ///
+  /// \param[in] object Object created by this allocator
+  void destroy(T* object)
+  {
+    if (object == nullptr) {
+      return;
+    }
+    object->~T();
+    m_freeList.push_back(object);
+    m_size--;
+  }
+
+  /// Free all slabs at once.
+  ///
+  /// Destructors of objects that are still alive are NOT called.
+  void release()
+  {
+    m_slabs.clear();
+    m_freeList.clear();
+    m_used = 0;
+    m_size = 0;
+  }
+
+  /// Get number of live objects.
+  ///
+  /// \return Number of objects
+  size_t size() const { return m_size; }
+
+  /// Get number of objects that fit in the allocated slabs.
+  ///
+  /// \return Number of objects
+  size_t capacity() const { return m_slabs.size() * m_slabSize; }
+
+private:
+  using Storage = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+
+  std::vector<std::unique_ptr<Storage[]>> m_slabs;
+  std::vector<void*> m_freeList;
+  size_t m_slabSize;
+  size_t m_used; // Number of used objects in last slab
+  size_t m_size;
+};
+
+} // namespace idx
+} // namespace spgl
+
+#endif // SPATIUMGL_IDX_SLABALLOCATOR_H
@@ -0,0 +1,214 @@
+/*
+ * Program: Spatium Graphics Library
+ *
+ * Copyright (C) Martijn Koopman
+ * All Rights Reserved
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.
+ *
+ */
+
+#ifndef SPATIUMGL_IDX_SPARSEVOXELDAG_H
+#define SPATIUMGL_IDX_SPARSEVOXELDAG_H
+
+#include "spatiumglexport.hpp"
+#include "spatiumgl/Bounds.hpp"
+#include "spatiumgl/idx/LinearOctree.hpp"
+#include "spatiumgl/idx/Octree.hpp"
+
+#include <cstdint> // std::uint8_t, std::uint32_t, std::uint64_t
+#include <string>  // std::string
+#include <vector>  // std::vector
+
+namespace spgl {
+namespace idx {
+
+/// \class SparseVoxelDag
+/// \brief Sparse voxel directed acyclic graph: read-only occupancy octree in
+///        which identical subtrees are stored once.
+///
+/// The topology of an octree is compressed bottom-up: every node is hashed
+/// by its child mask and the (already merged) nodes of its children, and
+/// equal nodes are merged. All leaves become a single node. Subtrees are
+/// merged across levels too; bounds are derived while traversing.
+///
+/// Nodes are stored in one array of 32-bit words. A node is identified by
+/// the offset of its first word, which holds the child mask (bit i = child
+/// i). It is followed by the offsets of its existing children, in child
+/// index order.
+class SPATIUMGL_EXPORT SparseVoxelDag
+{
+public:
+  /// Node offset
+  using NodeIndex = std::uint32_t;
+
+  /// Invalid node offset (no node)
+  static const NodeIndex InvalidNode = 0xffffffff;
+
+  /// Constructor.
+  ///
+  /// Constructs a DAG with only a root node (leaf).
+  ///
+  /// \param[in] bounds Bounds of entire octree
+  explicit SparseVoxelDag(const BoundingCube& bounds = BoundingCube());
+
+  /// Compress octree topology.
+  ///
+  /// The octree is traversed once, children first, with a stack of the
+  /// depth of the octree. No copy of the octree is made.
+  ///
+  /// \param[in] octree Octree
+  /// \return DAG
+  static SparseVoxelDag fromOctree(const Octree& octree);
+
+  /// Expand to a linear octree.
+  ///
+  /// \return Linear octree (with sourceNodeCount() nodes)
+  LinearOctree toLinearOctree() const;
+
+  /// Get bounds of entire octree. (cubical)
+  ///
+  /// \return Bounds
+  const BoundingCube& bounds() const { return m_bounds; }
+
+  /// Get number of unique nodes.
+  ///
+  /// \return Number of nodes (>= 1)
+  size_t nodeCount() const { return m_nodeCount; }
+
+  /// Get number of nodes of the octree the DAG was created from.
+  ///
+  /// \return Number of nodes (>= 1)
+  size_t sourceNodeCount() const
+  {
+    return static_cast<size_t>(m_sourceNodeCount);
+  }
+
+  /// Get root node.
+  ///
+  /// \return Root node offset
+  NodeIndex root() const { return m_root; }
+
+  /// Get child mask of node.
+  ///
+  /// \param[in] node Node offset
+  /// \return Child mask (bit i set if child i exists)
+  std::uint8_t childMask(NodeIndex node) const
+  {
+    return static_cast<std::uint8_t>(m_words[node]);
+  }
+
+  /// Check whether node has no children.
+  ///
+  /// \param[in] node Node offset
+  /// \return True if leaf, false otherwise
+  bool isLeaf(NodeIndex node) const { return m_words[node] == 0; }
+
+  /// Get child of node.
+  ///
+  /// \param[in] node Node offset
+  /// \param[in] childIndex Child index (0-7)
+  /// \return Child node offset or InvalidNode
+  NodeIndex child(NodeIndex node, size_t childIndex) const
+  {
+    const std::uint8_t mask = childMask(node);
+    if (childIndex >= 8 || (mask & (1u << childIndex)) == 0) {
+      return InvalidNode;
+    }
+    const std::uint8_t lower =
+      static_cast<std::uint8_t>(mask & ((1u << childIndex) - 1));
+    return m_words[node + 1 + LinearOctree::bitCount(lower)];
+  }
+
+  /// Check whether a position lies in an occupied leaf.
+  ///
+  /// \param[in] position Position
+  /// \return True if occupied, false otherwise
+  bool contains(const Vector3& position) const;
+
+  /// Traverse the (expanded) tree depth-first.
+  ///
+  /// Merged subtrees are visited once per occurrence. The visitor is called
+  /// as visitor(node, bounds, depth) and returns whether to descend into the
+  /// children of the node.
+  ///
+  /// \param[in] visitor Visitor function (object)
+  template<typename Visitor>
+  void traverse(Visitor visitor) const
+  {
+    struct Entry
+    {
+      NodeIndex node;
+      BoundingCube bounds;
+      size_t depth;
+    };
+    std::vector<Entry> stack;
+    stack.push_back({ m_root, m_bounds, 0 });
+    while (!stack.empty()) {
+      const Entry entry = stack.back();
+      stack.pop_back();
+      if (!visitor(entry.node, entry.bounds, entry.depth) ||
+          isLeaf(entry.node)) {
+        continue;
+      }
+
+      // Push children in reverse to visit them in child index order
+      const std::uint8_t mask = childMask(entry.node);
+      NodeIndex word = entry.node + 1 +
+                       static_cast<NodeIndex>(LinearOctree::bitCount(mask));
+      for (size_t i = 8; i-- > 0;) {
+        if ((mask & (1u << i)) != 0) {
+          stack.push_back({ m_words[--word],
+                            Octree::computeChildBounds(entry.bounds, i),
+                            entry.depth + 1 });
+        }
+      }
+    }
+  }
+
+  /// Compute memory usage of the node array.
+  ///
+  /// Compare with LinearOctree::memoryUsage() of the source octree.
+  ///
+  /// \return Size in bytes
+  size_t memoryUsage() const
+  {
+    return m_words.capacity() * sizeof(std::uint32_t);
+  }
+
+  /// Write DAG to file.
+  ///
+  /// File format (little endian):
+  /// 1. ASCII signature: SPATIUMGL_SVDAG\n (16 bytes)
+  /// 2. Bounds: center X, Y, Z, radius (64-bit floating points)
+  /// 3. Root offset (uint32), number of unique nodes (uint32)
+  /// 4. Number of source nodes (uint64), number of words (uint64)
+  /// 5. Words (uint32 each)
+  ///
+  /// \param[in] dag DAG
+  /// \param[in] fileName Path to file
+  /// \return Number of bytes written (0 on failure)
+  static size_t writeToFile(const SparseVoxelDag& dag,
+                            const std::string& fileName);
+
+  /// Read DAG from file.
+  ///
+  /// \param[in] fileName Path to file
+  /// \param[out] dag DAG
+  /// \return True on success, false otherwise
+  static bool readFromFile(const std::string& fileName, SparseVoxelDag& dag);
+
+protected:
+  BoundingCube m_bounds;
+  std::vector<std::uint32_t> m_words;
+  NodeIndex m_root;
+  size_t m_nodeCount;
+  std::uint64_t m_sourceNodeCount;
+};
+
+} // namespace idx
+} // namespace spgl
+
+#endif // SPATIUMGL_IDX_SPARSEVOXELDAG_H
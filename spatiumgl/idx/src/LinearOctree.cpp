@@ -0,0 +1,94 @@
+/*
+ * Program: Spatium Graphics Library
+ *
+ * Copyright (C) Martijn Koopman
+ * All Rights Reserved
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.
+ *
+ */
+
+#include "spatiumgl/idx/LinearOctree.hpp"
+
+#include <queue> // std::queue
+
+namespace spgl {
+namespace idx {
+
+const LinearOctree::NodeIndex LinearOctree::InvalidNode;
+
+LinearOctree::LinearOctree(const BoundingCube& bounds)
+  : m_bounds(bounds)
+  , m_childMasks(1, 0)
+  , m_firstChild(1, 0)
+  , m_lastExpanded(InvalidNode)
+{}
+
+LinearOctree
+LinearOctree::fromOctree(const Octree& octree)
+{
+  LinearOctree result(octree.bounds());
+
+  // Breadth-first, the same order as the arrays
+  NodeIndex node = 0;
+  for (const OctreeEntry& entry : octree.breadthFirst()) {
+    std::uint8_t mask = 0;
+    for (size_t i = 0; i < 8; i++) {
+      if (entry.node->child(i) != nullptr) {
+        mask = static_cast<std::uint8_t>(mask | (1u << i));
+      }
+    }
+    result.addChildren(node, mask);
+    node++;
+  }
+  return result;
+}
+
+Octree
+LinearOctree::toOctree() const
+{
+  Octree result(m_bounds);
+
+  // Nodes are created in array order, so the queue front matches 'node'
+  std::queue<OctreeNode*> queue;
+  queue.push(result.root());
+  for (NodeIndex node = 0; node < nodeCount(); node++) {
+    OctreeNode* octreeNode = queue.front();
+    queue.pop();
+
+    const std::uint8_t mask = m_childMasks[node];
+    for (size_t i = 0; i < 8; i++) {
+      if ((mask & (1u << i)) != 0 && octreeNode->createChild(i)) {
+        queue.push(octreeNode->child(i));
+      }
+    }
+  }
+  return result;
+}
+
+bool
+LinearOctree::addChildren(NodeIndex node, std::uint8_t mask)
+{
+  if (node >= nodeCount() || !isLeaf(node)) {
+    return false;
+  }
+  if (m_lastExpanded != InvalidNode && node <= m_lastExpanded) {
+    return false;
+  }
+  if (mask == 0) {
+    return true;
+  }
+
+  m_lastExpanded = node;
+  m_firstChild[node] = static_cast<NodeIndex>(nodeCount());
+  m_childMasks[node] = mask;
+  const size_t count = bitCount(mask);
+  m_childMasks.insert(m_childMasks.end(), count, 0);
+  m_firstChild.insert(m_firstChild.end(), count, 0);
+  return true;
+}
+
+} // namespace idx
+} // namespace spgl
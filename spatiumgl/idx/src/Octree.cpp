@@ -11,44 +11,406 @@
  */
 
 #include "spatiumgl/idx/Octree.hpp"
+#include "spatiumgl/idx/Morton.hpp"
+#include "spatiumgl/Parallel.hpp"
+
+#include <algorithm> // std::max, std::min, std::upper_bound, std::unique
+#include <array>     // std::array
+#include <cmath>     // std::abs
+#include <limits>    // std::numeric_limits
 
 namespace spgl {
 namespace idx {
 
+/// Sort keys and values by key. (parallel LSD radix sort, 8 bits per pass)
+///
+/// Every pass counts digits per chunk, computes the scatter offset of every
+/// (digit, chunk) pair and scatters the chunks in parallel. Passes in which
+/// all keys have the same digit are skipped. The sort is stable. Pass empty
+/// values to sort only the keys.
+static void
+radixSort(std::vector<std::uint64_t>& keys,
+          std::vector<std::uint32_t>& values,
+          size_t threads)
+{
+  const size_t count = keys.size();
+  const bool hasValues = !values.empty();
+  std::vector<std::uint64_t> keysTemp(count);
+  std::vector<std::uint32_t> valuesTemp(hasValues ? count : 0);
+  std::vector<std::array<size_t, 256>> offsets(resolveThreadCount(threads));
+
+  std::uint64_t* keysIn = keys.data();
+  std::uint64_t* keysOut = keysTemp.data();
+  std::uint32_t* valuesIn = values.data();
+  std::uint32_t* valuesOut = valuesTemp.data();
+  for (unsigned int shift = 0; shift < 64; shift += 8) {
+    // Count digits per chunk
+    const size_t chunks =
+      parallelFor(count, threads, [&](size_t chunk, size_t begin, size_t end) {
+        std::array<size_t, 256>& histogram = offsets[chunk];
+        histogram.fill(0);
+        for (size_t i = begin; i < end; i++) {
+          histogram[(keysIn[i] >> shift) & 0xff]++;
+        }
+      });
+
+    // Convert counts to offsets: digit-major, chunk-minor
+    size_t offset = 0;
+    bool skip = false;
+    for (size_t digit = 0; digit < 256; digit++) {
+      size_t digitCount = 0;
+      for (size_t chunk = 0; chunk < chunks; chunk++) {
+        const size_t chunkCount = offsets[chunk][digit];
+        offsets[chunk][digit] = offset;
+        offset += chunkCount;
+        digitCount += chunkCount;
+      }
+      skip = skip || (digitCount == count);
+    }
+    if (skip) {
+      continue;
+    }
+
+    // Scatter
+    parallelFor(count, threads, [&](size_t chunk, size_t begin, size_t end) {
+      std::array<size_t, 256>& chunkOffsets = offsets[chunk];
+      for (size_t i = begin; i < end; i++) {
+        const size_t target = chunkOffsets[(keysIn[i] >> shift) & 0xff]++;
+        keysOut[target] = keysIn[i];
+        if (hasValues) {
+          valuesOut[target] = valuesIn[i];
+        }
+      }
+    });
+    std::swap(keysIn, keysOut);
+    std::swap(valuesIn, valuesOut);
+  }
+
+  if (keysIn != keys.data()) {
+    keys.swap(keysTemp);
+    values.swap(valuesTemp);
+  }
+}
+
+Octree
+Octree::build(const Vector3f* positions,
+              size_t count,
+              size_t maxPointsPerLeaf,
+              size_t threads)
+{
+  if (count == 0) {
+    return Octree(BoundingCube({ 0, 0, 0 }, 0));
+  }
+
+  // Cubical bounds
+  const BoundingBox box = BoundingBox::fromPoints(positions, count, threads);
+  const Vector3& radii = box.radii();
+  const double radius = std::max(std::max(radii[0], radii[1]), radii[2]);
+  Octree octree(BoundingCube(box.center(), radius));
+
+  // Morton codes of grid cells, 2^21 cells per axis
+  const double cells = static_cast<double>(1u << MortonMaxDepth);
+  const double scale = (radius > 0 ? cells / (2 * radius) : 0);
+  const Vector3 origin = box.center() - Vector3(radius, radius, radius);
+  std::vector<std::uint64_t> codes(count);
+  octree.m_indices.resize(count);
+  parallelFor(count, threads, [&](size_t, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      std::uint32_t cell[3];
+      for (size_t axis = 0; axis < 3; axis++) {
+        // NaN is not cast (undefined): it is mapped to the first cell
+        const double value = (positions[i][axis] - origin[axis]) * scale;
+        cell[axis] = static_cast<std::uint32_t>(
+          value >= 0 ? std::min(value, cells - 1) : 0);
+      }
+      codes[i] = mortonEncode(cell[0], cell[1], cell[2]);
+      octree.m_indices[i] = static_cast<std::uint32_t>(i);
+    }
+  });
+
+  radixSort(codes, octree.m_indices, threads);
+
+  // Copy positions in sorted order
+  octree.m_points.resize(count);
+  parallelFor(count, threads, [&](size_t, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      octree.m_points[i] = positions[octree.m_indices[i]];
+    }
+  });
+
+  // Subdivide nodes top-down. The codes of a node share a prefix of 3 bits
+  // per level, so the points of its children are consecutive sub-ranges.
+  maxPointsPerLeaf = std::max(maxPointsPerLeaf, static_cast<size_t>(1));
+  struct Entry
+  {
+    OctreeNode* node;
+    unsigned int level;
+  };
+  std::vector<Entry> stack;
+  octree.root()->data() = OctreePointRange(0, count);
+  stack.push_back({ octree.root(), 0 });
+  while (!stack.empty()) {
+    const Entry entry = stack.back();
+    stack.pop_back();
+    const OctreePointRange range = entry.node->data();
+    if (range.size() <= maxPointsPerLeaf || entry.level == MortonMaxDepth ||
+        codes[range.begin] == codes[range.end - 1]) {
+      continue;
+    }
+
+    const unsigned int level = entry.level + 1;
+    const unsigned int shift = 3 * (MortonMaxDepth - level);
+    size_t begin = range.begin;
+    while (begin < range.end) {
+      const std::uint64_t childIndex = (codes[begin] >> shift) & 0x7;
+      const std::uint64_t childEnd = (codes[begin] | ((1ull << shift) - 1));
+      const size_t end = static_cast<size_t>(
+        std::upper_bound(
+          codes.begin() + static_cast<std::ptrdiff_t>(begin),
+          codes.begin() + static_cast<std::ptrdiff_t>(range.end),
+          childEnd) -
+        codes.begin());
+      entry.node->createChild(childIndex, begin, end);
+      stack.push_back({ entry.node->child(childIndex), level });
+      begin = end;
+    }
+  }
+
+  return octree;
+}
+
+Octree
+Octree::fromPoints(const Vector3f* positions,
+                   size_t count,
+                   const BoundingCube& bounds,
+                   size_t maxDepth,
+                   size_t threads)
+{
+  Octree octree(bounds);
+  maxDepth = std::min(maxDepth, static_cast<size_t>(MortonMaxDepth));
+  if (count == 0 || maxDepth == 0 || !(bounds.radius() > 0)) {
+    return octree;
+  }
+
+  // Morton codes of voxels; points outside get a code above all others
+  const std::uint64_t outside = 1ull << 63;
+  const double cells = static_cast<double>(1u << maxDepth);
+  const double scale = cells / (2 * bounds.radius());
+  const Vector3 origin =
+    bounds.center() -
+    Vector3(bounds.radius(), bounds.radius(), bounds.radius());
+  std::vector<std::uint64_t> codes(count);
+  parallelFor(count, threads, [&](size_t, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      std::uint32_t cell[3];
+      bool inside = true;
+      for (size_t axis = 0; axis < 3 && inside; axis++) {
+        // False for NaN as well: only cast values within the grid
+        const double value = (positions[i][axis] - origin[axis]) * scale;
+        inside = (value >= 0 && value <= cells);
+        if (inside) {
+          cell[axis] = static_cast<std::uint32_t>(std::min(value, cells - 1));
+        }
+      }
+      codes[i] = (inside ? mortonEncode(cell[0], cell[1], cell[2]) : outside);
+    }
+  });
+
+  std::vector<std::uint32_t> noValues;
+  radixSort(codes, noValues, threads);
+  codes.erase(std::unique(codes.begin(), codes.end()), codes.end());
+  if (codes.back() == outside) {
+    codes.pop_back();
+  }
+
+  // Path of nodes from the root to the leaf of the previous code
+  std::array<OctreeNode*, MortonMaxDepth + 1> path;
+  path[0] = octree.root();
+  for (size_t i = 0; i < codes.size(); i++) {
+    // First level at which the code differs from the previous code
+    size_t level = 1;
+    if (i > 0) {
+      const std::uint64_t difference = codes[i] ^ codes[i - 1];
+      size_t group = 0; // Deepest level = group 0
+      while ((difference >> (3 * (group + 1))) != 0) {
+        group++;
+      }
+      level = maxDepth - group;
+    }
+
+    for (; level <= maxDepth; level++) {
+      const size_t childIndex =
+        static_cast<size_t>(codes[i] >> (3 * (maxDepth - level))) & 0x7;
+      path[level - 1]->createChild(childIndex);
+      path[level] = path[level - 1]->child(childIndex);
+    }
+  }
+
+  return octree;
+}
+
 BoundingCube
 Octree::computeChildBounds(const BoundingCube& extent, size_t childIndex)
 {
-  const double radius = extent.radius() / 2;
-
-  switch (childIndex) {
-    case 0:
-      // Bottom front left
-      return { extent.center() + Vector3(-radius, -radius, -radius), radius };
-    case 1:
-      // Bottom front right
-      return { extent.center() + Vector3(radius, -radius, -radius), radius };
-    case 2:
-      // Bottom back left
-      return { extent.center() + Vector3(-radius, radius, -radius), radius };
-    case 3:
-      // Bottom back right
-      return { extent.center() + Vector3(radius, radius, -radius), radius };
-    case 4:
-      // Top front left
-      return { extent.center() + Vector3(-radius, -radius, radius), radius };
-    case 5:
-      // Top front right
-      return { extent.center() + Vector3(radius, -radius, radius), radius };
-    case 6:
-      // Top back left
-      return { extent.center() + Vector3(-radius, radius, radius), radius };
-    case 7:
-      // Top back right
-      return { extent.center() + Vector3(radius, radius, radius), radius };
-    default:
-      return extent;
+  if (childIndex > 7) {
+    return extent;
   }
+
+  return NTreeChildBounds<BoundingCube, 8>::compute(extent, childIndex);
 }
 
+/// Node to visit during a nearest neighbor query.
+struct KnnNodeEntry
+{
+  float distanceSquared; // Minimum squared distance to node bounds
+  const OctreeNode* node;
+  BoundingCube bounds;
+};
+
+/// Scratch memory of nearest neighbor queries, reused per thread.
+struct KnnScratch
+{
+  std::vector<KnnNodeEntry> nodes;       // Min-heap by distance
+  std::vector<OctreeNeighbor> neighbors; // Max-heap by distance
+};
+
+/// Compute squared distance from position to cube. (0 if inside)
+static inline float
+distanceSquared(const Vector3f& position, const BoundingCube& bounds)
+{
+  const float radius = static_cast<float>(bounds.radius());
+  float result = 0;
+  for (size_t axis = 0; axis < 3; axis++) {
+    const float center = static_cast<float>(bounds.center()[axis]);
+    const float delta = std::abs(position[axis] - center) - radius;
+    if (delta > 0) {
+      result += delta * delta;
+    }
+  }
+  return result;
 }
+
+static inline bool
+nodeFarther(const KnnNodeEntry& a, const KnnNodeEntry& b)
+{
+  return a.distanceSquared > b.distanceSquared;
 }
+
+size_t
+Octree::knn(const Vector3f& query, size_t k, OctreeNeighbor* result) const
+{
+  static thread_local KnnScratch scratch;
+  std::vector<KnnNodeEntry>& nodes = scratch.nodes;
+  std::vector<OctreeNeighbor>& neighbors = scratch.neighbors;
+  nodes.clear();
+  neighbors.clear();
+
+  if (k > 0 && !m_points.empty()) {
+    nodes.push_back({ distanceSquared(query, m_bounds), root(), m_bounds });
+  }
+  while (!nodes.empty()) {
+    std::pop_heap(nodes.begin(), nodes.end(), nodeFarther);
+    const KnnNodeEntry entry = nodes.back();
+    nodes.pop_back();
+    if (neighbors.size() == k &&
+        entry.distanceSquared > neighbors.front().distanceSquared) {
+      break; // All remaining nodes are farther
+    }
+
+    if (entry.node->isLeaf()) {
+      const OctreePointRange& range = entry.node->data();
+      for (size_t i = range.begin; i < range.end; i++) {
+        const Vector3f delta = m_points[i] - query;
+        const float distance =
+          delta[0] * delta[0] + delta[1] * delta[1] + delta[2] * delta[2];
+        if (neighbors.size() < k) {
+          neighbors.push_back({ m_indices[i], distance });
+          std::push_heap(neighbors.begin(), neighbors.end(), nearer<float>);
+        } else if (distance < neighbors.front().distanceSquared) {
+          std::pop_heap(neighbors.begin(), neighbors.end(), nearer<float>);
+          neighbors.back() = { m_indices[i], distance };
+          std::push_heap(neighbors.begin(), neighbors.end(), nearer<float>);
+        }
+      }
+      continue;
+    }
+
+    for (size_t i = 0; i < 8; i++) {
+      const OctreeNode* child = entry.node->child(i);
+      if (child == nullptr) {
+        continue;
+      }
+      const BoundingCube bounds = computeChildBounds(entry.bounds, i);
+      const float distance = distanceSquared(query, bounds);
+      if (neighbors.size() < k ||
+          distance <= neighbors.front().distanceSquared) {
+        nodes.push_back({ distance, child, bounds });
+        std::push_heap(nodes.begin(), nodes.end(), nodeFarther);
+      }
+    }
+  }
+
+  std::sort_heap(neighbors.begin(), neighbors.end(), nearer<float>);
+  std::copy(neighbors.begin(), neighbors.end(), result);
+  for (size_t i = neighbors.size(); i < k; i++) {
+    result[i] = { OctreeNeighbor::InvalidIndex,
+                  std::numeric_limits<float>::infinity() };
+  }
+  return neighbors.size();
+}
+
+void
+Octree::knn(const Vector3f* queries,
+            size_t count,
+            size_t k,
+            OctreeNeighbor* result,
+            size_t threads) const
+{
+  parallelFor(
+    count,
+    threads,
+    [&](size_t, size_t begin, size_t end) {
+      for (size_t i = begin; i < end; i++) {
+        knn(queries[i], k, result + i * k);
+      }
+    },
+    256);
+}
+
+void
+Octree::radiusQuery(const Vector3f* centers,
+                    size_t count,
+                    float radius,
+                    std::vector<std::uint32_t>* results,
+                    size_t threads) const
+{
+  parallelFor(
+    count,
+    threads,
+    [&](size_t, size_t begin, size_t end) {
+      for (size_t i = begin; i < end; i++) {
+        radiusQuery(centers[i], radius, results[i]);
+      }
+    },
+    64);
+}
+
+void
+Octree::boxQuery(const BoundingBox* boxes,
+                 size_t count,
+                 std::vector<std::uint32_t>* results,
+                 size_t threads) const
+{
+  parallelFor(
+    count,
+    threads,
+    [&](size_t, size_t begin, size_t end) {
+      for (size_t i = begin; i < end; i++) {
+        boxQuery(boxes[i], results[i]);
+      }
+    },
+    64);
+}
+
+} // namespace idx
+} // namespace spgl
@@ -0,0 +1,438 @@
+/*
+ * Program: Spatium Graphics Library
+ *
+ * Copyright (C) Martijn Koopman
+ * All Rights Reserved
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.
+ *
+ */
+
+#include "spatiumgl/idx/OctreeHierarchyFile.hpp"
+#include "spatiumgl/idx/LinearOctree.hpp" // LinearOctree::bitCount
+
+#include <cstring> // std::memcpy, std::memcmp
+#include <fstream> // std::ofstream
+#include <queue>   // std::queue
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>    // open
+#include <sys/mman.h> // mmap, munmap
+#include <sys/stat.h> // fstat
+#include <unistd.h>   // close
+#endif
+
+namespace spgl {
+namespace idx {
+
+static const char* Signature = "SPATIUMGL_OCTREE_PAGED\n"; // 23 bytes
+static const std::uint8_t Version = 1;
+static const size_t HeaderSize = 80;
+
+/// Append value to buffer (native byte order, little endian expected).
+template<typename T>
+static void
+append(std::vector<char>& buffer, T value)
+{
+  const char* bytes = reinterpret_cast<const char*>(&value);
+  buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+/// Read value from (unaligned) memory.
+template<typename T>
+static T
+load(const unsigned char* data)
+{
+  T value;
+  std::memcpy(&value, data, sizeof(T));
+  return value;
+}
+
+/// Compute child mask of octree node (bit i = child i).
+static std::uint8_t
+octreeChildMask(const OctreeNode* node)
+{
+  std::uint8_t mask = 0;
+  for (size_t i = 0; i < 8; i++) {
+    if (node->child(i) != nullptr) {
+      mask = static_cast<std::uint8_t>(mask | (1u << i));
+    }
+  }
+  return mask;
+}
+
+/// Writes pages children first.
+class PageWriter
+{
+public:
+  PageWriter(std::ofstream& ofile, size_t pageDepth, std::uint64_t position)
+    : m_ofile(ofile)
+    , m_pageDepth(pageDepth)
+    , m_position(position)
+    , m_nodeCount(0)
+  {}
+
+  /// Write page rooted at node (and all its descendant pages).
+  ///
+  /// \return Offset of page in file
+  std::uint64_t write(const OctreeNode* root)
+  {
+    // Nodes of the page, breadth-first
+    std::vector<const OctreeNode*> nodes;
+    nodes.push_back(root);
+    size_t levelBegin = 0;
+    for (size_t depth = 0; depth + 1 < m_pageDepth; depth++) {
+      const size_t levelEnd = nodes.size();
+      for (size_t i = levelBegin; i < levelEnd; i++) {
+        for (size_t j = 0; j < 8; j++) {
+          if (nodes[i]->child(j) != nullptr) {
+            nodes.push_back(nodes[i]->child(j));
+          }
+        }
+      }
+      levelBegin = levelEnd;
+    }
+
+    // Pages of the children of the deepest level
+    std::vector<std::uint64_t> childPageOffsets;
+    for (size_t i = levelBegin; i < nodes.size(); i++) {
+      for (size_t j = 0; j < 8; j++) {
+        if (nodes[i]->child(j) != nullptr) {
+          childPageOffsets.push_back(write(nodes[i]->child(j)));
+        }
+      }
+    }
+
+    // Write page
+    std::vector<char> buffer;
+    append(buffer, static_cast<std::uint32_t>(nodes.size()));
+    append(buffer, static_cast<std::uint32_t>(childPageOffsets.size()));
+    for (const OctreeNode* node : nodes) {
+      buffer.push_back(static_cast<char>(octreeChildMask(node)));
+    }
+    buffer.resize((buffer.size() + 7) / 8 * 8, 0);
+    for (std::uint64_t offset : childPageOffsets) {
+      append(buffer, offset);
+    }
+    m_ofile.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+
+    const std::uint64_t offset = m_position;
+    m_position += buffer.size();
+    m_nodeCount += nodes.size();
+    return offset;
+  }
+
+  std::uint64_t position() const { return m_position; }
+  std::uint64_t nodeCount() const { return m_nodeCount; }
+
+private:
+  std::ofstream& m_ofile;
+  size_t m_pageDepth;
+  std::uint64_t m_position;
+  std::uint64_t m_nodeCount;
+};
+
+OctreeHierarchyFile::OctreeHierarchyFile()
+  : m_data(nullptr)
+  , m_size(0)
+#if defined(_WIN32)
+  , m_fileHandle(nullptr)
+  , m_mappingHandle(nullptr)
+#endif
+  , m_bounds()
+  , m_pageDepth(0)
+  , m_spacing(0)
+  , m_nodeCount(0)
+  , m_rootOffset(0)
+  , m_pages()
+  , m_pageIndices()
+{}
+
+OctreeHierarchyFile::~OctreeHierarchyFile()
+{
+  close();
+}
+
+size_t
+OctreeHierarchyFile::write(const Octree& octree,
+                           const std::string& fileName,
+                           size_t pageDepth,
+                           float spacing)
+{
+  if (pageDepth == 0 || octree.root() == nullptr) {
+    return 0;
+  }
+  std::ofstream ofile(fileName, std::ios::out | std::ios::binary);
+  if (!ofile.is_open()) {
+    return 0;
+  }
+
+  // Placeholder header; completed when the root page offset is known
+  ofile.write(std::vector<char>(HeaderSize, 0).data(), HeaderSize);
+  PageWriter writer(ofile, pageDepth, HeaderSize);
+  const std::uint64_t rootOffset = writer.write(octree.root());
+
+  std::vector<char> header(Signature, Signature + 23);
+  append(header, Version);
+  append(header, static_cast<std::uint32_t>(pageDepth));
+  append(header, spacing);
+  const BoundingCube& bounds = octree.bounds();
+  append(header, bounds.center()[0]);
+  append(header, bounds.center()[1]);
+  append(header, bounds.center()[2]);
+  append(header, bounds.radius());
+  append(header, rootOffset);
+  append(header, writer.nodeCount());
+  ofile.seekp(0);
+  ofile.write(header.data(), static_cast<std::streamsize>(header.size()));
+
+  return (ofile.good() ? static_cast<size_t>(writer.position()) : 0);
+}
+
+bool
+OctreeHierarchyFile::open(const std::string& fileName)
+{
+  close();
+
+#if defined(_WIN32)
+  HANDLE file = CreateFileA(fileName.c_str(),
+                            GENERIC_READ,
+                            FILE_SHARE_READ,
+                            nullptr,
+                            OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL,
+                            nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart < HeaderSize) {
+    CloseHandle(file);
+    return false;
+  }
+  HANDLE mapping =
+    CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (mapping == nullptr) {
+    CloseHandle(file);
+    return false;
+  }
+  void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  if (data == nullptr) {
+    CloseHandle(mapping);
+    CloseHandle(file);
+    return false;
+  }
+  m_fileHandle = file;
+  m_mappingHandle = mapping;
+  m_size = static_cast<size_t>(fileSize.QuadPart);
+#else
+  const int file = ::open(fileName.c_str(), O_RDONLY);
+  if (file < 0) {
+    return false;
+  }
+  struct stat status;
+  if (fstat(file, &status) != 0 ||
+      static_cast<size_t>(status.st_size) < HeaderSize) {
+    ::close(file);
+    return false;
+  }
+  void* data = mmap(nullptr,
+                    static_cast<size_t>(status.st_size),
+                    PROT_READ,
+                    MAP_PRIVATE,
+                    file,
+                    0);
+  ::close(file); // The mapping stays valid
+  if (data == MAP_FAILED) {
+    return false;
+  }
+  m_size = static_cast<size_t>(status.st_size);
+#endif
+  m_data = static_cast<const unsigned char*>(data);
+
+  // Header
+  if (std::memcmp(m_data, Signature, 23) != 0 || m_data[23] != Version) {
+    close();
+    return false;
+  }
+  m_pageDepth = load<std::uint32_t>(m_data + 24);
+  m_spacing = load<float>(m_data + 28);
+  m_bounds = BoundingCube({ load<double>(m_data + 32),
+                            load<double>(m_data + 40),
+                            load<double>(m_data + 48) },
+                          load<double>(m_data + 56));
+  m_rootOffset = load<std::uint64_t>(m_data + 64);
+  m_nodeCount = static_cast<size_t>(load<std::uint64_t>(m_data + 72));
+  if (m_pageDepth == 0 || m_rootOffset >= m_size) {
+    close();
+    return false;
+  }
+
+  // Root page (page 0), so nodes can be navigated without further checks
+  std::uint32_t rootPage;
+  if (!loadPage(m_rootOffset, rootPage)) {
+    close();
+    return false;
+  }
+  return true;
+}
+
+void
+OctreeHierarchyFile::close()
+{
+  if (m_data != nullptr) {
+#if defined(_WIN32)
+    UnmapViewOfFile(m_data);
+    CloseHandle(m_mappingHandle);
+    CloseHandle(m_fileHandle);
+    m_mappingHandle = nullptr;
+    m_fileHandle = nullptr;
+#else
+    munmap(const_cast<unsigned char*>(m_data), m_size);
+#endif
+  }
+  m_data = nullptr;
+  m_size = 0;
+  m_pageDepth = 0;
+  m_spacing = 0;
+  m_nodeCount = 0;
+  m_rootOffset = 0;
+  m_pages.clear();
+  m_pageIndices.clear();
+}
+
+OctreeHierarchyFile::Node
+OctreeHierarchyFile::root()
+{
+  return { 0, 0 }; // Loaded by open()
+}
+
+bool
+OctreeHierarchyFile::child(const Node& node, size_t childIndex, Node& result)
+{
+  const Page& page = m_pages[node.page];
+  const std::uint8_t mask = page.masks[node.index];
+  if (childIndex >= 8 || (mask & (1u << childIndex)) == 0) {
+    return false;
+  }
+  const std::uint32_t position =
+    page.firstChild[node.index] +
+    static_cast<std::uint32_t>(LinearOctree::bitCount(
+      static_cast<std::uint8_t>(mask & ((1u << childIndex) - 1))));
+
+  if (node.index < page.lastLevelBegin) {
+    result = { node.page, position };
+    return true;
+  }
+
+  // Child is root of another page
+  const std::uint64_t offset =
+    load<std::uint64_t>(page.childPageOffsets + 8 * position);
+  if (offset >= page.offset) {
+    return false; // Child pages precede their parent, so there are no cycles
+  }
+  result.index = 0;
+  return loadPage(offset, result.page);
+}
+
+bool
+OctreeHierarchyFile::loadPage(std::uint64_t offset, std::uint32_t& page)
+{
+  if (m_data == nullptr) {
+    return false;
+  }
+  const auto found = m_pageIndices.find(offset);
+  if (found != m_pageIndices.end()) {
+    page = found->second;
+    return true;
+  }
+
+  // Validate sizes (without overflow for corrupt offsets)
+  if (offset > m_size || m_size - offset < 8) {
+    return false;
+  }
+  Page result;
+  result.offset = offset;
+  result.nodeCount = load<std::uint32_t>(m_data + offset);
+  result.childPageCount = load<std::uint32_t>(m_data + offset + 4);
+  const std::uint64_t masksSize = (result.nodeCount + 7) / 8 * 8;
+  const std::uint64_t available = m_size - offset - 8;
+  if (result.nodeCount == 0 || available < masksSize ||
+      (available - masksSize) / 8 < result.childPageCount) {
+    return false;
+  }
+  result.masks = m_data + offset + 8;
+  result.childPageOffsets = result.masks + masksSize;
+
+  // First child per node, level by level
+  result.firstChild.resize(result.nodeCount);
+  result.lastLevelBegin = result.nodeCount;
+  std::uint32_t levelBegin = 0;
+  std::uint32_t levelEnd = 1;
+  for (size_t depth = 0; levelBegin < levelEnd; depth++) {
+    const bool lastLevel = (depth + 1 == m_pageDepth);
+    std::uint32_t next = (lastLevel ? 0 : levelEnd);
+    for (std::uint32_t i = levelBegin; i < levelEnd; i++) {
+      result.firstChild[i] = next;
+      next += static_cast<std::uint32_t>(
+        LinearOctree::bitCount(result.masks[i]));
+    }
+    if (lastLevel) {
+      result.lastLevelBegin = levelBegin;
+      if (next != result.childPageCount || levelEnd != result.nodeCount) {
+        return false;
+      }
+      break;
+    }
+    if (next > result.nodeCount) {
+      return false;
+    }
+    levelBegin = levelEnd;
+    levelEnd = next;
+  }
+  if (levelBegin == levelEnd && levelEnd != result.nodeCount) {
+    return false;
+  }
+
+  page = static_cast<std::uint32_t>(m_pages.size());
+  m_pages.push_back(std::move(result));
+  m_pageIndices[offset] = page;
+  return true;
+}
+
+bool
+OctreeHierarchyFile::readOctree(Octree& octree)
+{
+  if (!isOpen()) {
+    return false;
+  }
+  octree = Octree(m_bounds);
+
+  std::queue<std::pair<Node, OctreeNode*>> queue;
+  queue.push({ root(), octree.root() });
+  while (!queue.empty()) {
+    const Node node = queue.front().first;
+    OctreeNode* octreeNode = queue.front().second;
+    queue.pop();
+    for (size_t i = 0; i < 8; i++) {
+      Node childNode;
+      if (child(node, i, childNode)) {
+        octreeNode->createChild(i);
+        queue.push({ childNode, octreeNode->child(i) });
+      } else if ((childMask(node) & (1u << i)) != 0) {
+        return false; // Invalid page
+      }
+    }
+  }
+  return true;
+}
+
+} // namespace idx
+} // namespace spgl
@@ -0,0 +1,304 @@
+/*
+ * Program: Spatium Graphics Library
+ *
+ * Copyright (C) Martijn Koopman
+ * All Rights Reserved
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.
+ *
+ */
+
+#include "spatiumgl/idx/SparseVoxelDag.hpp"
+
+#include <cmath>         // std::abs
+#include <cstring>       // std::memcpy, std::memcmp
+#include <fstream>       // std::ofstream, std::ifstream
+#include <unordered_set> // std::unordered_set
+
+namespace spgl {
+namespace idx {
+
+const SparseVoxelDag::NodeIndex SparseVoxelDag::InvalidNode;
+
+static const char* Signature = "SPATIUMGL_SVDAG\n"; // 16 bytes
+static const size_t HeaderSize = 16 + 4 * 8 + 2 * 4 + 2 * 8;
+
+/// Append value to buffer (native byte order, little endian expected).
+template<typename T>
+static void
+append(std::vector<char>& buffer, T value)
+{
+  const char* bytes = reinterpret_cast<const char*>(&value);
+  buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+/// Read value from (unaligned) memory.
+template<typename T>
+static T
+load(const char* data)
+{
+  T value;
+  std::memcpy(&value, data, sizeof(T));
+  return value;
+}
+
+/// Number of words of the node at an offset.
+static inline size_t
+nodeSize(const std::uint32_t* words, size_t offset)
+{
+  return 1 + LinearOctree::bitCount(static_cast<std::uint8_t>(words[offset]));
+}
+
+/// Hashes the words of a node, identified by its offset.
+struct DagNodeHash
+{
+  const std::vector<std::uint32_t>* words;
+
+  size_t operator()(std::uint32_t offset) const
+  {
+    const std::uint32_t* data = words->data();
+    const size_t size = nodeSize(data, offset);
+    std::uint64_t hash = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < size; i++) {
+      hash = (hash ^ data[offset + i]) * 0x100000001b3ull;
+    }
+    return static_cast<size_t>(hash ^ (hash >> 32));
+  }
+};
+
+/// Compares the words of two nodes, identified by their offsets.
+struct DagNodeEqual
+{
+  const std::vector<std::uint32_t>* words;
+
+  bool operator()(std::uint32_t a, std::uint32_t b) const
+  {
+    const std::uint32_t* data = words->data();
+    const size_t size = nodeSize(data, a);
+    return size == nodeSize(data, b) &&
+           std::memcmp(data + a, data + b, size * sizeof(std::uint32_t)) == 0;
+  }
+};
+
+SparseVoxelDag::SparseVoxelDag(const BoundingCube& bounds)
+  : m_bounds(bounds)
+  , m_words(1, 0)
+  , m_root(0)
+  , m_nodeCount(1)
+  , m_sourceNodeCount(1)
+{}
+
+SparseVoxelDag
+SparseVoxelDag::fromOctree(const Octree& octree)
+{
+  SparseVoxelDag dag(octree.bounds());
+  dag.m_words.clear();
+  dag.m_nodeCount = 0;
+  dag.m_sourceNodeCount = 0;
+
+  std::unordered_set<std::uint32_t, DagNodeHash, DagNodeEqual> nodes(
+    1024, DagNodeHash{ &dag.m_words }, DagNodeEqual{ &dag.m_words });
+
+  // Post-order: a node is merged after all its children
+  struct Frame
+  {
+    const OctreeNode* node;
+    size_t next; // Next child index to visit
+    std::uint32_t mask;
+    size_t childCount;
+    NodeIndex children[8];
+  };
+  std::vector<Frame> stack;
+  stack.push_back({ octree.root(), 0, 0, 0, {} });
+  while (!stack.empty()) {
+    Frame& frame = stack.back();
+    while (frame.next < 8 && frame.node->child(frame.next) == nullptr) {
+      frame.next++;
+    }
+    if (frame.next < 8) {
+      const OctreeNode* child = frame.node->child(frame.next);
+      frame.mask |= (1u << frame.next);
+      frame.next++;
+      stack.push_back({ child, 0, 0, 0, {} }); // Invalidates frame
+      continue;
+    }
+
+    // Append node, then drop it again if an equal node exists
+    const NodeIndex offset = static_cast<NodeIndex>(dag.m_words.size());
+    dag.m_words.push_back(frame.mask);
+    dag.m_words.insert(
+      dag.m_words.end(), frame.children, frame.children + frame.childCount);
+    NodeIndex node = offset;
+    const auto inserted = nodes.insert(offset);
+    if (!inserted.second) {
+      node = *inserted.first;
+      dag.m_words.resize(offset);
+    }
+
+    dag.m_sourceNodeCount++;
+    stack.pop_back();
+    if (stack.empty()) {
+      dag.m_root = node;
+    } else {
+      Frame& parent = stack.back();
+      parent.children[parent.childCount++] = node;
+    }
+  }
+
+  dag.m_nodeCount = nodes.size();
+  dag.m_words.shrink_to_fit();
+  return dag;
+}
+
+LinearOctree
+SparseVoxelDag::toLinearOctree() const
+{
+  LinearOctree result(m_bounds);
+  result.reserve(sourceNodeCount());
+
+  // Breadth-first; DAG node per linear octree node
+  std::vector<NodeIndex> nodes;
+  nodes.reserve(sourceNodeCount());
+  nodes.push_back(m_root);
+  for (size_t i = 0; i < nodes.size(); i++) {
+    const std::uint8_t mask = childMask(nodes[i]);
+    result.addChildren(static_cast<LinearOctree::NodeIndex>(i), mask);
+    const size_t count = LinearOctree::bitCount(mask);
+    for (size_t j = 0; j < count; j++) {
+      nodes.push_back(m_words[nodes[i] + 1 + j]);
+    }
+  }
+  return result;
+}
+
+bool
+SparseVoxelDag::contains(const Vector3& position) const
+{
+  for (size_t axis = 0; axis < 3; axis++) {
+    if (std::abs(position[axis] - m_bounds.center()[axis]) >
+        m_bounds.radius()) {
+      return false;
+    }
+  }
+
+  BoundingCube bounds = m_bounds;
+  NodeIndex node = m_root;
+  while (!isLeaf(node)) {
+    size_t childIndex = 0;
+    for (size_t axis = 0; axis < 3; axis++) {
+      if (position[axis] >= bounds.center()[axis]) {
+        childIndex |= (static_cast<size_t>(1) << axis);
+      }
+    }
+    node = child(node, childIndex);
+    if (node == InvalidNode) {
+      return false;
+    }
+    bounds = Octree::computeChildBounds(bounds, childIndex);
+  }
+  return true;
+}
+
+size_t
+SparseVoxelDag::writeToFile(const SparseVoxelDag& dag,
+                            const std::string& fileName)
+{
+  std::ofstream ofile(fileName, std::ios::out | std::ios::binary);
+  if (!ofile.is_open()) {
+    return 0;
+  }
+
+  std::vector<char> buffer(Signature, Signature + 16);
+  buffer.reserve(HeaderSize + dag.m_words.size() * sizeof(std::uint32_t));
+  for (size_t axis = 0; axis < 3; axis++) {
+    append(buffer, static_cast<double>(dag.m_bounds.center()[axis]));
+  }
+  append(buffer, static_cast<double>(dag.m_bounds.radius()));
+  append(buffer, static_cast<std::uint32_t>(dag.m_root));
+  append(buffer, static_cast<std::uint32_t>(dag.m_nodeCount));
+  append(buffer, static_cast<std::uint64_t>(dag.m_sourceNodeCount));
+  append(buffer, static_cast<std::uint64_t>(dag.m_words.size()));
+  const char* words = reinterpret_cast<const char*>(dag.m_words.data());
+  buffer.insert(
+    buffer.end(), words, words + dag.m_words.size() * sizeof(std::uint32_t));
+
+  ofile.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+  return (ofile.good() ? buffer.size() : 0);
+}
+
+bool
+SparseVoxelDag::readFromFile(const std::string& fileName, SparseVoxelDag& dag)
+{
+  // Read entire file
+  std::ifstream ifile(fileName,
+                      std::ios::in | std::ios::binary | std::ios::ate);
+  if (!ifile.is_open()) {
+    return false;
+  }
+  const std::streamoff size = ifile.tellg();
+  if (size < static_cast<std::streamoff>(HeaderSize)) {
+    return false;
+  }
+  std::vector<char> buffer(static_cast<size_t>(size));
+  ifile.seekg(0);
+  if (!ifile.read(buffer.data(), size)) {
+    return false;
+  }
+
+  // Header
+  const char* data = buffer.data();
+  if (std::memcmp(data, Signature, 16) != 0) {
+    return false;
+  }
+  const Vector3 center(
+    load<double>(data + 16), load<double>(data + 24), load<double>(data + 32));
+  const double radius = load<double>(data + 40);
+  const std::uint32_t root = load<std::uint32_t>(data + 48);
+  const std::uint32_t nodeCount = load<std::uint32_t>(data + 52);
+  const std::uint64_t sourceNodeCount = load<std::uint64_t>(data + 56);
+  const std::uint64_t wordCount = load<std::uint64_t>(data + 64);
+  if (wordCount == 0 ||
+      wordCount != (buffer.size() - HeaderSize) / sizeof(std::uint32_t)) {
+    return false;
+  }
+  std::vector<std::uint32_t> words(static_cast<size_t>(wordCount));
+  std::memcpy(words.data(), data + HeaderSize, words.size() * 4);
+
+  // Nodes are stored back-to-back, children before their parents, with the
+  // root last
+  std::vector<bool> nodeBegins(words.size(), false);
+  size_t offset = 0;
+  size_t last = 0;
+  size_t count = 0;
+  while (offset < words.size()) {
+    if (words[offset] > 0xff || offset + nodeSize(words.data(), offset) >
+                                  words.size()) {
+      return false;
+    }
+    const size_t end = offset + nodeSize(words.data(), offset);
+    for (size_t i = offset + 1; i < end; i++) {
+      if (words[i] >= offset || !nodeBegins[words[i]]) {
+        return false;
+      }
+    }
+    nodeBegins[offset] = true;
+    last = offset;
+    offset = end;
+    count++;
+  }
+  if (root != last || nodeCount != count) {
+    return false;
+  }
+
+  dag.m_bounds = BoundingCube(center, radius);
+  dag.m_words.swap(words);
+  dag.m_root = root;
+  dag.m_nodeCount = nodeCount;
+  dag.m_sourceNodeCount = sourceNodeCount;
+  return true;
+}
+
+} // namespace idx
+} // namespace spgl
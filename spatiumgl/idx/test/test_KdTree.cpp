@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+
+#include <spatiumgl/idx/KdTree.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+/// Squared distances from query to all points, sorted.
+template<typename T, size_t Dim>
+std::vector<T>
+bruteForce(const std::vector<spgl::Vector<T, Dim>>& points,
+           const spgl::Vector<T, Dim>& query)
+{
+  std::vector<T> distances;
+  for (const spgl::Vector<T, Dim>& point : points) {
+    T distance = 0;
+    for (size_t axis = 0; axis < Dim; axis++) {
+      distance += (point[axis] - query[axis]) * (point[axis] - query[axis]);
+    }
+    distances.push_back(distance);
+  }
+  std::sort(distances.begin(), distances.end());
+  return distances;
+}
+
+} // namespace
+
+TEST(KdTree, build)
+{
+  std::vector<spgl::Vector3f> points;
+  for (size_t i = 0; i < 1000; i++) {
+    points.push_back({ static_cast<float>(i % 97),
+                       static_cast<float>(i % 13),
+                       static_cast<float>(i % 7) });
+  }
+  const spgl::idx::KdTree3f tree = spgl::idx::KdTree3f::build(points, 10, 4);
+  EXPECT_EQ(tree.size(), points.size());
+  EXPECT_EQ(tree.depth(), 7u); // 1000 / 2^7 <= 10
+
+  // Indices are a permutation
+  std::vector<bool> found(points.size(), false);
+  for (size_t i = 0; i < points.size(); i++) {
+    const std::uint32_t index = tree.indices()[i];
+    ASSERT_LT(index, points.size());
+    EXPECT_FALSE(found[index]);
+    found[index] = true;
+    EXPECT_EQ(tree.points()[i], points[index]);
+  }
+
+  // Independent of number of threads
+  const spgl::idx::KdTree3f single = spgl::idx::KdTree3f::build(points, 10, 1);
+  EXPECT_EQ(single.indices(), tree.indices());
+
+  // Small and empty
+  EXPECT_EQ(spgl::idx::KdTree3f::build(points.data(), 5, 10).depth(), 0u);
+  EXPECT_EQ(spgl::idx::KdTree3f::build(points.data(), 0, 10).size(), 0u);
+}
+
+TEST(KdTree, knn)
+{
+  // Anisotropic: corridor along X
+  std::vector<spgl::Vector3f> points;
+  unsigned int seed = 11;
+  auto random = [&seed]() {
+    seed = seed * 1103515245 + 12345;
+    return static_cast<float>((seed >> 8) % 10000) / 100;
+  };
+  for (size_t i = 0; i < 20000; i++) {
+    points.push_back({ random() * 50, random() / 10, random() / 20 });
+  }
+  std::vector<spgl::Vector3f> queries;
+  for (size_t i = 0; i < 100; i++) {
+    queries.push_back({ random() * 50, random() / 5, random() / 20 });
+  }
+
+  const spgl::idx::KdTree3f tree = spgl::idx::KdTree3f::build(points, 8, 2);
+  const size_t k = 12;
+  const std::vector<spgl::idx::KdTree3f::Neighbor> batch =
+    tree.knn(queries, k, 3);
+  for (size_t q = 0; q < queries.size(); q++) {
+    const std::vector<float> expected = bruteForce(points, queries[q]);
+    const std::vector<spgl::idx::KdTree3f::Neighbor> result =
+      tree.knn(queries[q], k);
+    ASSERT_EQ(result.size(), k);
+    for (size_t i = 0; i < k; i++) {
+      EXPECT_EQ(result[i].distanceSquared, expected[i]);
+      EXPECT_EQ(batch[q * k + i].distanceSquared, expected[i]);
+    }
+  }
+
+  // Fewer points than k
+  const spgl::idx::KdTree3f small =
+    spgl::idx::KdTree3f::build(points.data(), 2, 1);
+  spgl::idx::KdTree3f::Neighbor neighbors[3];
+  EXPECT_EQ(small.knn(points[1], 3, neighbors), 2u);
+  EXPECT_EQ(neighbors[0].index, 1u);
+  EXPECT_EQ(neighbors[2].index, spgl::idx::KdTree3f::Neighbor::InvalidIndex);
+}
+
+TEST(KdTree, radiusQuery)
+{
+  std::vector<spgl::Vector<double, 2>> points;
+  for (size_t i = 0; i < 5000; i++) {
+    points.push_back({ static_cast<double>((i * 7919) % 1000) / 10,
+                       static_cast<double>((i * 104729) % 1000) / 10 });
+  }
+  const spgl::idx::KdTree<double, 2> tree =
+    spgl::idx::KdTree<double, 2>::build(points, 4);
+
+  std::vector<spgl::Vector<double, 2>> centers = { { 50, 50 },
+                                                   { 0, 0 },
+                                                   { 99.9, 12.3 },
+                                                   { -10, -10 } };
+  std::vector<std::vector<std::uint32_t>> results(centers.size());
+  const double radius = 7.5;
+  tree.radiusQuery(centers.data(), centers.size(), radius, results.data(), 2);
+  std::vector<std::uint32_t> result;
+  for (size_t q = 0; q < centers.size(); q++) {
+    std::vector<std::uint32_t> expected;
+    for (std::uint32_t i = 0; i < points.size(); i++) {
+      const double dx = points[i][0] - centers[q][0];
+      const double dy = points[i][1] - centers[q][1];
+      if (dx * dx + dy * dy <= radius * radius) {
+        expected.push_back(i);
+      }
+    }
+    EXPECT_EQ(tree.radiusQuery(centers[q], radius, result), expected.size());
+    std::sort(result.begin(), result.end());
+    EXPECT_EQ(result, expected);
+    std::sort(results[q].begin(), results[q].end());
+    EXPECT_EQ(results[q], expected);
+  }
+}
@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+
+#include <spatiumgl/idx/LinearOctree.hpp>
+#include <spatiumgl/idx/Morton.hpp>
+
+#include <vector>
+
+TEST(Morton, encodeDecode)
+{
+  EXPECT_EQ(spgl::idx::mortonEncode(0, 0, 0), 0u);
+  EXPECT_EQ(spgl::idx::mortonEncode(1, 0, 0), 1u);
+  EXPECT_EQ(spgl::idx::mortonEncode(0, 1, 0), 2u);
+  EXPECT_EQ(spgl::idx::mortonEncode(0, 0, 1), 4u);
+  EXPECT_EQ(spgl::idx::mortonEncode(3, 3, 3), 63u);
+
+  const std::uint32_t values[] = { 0, 1, 2, 1000, 123456, 0x1fffff };
+  for (std::uint32_t x : values) {
+    for (std::uint32_t y : values) {
+      for (std::uint32_t z : values) {
+        std::uint32_t dx, dy, dz;
+        spgl::idx::mortonDecode(spgl::idx::mortonEncode(x, y, z), dx, dy, dz);
+        EXPECT_EQ(dx, x);
+        EXPECT_EQ(dy, y);
+        EXPECT_EQ(dz, z);
+      }
+    }
+  }
+}
+
+TEST(Morton, childIndex)
+{
+  // Top level bit of X and Z set -> child 5
+  const std::uint32_t top = 1u << (spgl::idx::MortonMaxDepth - 1);
+  const std::uint64_t code = spgl::idx::mortonEncode(top, 0, top | 1);
+  EXPECT_EQ(spgl::idx::mortonChildIndex(code, 1), 5u);
+  EXPECT_EQ(spgl::idx::mortonChildIndex(code, 2), 0u);
+  EXPECT_EQ(spgl::idx::mortonChildIndex(code, spgl::idx::MortonMaxDepth), 4u);
+}
+
+TEST(LinearOctree, addChildren)
+{
+  spgl::idx::LinearOctree octree(spgl::BoundingCube({ 0, 0, 0 }, 8));
+  EXPECT_EQ(octree.nodeCount(), 1u);
+  EXPECT_TRUE(octree.isLeaf(octree.root()));
+
+  // Root: children 1, 4 and 6
+  EXPECT_TRUE(octree.addChildren(0, 0x52));
+  EXPECT_FALSE(octree.addChildren(0, 0x01)); // already expanded
+  EXPECT_EQ(octree.nodeCount(), 4u);
+  EXPECT_EQ(octree.childCount(0), 3u);
+  EXPECT_EQ(octree.child(0, 0), spgl::idx::LinearOctree::InvalidNode);
+  EXPECT_EQ(octree.child(0, 1), 1u);
+  EXPECT_EQ(octree.child(0, 4), 2u);
+  EXPECT_EQ(octree.child(0, 6), 3u);
+  EXPECT_EQ(octree.child(0, 8), spgl::idx::LinearOctree::InvalidNode);
+
+  // Children of node 3, then node 2 is out of breadth-first order
+  EXPECT_TRUE(octree.addChildren(3, 0x81));
+  EXPECT_FALSE(octree.addChildren(2, 0x01));
+  EXPECT_EQ(octree.child(3, 0), 4u);
+  EXPECT_EQ(octree.child(3, 7), 5u);
+  EXPECT_TRUE(octree.isLeaf(4));
+  EXPECT_FALSE(octree.addChildren(6, 0x01)); // no such node
+}
+
+TEST(LinearOctree, convertOctree)
+{
+  spgl::idx::Octree octree(spgl::BoundingCube({ 1, 2, 3 }, 4));
+  spgl::idx::OctreeNode* node = octree.root();
+  node->createChild(0);
+  node->createChild(2);
+  node->createChild(7);
+  node->child(2)->createChild(3);
+  node->child(2)->createChild(5);
+  node->child(7)->createChild(1);
+  node->child(2)->child(5)->createChild(6);
+
+  const spgl::idx::LinearOctree linear =
+    spgl::idx::LinearOctree::fromOctree(octree);
+  EXPECT_EQ(linear.nodeCount(), 8u);
+  EXPECT_EQ(linear.bounds().center(), octree.bounds().center());
+  EXPECT_EQ(linear.childMask(0), 0x85);
+
+  const spgl::idx::LinearOctree::NodeIndex child2 = linear.child(0, 2);
+  const spgl::idx::LinearOctree::NodeIndex child25 = linear.child(child2, 5);
+  ASSERT_NE(child25, spgl::idx::LinearOctree::InvalidNode);
+  EXPECT_NE(linear.child(child25, 6), spgl::idx::LinearOctree::InvalidNode);
+  EXPECT_EQ(linear.child(child25, 5), spgl::idx::LinearOctree::InvalidNode);
+
+  // Round trip
+  const spgl::idx::Octree copy = linear.toOctree();
+  EXPECT_TRUE(copy.root()->child(0) != nullptr);
+  EXPECT_TRUE(copy.root()->child(1) == nullptr);
+  EXPECT_TRUE(copy.root()->child(7)->child(1) != nullptr);
+  EXPECT_TRUE(copy.root()->child(2)->child(5)->child(6) != nullptr);
+  EXPECT_TRUE(copy.root()->child(2)->child(3)->child(6) == nullptr);
+  EXPECT_EQ(spgl::idx::LinearOctree::fromOctree(copy).nodeCount(), 8u);
+}
+
+TEST(LinearOctree, traverse)
+{
+  spgl::idx::LinearOctree octree(spgl::BoundingCube({ 0, 0, 0 }, 4));
+  octree.addChildren(0, 0x09); // children 0 and 3
+  octree.addChildren(1, 0x80); // child 7 of child 0
+  octree.addChildren(2, 0x01); // child 0 of child 3
+
+  // Depth-first, children in child index order
+  std::vector<spgl::idx::LinearOctree::NodeIndex> order;
+  std::vector<size_t> depths;
+  octree.traverse([&](spgl::idx::LinearOctree::NodeIndex node,
+                      const spgl::BoundingCube& bounds,
+                      size_t depth) {
+    order.push_back(node);
+    depths.push_back(depth);
+    if (node == 3) {
+      // Child 7 of child 0
+      EXPECT_EQ(bounds.center(), spgl::Vector3(-1, -1, -1));
+      EXPECT_EQ(bounds.radius(), 1);
+    }
+    return true;
+  });
+  using Nodes = std::vector<spgl::idx::LinearOctree::NodeIndex>;
+  EXPECT_EQ(order, (Nodes{ 0, 1, 3, 2, 4 }));
+  EXPECT_EQ(depths, (std::vector<size_t>{ 0, 1, 2, 1, 2 }));
+
+  // Pruning
+  order.clear();
+  octree.traverse([&](spgl::idx::LinearOctree::NodeIndex node,
+                      const spgl::BoundingCube&,
+                      size_t) {
+    order.push_back(node);
+    return node != 1;
+  });
+  EXPECT_EQ(order, (Nodes{ 0, 1, 2, 4 }));
+}
@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+
+#include <spatiumgl/idx/OctreeHierarchyFile.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+namespace {
+
+/// Compare hierarchy file with octree, recursively.
+void
+compare(spgl::idx::OctreeHierarchyFile& file,
+        const spgl::idx::OctreeHierarchyFile::Node& node,
+        const spgl::idx::OctreeNode* octreeNode,
+        size_t& count)
+{
+  count++;
+  for (size_t i = 0; i < 8; i++) {
+    spgl::idx::OctreeHierarchyFile::Node child;
+    const bool exists = file.child(node, i, child);
+    ASSERT_EQ(exists, octreeNode->child(i) != nullptr);
+    EXPECT_EQ((file.childMask(node) >> i) & 1, exists ? 1 : 0);
+    if (exists) {
+      compare(file, child, octreeNode->child(i), count);
+    }
+  }
+}
+
+} // namespace
+
+TEST(OctreeHierarchyFile, writeOpen)
+{
+  std::vector<spgl::Vector3f> points;
+  for (size_t i = 0; i < 20000; i++) {
+    points.push_back({ static_cast<float>((i * 7919) % 1000),
+                       static_cast<float>((i * 104729) % 1000),
+                       static_cast<float>((i * 31) % 100) });
+  }
+  const spgl::idx::Octree octree = spgl::idx::Octree::build(points, 4);
+  ASSERT_GT(octree.nodeCount(), 1000u);
+
+  const std::string fileName = "octree_paged.idx";
+  EXPECT_GT(spgl::idx::OctreeHierarchyFile::write(octree, fileName, 3, 2.5f), 0u);
+
+  spgl::idx::OctreeHierarchyFile file;
+  ASSERT_TRUE(file.open(fileName));
+  EXPECT_EQ(file.pageDepth(), 3u);
+  EXPECT_EQ(file.spacing(), 2.5f);
+  EXPECT_EQ(file.nodeCount(), octree.nodeCount());
+  EXPECT_EQ(file.bounds().center(), octree.bounds().center());
+  EXPECT_EQ(file.bounds().radius(), octree.bounds().radius());
+  EXPECT_EQ(file.loadedPageCount(), 1u); // Lazy: only the root page
+
+  // Navigate to first leaf: only the pages on the path are loaded
+  spgl::idx::OctreeHierarchyFile::Node node = file.root();
+  size_t depth = 0;
+  while (file.childMask(node) != 0) {
+    size_t i = 0;
+    while (((file.childMask(node) >> i) & 1) == 0) {
+      i++;
+    }
+    ASSERT_TRUE(file.child(node, i, node));
+    depth++;
+  }
+  EXPECT_EQ(file.loadedPageCount(), depth / 3 + 1);
+
+  // Entire hierarchy
+  size_t count = 0;
+  compare(file, file.root(), octree.root(), count);
+  EXPECT_EQ(count, octree.nodeCount());
+
+  spgl::idx::Octree copy({});
+  ASSERT_TRUE(file.readOctree(copy));
+  EXPECT_EQ(copy.nodeCount(), octree.nodeCount());
+  EXPECT_EQ(copy.bounds().center(), octree.bounds().center());
+
+  file.close();
+  EXPECT_FALSE(file.isOpen());
+  std::remove(fileName.c_str());
+}
+
+TEST(OctreeHierarchyFile, invalid)
+{
+  spgl::idx::OctreeHierarchyFile file;
+  EXPECT_FALSE(file.open("does_not_exist.idx"));
+
+  const std::string fileName = "octree_invalid.idx";
+  {
+    std::ofstream ofile(fileName, std::ios::binary);
+    ofile << std::string(100, 'x');
+  }
+  EXPECT_FALSE(file.open(fileName));
+  EXPECT_FALSE(file.isOpen());
+  std::remove(fileName.c_str());
+}
+
+TEST(OctreeHierarchyFile, corruptRoot)
+{
+  spgl::idx::Octree octree({});
+  octree.root()->createChild(3);
+  const std::string fileName = "octree_corrupt.idx";
+  ASSERT_GT(spgl::idx::OctreeHierarchyFile::write(octree, fileName, 2, 1), 0u);
+
+  // Root page without nodes
+  std::uint64_t rootOffset = 0;
+  {
+    std::fstream file(fileName,
+                      std::ios::in | std::ios::out | std::ios::binary);
+    file.seekg(64);
+    file.read(reinterpret_cast<char*>(&rootOffset), 8);
+    const std::uint32_t nodeCount = 0;
+    file.seekp(static_cast<std::streamoff>(rootOffset));
+    file.write(reinterpret_cast<const char*>(&nodeCount), 4);
+  }
+  spgl::idx::OctreeHierarchyFile file;
+  EXPECT_FALSE(file.open(fileName));
+  EXPECT_FALSE(file.isOpen());
+
+  std::remove(fileName.c_str());
+}
+
+TEST(OctreeHierarchyFile, cyclicPage)
+{
+  spgl::idx::Octree octree({});
+  octree.root()->createChild(3);
+  const std::string fileName = "octree_cyclic.idx";
+  ASSERT_GT(spgl::idx::OctreeHierarchyFile::write(octree, fileName, 1, 1), 0u);
+
+  // Child page of the root page is the root page itself
+  {
+    std::fstream file(fileName,
+                      std::ios::in | std::ios::out | std::ios::binary);
+    std::uint64_t rootOffset = 0;
+    file.seekg(64);
+    file.read(reinterpret_cast<char*>(&rootOffset), 8);
+    file.seekp(static_cast<std::streamoff>(rootOffset + 16)); // After mask
+    file.write(reinterpret_cast<const char*>(&rootOffset), 8);
+  }
+  spgl::idx::OctreeHierarchyFile file;
+  ASSERT_TRUE(file.open(fileName));
+  spgl::idx::OctreeHierarchyFile::Node child;
+  EXPECT_EQ(file.childMask(file.root()), 1u << 3);
+  EXPECT_FALSE(file.child(file.root(), 3, child));
+  spgl::idx::Octree result({});
+  EXPECT_FALSE(file.readOctree(result));
+  file.close();
+
+  std::remove(fileName.c_str());
+}
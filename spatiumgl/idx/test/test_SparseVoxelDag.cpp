@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+
+#include <spatiumgl/idx/SparseVoxelDag.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+namespace {
+
+/// Voxelized facades: vertical planes on a regular grid, one point per voxel.
+std::vector<spgl::Vector3f>
+facadePoints()
+{
+  std::vector<spgl::Vector3f> points;
+  for (int x = 0; x < 64; x++) {
+    for (int y = 0; y < 64; y++) {
+      for (int z = 0; z < 32; z++) {
+        if (x % 16 == 0 || y % 16 == 0) {
+          points.push_back({ x + 0.5f, y + 0.5f, z + 0.5f });
+        }
+      }
+    }
+  }
+  return points;
+}
+
+} // namespace
+
+TEST(SparseVoxelDag, fromOctree)
+{
+  const std::vector<spgl::Vector3f> points = facadePoints();
+  const spgl::idx::Octree octree = spgl::idx::Octree::build(points, 1);
+  const spgl::idx::SparseVoxelDag dag =
+    spgl::idx::SparseVoxelDag::fromOctree(octree);
+  EXPECT_EQ(dag.sourceNodeCount(), octree.nodeCount());
+  EXPECT_LT(dag.nodeCount() * 10, dag.sourceNodeCount());
+
+  const spgl::idx::LinearOctree linear =
+    spgl::idx::LinearOctree::fromOctree(octree);
+  EXPECT_LT(dag.memoryUsage() * 10, linear.memoryUsage());
+
+  // Expands to the same topology
+  const spgl::idx::LinearOctree expanded = dag.toLinearOctree();
+  ASSERT_EQ(expanded.nodeCount(), linear.nodeCount());
+  for (spgl::idx::LinearOctree::NodeIndex i = 0; i < linear.nodeCount(); i++) {
+    EXPECT_EQ(expanded.childMask(i), linear.childMask(i));
+  }
+
+  // Traversal visits every node of the source with its bounds
+  size_t count = 0;
+  size_t leaves = 0;
+  dag.traverse([&](spgl::idx::SparseVoxelDag::NodeIndex node,
+                   const spgl::BoundingCube& bounds,
+                   size_t) {
+    count++;
+    if (dag.isLeaf(node)) {
+      leaves++;
+      EXPECT_TRUE(dag.contains(bounds.center()));
+    }
+    return true;
+  });
+  EXPECT_EQ(count, octree.nodeCount());
+  EXPECT_EQ(leaves, points.size());
+
+  // Occupancy
+  for (size_t i = 0; i < points.size(); i += 7) {
+    EXPECT_TRUE(dag.contains(points[i].staticCast<double>()));
+  }
+  EXPECT_FALSE(dag.contains({ 8.5, 8.5, 8.5 }));
+  EXPECT_FALSE(dag.contains({ -100, 0, 0 }));
+
+  // Empty octree
+  const spgl::idx::SparseVoxelDag single =
+    spgl::idx::SparseVoxelDag::fromOctree(spgl::idx::Octree({}));
+  EXPECT_EQ(single.nodeCount(), 1u);
+  EXPECT_TRUE(single.isLeaf(single.root()));
+}
+
+TEST(SparseVoxelDag, readWrite)
+{
+  const spgl::idx::Octree octree =
+    spgl::idx::Octree::build(facadePoints(), 1);
+  const spgl::idx::SparseVoxelDag dag =
+    spgl::idx::SparseVoxelDag::fromOctree(octree);
+  EXPECT_GT(spgl::idx::SparseVoxelDag::writeToFile(dag, "dag.svdag"), 0u);
+
+  spgl::idx::SparseVoxelDag dagIn;
+  ASSERT_TRUE(spgl::idx::SparseVoxelDag::readFromFile("dag.svdag", dagIn));
+  EXPECT_EQ(dagIn.nodeCount(), dag.nodeCount());
+  EXPECT_EQ(dagIn.sourceNodeCount(), dag.sourceNodeCount());
+  EXPECT_EQ(dagIn.root(), dag.root());
+  EXPECT_EQ(dagIn.bounds().center(), dag.bounds().center());
+  EXPECT_EQ(dagIn.bounds().radius(), dag.bounds().radius());
+  EXPECT_EQ(dagIn.toLinearOctree().nodeCount(), octree.nodeCount());
+
+  // Invalid child mask is rejected
+  {
+    std::fstream file("dag.svdag",
+                      std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(72 + 4);
+    const std::uint32_t invalid = 0xfffffff0;
+    file.write(reinterpret_cast<const char*>(&invalid), sizeof(invalid));
+  }
+  spgl::idx::SparseVoxelDag corrupt;
+  EXPECT_FALSE(spgl::idx::SparseVoxelDag::readFromFile("dag.svdag", corrupt));
+  EXPECT_EQ(corrupt.nodeCount(), 1u);
+  EXPECT_FALSE(
+    spgl::idx::SparseVoxelDag::readFromFile("missing.svdag", corrupt));
+  std::remove("dag.svdag");
+}
@@ -3,6 +3,15 @@
 #include <spatiumgl/idx/NTree.hpp>
 #include <spatiumgl/idx/Octree.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <string>
+#include <vector>
+
 TEST(Tree, NQuadtree)
 {
   spgl::idx::NTree<4> quadtree;
@@ -45,12 +54,14 @@ TEST(Tree, ReadWriteOctree) {
   node->child(6)->createChild(2);
   node->child(6)->createChild(3);
 
-  // Write to file
-  EXPECT_GT(spgl::idx::Octree::writeToFile(octreeOut, "octree.idx"), 0);
+  // Write to file (in the temporary directory)
+  const std::string fileName = testing::TempDir() + "octree.idx";
+  EXPECT_GT(spgl::idx::Octree::writeToFile(octreeOut, fileName), 0);
 
   // Read from file
   spgl::idx::Octree octreeIn({});
-  EXPECT_TRUE(spgl::idx::Octree::readFromFile("octree.idx", octreeIn));
+  EXPECT_TRUE(spgl::idx::Octree::readFromFile(fileName, octreeIn));
+  std::remove(fileName.c_str());
 
   // Compare octrees
   EXPECT_TRUE(octreeIn.root() != nullptr);
@@ -70,4 +81,518 @@ TEST(Tree, ReadWriteOctree) {
   EXPECT_TRUE(octreeIn.root()->child(6)->child(5) == nullptr);
   EXPECT_TRUE(octreeIn.root()->child(6)->child(6) == nullptr);
   EXPECT_TRUE(octreeIn.root()->child(6)->child(7) == nullptr);
-}
\ No newline at end of file
+}
+TEST(Tree, OctreeChildBounds)
+{
+  const spgl::BoundingCube parent({ 1, 2, 3 }, 4);
+
+  const spgl::BoundingCube child0 =
+    spgl::idx::Octree::computeChildBounds(parent, 0);
+  EXPECT_EQ(child0.center(), spgl::Vector3(-1, 0, 1));
+  EXPECT_EQ(child0.radius(), 2);
+
+  const spgl::BoundingCube child3 =
+    spgl::idx::Octree::computeChildBounds(parent, 3);
+  EXPECT_EQ(child3.center(), spgl::Vector3(3, 4, 1));
+
+  const spgl::BoundingCube child5 =
+    spgl::idx::Octree::computeChildBounds(parent, 5);
+  EXPECT_EQ(child5.center(), spgl::Vector3(3, 0, 5));
+
+  const spgl::BoundingCube child7 =
+    spgl::idx::Octree::computeChildBounds(parent, 7);
+  EXPECT_EQ(child7.center(), spgl::Vector3(3, 4, 5));
+
+  const spgl::BoundingCube invalid =
+    spgl::idx::Octree::computeChildBounds(parent, 8);
+  EXPECT_EQ(invalid.center(), parent.center());
+  EXPECT_EQ(invalid.radius(), parent.radius());
+}
+
+TEST(Tree, NTreePayload)
+{
+  spgl::idx::NTree<4, std::string> quadtree;
+  spgl::idx::NTreeNode<4, std::string>* node = quadtree.root();
+  EXPECT_TRUE(node->data().empty());
+  node->data() = "root";
+
+  EXPECT_TRUE(node->createChild(1, "child"));
+  EXPECT_TRUE(node->createChild(2, 3, 'x'));
+  EXPECT_EQ(node->child(1)->data(), "child");
+  EXPECT_EQ(node->child(2)->data(), "xxx");
+  EXPECT_TRUE(node->child(1)->createChild(0, "grandchild"));
+  EXPECT_EQ(quadtree.nodeCount(), 4u);
+
+  // Deleting a child deletes its descendants
+  EXPECT_TRUE(node->deleteChild(1));
+  EXPECT_EQ(quadtree.nodeCount(), 2u);
+  EXPECT_EQ(node->data(), "root");
+}
+
+TEST(Tree, NTreeAllocator)
+{
+  spgl::idx::NTree<8> octree(4);
+  spgl::idx::NTreeNode<8>* node = octree.root();
+  for (size_t i = 0; i < 8; i++) {
+    EXPECT_TRUE(node->createChild(i));
+  }
+  EXPECT_EQ(octree.nodeCount(), 9u);
+
+  // Deleted nodes are recycled
+  spgl::idx::NTreeNode<8>* child = node->child(3);
+  EXPECT_TRUE(node->deleteChild(3));
+  EXPECT_TRUE(node->createChild(3));
+  EXPECT_EQ(node->child(3), child);
+  EXPECT_EQ(octree.nodeCount(), 9u);
+
+  // Move
+  spgl::idx::NTree<8> moved(std::move(octree));
+  EXPECT_EQ(moved.root(), node);
+  EXPECT_EQ(moved.nodeCount(), 9u);
+  EXPECT_TRUE(octree.root() == nullptr);
+  EXPECT_EQ(octree.nodeCount(), 0u);
+  EXPECT_TRUE(moved.root()->child(3)->createChild(0));
+  EXPECT_EQ(moved.nodeCount(), 10u);
+}
+
+TEST(Tree, OctreeBuild)
+{
+  std::vector<spgl::Vector3f> points;
+  unsigned int seed = 1;
+  for (size_t i = 0; i < 200000; i++) {
+    seed = seed * 1103515245 + 12345;
+    const float x = static_cast<float>((seed >> 8) % 1000);
+    seed = seed * 1103515245 + 12345;
+    const float y = static_cast<float>((seed >> 8) % 500);
+    // Cluster of duplicates every 10th point
+    points.push_back(i % 10 == 0 ? spgl::Vector3f(1, 2, 3)
+                                 : spgl::Vector3f(x, y, x * 0.1f));
+  }
+  points[12345][0] = std::numeric_limits<float>::quiet_NaN();
+
+  const size_t maxPointsPerLeaf = 100;
+  const spgl::idx::Octree octree =
+    spgl::idx::Octree::build(points, maxPointsPerLeaf, 4);
+  ASSERT_EQ(octree.indices().size(), points.size());
+  EXPECT_EQ(octree.root()->data().begin, 0u);
+  EXPECT_EQ(octree.root()->data().end, points.size());
+
+  // Indices are a permutation
+  std::vector<bool> found(points.size(), false);
+  for (std::uint32_t index : octree.indices()) {
+    ASSERT_LT(index, points.size());
+    EXPECT_FALSE(found[index]);
+    found[index] = true;
+  }
+
+  // Leaves cover all points, in order, and contain only their points
+  size_t next = 0;
+  size_t leaves = 0;
+  std::vector<std::pair<const spgl::idx::OctreeNode*, spgl::BoundingCube>>
+    stack;
+  stack.push_back({ octree.root(), octree.bounds() });
+  while (!stack.empty()) {
+    const auto entry = stack.back();
+    stack.pop_back();
+    const spgl::idx::OctreePointRange& range = entry.first->data();
+    bool leaf = true;
+    size_t childBegin = range.begin;
+    for (size_t i = 8; i-- > 0;) {
+      const spgl::idx::OctreeNode* child = entry.first->child(i);
+      if (child != nullptr) {
+        leaf = false;
+        stack.push_back(
+          { child, spgl::idx::Octree::computeChildBounds(entry.second, i) });
+      }
+    }
+    for (size_t i = 0; i < 8; i++) {
+      const spgl::idx::OctreeNode* child = entry.first->child(i);
+      if (child != nullptr) {
+        EXPECT_EQ(child->data().begin, childBegin);
+        childBegin = child->data().end;
+      }
+    }
+    if (!leaf) {
+      EXPECT_EQ(childBegin, range.end);
+      continue;
+    }
+
+    leaves++;
+    EXPECT_EQ(range.begin, next);
+    next = range.end;
+    const bool duplicates = (range.size() > maxPointsPerLeaf);
+    const double tolerance = entry.second.radius() * 1e-3;
+    for (size_t i = range.begin; i < range.end; i++) {
+      const spgl::Vector3f& point = points[octree.indices()[i]];
+      if (duplicates) {
+        EXPECT_EQ(point, spgl::Vector3f(1, 2, 3));
+      }
+      if (std::isnan(point[0])) {
+        continue; // Invalid position: in any leaf
+      }
+      for (size_t axis = 0; axis < 3; axis++) {
+        EXPECT_LE(std::abs(point[axis] - entry.second.center()[axis]),
+                  entry.second.radius() + tolerance);
+      }
+    }
+  }
+  EXPECT_EQ(next, points.size());
+  EXPECT_GT(leaves, points.size() / maxPointsPerLeaf / 8);
+
+  // Independent of number of threads
+  const spgl::idx::Octree single =
+    spgl::idx::Octree::build(points, maxPointsPerLeaf, 1);
+  EXPECT_EQ(single.indices(), octree.indices());
+  EXPECT_EQ(single.nodeCount(), octree.nodeCount());
+
+  // Empty
+  const spgl::idx::Octree empty = spgl::idx::Octree::build(
+    std::vector<spgl::Vector3f>(), maxPointsPerLeaf);
+  EXPECT_TRUE(empty.indices().empty());
+  EXPECT_EQ(empty.nodeCount(), 1u);
+}
+
+TEST(Tree, OctreeKnn)
+{
+  std::vector<spgl::Vector3f> points;
+  unsigned int seed = 7;
+  auto random = [&seed]() {
+    seed = seed * 1103515245 + 12345;
+    return static_cast<float>((seed >> 8) % 10000) / 100;
+  };
+  for (size_t i = 0; i < 20000; i++) {
+    points.push_back({ random(), random(), random() / 10 });
+  }
+  std::vector<spgl::Vector3f> queries;
+  for (size_t i = 0; i < 200; i++) {
+    queries.push_back({ random() * 1.2f - 10, random(), random() / 10 });
+  }
+  queries.push_back(points[123]);
+
+  const spgl::idx::Octree octree = spgl::idx::Octree::build(points, 32, 2);
+  ASSERT_EQ(octree.points().size(), points.size());
+  EXPECT_EQ(octree.points()[5], points[octree.indices()[5]]);
+
+  const size_t k = 10;
+  const std::vector<spgl::idx::OctreeNeighbor> batch =
+    octree.knn(queries, k, 3);
+  ASSERT_EQ(batch.size(), queries.size() * k);
+  for (size_t q = 0; q < queries.size(); q++) {
+    // Brute force
+    std::vector<float> distances;
+    for (const spgl::Vector3f& point : points) {
+      const spgl::Vector3f delta = point - queries[q];
+      distances.push_back(delta[0] * delta[0] + delta[1] * delta[1] +
+                          delta[2] * delta[2]);
+    }
+    std::sort(distances.begin(), distances.end());
+
+    const std::vector<spgl::idx::OctreeNeighbor> result =
+      octree.knn(queries[q], k);
+    ASSERT_EQ(result.size(), k);
+    for (size_t i = 0; i < k; i++) {
+      EXPECT_EQ(result[i].distanceSquared, distances[i]);
+      EXPECT_EQ(batch[q * k + i].distanceSquared, distances[i]);
+      const spgl::Vector3f delta = points[result[i].index] - queries[q];
+      EXPECT_EQ(delta[0] * delta[0] + delta[1] * delta[1] +
+                  delta[2] * delta[2],
+                result[i].distanceSquared);
+    }
+  }
+  EXPECT_EQ(octree.knn(points[123], 1)[0].distanceSquared, 0);
+
+  // Fewer points than k
+  const spgl::idx::Octree small = spgl::idx::Octree::build(
+    std::vector<spgl::Vector3f>{ { 0, 0, 0 }, { 1, 0, 0 } }, 1);
+  spgl::idx::OctreeNeighbor neighbors[3];
+  EXPECT_EQ(small.knn({ 0.9f, 0, 0 }, 3, neighbors), 2u);
+  EXPECT_EQ(neighbors[0].index, 1u);
+  EXPECT_EQ(neighbors[1].index, 0u);
+  EXPECT_EQ(neighbors[2].index, spgl::idx::OctreeNeighbor::InvalidIndex);
+  EXPECT_TRUE(spgl::idx::Octree({}).knn(spgl::Vector3f(0, 0, 0), 3).empty());
+}
+
+TEST(Tree, OctreeRangeQuery)
+{
+  std::vector<spgl::Vector3f> points;
+  unsigned int seed = 3;
+  auto random = [&seed]() {
+    seed = seed * 1103515245 + 12345;
+    return static_cast<float>((seed >> 8) % 10000) / 100;
+  };
+  for (size_t i = 0; i < 20000; i++) {
+    points.push_back({ random(), random(), random() });
+  }
+  const spgl::idx::Octree octree = spgl::idx::Octree::build(points, 16, 2);
+
+  std::vector<spgl::Vector3f> centers;
+  std::vector<spgl::BoundingBox> boxes;
+  for (size_t i = 0; i < 50; i++) {
+    centers.push_back({ random(), random(), random() });
+    boxes.push_back(spgl::BoundingBox(
+      { random(), random(), random() }, { random() / 2, random() / 4, 30 }));
+  }
+  const float radius = 20;
+
+  std::vector<std::vector<std::uint32_t>> radiusResults(centers.size());
+  octree.radiusQuery(
+    centers.data(), centers.size(), radius, radiusResults.data(), 3);
+  std::vector<std::vector<std::uint32_t>> boxResults(boxes.size());
+  octree.boxQuery(boxes.data(), boxes.size(), boxResults.data(), 3);
+
+  std::vector<std::uint32_t> result;
+  for (size_t q = 0; q < centers.size(); q++) {
+    // Brute force
+    std::vector<std::uint32_t> expected;
+    for (std::uint32_t i = 0; i < points.size(); i++) {
+      const spgl::Vector3f delta = points[i] - centers[q];
+      if (delta[0] * delta[0] + delta[1] * delta[1] + delta[2] * delta[2] <=
+          radius * radius) {
+        expected.push_back(i);
+      }
+    }
+    EXPECT_EQ(octree.radiusQuery(centers[q], radius, result), expected.size());
+    std::sort(result.begin(), result.end());
+    EXPECT_EQ(result, expected);
+    std::sort(radiusResults[q].begin(), radiusResults[q].end());
+    EXPECT_EQ(radiusResults[q], expected);
+
+    expected.clear();
+    const spgl::Vector3 min = boxes[q].min();
+    const spgl::Vector3 max = boxes[q].max();
+    for (std::uint32_t i = 0; i < points.size(); i++) {
+      bool inside = true;
+      for (size_t axis = 0; axis < 3; axis++) {
+        inside = inside && points[i][axis] >= min[axis] &&
+                 points[i][axis] <= max[axis];
+      }
+      if (inside) {
+        expected.push_back(i);
+      }
+    }
+    EXPECT_EQ(octree.boxQuery(boxes[q], result), expected.size());
+    std::sort(result.begin(), result.end());
+    EXPECT_EQ(result, expected);
+    std::sort(boxResults[q].begin(), boxResults[q].end());
+    EXPECT_EQ(boxResults[q], expected);
+  }
+
+  // Entire octree
+  size_t visited = 0;
+  octree.visitBox(spgl::BoundingBox({ 50, 50, 50 }, { 100, 100, 100 }),
+                  [&](std::uint32_t) { visited++; });
+  EXPECT_EQ(visited, points.size());
+}
+
+TEST(Tree, NTreeIterators)
+{
+  // Root with children 1 and 3; child 1 has children 0 and 2
+  spgl::idx::NTree<4> quadtree;
+  spgl::idx::NTreeNode<4>* root = quadtree.root();
+  root->createChild(1);
+  root->createChild(3);
+  root->child(1)->createChild(0);
+  root->child(1)->createChild(2);
+
+  // Depth-first (pre-order)
+  std::vector<std::uint64_t> paths;
+  std::vector<size_t> depths;
+  for (const auto& entry : quadtree.depthFirst()) {
+    paths.push_back(entry.path);
+    depths.push_back(entry.depth);
+  }
+  EXPECT_EQ(paths, std::vector<std::uint64_t>({ 0, 1, 4, 6, 3 }));
+  EXPECT_EQ(depths, std::vector<size_t>({ 0, 1, 2, 2, 1 }));
+
+  // Breadth-first
+  paths.clear();
+  for (const auto& entry : quadtree.breadthFirst()) {
+    paths.push_back(entry.path);
+  }
+  EXPECT_EQ(paths, std::vector<std::uint64_t>({ 0, 1, 3, 4, 6 }));
+
+  // Pruning predicate
+  auto notChild1 = [](const spgl::idx::NTreeEntry<4>& entry) {
+    return entry.path != 1;
+  };
+  paths.clear();
+  for (const auto& entry : quadtree.depthFirst(notChild1)) {
+    paths.push_back(entry.path);
+  }
+  EXPECT_EQ(paths, std::vector<std::uint64_t>({ 0, 3 }));
+  paths.clear();
+  for (const auto& entry : quadtree.breadthFirst(notChild1)) {
+    paths.push_back(entry.path);
+  }
+  EXPECT_EQ(paths, std::vector<std::uint64_t>({ 0, 3 }));
+
+  // Skip children
+  paths.clear();
+  auto range = quadtree.depthFirst();
+  for (auto it = range.begin(); it != range.end(); ++it) {
+    paths.push_back(it->path);
+    if (it->depth == 1) {
+      it.skipChildren();
+    }
+  }
+  EXPECT_EQ(paths, std::vector<std::uint64_t>({ 0, 1, 3 }));
+}
+
+TEST(Tree, OctreeIterators)
+{
+  std::vector<spgl::Vector3f> points;
+  unsigned int seed = 5;
+  for (size_t i = 0; i < 20000; i++) {
+    seed = seed * 1103515245 + 12345;
+    const float x = static_cast<float>((seed >> 8) % 1000);
+    seed = seed * 1103515245 + 12345;
+    const float y = static_cast<float>((seed >> 8) % 1000);
+    points.push_back({ x, y, (x + y) * 0.01f });
+  }
+  const spgl::idx::Octree octree = spgl::idx::Octree::build(points, 16, 2);
+
+  // Bounds and Morton path are derived incrementally
+  size_t count = 0;
+  size_t leafPoints = 0;
+  for (const spgl::idx::OctreeEntry& entry : octree.depthFirst()) {
+    count++;
+    spgl::BoundingCube bounds = octree.bounds();
+    const spgl::idx::OctreeNode* node = octree.root();
+    for (size_t level = 1; level <= entry.depth; level++) {
+      const size_t childIndex =
+        static_cast<size_t>(entry.path >> (3 * (entry.depth - level))) & 7;
+      bounds = spgl::idx::Octree::computeChildBounds(bounds, childIndex);
+      node = node->child(childIndex);
+    }
+    EXPECT_EQ(entry.node, node);
+    EXPECT_EQ(entry.bounds.center(), bounds.center());
+    EXPECT_EQ(entry.bounds.radius(), bounds.radius());
+    if (entry.node->isLeaf()) {
+      leafPoints += entry.node->data().size();
+    }
+  }
+  EXPECT_EQ(count, octree.nodeCount());
+  EXPECT_EQ(leafPoints, points.size());
+
+  // Breadth-first: non-decreasing depth, all nodes
+  count = 0;
+  size_t depth = 0;
+  for (const spgl::idx::OctreeEntry& entry : octree.breadthFirst()) {
+    EXPECT_GE(entry.depth, depth);
+    depth = entry.depth;
+    count++;
+  }
+  EXPECT_EQ(count, octree.nodeCount());
+
+  // Breadth-first queue holds the frontier only: at most two adjacent
+  // levels, and it grows by doubling (no copy of the whole tree)
+  std::vector<size_t> levelWidths;
+  for (const spgl::idx::OctreeEntry& entry : octree.depthFirst()) {
+    levelWidths.resize(std::max(levelWidths.size(), entry.depth + 2), 0);
+    levelWidths[entry.depth]++;
+  }
+  size_t frontier = 0;
+  for (size_t i = 0; i + 1 < levelWidths.size(); i++) {
+    frontier = std::max(frontier, levelWidths[i] + levelWidths[i + 1]);
+  }
+  auto range = octree.breadthFirst();
+  auto it = range.begin();
+  EXPECT_EQ(it.queueCapacity(), 8u);
+  size_t capacity = it.queueCapacity();
+  size_t growths = 0;
+  for (; it != range.end(); ++it) {
+    if (it.queueCapacity() != capacity) {
+      EXPECT_EQ(it.queueCapacity(), 2 * capacity);
+      capacity = it.queueCapacity();
+      growths++;
+    }
+  }
+  EXPECT_LE(capacity, 2 * frontier);
+  EXPECT_LT(capacity, octree.nodeCount());
+  EXPECT_LE(growths, static_cast<size_t>(std::log2(frontier)) + 1);
+
+  // Parallel traversal by subtree
+  std::atomic<size_t> subtreeNodes(0);
+  const size_t subtrees = spgl::idx::parallelForSubtrees(
+    octree.rootEntry(), 2, 3, [&](const spgl::idx::OctreeEntry& subtree) {
+      using Iterator = spgl::idx::
+        NTreeIteratorDF<8, spgl::idx::OctreePointRange, spgl::BoundingCube>;
+      for (Iterator it(subtree), end; it != end; ++it) {
+        subtreeNodes++;
+      }
+    });
+  size_t shallowNodes = 0;
+  for (const spgl::idx::OctreeEntry& entry : octree.breadthFirst()) {
+    if (entry.depth < 2 && !entry.node->isLeaf()) {
+      shallowNodes++;
+    }
+  }
+  EXPECT_GT(subtrees, 8u);
+  EXPECT_EQ(subtreeNodes + shallowNodes, octree.nodeCount());
+}
+
+TEST(Tree, OctreeFromPoints)
+{
+  std::vector<spgl::Vector3f> points;
+  unsigned int seed = 9;
+  auto random = [&seed]() {
+    seed = seed * 1103515245 + 12345;
+    return static_cast<float>((seed >> 8) % 6400) / 100;
+  };
+  for (size_t i = 0; i < 50000; i++) {
+    points.push_back({ random(), random(), random() / 8 });
+  }
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+  points.push_back({ nan, 1, 1 });  // Invalid: skipped
+  points.push_back({ 100, 0, 0 });  // Outside
+  points.push_back({ 64, 64, 64 }); // On the boundary
+
+  const spgl::BoundingCube bounds({ 32, 32, 32 }, 32);
+  const size_t maxDepth = 6; // Voxels of 1 x 1 x 1
+  const spgl::idx::Octree octree =
+    spgl::idx::Octree::fromPoints(points, bounds, maxDepth, 3);
+
+  // Occupied voxels (brute force)
+  std::vector<bool> occupied(64 * 64 * 64, false);
+  size_t voxels = 0;
+  for (size_t i = 0; i + 3 < points.size(); i++) {
+    const size_t x = static_cast<size_t>(points[i][0]);
+    const size_t y = static_cast<size_t>(points[i][1]);
+    const size_t z = static_cast<size_t>(points[i][2]);
+    const size_t voxel = (x * 64 + y) * 64 + z;
+    voxels += occupied[voxel] ? 0 : 1;
+    occupied[voxel] = true;
+  }
+  if (!occupied[64 * 64 * 64 - 1]) {
+    voxels++;
+    occupied[64 * 64 * 64 - 1] = true;
+  }
+
+  // Leaves are the occupied voxels, all at the maximum depth
+  size_t leaves = 0;
+  for (const spgl::idx::OctreeEntry& entry : octree.depthFirst()) {
+    if (!entry.node->isLeaf()) {
+      continue;
+    }
+    leaves++;
+    EXPECT_EQ(entry.depth, maxDepth);
+    EXPECT_EQ(entry.bounds.radius(), 0.5);
+    const spgl::Vector3& center = entry.bounds.center();
+    const size_t voxel = (static_cast<size_t>(center[0]) * 64 +
+                          static_cast<size_t>(center[1])) *
+                           64 +
+                         static_cast<size_t>(center[2]);
+    EXPECT_TRUE(occupied[voxel]);
+  }
+  EXPECT_EQ(leaves, voxels);
+
+  // Independent of number of threads
+  EXPECT_EQ(
+    spgl::idx::Octree::fromPoints(points, bounds, maxDepth, 1).nodeCount(),
+    octree.nodeCount());
+
+  // No points inside
+  const spgl::idx::Octree empty = spgl::idx::Octree::fromPoints(
+    std::vector<spgl::Vector3f>{ { -1, 0, 0 } }, bounds, maxDepth);
+  EXPECT_EQ(empty.nodeCount(), 1u);
+}
@@ -16,9 +16,12 @@
 #include "spatiumglexport.hpp"
 #include "spatiumgl/AsyncTask.hpp"
 #include "spatiumgl/gfx3d/PointCloud.hpp"
+#include "spatiumgl/gfx3d/PointOrder.hpp"
 #include "spatiumgl/io/LasReader.hpp"
 
 #include <memory> // std::unique_ptr
+#include <mutex>  // std::mutex
+#include <vector> // std::vector
 
 namespace spgl {
 namespace io {
@@ -36,9 +39,12 @@ public:
   /// \param[in] path Path to LAS/LAZ file
   /// \param[in] readRgb If RGB color should be read
   /// \param[in] readScalars If scalars should to read
+  /// \param[in] packColors If RGB colors should be packed (RGBA8, 4 bytes per
+  ///                       point instead of 12)
   LasReadTask(const std::string& path,
               bool readRgb = true,
-              LasScalars readScalars = LasScalars::None);
+              LasScalars readScalars = LasScalars::None,
+              bool packColors = false);
 
   /// Copy constructor. (deleted)
   LasReadTask(const LasReadTask& other) = delete;
@@ -60,6 +66,60 @@ public:
   /// \return Error message (empty if none)
   std::string validate();
 
+  /// Get boolean indicator if RGB colors are read: requested, and supported
+  /// by the point data format.
+  ///
+  /// Requires the LAS header (see validate()).
+  ///
+  /// \return True if read, false otherwise
+  bool readsRgb() const;
+
+  /// Get the scalars that are read: those requested, if supported by the
+  /// point data format.
+  ///
+  /// Requires the LAS header (see validate()).
+  ///
+  /// \return Scalars (None if not supported)
+  LasScalars readsScalars() const;
+
+  /// Set number of points handed out per batch while reading.
+  ///
+  /// If > 0, the points are not collected in the result but handed out in
+  /// batches (see takeBatches()), so they can be displayed while the file is
+  /// being read. The result then only holds the header. Set before start().
+  ///
+  /// \param[in] pointCount Points per batch (0 = no batches, default)
+  void setBatchSize(size_t pointCount) { m_batchSize = pointCount; }
+
+  /// Get number of points handed out per batch while reading.
+  ///
+  /// \return Points per batch (0 = no batches)
+  size_t batchSize() const { return m_batchSize; }
+
+  /// Set order of the points within blocks.
+  ///
+  /// Points are reordered after reading (per batch, if batches are handed
+  /// out), so that every prefix of a block is a uniform subsample. See
+  /// computePointOrder(). Set before start().
+  ///
+  /// \param[in] order Order within blocks (default: Original)
+  /// \param[in] blockSize Points per block (0 = one block, or the batch size)
+  void setPointOrder(gfx3d::PointOrder order, size_t blockSize = 0)
+  {
+    m_pointOrder = order;
+    m_pointBlockSize = blockSize;
+  }
+
+  /// Get order of the points within blocks.
+  ///
+  /// \return Order within blocks
+  gfx3d::PointOrder pointOrder() const { return m_pointOrder; }
+
+  /// Take the batches of points read since the last call. (thread safe)
+  ///
+  /// \return Batches, in file order
+  std::vector<gfx3d::PointCloudData> takeBatches();
+
   /// Get the LAS/LAZ reader.
   ///
   /// \return LAS/LAZ reader
@@ -73,6 +133,12 @@ private:
   LasReader m_lasReader;
   bool m_readRgb;
   LasScalars m_readScalars;
+  bool m_packColors;
+  size_t m_batchSize;
+  gfx3d::PointOrder m_pointOrder;
+  size_t m_pointBlockSize;
+  std::vector<gfx3d::PointCloudData> m_batches;
+  std::mutex m_batchesMutex;
 };
 
 } // namespace io
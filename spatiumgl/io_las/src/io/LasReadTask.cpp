@@ -19,12 +19,47 @@ namespace io {
 
 LasReadTask::LasReadTask(const std::string& path,
                          bool readRgb,
-                         LasScalars readScalars)
+                         LasScalars readScalars,
+                         bool packColors)
   : m_lasReader(path)
   , m_readRgb(readRgb)
   , m_readScalars(readScalars)
+  , m_packColors(packColors)
+  , m_batchSize(0)
+  , m_pointOrder(gfx3d::PointOrder::Original)
+  , m_pointBlockSize(0)
+  , m_batches()
+  , m_batchesMutex()
 {}
 
+std::vector<gfx3d::PointCloudData>
+LasReadTask::takeBatches()
+{
+  std::vector<gfx3d::PointCloudData> batches;
+  std::lock_guard<std::mutex> guard(m_batchesMutex);
+  batches.swap(m_batches);
+  return batches;
+}
+
+bool
+LasReadTask::readsRgb() const
+{
+  return m_readRgb &&
+         LasUtils::formatHasRgb(m_lasReader.lasHeader().point_data_format);
+}
+
+LasScalars
+LasReadTask::readsScalars() const
+{
+  const unsigned char format = m_lasReader.lasHeader().point_data_format;
+  if ((m_readScalars == LasScalars::GpsTime &&
+       !LasUtils::formatHasGpsTime(format)) ||
+      (m_readScalars == LasScalars::Nir && !LasUtils::formatHasNir(format))) {
+    return LasScalars::None;
+  }
+  return m_readScalars;
+}
+
 std::string
 LasReadTask::validate()
 {
@@ -85,38 +120,56 @@ LasReadTask::run()
 
   // Read point cloud metrics from file header
   const LasHeader& lasHeader = m_lasReader.lasHeader();
-  const bool shouldReadRgb =
-    LasUtils::formatHasRgb(lasHeader.point_data_format) && m_readRgb;
-
-  if (m_readScalars == LasScalars::GpsTime &&
-      LasUtils::formatHasGpsTime(lasHeader.point_data_format)) {
-    m_readScalars = LasScalars::None;
-  }
-  if (m_readScalars == LasScalars::Nir &&
-      LasUtils::formatHasNir(lasHeader.point_data_format)) {
-    m_readScalars = LasScalars::None;
-  }
+  const bool shouldReadRgb = readsRgb();
+  m_readScalars = readsScalars();
   const bool shouldReadScalars = (m_readScalars != LasScalars::None);
 
   const size_t pointCount = static_cast<const size_t>(
     lasHeader.number_of_point_records); // warning cast: long long to size_t
 
-  // Allocate memory for points positions
+  // Points are collected for the result, or per batch
+  const size_t capacity = (m_batchSize > 0 ? m_batchSize : pointCount);
   std::vector<Vector3f> pointPositions;
-  pointPositions.reserve(pointCount);
-
-  // Allocate memory for points colors
   std::vector<Vector3f> pointColors;
-  if (shouldReadRgb) {
-    pointColors.reserve(pointCount);
-  }
-
-  // Allocate memory for point scalars
+  std::vector<gfx3d::Rgba8> pointPackedColors;
   gfx3d::Scalars<float> pointScalars;
-  if (shouldReadScalars) {
-    pointScalars.setName(LasUtils::scalarsToString(m_readScalars));
-    pointScalars.reserve(pointCount);
-  }
+
+  // Allocate memory for point positions, colors and scalars
+  auto allocate = [&]() {
+    pointPositions.reserve(capacity);
+    if (shouldReadRgb && m_packColors) {
+      pointPackedColors.reserve(capacity);
+    } else if (shouldReadRgb) {
+      pointColors.reserve(capacity);
+    }
+    if (shouldReadScalars) {
+      pointScalars.setName(LasUtils::scalarsToString(m_readScalars));
+      pointScalars.reserve(capacity);
+    }
+  };
+  allocate();
+
+  // Reorder points within blocks
+  auto reorder = [&](gfx3d::PointCloudData& data) {
+    if (m_pointOrder != gfx3d::PointOrder::Original) {
+      data.reorder(gfx3d::computePointOrder(
+        data.positions(), m_pointBlockSize, m_pointOrder));
+    }
+  };
+
+  // Hand out the points read so far as a batch (moved)
+  auto handOutBatch = [&]() {
+    gfx3d::PointCloudData batch =
+      m_packColors ? gfx3d::PointCloudData(std::move(pointPositions),
+                                           std::move(pointPackedColors),
+                                           std::move(pointScalars))
+                   : gfx3d::PointCloudData(std::move(pointPositions),
+                                           std::move(pointColors),
+                                           std::move(pointScalars));
+    reorder(batch);
+    std::lock_guard<std::mutex> guard(m_batchesMutex);
+    m_batches.push_back(std::move(batch));
+  };
 
   // Keep track of progress
   const size_t onePercent = pointCount / 100;
@@ -126,6 +179,12 @@ LasReadTask::run()
   // Read points from file
   while (m_lasReader.readLasPoint()) {
 
+    // Stop if requested (no result)
+    if (shouldCancel()) {
+      setProgressMessage("Cancelled.");
+      return;
+    }
+
     const LasPoint& lasPoint = m_lasReader.lasPoint();
 
     // Add to position vector
@@ -133,9 +192,14 @@ LasReadTask::run()
 
     // Add to color vector
     if (shouldReadRgb) {
-      pointColors.emplace_back(static_cast<float>(lasPoint.rgb[0]) / 65535,
-                               static_cast<float>(lasPoint.rgb[1]) / 65535,
-                               static_cast<float>(lasPoint.rgb[2]) / 65535);
+      const Vector3f color(static_cast<float>(lasPoint.rgb[0]) / 65535,
+                           static_cast<float>(lasPoint.rgb[1]) / 65535,
+                           static_cast<float>(lasPoint.rgb[2]) / 65535);
+      if (m_packColors) {
+        pointPackedColors.push_back(gfx3d::packColor(color));
+      } else {
+        pointColors.push_back(color);
+      }
     }
 
     // Add scalar vector
@@ -143,6 +207,11 @@ LasReadTask::run()
       pointScalars.addValue(lasPoint.scalarValue(m_readScalars));
     }
 
+    if (m_batchSize > 0 && pointPositions.size() == m_batchSize) {
+      handOutBatch();
+      allocate();
+    }
+
     // Update progress percentage
     if (onePercent > 0) {
       pointIndex++;
@@ -154,6 +223,10 @@ LasReadTask::run()
     }
   }
 
+  if (m_batchSize > 0 && !pointPositions.empty()) {
+    handOutBatch();
+  }
+
   // Compute extent from point statistics
   const LasPointStatistics& pointStatistics = m_lasReader.lasPointStatistics();
   const BoundingBox extent = BoundingBox::fromMinMax(
@@ -164,14 +237,22 @@ LasReadTask::run()
   std::shared_ptr<gfx3d::PointCloud> pointCloud;
   gfx3d::PointCloudHeader header(
     pointCount, shouldReadRgb, shouldReadScalars, extent);
-  if (shouldReadScalars) {
+  if (m_packColors) {
+    gfx3d::PointCloudData data(std::move(pointPositions),
+                               std::move(pointPackedColors),
+                               std::move(pointScalars));
+    reorder(data);
+    pointCloud = std::make_shared<gfx3d::PointCloud>(header, std::move(data));
+  } else if (shouldReadScalars) {
     gfx3d::PointCloudData data(std::move(pointPositions),
                                std::move(pointColors),
 								std::move(pointScalars));
+    reorder(data);
     pointCloud = std::make_shared<gfx3d::PointCloud>(header, std::move(data));
   } else {
     gfx3d::PointCloudData data(std::move(pointPositions),
                                std::move(pointColors));
+    reorder(data);
     pointCloud = std::make_shared<gfx3d::PointCloud>(header, std::move(data));
   }
   